@@ -0,0 +1,61 @@
+/*!
+@file    my-tutorial-2-grid.vert
+@author  brandonjunjie.ho@digipen.edu
+@date    7/21/2023
+
+@brief
+This file contains the code for the vertex shader that pulls the vertices
+of the grid models of tutorial 2 without a vertex buffer. The position of
+a vertex is derived from gl_VertexID and the tessellation uniforms in the
+order points_model, lines_model and tristrip_model write their vertices;
+the strip is drawn one instance per stack.
+
+*//*__________________________________________________________________________*/
+
+#version 450 core
+
+uniform int uSlices;
+uniform int uStacks;
+uniform int uPrimitive; // 0: points, 1: lines, 2: triangle strip
+
+// not enabled in the empty VAO, so it holds the value of glVertexAttrib3f
+layout (location=1) in vec3 aVertexColor;
+layout (location=0) out vec3 vColor;
+
+// integer hash of the index of a grid vertex, in place of the random colors
+// tristrip_model computes on the CPU
+vec3 grid_color(uint v)
+{
+	v ^= v >> 16;
+	v *= 0x7feb352du;
+	v ^= v >> 15;
+	v *= 0x846ca68bu;
+	v ^= v >> 16;
+	return vec3(uvec3(v, v >> 8, v >> 16) & 0xFFu) / 255.0;
+}
+
+void main()
+{
+	ivec2 cell;
+	if (uPrimitive == 0)
+	{
+		// row by row
+		cell = ivec2(gl_VertexID % (uSlices + 1), gl_VertexID / (uSlices + 1));
+		vColor = aVertexColor;
+	}
+	else if (uPrimitive == 1)
+	{
+		// bottom and top end of each slice, then left and right end of each stack
+		int line = gl_VertexID / 2, end = gl_VertexID % 2;
+		cell = (line <= uSlices) ? ivec2(line, end * uStacks)
+		                         : ivec2(end * uSlices, line - uSlices - 1);
+		vColor = aVertexColor;
+	}
+	else
+	{
+		// even vertices on the row above the stack, odd ones on the row below
+		cell = ivec2(gl_VertexID / 2, gl_InstanceID + 1 - gl_VertexID % 2);
+		vColor = grid_color(uint(cell.x + cell.y * (uSlices + 1)));
+	}
+	gl_Position = vec4(vec2(cell) * 2.0 / vec2(uSlices, uStacks) - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,25 @@
+/*!
+@file    my-tutorial-3-instanced.vert
+@author  brandonjunjie.ho@digipen.edu
+@date    6/26/2023
+
+@brief
+This file contains the code for the vertex shader used by the instanced
+rendering path. The model-to-NDC matrix is fetched per instance from a
+vertex buffer instead of a uniform variable.
+
+*//*__________________________________________________________________________*/
+
+#version 450 core
+
+layout (location=0) in vec2 aVertexPosition;
+layout (location=1) in vec3 aVertexColor;
+layout (location=2) in mat3 aModel_to_NDC; // occupies locations 2, 3 and 4
+layout (location=0) out vec3 vColor;
+
+void main()
+{
+	gl_Position = vec4(vec2(aModel_to_NDC * vec3(aVertexPosition, 1.f)),
+					   0.0, 1.0);
+	vColor = aVertexColor;
+}
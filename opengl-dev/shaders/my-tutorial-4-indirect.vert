@@ -0,0 +1,40 @@
+/*!
+@file    my-tutorial-4-indirect.vert
+@author  brandonjunjie.ho@digipen.edu
+@date    7/14/2023
+
+@brief
+This file contains the code for the vertex shader used by the multi-draw
+indirect rendering path. Every object is one command of a
+glMultiDrawElementsIndirect call; gl_DrawIDARB is the index of the command
+within the call and uDrawOffset the index of the first command of the call,
+so together they index the model-to-world matrix and color of the object in
+the Draws shader storage buffer. Vertices are only taken to world space here;
+the geometry shader applies the world-to-NDC matrix of each viewport.
+
+*//*__________________________________________________________________________*/
+
+#version 450 core
+#extension GL_ARB_shader_draw_parameters : require
+
+layout (location=0) in vec2 aVertexPosition;
+
+struct Draw {
+	mat3 mdl_to_world; // model-to-world matrix of the object
+	vec4 color;        // color of the object in rgb
+};
+
+layout (std430, binding=1) readonly buffer Draws {
+	Draw uDraws[];
+};
+
+uniform uint uDrawOffset;
+
+layout (location=0) flat out vec3 vColor;
+
+void main()
+{
+	Draw draw = uDraws[uDrawOffset + uint(gl_DrawIDARB)];
+	gl_Position = vec4(draw.mdl_to_world * vec3(aVertexPosition, 1.f), 1.0);
+	vColor = draw.color.rgb;
+}
@@ -0,0 +1,33 @@
+/*!
+@file    my-tutorial-4-multiview.frag
+@author  brandonjunjie.ho@digipen.edu
+@date    7/8/2023
+
+@brief
+This file contains the code for the fragment shader used by the single-pass
+multi-viewport and the multi-draw indirect rendering paths. The main view does not draw over the minimap,
+so fragments of viewport 0 inside the minimap rectangle are discarded.
+
+*//*__________________________________________________________________________*/
+
+#version 450 core
+
+layout (std140, binding=0) uniform Views {
+	mat3 uWorld_to_NDC[2]; // per-viewport world-to-NDC matrices
+	vec4 uMapRect;         // minimap rectangle in window coordinates
+};
+
+layout (location=0) flat in vec3 gColor;
+
+layout (location=0) out vec4 fFragColor;
+
+void main ()
+{
+	if (gl_ViewportIndex == 0 &&
+		all(greaterThanEqual(gl_FragCoord.xy, uMapRect.xy)) &&
+		all(lessThan(gl_FragCoord.xy, uMapRect.zw)))
+	{
+		discard;
+	}
+	fFragColor = vec4(gColor, 1.0);
+}
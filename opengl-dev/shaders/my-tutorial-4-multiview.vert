@@ -0,0 +1,38 @@
+/*!
+@file    my-tutorial-4-multiview.vert
+@author  brandonjunjie.ho@digipen.edu
+@date    7/8/2023
+
+@brief
+This file contains the code for the vertex shader used by the single-pass
+multi-viewport rendering path. uDrawIndex indexes the model-to-world matrix
+and color of the object in the Draws shader storage buffer, which is written
+once per frame, so no other uniform is set per draw call. Vertices are only
+taken to world space here; the geometry shader applies the world-to-NDC
+matrix of each viewport.
+
+*//*__________________________________________________________________________*/
+
+#version 450 core
+
+layout (location=0) in vec2 aVertexPosition;
+
+struct Draw {
+	mat3 mdl_to_world; // model-to-world matrix of the object
+	vec4 color;        // color of the object in rgb
+};
+
+layout (std430, binding=1) readonly buffer Draws {
+	Draw uDraws[];
+};
+
+uniform uint uDrawIndex;
+
+layout (location=0) flat out vec3 vColor;
+
+void main()
+{
+	Draw draw = uDraws[uDrawIndex];
+	gl_Position = vec4(draw.mdl_to_world * vec3(aVertexPosition, 1.f), 1.0);
+	vColor = draw.color.rgb;
+}
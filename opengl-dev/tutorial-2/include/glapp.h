@@ -23,6 +23,10 @@
 /*                                                                   includes
 ----------------------------------------------------------------------------- */
 #include <glslshader.h>
+#include <bufferarena.h>
+#include <meshindex.h>
+#include <meshlod.h>
+#include <procmesh.h>
 #include <string>
 #include <vector>
 
@@ -39,6 +43,12 @@ struct GLApp {
 	  GLenum primitive_type; // which OpenGL primitive to be rendered?
 	  GLuint primitive_cnt; // added for tutorial 2
 	  GLuint vaoid; // handle to VAO
+	  BufferArena::Allocation vtx_alloc, idx_alloc; // ranges of buffer_arena
+	  GLenum idx_type; // type of the indices in idx_alloc
+	  std::vector<MeshLod::Level> lods; // levels of detail in idx_alloc, finest first
+	  std::vector<GLuint> lod_primitive_cnts; // triangles of each level
+	  GLuint lod; // level drawn
+	  GLint slices, stacks; // tessellation of a grid model; 0 for other models
 
 	  GLuint draw_cnt; // added for tutorial 2
 
@@ -49,7 +59,13 @@ struct GLApp {
 	  // member functions defined in glapp.cpp
 	  void setup_shdrpgm(std::string vtx_shdr,
 						 std::string frg_shdr);
+	  // picks the level drawn at px_per_unit pixels per model space unit
+	  // and sets draw_cnt and primitive_cnt to those of the level
+	  void set_lod(GLfloat px_per_unit);
 	  void draw();
+	  // draws a grid model with grid_pgm, which pulls its vertices from
+	  // gl_VertexID and the tessellation instead of vtx_alloc
+	  void draw_pulled();
   };
 
   struct GLViewport {
@@ -64,6 +80,36 @@ struct GLApp {
 
   static std::vector<GLModel> models;
 
+  // buffers the vertices and indices of every model are suballocated from
+  static BufferArena buffer_arena;
+
+  // grid models are drawn with vertex pulling if set (key 'P')
+  static GLboolean pull_vertices;
+  // shader program pulling the vertices of grid models
+  static GLSLShader grid_pgm;
+  // locations of the uniforms of grid_pgm, looked up once after linking
+  static GLint grid_slices_loc, grid_stacks_loc, grid_primitive_loc;
+  // VAO without attributes bound while pulling vertices
+  static GLuint empty_vaoid;
+
+  // vertices of a grid of slices x stacks cells over [-1, 1], row by row
+  static std::vector<glm::vec2> grid_positions(int slices, int stacks);
+  // endpoints of the slices, then of the stacks, of the same grid
+  static std::vector<glm::vec2> grid_lines(int slices, int stacks);
+
+  // seeds of the vertex colors of trifans_model and tristrip_model
+  static GLuint constexpr fan_seed{ 2 };
+  static GLuint constexpr strip_seed{ 3 };
+
+  // upload the interleaved vertices of mesh and idx_bytes to buffer_arena
+  // and create the VAO reading them
+  static GLModel interleaved_model(ProcMesh::Mesh const& mesh, std::vector<GLubyte> const& idx_bytes,
+								   GLenum idx_type, std::string const& tag);
+
+  // print the time to retessellate and draw 1024 x 1024 grids with
+  // vertices computed on the CPU and pulled on the GPU
+  static void benchmark_grids();
+
   static GLApp::GLModel points_model(int slices, int stacks,
 									 std::string vtx_shdr,
 									 std::string frg_shdr);
@@ -47,6 +47,9 @@ struct GLHelper
   static std::string title;
   static GLFWwindow *ptr_window;
 
+  static GLboolean keystateP; // toggle vertex pulling of the grids
+  static GLboolean keystateB; // benchmark grid generation
+
   static void print_specs();
 };
 
@@ -0,0 +1,66 @@
+/*!
+* @file    meshlod.h
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/20/2023
+*
+* @brief This file contains the declaration of struct MeshLod that builds
+*		 levels of detail of curved meshes and picks the level to draw. A
+*		 curved mesh is tessellated into triangle fans; a coarser level keeps
+*		 every second rim vertex of the level before it, so every level
+*		 indexes the vertices of the full mesh and all levels share one
+*		 vertex buffer. Each level records its geometric error, the largest
+*		 distance in model space between its rim and the rim of the full
+*		 mesh. The level drawn is the coarsest one whose error, projected to
+*		 the viewport, stays below tolerance pixels.
+*//*__________________________________________________________________________*/
+
+/*                                                                      guard
+----------------------------------------------------------------------------- */
+#ifndef MESHLOD_H
+#define MESHLOD_H
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <GL/glew.h> // for access to OpenGL API declarations
+#include <glm/glm.hpp>
+#include <vector>
+
+/*  _________________________________________________________________________ */
+struct MeshLod
+  /*! MeshLod structure to build and pick levels of detail of meshes.
+  */
+{
+  static GLuint constexpr max_levels{ 8 };
+
+  // fewest rim edges a fan of a coarser level may have
+  static GLuint constexpr min_edges{ 8 };
+
+  // largest error in pixels allowed in the level drawn
+  static GLfloat constexpr tolerance{ 0.5f };
+
+  // indices first to first + cnt - 1 of the index list of a mesh draw a
+  // level whose rim is at most error model units off the full mesh
+  struct Level {
+    GLuint first;
+    GLuint cnt;
+    GLfloat error;
+  };
+
+  // levels of fans separated by MeshIndex::restart, finest first; the
+  // first level is idx_vtx itself. Every level halves the rim edges of
+  // each fan, always keeping its first and last rim vertex, until a fan
+  // would have fewer than min_edges or max_levels are built. errors
+  // receives the error of each level
+  static std::vector<std::vector<GLuint>> decimate_fans(std::vector<glm::vec2> const& pos_vtx,
+                                                        std::vector<GLuint> const& idx_vtx,
+                                                        std::vector<GLfloat>& errors);
+
+  // pixels covered by a model space unit drawn with mdl_to_ndc in a
+  // viewport of vp_width x vp_height pixels, along the longer axis
+  static GLfloat pixels_per_unit(glm::mat3 const& mdl_to_ndc, GLfloat vp_width, GLfloat vp_height);
+
+  // coarsest of level_cnt levels whose error is at most tolerance pixels
+  static GLuint select(Level const* levels, size_t level_cnt, GLfloat px_per_unit);
+};
+
+#endif /* MESHLOD_H */
@@ -0,0 +1,91 @@
+/*!
+* @file    procmesh.h
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/21/2023
+*
+* @brief This file contains the declaration of struct ProcMesh that builds
+*		 procedural meshes: grids, triangle strips, triangle fans, discs and
+*		 annuli. The vertices are interleaved position and color, ready for
+*		 a single vertex buffer binding. Large meshes are split into chunks
+*		 of rows or rim vertices that are built on the threads of
+*		 JobSystem. Every value written depends only on the index it is
+*		 written to: rim angles go through the same sine and cosine
+*		 polynomials in the SSE2 and scalar paths, and colors are drawn from
+*		 a counter-based generator keyed by the seed and counted by the
+*		 vertex index instead of rand(). The output is therefore identical to
+*		 the byte for any thread count.
+*//*__________________________________________________________________________*/
+
+/*                                                                      guard
+----------------------------------------------------------------------------- */
+#ifndef PROCMESH_H
+#define PROCMESH_H
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <GL/glew.h> // for access to OpenGL API declarations
+#include <glm/glm.hpp>
+#include <vector>
+
+/*  _________________________________________________________________________ */
+struct ProcMesh
+  /*! ProcMesh structure to build procedural meshes on every core.
+  */
+{
+  // position for attribute 0 and color for attribute 1, interleaved
+  struct Vertex {
+    glm::vec2 pos;
+    glm::vec3 clr;
+  };
+
+  // vertices and indices of a mesh; strips are separated by MeshIndex::restart
+  struct Mesh {
+    GLenum primitive_type{ GL_TRIANGLES };
+    std::vector<Vertex> vtx;
+    std::vector<GLuint> idx;
+  };
+
+  // counter-based random numbers: the n-th number of key is a hash of key
+  // and n, so a thread starting at the counter of its first vertex draws
+  // the numbers a single thread would have drawn for those vertices
+  struct Rng {
+    GLuint key;
+    GLuint counter;
+
+    Rng(GLuint seed, GLuint counter);
+    // next number in [0, 1)
+    GLfloat next();
+  };
+
+  // fewest vertices a chunk built by one thread has; a multiple of the
+  // SSE2 width so that chunks start on a full batch of rim angles
+  static size_t constexpr grain{ 16384 };
+
+  // slices x stacks cells over [-1, 1] x [-1, 1] drawn as GL_TRIANGLES,
+  // vertex (i, j) at index i + j * (slices + 1)
+  static Mesh grid(GLuint slices, GLuint stacks, GLuint seed);
+
+  // the vertices of grid drawn as one GL_TRIANGLE_STRIP per stack
+  static Mesh strip(GLuint slices, GLuint stacks, GLuint seed);
+
+  // unit circle drawn as a GL_TRIANGLE_FAN of the center and slices + 1
+  // rim vertices, the last on the first
+  static Mesh fan(GLuint slices, GLuint seed);
+
+  // unit disc of rings concentric rings of slices + 1 vertices around the
+  // center, drawn as GL_TRIANGLES
+  static Mesh disc(GLuint slices, GLuint rings, GLuint seed);
+
+  // ring between radius inner and the unit circle drawn as one
+  // GL_TRIANGLE_STRIP of slices + 1 inner and outer vertex pairs
+  static Mesh annulus(GLuint slices, GLfloat inner, GLuint seed);
+
+  // sines and cosines of turns i / slices for i in [0, slices]
+  static void rim(GLuint slices, std::vector<GLfloat>& sines, std::vector<GLfloat>& cosines);
+
+  // print the time to build million-vertex meshes for every thread count
+  // and whether the output matches the single-threaded one
+  static void benchmark();
+};
+
+#endif /* PROCMESH_H */
@@ -19,31 +19,46 @@
 ----------------------------------------------------------------------------- */
 #include <glapp.h>
 #include <glhelper.h>
+#include <jobsystem.h>
 #include <glm/glm.hpp>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <cstddef>
 
 /*                                                   objects with file scope
 ----------------------------------------------------------------------------- */
 std::vector<GLApp::GLModel> GLApp::models{};
 std::vector<GLApp::GLViewport> GLApp::vps{};
+BufferArena GLApp::buffer_arena{};
+GLboolean GLApp::pull_vertices{ GL_FALSE };
+GLSLShader GLApp::grid_pgm{};
+GLint GLApp::grid_slices_loc{ -1 };
+GLint GLApp::grid_stacks_loc{ -1 };
+GLint GLApp::grid_primitive_loc{ -1 };
+GLuint GLApp::empty_vaoid{ 0 };
 
 /*  _________________________________________________________________________ */
 /*! GLApp::init
  * @brief Initialize the GLApp.
  *
  * This function initializes the GLApp by performing the following tasks:
+ * 0. Starts the worker threads the procedural meshes are built on.
  * 1. Clears the color buffer to white with RGBA value in glClearColor.
  * 2. Splits the color buffer into four viewports: top-left, top-right,
  *    bottom-left, and bottom-right.
  * 3. Creates different geometries and inserts them into the GLApp::models repository container.
+ * 4. Compiles the shader program pulling the vertices of the grid models
+ *    and creates the empty VAO bound while it draws.
  *
  * @param none
  * @return void
 */
 void GLApp::init() {
 
+	JobSystem::init();
+
 	// Part 1: clear colorbuffer to white with RGBA value in glClearColor ...
 	glClearColor(1.f, 1.f, 1.f, 1.f);
 
@@ -76,6 +91,31 @@ void GLApp::init() {
 	GLApp::models.emplace_back(tristrip_model(10, 15,
 											"../shaders/my-tutorial-2.vert",
 											"../shaders/my-tutorial-2.frag"));
+
+	// Part 4: the grids can instead be drawn without vertex buffers; a core
+	// profile context still needs a VAO bound to draw, so an empty one is
+	std::vector<std::pair<GLenum, std::string>> shdr_files;
+	shdr_files.emplace_back(std::make_pair(GL_VERTEX_SHADER, "../shaders/my-tutorial-2-grid.vert"));
+	shdr_files.emplace_back(std::make_pair(GL_FRAGMENT_SHADER, "../shaders/my-tutorial-2.frag"));
+	grid_pgm.CompileLinkValidate(shdr_files);
+
+	if (GL_FALSE == grid_pgm.IsLinked())
+	{
+		std::cout << "Unable to compile/link/validate shader programs\n";
+		std::cout << grid_pgm.GetLog() << "\n";
+		std::exit(EXIT_FAILURE);
+	}
+	// draw_pulled sets these uniforms for every grid drawn, so their
+	// locations are looked up here instead of by name on each draw
+	grid_slices_loc = glGetUniformLocation(grid_pgm.GetHandle(), "uSlices");
+	grid_stacks_loc = glGetUniformLocation(grid_pgm.GetHandle(), "uStacks");
+	grid_primitive_loc = glGetUniformLocation(grid_pgm.GetHandle(), "uPrimitive");
+	if (grid_slices_loc < 0 || grid_stacks_loc < 0 || grid_primitive_loc < 0)
+	{
+		std::cout << "Uniform variables of grid shader program don't exist\n";
+		std::exit(EXIT_FAILURE);
+	}
+	glCreateVertexArrays(1, &empty_vaoid);
 }
 
 /*  _________________________________________________________________________ */
@@ -83,7 +123,8 @@ void GLApp::init() {
  * @brief Update the GLApp.
  *
  * This function updates the GLApp by clearing the color buffer to white with RGBA
- * value in glClearColor.
+ * value in glClearColor. Key 'P' toggles vertex pulling of the grid models
+ * and key 'B' runs GLApp::benchmark_grids and ProcMesh::benchmark.
  *
  * @param none
  * @return void
@@ -92,6 +133,18 @@ void GLApp::update() {
 
 	glClearColor(1.f, 1.f, 1.f, 1.f);
 
+	if (GLHelper::keystateP == GL_TRUE)
+	{
+		pull_vertices = (pull_vertices == GL_TRUE) ? GL_FALSE : GL_TRUE;
+		GLHelper::keystateP = GL_FALSE;
+	}
+
+	if (GLHelper::keystateB == GL_TRUE)
+	{
+		GLApp::benchmark_grids();
+		ProcMesh::benchmark();
+		GLHelper::keystateB = GL_FALSE;
+	}
 }
 
 /*  _________________________________________________________________________ */
@@ -99,7 +152,9 @@ void GLApp::update() {
  * @brief Draw the GLApp.
  *
  * This function draws the GLApp by performing the following tasks:
- * 1. Sets the window title with information about the number of primitives and draw counts.
+ * 1. Picks the level of detail of the triangle fan from the size of its
+ *    viewport, and sets the window title with information about the number
+ *    of primitives and draw counts.
  * 2. Clears the back buffer.
  * 3. Renders points in the top-left viewport.
  * 4. Renders lines in the top-right viewport.
@@ -111,6 +166,10 @@ void GLApp::update() {
 */
 void GLApp::draw() {
 
+	// the fan is drawn in NDC, a unit of which covers half the viewport
+	GLApp::models[2].set_lod(MeshLod::pixels_per_unit(glm::mat3{ 1.f },
+		static_cast<GLfloat>(vps[2].width), static_cast<GLfloat>(vps[2].height)));
+
 	// window title
 	std::stringstream title;
 
@@ -122,7 +181,8 @@ void GLApp::draw() {
 																<< GLApp::models[2].draw_cnt		<< " | " 
 												  << "STRIP: "  << GLApp::models[3].primitive_cnt	<< ", "
 																<< GLApp::models[3].draw_cnt		<< " | " 
-												  << std::setprecision(2) << std::fixed << GLHelper::fps;
+												  << std::setprecision(2) << std::fixed << GLHelper::fps
+												  << (pull_vertices == GL_TRUE ? " | PULLED" : "");
 	
 	glfwSetWindowTitle(GLHelper::ptr_window, title.str().c_str());
 
@@ -148,14 +208,28 @@ void GLApp::draw() {
 
 /*  _________________________________________________________________________ */
 /*! GLApp::cleanup
- * @brief Empty.
+ * @brief Stop the worker threads and free each model's ranges, VAO and program.
  * 
  * @param none
  * @return none
 */
 void GLApp::cleanup()
 {
-  // empty for now
+	JobSystem::cleanup();
+
+	for (GLModel& mdl : models)
+	{
+		buffer_arena.free(mdl.vtx_alloc);
+		buffer_arena.free(mdl.idx_alloc);
+		glDeleteVertexArrays(1, &mdl.vaoid);
+		mdl.shdr_pgm.DeleteShaderProgram();
+	}
+	models.clear();
+	glDeleteVertexArrays(1, &empty_vaoid);
+	grid_pgm.DeleteShaderProgram();
+
+	buffer_arena.report("GPU buffer arena at cleanup");
+	buffer_arena.destroy();
 }
 
 /*  _________________________________________________________________________ */
@@ -196,15 +270,24 @@ void GLApp::GLModel::setup_shdrpgm(std::string vtx_shader,
  * 3. Specifies the primitive type and the number of primitives to be rendered.
  *    - For GL_POINTS: Sets the point size, vertex attribute, and calls glDrawArrays.
  *    - For GL_LINES: Sets the line width, vertex attribute, and calls glDrawArrays.
- *    - For GL_TRIANGLE_FAN: Calls glDrawArrays.
- *    - For GL_TRIANGLE_STRIP: Enables primitive restart, calls glDrawElements, and disables primitive restart.
+ *    - For GL_TRIANGLE_FAN and GL_TRIANGLE_STRIP: If the model has indices, enables
+ *      primitive restart at the largest value of its index type, calls glDrawElements,
+ *      and disables primitive restart. Otherwise calls glDrawArrays.
  * 4. Unbinds the VAO and sets the current shader program to no longer be current.
+ * Grid models are drawn with draw_pulled instead while GLApp::pull_vertices
+ * is set.
  *
  * @param none
  * @return void
 */
 void GLApp::GLModel::draw() {
 
+	if (pull_vertices == GL_TRUE && slices > 0)
+	{
+		draw_pulled();
+		return;
+	}
+
 	// there are many shader programs initialized - here we're saying
 	// which specific shader program should be used to render geometry
 	shdr_pgm.Use();
@@ -233,12 +316,21 @@ void GLApp::GLModel::draw() {
 		glLineWidth(1.f);
 		break;
 	case GL_TRIANGLE_FAN:
-		glDrawArrays(primitive_type, 0, draw_cnt);
-		break;
 	case GL_TRIANGLE_STRIP:
-		glEnable(GL_PRIMITIVE_RESTART);
-		glDrawElements(primitive_type, draw_cnt, GL_UNSIGNED_SHORT, NULL);
-		glDisable(GL_PRIMITIVE_RESTART);
+		if (idx_alloc.id == 0)
+		{
+			glDrawArrays(primitive_type, 0, draw_cnt);
+			break;
+		}
+		// MeshIndex::restart was packed to the largest value of idx_type,
+		// the restart index of GL_PRIMITIVE_RESTART_FIXED_INDEX
+		glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+		// the indices start at the offset of idx_alloc in the element buffer,
+		// those of a level of detail at its first index
+		glDrawElements(primitive_type, draw_cnt, idx_type,
+			reinterpret_cast<GLvoid const*>(idx_alloc.offset + (lods.empty() ? 0 :
+				MeshIndex::size(idx_type) * static_cast<GLintptr>(lods[lod].first))));
+		glDisable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
 		break;
 	}
 	// after completing the rendering, we tell the driver that VAO
@@ -248,15 +340,83 @@ void GLApp::GLModel::draw() {
 	shdr_pgm.UnUse();
 }
 
+/*  _________________________________________________________________________ */
+/*! GLApp::GLModel::draw_pulled
+ * @brief Draw the grid GLModel without reading its vertex buffer.
+ *
+ * GLApp::grid_pgm computes the position of each vertex from gl_VertexID
+ * and the tessellation uniforms, so only the tessellation is sent and a
+ * new one costs no upload. Points and lines are drawn as in draw; the
+ * strip is drawn one instance per stack instead of restarting it between
+ * stacks, and its colors are hashed from the vertex index.
+ *
+ * @param none
+ * @return void
+*/
+void GLApp::GLModel::draw_pulled() {
+
+	grid_pgm.Use();
+	glBindVertexArray(empty_vaoid);
+	glUniform1i(grid_slices_loc, slices);
+	glUniform1i(grid_stacks_loc, stacks);
+
+	switch (primitive_type)
+	{
+	case GL_POINTS:
+		glUniform1i(grid_primitive_loc, 0);
+		glPointSize(10.f);
+		glVertexAttrib3f(1, 1.f, 0.f, 0.f); // redcolor for points
+		glDrawArrays(primitive_type, 0, (slices + 1) * (stacks + 1));
+		glPointSize(1.f);
+		break;
+	case GL_LINES:
+		glUniform1i(grid_primitive_loc, 1);
+		glLineWidth(3.f);
+		glVertexAttrib3f(1, 0.f, 0.f, 1.f); // blue color for lines
+		glDrawArrays(primitive_type, 0, 2 * (slices + 1) + 2 * (stacks + 1));
+		glLineWidth(1.f);
+		break;
+	case GL_TRIANGLE_STRIP:
+		glUniform1i(grid_primitive_loc, 2);
+		glDrawArraysInstanced(primitive_type, 0, 2 * (slices + 1), stacks);
+		break;
+	}
+
+	glBindVertexArray(0);
+	grid_pgm.UnUse();
+}
+
+/*  _________________________________________________________________________ */
+/*! GLApp::GLModel::set_lod
+ * @brief Pick the level of detail of the GLModel to draw.
+ *
+ * The level is the coarsest whose error is at most MeshLod::tolerance
+ * pixels. Models without levels of detail are left as they are.
+ *
+ * @param[in] px_per_unit Pixels per model space unit in the viewport.
+ * @return void
+*/
+void GLApp::GLModel::set_lod(GLfloat px_per_unit)
+{
+	if (lods.empty())
+	{
+		return;
+	}
+	lod = MeshLod::select(lods.data(), lods.size(), px_per_unit);
+	draw_cnt = lods[lod].cnt;
+	primitive_cnt = lod_primitive_cnts[lod];
+}
+
 /*  _________________________________________________________________________ */
 /*! GLApp::points_model
  * @brief Create a GLModel for rendering points.
  *
  * This function creates a GLModel for rendering points by performing the following tasks:
- * 1. Calculates the positions of the vertices based on the number of slices and stacks.
- * 2. Creates a Vertex Buffer Object (VBO) and Vertex Array Object (VAO) to store the vertex data.
+ * 1. Calculates the positions of the vertices based on the number of slices and stacks (GLApp::grid_positions).
+ * 2. Allocates the vertex data from GLApp::buffer_arena and creates a Vertex Array Object (VAO) reading it.
  * 3. Sets up the vertex attribute and format for the VAO.
- * 4. Initializes the GLModel's attributes, including the VAO, primitive type, shader program, and draw count.
+ * 4. Initializes the GLModel's attributes, including the VAO, primitive type, tessellation, shader program,
+ *    and draw count.
  * 5. Returns the created GLModel.
  *
  * @param[in] slices The number of slices.
@@ -268,27 +428,15 @@ void GLApp::GLModel::draw() {
 GLApp::GLModel GLApp::points_model(int slices, int stacks,
 					  std::string vtx_shdr, std::string frg_shdr)
 {
-	std::vector<glm::vec2> pos_vtx((slices + 1) * (stacks + 1));
-	float xinterval{ 2.f / slices };
-	float yinterval{ 2.f / stacks };
-
-	for (int j{}; j < stacks + 1; ++j)
-	{
-		for (int i{}; i < slices + 1; ++i)
-		{
-			pos_vtx[i + j * (slices + 1)] = glm::vec2{ xinterval * i - 1.f, yinterval * j - 1.f };
-		}
-	}
+	std::vector<glm::vec2> const pos_vtx{ grid_positions(slices, stacks) };
 
 	// define VAO handle
-	GLuint vbo_hdl;
-	glCreateBuffers(1, &vbo_hdl);
-	glNamedBufferStorage(vbo_hdl, sizeof(glm::vec2) * pos_vtx.size(),
-						 pos_vtx.data(), GL_DYNAMIC_STORAGE_BIT);
+	BufferArena::Allocation const vtx_alloc{ buffer_arena.allocate(sizeof(glm::vec2) * pos_vtx.size(),
+		pos_vtx.data(), "points_model vertices") };
 	GLuint vaoid;
 	glCreateVertexArrays(1, &vaoid);
 	glEnableVertexArrayAttrib(vaoid, 0);
-	glVertexArrayVertexBuffer(vaoid, 0, vbo_hdl, 0, sizeof(glm::vec2));
+	glVertexArrayVertexBuffer(vaoid, 0, vtx_alloc.buffer, vtx_alloc.offset, sizeof(glm::vec2));
 	glVertexArrayAttribFormat(vaoid, 0, 2, GL_FLOAT, GL_FALSE, 0);
 	glVertexArrayAttribBinding(vaoid, 0, 0);
 	glBindVertexArray(0);
@@ -296,7 +444,10 @@ GLApp::GLModel GLApp::points_model(int slices, int stacks,
 	// assign attributes to instance model to return
 	GLModel mdl{};
 	mdl.vaoid = vaoid;
+	mdl.vtx_alloc = vtx_alloc;
 	mdl.primitive_type = GL_POINTS;
+	mdl.slices = slices;
+	mdl.stacks = stacks;
 	mdl.setup_shdrpgm(vtx_shdr, frg_shdr);
 	mdl.draw_cnt = pos_vtx.size();
 	mdl.primitive_cnt = mdl.draw_cnt;
@@ -309,10 +460,11 @@ GLApp::GLModel GLApp::points_model(int slices, int stacks,
  * @brief Create a GLModel for rendering lines.
  *
  * This function creates a GLModel for rendering lines by performing the following tasks:
- * 1. Calculates the positions of the vertices based on the number of slices and stacks.
- * 2. Creates a Vertex Buffer Object (VBO) and Vertex Array Object (VAO) to store the vertex data.
+ * 1. Calculates the positions of the vertices based on the number of slices and stacks (GLApp::grid_lines).
+ * 2. Allocates the vertex data from GLApp::buffer_arena and creates a Vertex Array Object (VAO) reading it.
  * 3. Sets up the vertex attribute and format for the VAO.
- * 4. Initializes the GLModel's attributes, including the VAO, primitive type, shader program, and draw count.
+ * 4. Initializes the GLModel's attributes, including the VAO, primitive type, tessellation, shader program,
+ *    and draw count.
  * 5. Returns the created GLModel.
  *
  * @param[in] slices The number of slices.
@@ -324,49 +476,32 @@ GLApp::GLModel GLApp::points_model(int slices, int stacks,
 GLApp::GLModel GLApp::lines_model(int slices, int stacks,
 					  std::string vtx_shdr, std::string frg_shdr)
 {
-	// count of vertices need for slices and stacks
-	int const countx{ (slices + 1) * 2 };
-	int const county{ (stacks + 1) * 2 };
-	std::vector<glm::vec2> pos_vtx(countx * county);
-
-	// interval between slices and stacks
-	float const u{ 2.f / static_cast<float>(slices) };
-	float const m{ 2.f / static_cast<float>(stacks) };
-	int index{ 0 };
-
-	for (int col{ 0 }; col <= slices; ++col) {
-		float x{ u * static_cast<float>(col) - 1.f };
-		pos_vtx[index++] = glm::vec2(x, -1.f);
-		pos_vtx[index++] = glm::vec2(x, 1.f);
-	}
-	for (int row{ 0 }; row <= stacks; ++row)
-	{
-		float y{ m * static_cast<float>(row) - 1.f };
-		pos_vtx[index++] = glm::vec2(-1.f, y);
-		pos_vtx[index++] = glm::vec2(1.f, y);
-	}
 	// compute and store endpoints for (slices+1) set of lines
 	// for each x from -1 to 1
 	// start endpoint is (x, -1) and end endpoint is (x, 1)
+	// then likewise for (stacks+1) set of lines for each y
+	std::vector<glm::vec2> const pos_vtx{ grid_lines(slices, stacks) };
+
 	// set up VAO as in GLApp::points_model
 
 	// define VAO handle
-	GLuint vbo_hdl;
-	glCreateBuffers(1, &vbo_hdl);
-	glNamedBufferStorage(vbo_hdl, sizeof(glm::vec2) * pos_vtx.size(),
-		pos_vtx.data(), GL_DYNAMIC_STORAGE_BIT);
+	BufferArena::Allocation const vtx_alloc{ buffer_arena.allocate(sizeof(glm::vec2) * pos_vtx.size(),
+		pos_vtx.data(), "lines_model vertices") };
 
 	GLuint vaoid;
 	glCreateVertexArrays(1, &vaoid);
 	glEnableVertexArrayAttrib(vaoid, 0);
-	glVertexArrayVertexBuffer(vaoid, 0, vbo_hdl, 0, sizeof(glm::vec2));
+	glVertexArrayVertexBuffer(vaoid, 0, vtx_alloc.buffer, vtx_alloc.offset, sizeof(glm::vec2));
 	glVertexArrayAttribFormat(vaoid, 0, 2, GL_FLOAT, GL_FALSE, 0);
 	glVertexArrayAttribBinding(vaoid, 0, 0);
 	glBindVertexArray(0);
 
 	GLApp::GLModel mdl{};
 	mdl.vaoid = vaoid; // set up VAO same as in GLApp::points_model
+	mdl.vtx_alloc = vtx_alloc;
 	mdl.primitive_type = GL_LINES;
+	mdl.slices = slices;
+	mdl.stacks = stacks;
 	mdl.setup_shdrpgm(vtx_shdr, frg_shdr);
 	mdl.draw_cnt = 2 * (slices + 1) + 2 * (stacks + 1); // number of vertices
 	mdl.primitive_cnt = mdl.draw_cnt / 2; // number of primitives (not used)
@@ -378,12 +513,13 @@ GLApp::GLModel GLApp::lines_model(int slices, int stacks,
  * @brief Create a GLModel for rendering triangle fans.
  *
  * This function creates a GLModel for rendering triangle fans by performing the following tasks:
- * 1. Generates the positions of the vertices based on the number of slices to form a triangle fan.
- * 2. Computes random color coordinates for each vertex.
- * 3. Creates a Vertex Buffer Object (VBO) and Vertex Array Object (VAO) to store the vertex data.
- * 4. Sets up the vertex attributes and formats for the VAO.
- * 5. Initializes the GLModel's attributes, including the VAO, primitive type, shader program, and draw count.
- * 6. Returns the created GLModel.
+ * 1. Builds the interleaved positions and random colors of a triangle fan with ProcMesh::fan,
+ *    and the indices of the fan and of its coarser levels of detail (MeshLod::decimate_fans).
+ * 2. Allocates the vertex and index data from GLApp::buffer_arena and creates a Vertex Array Object (VAO) reading it.
+ * 3. Sets up the vertex attributes and formats for the VAO.
+ * 4. Initializes the GLModel's attributes, including the VAO, primitive type, levels of detail, shader program,
+ *    and draw count.
+ * 5. Returns the created GLModel.
  *
  * @param[in] slices The number of slices.
  * @param[in] vtx_shdr The vertex shader file path.
@@ -395,63 +531,47 @@ GLApp::GLModel GLApp::trifans_model(int slices, std::string vtx_shdr,
 {
 	// Step 1: Generate the (slices+2) count of vertices required to
 	// render a triangle fan parameterization of a circle with unit
-	// radius and centered at (0, 0)
-	std::vector<glm::vec2> pos_vtx(slices + 2);
-
-	float interval{ glm::radians(360.f / slices)};
-
-	pos_vtx[0] = glm::vec2(0.f, 0.f);
-
-	for (int i{ 0 }; i <= slices; ++i)
+	// radius and centered at (0, 0), each with a random color
+	ProcMesh::Mesh const mesh{ ProcMesh::fan(static_cast<GLuint>(slices), fan_seed) };
+	std::vector<glm::vec2> pos_vtx(mesh.vtx.size());
+	for (size_t i{ 0 }; i < pos_vtx.size(); ++i)
 	{
-		pos_vtx[i+1] = glm::vec2(cosf(i * interval), sinf(i * interval));
+		pos_vtx[i] = mesh.vtx[i].pos;
 	}
 
-	// Step 2: In addition to vertex position coordinates, compute
-	// (slices+2) count of vertex color coordinates.
-	// Each RGB component must be randomly computed.
-	std::vector<glm::vec3> clr_vtx(slices + 2);
-	
-	for (glm::vec3& tmp : clr_vtx)
+	// coarser levels of detail keep every second rim vertex of the level
+	// before them; all of them index the vertices above, so they share
+	// the vertices and their colors and are stored end to end
+	std::vector<GLfloat> errors;
+	std::vector<std::vector<GLuint>> const levels{ MeshLod::decimate_fans(pos_vtx, mesh.idx, errors) };
+	std::vector<MeshLod::Level> lods;
+	std::vector<GLuint> lod_primitive_cnts;
+	std::vector<GLuint> idx_vtx;
+	for (size_t i{ 0 }; i < levels.size(); ++i)
 	{
-		tmp = glm::vec3(static_cast<float>(rand()) / RAND_MAX, static_cast<float>(rand()) / RAND_MAX, static_cast<float>(rand()) / RAND_MAX);
+		lods.push_back(MeshLod::Level{ static_cast<GLuint>(idx_vtx.size()),
+			static_cast<GLuint>(levels[i].size()), errors[i] });
+		idx_vtx.insert(idx_vtx.end(), levels[i].begin(), levels[i].end());
+
+		// a fan of n indices draws n - 2 triangles, and the fans of a
+		// level are separated by one restart index each
+		GLuint const fans{ static_cast<GLuint>(
+			std::count(levels[i].begin(), levels[i].end(), MeshIndex::restart)) + 1 };
+		lod_primitive_cnts.push_back(static_cast<GLuint>(levels[i].size()) - 3 * fans + 1);
 	}
+	GLenum const idx_type{ MeshIndex::type(mesh.vtx.size()) };
+	std::vector<GLubyte> const idx_bytes{ MeshIndex::pack(idx_vtx, idx_type) };
 
-	// Step 3: Generate a VAO handle to encapsulate the VBO(s) and
+	// Step 2: Generate a VAO handle to encapsulate the VBO(s) and
 	// state of this triangle mesh
-	// define VAO handle
-	GLuint vbo_hdl;
-	glCreateBuffers(1, &vbo_hdl);
-	glNamedBufferStorage(vbo_hdl, sizeof(glm::vec2) * pos_vtx.size() + sizeof(glm::vec3) * clr_vtx.size(),
-	nullptr, GL_DYNAMIC_STORAGE_BIT);
-	glNamedBufferSubData(vbo_hdl, 0,
-		sizeof(glm::vec2) * pos_vtx.size(), pos_vtx.data());
-	glNamedBufferSubData(vbo_hdl, sizeof(glm::vec2) * pos_vtx.size(),
-		sizeof(glm::vec3) * clr_vtx.size(), clr_vtx.data());
-
-	GLuint vaoid;
-	glCreateVertexArrays(1, &vaoid);
-	glEnableVertexArrayAttrib(vaoid, 0);
-	glVertexArrayVertexBuffer(vaoid, 0, vbo_hdl, 0, sizeof(glm::vec2));
-	glVertexArrayAttribFormat(vaoid, 0, 2, GL_FLOAT, GL_FALSE, 0);
-	glVertexArrayAttribBinding(vaoid, 0, 0);
-
-	glEnableVertexArrayAttrib(vaoid, 1);
-	glVertexArrayVertexBuffer(vaoid, 1, vbo_hdl,
-		sizeof(glm::vec2) * pos_vtx.size(), sizeof(glm::vec3));
-	glVertexArrayAttribFormat(vaoid, 1, 3, GL_FLOAT, GL_FALSE, 0);
-	glVertexArrayAttribBinding(vaoid, 1, 1);
-
-	glBindVertexArray(0);
-
-	GLApp::GLModel mdl{};
-	mdl.vaoid = vaoid; // set up VAO same as in GLApp::points_model
-	mdl.primitive_type = GL_TRIANGLE_FAN;
+	GLModel mdl{ interleaved_model(mesh, idx_bytes, idx_type, "trifans_model") };
+	mdl.lods = lods;
+	mdl.lod_primitive_cnts = lod_primitive_cnts;
 	mdl.setup_shdrpgm(vtx_shdr, frg_shdr);
-	mdl.draw_cnt = pos_vtx.size(); // number of vertices
+	mdl.draw_cnt = mesh.vtx.size(); // number of vertices of the finest level
 	mdl.primitive_cnt = slices; // number of primitives (not used)
 
-	// Step 4: Return an appropriately initialized instance of GLApp::GLModel
+	// Step 3: Return an appropriately initialized instance of GLApp::GLModel
 	return mdl;
 }
 
@@ -460,13 +580,15 @@ GLApp::GLModel GLApp::trifans_model(int slices, std::string vtx_shdr,
  * @brief Create a GLModel for rendering triangle strips.
  *
  * This function creates a GLModel for rendering triangle strips by performing the following tasks:
- * 1. Generates the positions of the vertices based on the number of slices and stacks.
- * 2. Generates the indices for rendering the triangle strips.
- * 3. Computes random color coordinates for each vertex.
- * 4. Creates a Vertex Buffer Object (VBO) and Element Buffer Object (EBO) to store the vertex and index data.
- * 5. Creates a Vertex Array Object (VAO) and sets up the vertex attributes and formats for the VAO.
- * 6. Initializes the GLModel's attributes, including the VAO, primitive type, shader program, and draw count.
- * 7. Returns the created GLModel.
+ * 1. Builds the interleaved positions and random colors of the vertices based on the number of
+ *    slices and stacks, and the indices for rendering the triangle strips, one strip per stack
+ *    separated by the primitive restart index, with ProcMesh::strip.
+ * 2. Packs the indices to the smallest index type able to address every vertex.
+ * 3. Allocates the vertex and index data from GLApp::buffer_arena.
+ * 4. Creates a Vertex Array Object (VAO) and sets up the vertex attributes and formats for the VAO.
+ * 5. Initializes the GLModel's attributes, including the VAO, primitive type, tessellation, shader program,
+ *    and draw count.
+ * 6. Returns the created GLModel.
  *
  * @param slices The number of slices.
  * @param stacks The number of stacks.
@@ -477,6 +599,84 @@ GLApp::GLModel GLApp::trifans_model(int slices, std::string vtx_shdr,
 GLApp::GLModel GLApp::tristrip_model(int slices, int stacks,
 									 std::string vtx_shdr,
 									 std::string frg_shdr)
+{
+	ProcMesh::Mesh const mesh{ ProcMesh::strip(static_cast<GLuint>(slices), static_cast<GLuint>(stacks), strip_seed) };
+
+	// Bonus task
+	// indices are computed with 32 bits and packed to the smallest type
+	// that addresses every vertex, so the grid is not limited to 65536
+	// vertices
+	GLenum const idx_type{ MeshIndex::type(mesh.vtx.size()) };
+	std::vector<GLubyte> const idx_bytes{ MeshIndex::pack(mesh.idx, idx_type) };
+
+	GLModel mdl{ interleaved_model(mesh, idx_bytes, idx_type, "tristrip_model") };
+	mdl.slices = slices;
+	mdl.stacks = stacks;
+	mdl.setup_shdrpgm(vtx_shdr, frg_shdr);
+	mdl.draw_cnt = mesh.idx.size(); // number of vertices
+	mdl.primitive_cnt = (slices * stacks * 2); // number of primitives (not used)
+
+	// Step 4: Return an appropriately initialized instance of GLApp::GLModel
+	return mdl;
+}
+
+/*  _________________________________________________________________________ */
+/*! GLApp::interleaved_model
+ * @brief Upload a procedural mesh and create the VAO reading it.
+ *
+ * The interleaved vertices are read through a single binding: the
+ * position at attribute 0 and the color at attribute 1.
+ *
+ * @param[in] mesh The vertices and primitive type of the model.
+ * @param[in] idx_bytes The indices of the model packed to idx_type.
+ * @param[in] idx_type The type of the indices.
+ * @param[in] tag The name of the owner in the arena leak report.
+ * @return The GLModel with its VAO, allocations, index and primitive type set.
+*/
+GLApp::GLModel GLApp::interleaved_model(ProcMesh::Mesh const& mesh, std::vector<GLubyte> const& idx_bytes,
+										GLenum idx_type, std::string const& tag)
+{
+	BufferArena::Allocation const vtx_alloc{ buffer_arena.allocate(
+		static_cast<GLsizeiptr>(sizeof(ProcMesh::Vertex) * mesh.vtx.size()), mesh.vtx.data(), tag + " vertices") };
+	BufferArena::Allocation const idx_alloc{ buffer_arena.allocate(static_cast<GLsizeiptr>(idx_bytes.size()),
+		idx_bytes.data(), tag + " indices") };
+
+	GLuint vaoid;
+	glCreateVertexArrays(1, &vaoid);
+	glVertexArrayVertexBuffer(vaoid, 0, vtx_alloc.buffer, vtx_alloc.offset, sizeof(ProcMesh::Vertex));
+
+	glEnableVertexArrayAttrib(vaoid, 0);
+	glVertexArrayAttribFormat(vaoid, 0, 2, GL_FLOAT, GL_FALSE, offsetof(ProcMesh::Vertex, pos));
+	glVertexArrayAttribBinding(vaoid, 0, 0);
+
+	glEnableVertexArrayAttrib(vaoid, 1);
+	glVertexArrayAttribFormat(vaoid, 1, 3, GL_FLOAT, GL_FALSE, offsetof(ProcMesh::Vertex, clr));
+	glVertexArrayAttribBinding(vaoid, 1, 0);
+
+	glVertexArrayElementBuffer(vaoid, idx_alloc.buffer);
+	glBindVertexArray(0);
+
+	GLApp::GLModel mdl{};
+	mdl.vaoid = vaoid;
+	mdl.vtx_alloc = vtx_alloc;
+	mdl.idx_alloc = idx_alloc;
+	mdl.idx_type = idx_type;
+	mdl.primitive_type = mesh.primitive_type;
+	return mdl;
+}
+
+/*  _________________________________________________________________________ */
+/*! GLApp::grid_positions
+ * @brief Compute the vertices of a grid covering [-1, 1] x [-1, 1].
+ *
+ * Vertex (i, j) is at index i + j * (slices + 1), the order
+ * my-tutorial-2-grid.vert derives it from gl_VertexID in.
+ *
+ * @param[in] slices The number of slices.
+ * @param[in] stacks The number of stacks.
+ * @return The (slices + 1) * (stacks + 1) vertex positions, row by row.
+*/
+std::vector<glm::vec2> GLApp::grid_positions(int slices, int stacks)
 {
 	std::vector<glm::vec2> pos_vtx((slices + 1) * (stacks + 1));
 	float xinterval{ 2.f / slices };
@@ -489,80 +689,150 @@ GLApp::GLModel GLApp::tristrip_model(int slices, int stacks,
 			pos_vtx[i + j * (slices + 1)] = glm::vec2{ xinterval * i - 1.f, yinterval * j - 1.f };
 		}
 	}
+	return pos_vtx;
+}
 
-	// Bonus task
-	GLushort primitiveRestartIndex = std::numeric_limits<GLushort>::max();
-	glPrimitiveRestartIndex(primitiveRestartIndex);
-
-	std::vector<GLushort> idx_vtx((slices + 1) * 2 * stacks + 1 * (stacks - 1));
+/*  _________________________________________________________________________ */
+/*! GLApp::grid_lines
+ * @brief Compute the endpoints of the lines of a grid covering [-1, 1] x [-1, 1].
+ *
+ * @param[in] slices The number of slices.
+ * @param[in] stacks The number of stacks.
+ * @return The endpoints (x, -1) and (x, 1) of the (slices + 1) vertical
+ * lines, followed by the endpoints (-1, y) and (1, y) of the (stacks + 1)
+ * horizontal lines.
+*/
+std::vector<glm::vec2> GLApp::grid_lines(int slices, int stacks)
+{
+	std::vector<glm::vec2> pos_vtx(2 * (slices + 1) + 2 * (stacks + 1));
 
+	// interval between slices and stacks
+	float const u{ 2.f / static_cast<float>(slices) };
+	float const m{ 2.f / static_cast<float>(stacks) };
 	int index{ 0 };
-	for (int row{ 0 }; row < stacks; ++row)
+
+	for (int col{ 0 }; col <= slices; ++col) {
+		float x{ u * static_cast<float>(col) - 1.f };
+		pos_vtx[index++] = glm::vec2(x, -1.f);
+		pos_vtx[index++] = glm::vec2(x, 1.f);
+	}
+	for (int row{ 0 }; row <= stacks; ++row)
 	{
-		for (int col{ 0 }; col < slices + 1; ++col)
-		{
-			idx_vtx[index++] = static_cast<GLushort>(col + (slices + 1) * (row + 1));
-			idx_vtx[index++] = static_cast<GLushort>(col + (slices + 1) * row);
-		}
+		float y{ m * static_cast<float>(row) - 1.f };
+		pos_vtx[index++] = glm::vec2(-1.f, y);
+		pos_vtx[index++] = glm::vec2(1.f, y);
+	}
+	return pos_vtx;
+}
 
-		// Bonus task
-		if (row < stacks - 1)
+/*  _________________________________________________________________________ */
+/*! GLApp::benchmark_grids
+ * @brief Print the time to retessellate and draw 1024 x 1024 grids.
+ *
+ * For the points, lines and strip grids the table shows per frame:
+ * - CPU rebuild: the vertices (and indices of the strip) are built as
+ *   the model functions do, allocated from a buffer arena and drawn, with
+ *   the tessellation switching between 1024 and 1023 every frame.
+ * - CPU draw: the vertices computed once are drawn again.
+ * - Pulled: the grid is drawn with GLModel::draw_pulled, switching the
+ *   tessellation every frame as well.
+ * - Uploaded: megabytes copied to the GPU by a CPU rebuild; pulling sends
+ *   only the tessellation uniforms.
+ * Both paths draw through GLModel with the same point size and line width.
+ *
+ * @param none
+ * @return void
+*/
+void GLApp::benchmark_grids()
+{
+	int constexpr tess{ 1024 };
+	int constexpr frames{ 10 };
+	GLenum const types[]{ GL_POINTS, GL_LINES, GL_TRIANGLE_STRIP };
+	char const* const names[]{ "Points", "Lines", "Strip" };
+
+	// time per frame in milliseconds of frames calls of frame(f)
+	auto const time_frames = [](auto&& frame) {
+		glFinish();
+		double const start{ glfwGetTime() };
+		for (int f{ 0 }; f < frames; ++f)
 		{
-			idx_vtx[index++] = primitiveRestartIndex;
+			frame(f);
 		}
-	}
-
-	// Step 2: In addition to vertex position coordinates, compute
-	// (slices + 1) * (stacks + 1) count of vertex color coordinates.
-	// Each RGB component must be randomly computed.
-	std::vector<glm::vec3> clr_vtx((slices + 1) * (stacks + 1));
-
-
-	for (glm::vec3& tmp : clr_vtx)
+		glFinish();
+		return (glfwGetTime() - start) * 1000.0 / frames;
+	};
+
+	BufferArena arena;
+	std::cout << "Grids of " << tess << " x " << tess << " cells\n";
+	std::cout << "Grid\t|\tCPU rebuild (ms)\t|\tCPU draw (ms)\t|\tPulled (ms)\t|\tUploaded (MB)\n";
+	std::cout << "------------------------------------------------------------------------------------------------\n";
+	for (size_t t{ 0 }; t < sizeof(types) / sizeof(types[0]); ++t)
 	{
-		tmp = glm::vec3(static_cast<float>(rand()) / RAND_MAX, static_cast<float>(rand()) / RAND_MAX, static_cast<float>(rand()) / RAND_MAX);
+		GLModel mdl{};
+		mdl.primitive_type = types[t];
+		mdl.shdr_pgm = models[0].shdr_pgm;
+		glCreateVertexArrays(1, &mdl.vaoid);
+		GLsizeiptr uploaded{ 0 };
+
+		// compute the grid at slices x slices, upload it and point the VAO at it
+		auto const build = [&](int slices) {
+			arena.free(mdl.vtx_alloc);
+			arena.free(mdl.idx_alloc);
+
+			if (mdl.primitive_type == GL_TRIANGLE_STRIP)
+			{
+				ProcMesh::Mesh const mesh{ ProcMesh::strip(static_cast<GLuint>(slices), static_cast<GLuint>(slices), strip_seed) };
+				mdl.idx_type = MeshIndex::type(mesh.vtx.size());
+				std::vector<GLubyte> const idx_bytes{ MeshIndex::pack(mesh.idx, mdl.idx_type) };
+				GLsizeiptr const vtx_size{ static_cast<GLsizeiptr>(sizeof(ProcMesh::Vertex) * mesh.vtx.size()) };
+
+				mdl.vtx_alloc = arena.allocate(vtx_size, mesh.vtx.data(), "benchmark_grids vertices");
+				mdl.idx_alloc = arena.allocate(static_cast<GLsizeiptr>(idx_bytes.size()), idx_bytes.data(),
+					"benchmark_grids indices");
+				glVertexArrayVertexBuffer(mdl.vaoid, 0, mdl.vtx_alloc.buffer, mdl.vtx_alloc.offset, sizeof(ProcMesh::Vertex));
+				glEnableVertexArrayAttrib(mdl.vaoid, 0);
+				glVertexArrayAttribFormat(mdl.vaoid, 0, 2, GL_FLOAT, GL_FALSE, offsetof(ProcMesh::Vertex, pos));
+				glVertexArrayAttribBinding(mdl.vaoid, 0, 0);
+				glEnableVertexArrayAttrib(mdl.vaoid, 1);
+				glVertexArrayAttribFormat(mdl.vaoid, 1, 3, GL_FLOAT, GL_FALSE, offsetof(ProcMesh::Vertex, clr));
+				glVertexArrayAttribBinding(mdl.vaoid, 1, 0);
+				glVertexArrayElementBuffer(mdl.vaoid, mdl.idx_alloc.buffer);
+				mdl.draw_cnt = static_cast<GLuint>(mesh.idx.size());
+				uploaded += vtx_size + static_cast<GLsizeiptr>(idx_bytes.size());
+				return;
+			}
+
+			std::vector<glm::vec2> const pos_vtx{ (mdl.primitive_type == GL_LINES) ?
+				grid_lines(slices, slices) : grid_positions(slices, slices) };
+			GLsizeiptr const pos_size{ static_cast<GLsizeiptr>(sizeof(glm::vec2) * pos_vtx.size()) };
+
+			mdl.vtx_alloc = arena.allocate(pos_size, pos_vtx.data(), "benchmark_grids vertices");
+			glEnableVertexArrayAttrib(mdl.vaoid, 0);
+			glVertexArrayVertexBuffer(mdl.vaoid, 0, mdl.vtx_alloc.buffer, mdl.vtx_alloc.offset, sizeof(glm::vec2));
+			glVertexArrayAttribFormat(mdl.vaoid, 0, 2, GL_FLOAT, GL_FALSE, 0);
+			glVertexArrayAttribBinding(mdl.vaoid, 0, 0);
+			mdl.draw_cnt = static_cast<GLuint>(pos_vtx.size());
+			uploaded += pos_size;
+		};
+
+		// mdl.slices is 0 until the pulled run, so draw reads the VAO
+		double const rebuild_ms{ time_frames([&](int f) { build(tess - f % 2); mdl.draw(); }) };
+		double const upload_mb{ static_cast<double>(uploaded) / frames / (1 << 20) };
+		build(tess);
+		double const draw_ms{ time_frames([&](int) { mdl.draw(); }) };
+
+		double const pulled_ms{ time_frames([&](int f) {
+			mdl.slices = mdl.stacks = tess - f % 2;
+			mdl.draw_pulled();
+		}) };
+
+		std::cout << names[t] << "\t|\t" << std::setprecision(3) << std::fixed
+		          << rebuild_ms << "\t\t\t|\t" << draw_ms << "\t\t|\t" << pulled_ms << "\t\t|\t"
+		          << upload_mb << std::defaultfloat << "\n";
+
+		arena.free(mdl.vtx_alloc);
+		arena.free(mdl.idx_alloc);
+		glDeleteVertexArrays(1, &mdl.vaoid);
 	}
-
-	// Step 3: Generate a VAO handle to encapsulate the VBO(s) and
-	// state of this triangle mesh
-			// define VAO handle
-	GLuint vbo_hdl;
-	glCreateBuffers(1, &vbo_hdl);
-	glNamedBufferStorage(vbo_hdl, sizeof(glm::vec2) * pos_vtx.size() + sizeof(glm::vec3) * clr_vtx.size(),
-		nullptr, GL_DYNAMIC_STORAGE_BIT);
-	glNamedBufferSubData(vbo_hdl, 0,
-		sizeof(glm::vec2) * pos_vtx.size(), pos_vtx.data());
-	glNamedBufferSubData(vbo_hdl, sizeof(glm::vec2) * pos_vtx.size(),
-		sizeof(glm::vec3) * clr_vtx.size(), clr_vtx.data());
-
-	GLuint vaoid;
-	glCreateVertexArrays(1, &vaoid);
-	glEnableVertexArrayAttrib(vaoid, 0);
-	glVertexArrayVertexBuffer(vaoid, 0, vbo_hdl, 0, sizeof(glm::vec2));
-	glVertexArrayAttribFormat(vaoid, 0, 2, GL_FLOAT, GL_FALSE, 0);
-	glVertexArrayAttribBinding(vaoid, 0, 0);
-
-	glEnableVertexArrayAttrib(vaoid, 1);
-	glVertexArrayVertexBuffer(vaoid, 1, vbo_hdl,
-		sizeof(glm::vec2) * pos_vtx.size(), sizeof(glm::vec3));
-	glVertexArrayAttribFormat(vaoid, 1, 3, GL_FLOAT, GL_FALSE, 0);
-	glVertexArrayAttribBinding(vaoid, 1, 1);
-
-	GLuint ebo_hdl;
-	glCreateBuffers(1, &ebo_hdl);
-	glNamedBufferStorage(ebo_hdl, sizeof(GLushort) * idx_vtx.size(),
-		reinterpret_cast<GLvoid*>(idx_vtx.data()),
-		GL_DYNAMIC_STORAGE_BIT);
-	glVertexArrayElementBuffer(vaoid, ebo_hdl);
-	glBindVertexArray(0);
-
-	GLApp::GLModel mdl{};
-	mdl.vaoid = vaoid; // set up VAO same as in GLApp::points_model
-	mdl.primitive_type = GL_TRIANGLE_STRIP;
-	mdl.setup_shdrpgm(vtx_shdr, frg_shdr);
-	mdl.draw_cnt = idx_vtx.size(); // number of vertices
-	mdl.primitive_cnt = (slices * stacks * 2); // number of primitives (not used)
-
-	// Step 4: Return an appropriately initialized instance of GLApp::GLModel
-	return mdl;
+	std::cout << std::endl;
 }
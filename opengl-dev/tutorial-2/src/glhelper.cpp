@@ -26,6 +26,8 @@ GLdouble GLHelper::fps;
 GLdouble GLHelper::delta_time;
 std::string GLHelper::title;
 GLFWwindow* GLHelper::ptr_window;
+GLboolean GLHelper::keystateP = GL_FALSE;
+GLboolean GLHelper::keystateB = GL_FALSE;
 
 /*  _________________________________________________________________________ */
 /*! init
@@ -151,6 +153,7 @@ were held down
 
 This function is called when keyboard buttons are pressed.
 When the ESC key is pressed, the close flag of the window is set.
+When the key P or B is pressed, its keystate is set and it is unset upon release.
 */
 void GLHelper::key_cb(GLFWwindow *pwin, int key, int scancode, int action, int mod) {
 
@@ -162,6 +165,8 @@ void GLHelper::key_cb(GLFWwindow *pwin, int key, int scancode, int action, int m
 #ifdef _DEBUG
     std::cout << "Key pressed" << std::endl;
 #endif
+    keystateP = (key == GLFW_KEY_P) ? GL_TRUE : keystateP;
+    keystateB = (key == GLFW_KEY_B) ? GL_TRUE : keystateB;
   } else if (GLFW_REPEAT == action) {
 #ifdef _DEBUG
     std::cout << "Key repeatedly pressed" << std::endl;
@@ -170,6 +175,8 @@ void GLHelper::key_cb(GLFWwindow *pwin, int key, int scancode, int action, int m
 #ifdef _DEBUG
     std::cout << "Key released" << std::endl;
 #endif
+    keystateP = (key == GLFW_KEY_P) ? GL_FALSE : keystateP;
+    keystateB = (key == GLFW_KEY_B) ? GL_FALSE : keystateB;
   }
 
   if (GLFW_KEY_ESCAPE == key && GLFW_PRESS == action) {
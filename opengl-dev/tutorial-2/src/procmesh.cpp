@@ -0,0 +1,523 @@
+/*!
+* @file    procmesh.cpp
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/21/2023
+*
+* @brief This file implements the procedural mesh builders of struct
+*		 ProcMesh declared in procmesh.h. Each builder sizes its arrays once
+*		 and then fills vertices and indices in chunks with
+*		 JobSystem::parallel_for; a chunk writes a contiguous range of whole
+*		 rows, rings or rim vertices, so threads never share a cache line
+*		 but at chunk ends. Rim angles are given in turns, i / slices, which
+*		 reduces exactly to the octant the sine and cosine polynomials are
+*		 accurate on.
+*//*__________________________________________________________________________*/
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <procmesh.h>
+#include <meshindex.h>
+#include <jobsystem.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define PROCMESH_SSE2
+#endif
+
+// the sine and cosine must not fuse multiplies and adds into FMA
+// instructions in one path only, or the paths would differ
+#if defined(_MSC_VER)
+#pragma fp_contract(off)
+#elif defined(__clang__)
+#pragma clang fp contract(off)
+#else
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+/*                                                   objects with file scope
+----------------------------------------------------------------------------- */
+namespace {
+  float const TWO_PI{ 6.28318531f };
+
+  // minimax coefficients of sin and cos on [-pi/4, pi/4]
+  float const S1{ -1.6666654611e-1f };
+  float const S2{ 8.3321608736e-3f };
+  float const S3{ -1.9515295891e-4f };
+  float const C1{ 4.166664568298827e-2f };
+  float const C2{ -1.388731625493765e-3f };
+  float const C3{ 2.443315711809948e-5f };
+
+  /*  _______________________________________________________________________ */
+  /*! hash
+   * @brief Mix the bits of a 32-bit integer.
+  */
+  inline GLuint hash(GLuint x)
+  {
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! sincos_turn_scalar
+   * @brief Compute sine and cosine of an angle given in turns.
+   *
+   * The nearest multiple q of a quarter turn is subtracted and the rest
+   * converted to radians in [-pi/4, pi/4]. The quadrant q selects and
+   * negates the polynomial results.
+   *
+   * @param t[in] Angle in turns in [0, 1].
+   * @param s[out] Sine of the angle.
+   * @param c[out] Cosine of the angle.
+   * @return void
+  */
+  inline void sincos_turn_scalar(float t, float& s, float& c)
+  {
+    int const q{ static_cast<int>(std::nearbyint(t * 4.f)) };
+    float const qf{ static_cast<float>(q) };
+    float const x{ (t - qf * 0.25f) * TWO_PI };
+    float const z{ x * x };
+
+    float sp{ S3 * z };
+    sp = sp + S2;
+    sp = sp * z;
+    sp = sp + S1;
+    sp = sp * z;
+    sp = sp * x;
+    sp = sp + x;
+
+    float cp{ C3 * z };
+    cp = cp + C2;
+    cp = cp * z;
+    cp = cp + C1;
+    cp = cp * z;
+    cp = cp * z;
+    cp = cp - 0.5f * z;
+    cp = cp + 1.f;
+
+    float const ss{ (q & 1) ? cp : sp };
+    float const cc{ (q & 1) ? sp : cp };
+    s = (q & 2) ? -ss : ss;
+    c = ((q + 1) & 2) ? -cc : cc;
+  }
+
+#ifdef PROCMESH_SSE2
+  /*  _______________________________________________________________________ */
+  /*! sincos_turn_sse2
+   * @brief SSE2 version of sincos_turn_scalar for 4 angles.
+  */
+  inline void sincos_turn_sse2(__m128 t, __m128& s, __m128& c)
+  {
+    __m128i const one{ _mm_set1_epi32(1) }, two{ _mm_set1_epi32(2) };
+    __m128i const q{ _mm_cvtps_epi32(_mm_mul_ps(t, _mm_set1_ps(4.f))) };
+    __m128 const qf{ _mm_cvtepi32_ps(q) };
+    __m128 const x{ _mm_mul_ps(_mm_sub_ps(t, _mm_mul_ps(qf, _mm_set1_ps(0.25f))), _mm_set1_ps(TWO_PI)) };
+    __m128 const z{ _mm_mul_ps(x, x) };
+
+    __m128 sp{ _mm_mul_ps(_mm_set1_ps(S3), z) };
+    sp = _mm_add_ps(sp, _mm_set1_ps(S2));
+    sp = _mm_mul_ps(sp, z);
+    sp = _mm_add_ps(sp, _mm_set1_ps(S1));
+    sp = _mm_mul_ps(sp, z);
+    sp = _mm_mul_ps(sp, x);
+    sp = _mm_add_ps(sp, x);
+
+    __m128 cp{ _mm_mul_ps(_mm_set1_ps(C3), z) };
+    cp = _mm_add_ps(cp, _mm_set1_ps(C2));
+    cp = _mm_mul_ps(cp, z);
+    cp = _mm_add_ps(cp, _mm_set1_ps(C1));
+    cp = _mm_mul_ps(cp, z);
+    cp = _mm_mul_ps(cp, z);
+    cp = _mm_sub_ps(cp, _mm_mul_ps(_mm_set1_ps(0.5f), z));
+    cp = _mm_add_ps(cp, _mm_set1_ps(1.f));
+
+    __m128 const swap{ _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, one), one)) };
+    s = _mm_or_ps(_mm_and_ps(swap, cp), _mm_andnot_ps(swap, sp));
+    c = _mm_or_ps(_mm_and_ps(swap, sp), _mm_andnot_ps(swap, cp));
+    s = _mm_xor_ps(s, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, two), 30)));
+    c = _mm_xor_ps(c, _mm_castsi128_ps(
+      _mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, one), two), 30)));
+  }
+#endif
+
+  /*  _______________________________________________________________________ */
+  /*! color
+   * @brief Draw the color of the next vertex.
+  */
+  inline glm::vec3 color(ProcMesh::Rng& rng)
+  {
+    // braced initializers are evaluated left to right
+    return glm::vec3{ rng.next(), rng.next(), rng.next() };
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! chunk
+   * @brief Number of items of per vertices each a chunk of about
+   * ProcMesh::grain vertices holds.
+  */
+  inline size_t chunk(size_t per)
+  {
+    return std::max<size_t>(1, ProcMesh::grain / std::max<size_t>(1, per));
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! grid_vertices
+   * @brief Build the vertices shared by ProcMesh::grid and ProcMesh::strip,
+   * vertex (i, j) at index i + j * (slices + 1).
+   *
+   * @param slices[in] Number of columns of cells.
+   * @param stacks[in] Number of rows of cells.
+   * @param seed[in] Seed of the vertex colors.
+   * @param vtx[out] Vertices of the grid.
+   * @return void
+  */
+  void grid_vertices(GLuint slices, GLuint stacks, GLuint seed, std::vector<ProcMesh::Vertex>& vtx)
+  {
+    size_t const row_len{ static_cast<size_t>(slices) + 1 };
+    vtx.resize(row_len * (static_cast<size_t>(stacks) + 1));
+    float const xinterval{ 2.f / static_cast<float>(slices) };
+    float const yinterval{ 2.f / static_cast<float>(stacks) };
+
+    JobSystem::parallel_for(static_cast<size_t>(stacks) + 1, chunk(row_len), [&](size_t first, size_t last) {
+      ProcMesh::Rng rng{ seed, static_cast<GLuint>(3 * row_len * first) };
+      for (size_t j{ first }; j < last; ++j) {
+        ProcMesh::Vertex* out{ vtx.data() + row_len * j };
+        float const y{ yinterval * static_cast<float>(j) - 1.f };
+        for (size_t i{ 0 }; i < row_len; ++i) {
+          out[i].pos = glm::vec2{ xinterval * static_cast<float>(i) - 1.f, y };
+          out[i].clr = color(rng);
+        }
+      }
+    });
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! ProcMesh::Rng::Rng
+ * @brief Start drawing numbers of seed at counter.
+ *
+ * @param seed[in] Seed of the mesh.
+ * @param counter[in] Number of numbers drawn before the first one.
+*/
+ProcMesh::Rng::Rng(GLuint seed, GLuint counter) : key{ hash(seed ^ 0x9e3779b9u) }, counter{ counter }
+{
+}
+
+/*  _________________________________________________________________________ */
+/*! ProcMesh::Rng::next
+ * @brief Draw the next number.
+ *
+ * @return Number in [0, 1) with 24 random bits.
+*/
+GLfloat ProcMesh::Rng::next()
+{
+  GLuint const bits{ hash(hash(counter++ ^ key) + key) };
+  return static_cast<GLfloat>(bits >> 8) * (1.f / 16777216.f);
+}
+
+/*  _________________________________________________________________________ */
+/*! ProcMesh::rim
+ * @brief Compute the sines and cosines of the rim angles of a circle.
+ *
+ * Angles are computed 4 at a time with SSE2 where available; the scalar
+ * path evaluates the same operations so the results do not depend on
+ * which path a vertex falls in.
+ *
+ * @param slices[in] Number of rim edges.
+ * @param sines[out] Sine of turn i / slices at index i.
+ * @param cosines[out] Cosine of turn i / slices at index i.
+ * @return void
+*/
+void ProcMesh::rim(GLuint slices, std::vector<GLfloat>& sines, std::vector<GLfloat>& cosines)
+{
+  sines.resize(static_cast<size_t>(slices) + 1);
+  cosines.resize(static_cast<size_t>(slices) + 1);
+  float const denom{ static_cast<float>(slices) };
+
+  JobSystem::parallel_for(sines.size(), grain, [&](size_t first, size_t last) {
+    size_t i{ first };
+#ifdef PROCMESH_SSE2
+    __m128 const d{ _mm_set1_ps(denom) };
+    for (; i + 4 <= last; i += 4) {
+      __m128i const idx{ _mm_add_epi32(_mm_set1_epi32(static_cast<int>(i)), _mm_set_epi32(3, 2, 1, 0)) };
+      __m128 s, c;
+      sincos_turn_sse2(_mm_div_ps(_mm_cvtepi32_ps(idx), d), s, c);
+      _mm_storeu_ps(sines.data() + i, s);
+      _mm_storeu_ps(cosines.data() + i, c);
+    }
+#endif
+    for (; i < last; ++i) {
+      sincos_turn_scalar(static_cast<float>(i) / denom, sines[i], cosines[i]);
+    }
+  });
+}
+
+/*  _________________________________________________________________________ */
+/*! ProcMesh::grid
+ * @brief Build a grid drawn as GL_TRIANGLES, two counterclockwise
+ * triangles per cell.
+ *
+ * @param slices[in] Number of columns of cells.
+ * @param stacks[in] Number of rows of cells.
+ * @param seed[in] Seed of the vertex colors.
+ * @return The mesh.
+*/
+ProcMesh::Mesh ProcMesh::grid(GLuint slices, GLuint stacks, GLuint seed)
+{
+  Mesh mesh;
+  mesh.primitive_type = GL_TRIANGLES;
+  grid_vertices(slices, stacks, seed, mesh.vtx);
+
+  size_t const row_len{ static_cast<size_t>(slices) + 1 };
+  mesh.idx.resize(6 * static_cast<size_t>(slices) * stacks);
+  JobSystem::parallel_for(stacks, chunk(6 * slices), [&](size_t first, size_t last) {
+    for (size_t j{ first }; j < last; ++j) {
+      GLuint* out{ mesh.idx.data() + 6 * slices * j };
+      for (size_t i{ 0 }; i < slices; ++i) {
+        GLuint const a{ static_cast<GLuint>(i + row_len * j) }, d{ static_cast<GLuint>(a + row_len) };
+        *out++ = a;
+        *out++ = a + 1;
+        *out++ = d + 1;
+        *out++ = a;
+        *out++ = d + 1;
+        *out++ = d;
+      }
+    }
+  });
+  return mesh;
+}
+
+/*  _________________________________________________________________________ */
+/*! ProcMesh::strip
+ * @brief Build a grid drawn as one GL_TRIANGLE_STRIP per stack.
+ *
+ * The strip of a stack alternates between the row above and the row below
+ * it, as tristrip_model did, with MeshIndex::restart between strips.
+ *
+ * @param slices[in] Number of columns of cells.
+ * @param stacks[in] Number of rows of cells.
+ * @param seed[in] Seed of the vertex colors.
+ * @return The mesh.
+*/
+ProcMesh::Mesh ProcMesh::strip(GLuint slices, GLuint stacks, GLuint seed)
+{
+  Mesh mesh;
+  mesh.primitive_type = GL_TRIANGLE_STRIP;
+  grid_vertices(slices, stacks, seed, mesh.vtx);
+
+  size_t const row_len{ static_cast<size_t>(slices) + 1 };
+  size_t const strip_len{ 2 * row_len + 1 };
+  mesh.idx.resize(strip_len * stacks - 1);
+  JobSystem::parallel_for(stacks, chunk(strip_len), [&](size_t first, size_t last) {
+    for (size_t j{ first }; j < last; ++j) {
+      GLuint* out{ mesh.idx.data() + strip_len * j };
+      for (size_t i{ 0 }; i < row_len; ++i) {
+        *out++ = static_cast<GLuint>(i + row_len * (j + 1));
+        *out++ = static_cast<GLuint>(i + row_len * j);
+      }
+      if (j + 1 < stacks) {
+        *out = MeshIndex::restart;
+      }
+    }
+  });
+  return mesh;
+}
+
+/*  _________________________________________________________________________ */
+/*! ProcMesh::fan
+ * @brief Build the unit circle drawn as a GL_TRIANGLE_FAN.
+ *
+ * @param slices[in] Number of rim edges.
+ * @param seed[in] Seed of the vertex colors.
+ * @return The mesh; vertex 0 is the center, vertex i + 1 is at turn
+ * i / slices and the indices are 0 to slices + 1.
+*/
+ProcMesh::Mesh ProcMesh::fan(GLuint slices, GLuint seed)
+{
+  std::vector<GLfloat> sines, cosines;
+  rim(slices, sines, cosines);
+
+  Mesh mesh;
+  mesh.primitive_type = GL_TRIANGLE_FAN;
+  mesh.vtx.resize(static_cast<size_t>(slices) + 2);
+  mesh.idx.resize(mesh.vtx.size());
+
+  JobSystem::parallel_for(mesh.vtx.size(), grain, [&](size_t first, size_t last) {
+    Rng rng{ seed, static_cast<GLuint>(3 * first) };
+    for (size_t v{ first }; v < last; ++v) {
+      mesh.vtx[v].pos = (v == 0) ? glm::vec2{ 0.f, 0.f } : glm::vec2{ cosines[v - 1], sines[v - 1] };
+      mesh.vtx[v].clr = color(rng);
+      mesh.idx[v] = static_cast<GLuint>(v);
+    }
+  });
+  return mesh;
+}
+
+/*  _________________________________________________________________________ */
+/*! ProcMesh::disc
+ * @brief Build the unit disc drawn as GL_TRIANGLES.
+ *
+ * Ring k, k in [0, rings), has radius (k + 1) / rings; its vertices start
+ * at 1 + k * (slices + 1) after the center. The innermost ring is joined
+ * to the center by one triangle per slice and every other ring to the one
+ * inside it by two.
+ *
+ * @param slices[in] Number of rim edges of each ring.
+ * @param rings[in] Number of rings.
+ * @param seed[in] Seed of the vertex colors.
+ * @return The mesh.
+*/
+ProcMesh::Mesh ProcMesh::disc(GLuint slices, GLuint rings, GLuint seed)
+{
+  std::vector<GLfloat> sines, cosines;
+  rim(slices, sines, cosines);
+
+  Mesh mesh;
+  mesh.primitive_type = GL_TRIANGLES;
+  size_t const ring_len{ static_cast<size_t>(slices) + 1 };
+  mesh.vtx.resize(1 + ring_len * rings);
+  mesh.vtx[0].pos = glm::vec2{ 0.f, 0.f };
+  Rng center{ seed, 0 };
+  mesh.vtx[0].clr = color(center);
+
+  JobSystem::parallel_for(rings, chunk(ring_len), [&](size_t first, size_t last) {
+    Rng rng{ seed, static_cast<GLuint>(3 * (1 + ring_len * first)) };
+    for (size_t k{ first }; k < last; ++k) {
+      Vertex* out{ mesh.vtx.data() + 1 + ring_len * k };
+      float const radius{ static_cast<float>(k + 1) / static_cast<float>(rings) };
+      for (size_t i{ 0 }; i < ring_len; ++i) {
+        out[i].pos = glm::vec2{ radius * cosines[i], radius * sines[i] };
+        out[i].clr = color(rng);
+      }
+    }
+  });
+
+  mesh.idx.resize(3 * static_cast<size_t>(slices) * (2 * static_cast<size_t>(rings) - 1));
+  JobSystem::parallel_for(rings, chunk(6 * slices), [&](size_t first, size_t last) {
+    for (size_t k{ first }; k < last; ++k) {
+      GLuint* out{ mesh.idx.data() + ((k == 0) ? 0 : 3 * slices * (2 * k - 1)) };
+      GLuint const outer{ static_cast<GLuint>(1 + ring_len * k) };
+      for (GLuint i{ 0 }; i < slices; ++i) {
+        if (k == 0) {
+          *out++ = 0;
+          *out++ = outer + i;
+          *out++ = outer + i + 1;
+          continue;
+        }
+        GLuint const inner{ static_cast<GLuint>(outer - ring_len) };
+        *out++ = inner + i;
+        *out++ = outer + i;
+        *out++ = outer + i + 1;
+        *out++ = inner + i;
+        *out++ = outer + i + 1;
+        *out++ = inner + i + 1;
+      }
+    }
+  });
+  return mesh;
+}
+
+/*  _________________________________________________________________________ */
+/*! ProcMesh::annulus
+ * @brief Build a ring drawn as one GL_TRIANGLE_STRIP.
+ *
+ * @param slices[in] Number of rim edges.
+ * @param inner[in] Radius of the inner rim, in [0, 1).
+ * @param seed[in] Seed of the vertex colors.
+ * @return The mesh; vertex 2i is on the inner rim and 2i + 1 on the outer
+ * rim at turn i / slices, which winds the strip counterclockwise.
+*/
+ProcMesh::Mesh ProcMesh::annulus(GLuint slices, GLfloat inner, GLuint seed)
+{
+  std::vector<GLfloat> sines, cosines;
+  rim(slices, sines, cosines);
+
+  Mesh mesh;
+  mesh.primitive_type = GL_TRIANGLE_STRIP;
+  mesh.vtx.resize(2 * (static_cast<size_t>(slices) + 1));
+  mesh.idx.resize(mesh.vtx.size());
+
+  JobSystem::parallel_for(sines.size(), chunk(2), [&](size_t first, size_t last) {
+    Rng rng{ seed, static_cast<GLuint>(3 * 2 * first) };
+    for (size_t i{ first }; i < last; ++i) {
+      Vertex* out{ mesh.vtx.data() + 2 * i };
+      out[0].pos = glm::vec2{ inner * cosines[i], inner * sines[i] };
+      out[0].clr = color(rng);
+      out[1].pos = glm::vec2{ cosines[i], sines[i] };
+      out[1].clr = color(rng);
+      mesh.idx[2 * i] = static_cast<GLuint>(2 * i);
+      mesh.idx[2 * i + 1] = static_cast<GLuint>(2 * i + 1);
+    }
+  });
+  return mesh;
+}
+
+/*  _________________________________________________________________________ */
+/*! ProcMesh::benchmark
+ * @brief Print the time to build million-vertex meshes.
+ *
+ * Each mesh is built with 1, 2, 4, ... threads up to the hardware thread
+ * count. Speedup is relative to a single thread and Identical tells
+ * whether the vertices and indices match those of the single thread to the
+ * byte.
+ *
+ * @param none
+ * @return void
+*/
+void ProcMesh::benchmark()
+{
+  struct Case {
+    char const* name;
+    Mesh (*build)();
+  };
+  Case const cases[]{
+    { "Grid", [] { return grid(1023, 1023, 1); } },
+    { "Strip", [] { return strip(1023, 1023, 1); } },
+    { "Fan", [] { return fan((1 << 20) - 2, 1); } },
+    { "Disc", [] { return disc(1023, 1024, 1); } },
+    { "Annulus", [] { return annulus((1 << 19) - 1, 0.5f, 1); } },
+  };
+  int const repeats{ 5 };
+  unsigned const saved_threads{ JobSystem::get_thread_count() };
+
+  std::cout << "Mesh\t|\tThreads\t|\tBuild (ms)\t|\tMvertices/s\t|\tSpeedup\t|\tIdentical\n";
+  std::cout << "----------------------------------------------------------------------------------------------\n";
+  for (Case const& c : cases) {
+    Mesh serial;
+    double serial_ms{ 0.0 };
+    for (unsigned threads{ 1 }; threads <= JobSystem::max_thread_count(); threads *= 2) {
+      JobSystem::set_thread_count(threads);
+
+      Mesh mesh;
+      auto const start{ std::chrono::steady_clock::now() };
+      for (int r{ 0 }; r < repeats; ++r) {
+        mesh = c.build();
+      }
+      double const ms{ std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count() / repeats };
+
+      if (threads == 1) {
+        serial = mesh;
+        serial_ms = ms;
+      }
+      bool const identical{ mesh.vtx.size() == serial.vtx.size() && mesh.idx.size() == serial.idx.size()
+        && std::memcmp(mesh.vtx.data(), serial.vtx.data(), sizeof(Vertex) * mesh.vtx.size()) == 0
+        && std::memcmp(mesh.idx.data(), serial.idx.data(), sizeof(GLuint) * mesh.idx.size()) == 0 };
+
+      std::cout << c.name << "\t|\t" << threads << "\t|\t" << std::setprecision(3) << std::fixed
+                << ms << "\t\t|\t" << static_cast<double>(mesh.vtx.size()) / ms / 1000.0 << "\t\t|\t"
+                << serial_ms / ms << "\t|\t" << (identical ? "yes" : "no") << std::defaultfloat << "\n";
+    }
+  }
+  std::cout << "----------------------------------------------------------------------------------------------\n";
+
+  JobSystem::set_thread_count(saved_threads);
+}
@@ -0,0 +1,103 @@
+/*!
+* @file    bufferarena.h
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/17/2023
+*
+* @brief This file contains the declaration of class BufferArena that
+*		 suballocates vertex and index ranges from a few large immutable
+*		 buffers (blocks) instead of creating a buffer object per range. Each
+*		 block keeps a list of its free ranges sorted by offset; an
+*		 allocation takes the first free range it fits in and a freed range
+*		 is merged with its free neighbors, so memory is reused. Every live
+*		 allocation is tagged with the name of its owner, so that the
+*		 allocations still live when the arena is destroyed can be reported
+*		 as leaks.
+*//*__________________________________________________________________________*/
+
+/*                                                                      guard
+----------------------------------------------------------------------------- */
+#ifndef BUFFERARENA_H
+#define BUFFERARENA_H
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <GL/glew.h> // for access to OpenGL API declarations
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*  _________________________________________________________________________ */
+class BufferArena
+  /*! BufferArena class.
+  */
+{
+public:
+  // range of a block; id is 0 if nothing was allocated
+  struct Allocation {
+    GLuint buffer{ 0 };   // block holding the range
+    GLintptr offset{ 0 }; // offset of the range in the block
+    GLsizeiptr size{ 0 }; // bytes requested
+    GLuint id{ 0 };       // identifies the allocation to free
+  };
+
+  // bytes of every block: reserved = used + wasted + free, where wasted is
+  // the padding in front of allocations needed to align them and
+  // fragmented is the free memory outside the largest free range, which
+  // an allocation of every free byte could not use
+  struct Stats {
+    GLuint block_cnt{ 0 }, alloc_cnt{ 0 };
+    GLsizeiptr reserved{ 0 }, used{ 0 }, wasted{ 0 }, free{ 0 }, fragmented{ 0 };
+  };
+
+  static GLsizeiptr constexpr default_block_size{ 1 << 20 };
+  static GLsizeiptr constexpr default_alignment{ 16 };
+
+  explicit BufferArena(GLsizeiptr block_size = default_block_size) : block_size{ block_size } {}
+  BufferArena(BufferArena const&) = delete;
+  BufferArena& operator=(BufferArena const&) = delete;
+  ~BufferArena() { destroy(); }
+
+  // allocate size bytes at an offset that is a multiple of alignment and
+  // copy data to them unless it is nullptr; tag names the owner in the
+  // leak report
+  Allocation allocate(GLsizeiptr size, void const* data, std::string const& tag,
+                      GLsizeiptr alignment = default_alignment);
+
+  // return the range of an allocation to its block and reset it
+  void free(Allocation& alloc);
+
+  Stats get_stats() const;
+
+  // print the stats and every live allocation; return the number of
+  // live allocations
+  GLuint report(std::string const& title) const;
+
+  // delete every block, forgetting the live allocations
+  void destroy();
+
+private:
+  struct Range {
+    GLintptr offset;
+    GLsizeiptr size;
+  };
+
+  struct Block {
+    GLuint buffer;
+    GLsizeiptr size;
+    std::vector<Range> free_ranges; // sorted by offset, never adjacent
+  };
+
+  struct Live {
+    GLuint block;   // index of the block in blocks
+    Range range;    // range taken from the block, padding included
+    GLsizeiptr size;
+    std::string tag;
+  };
+
+  GLsizeiptr block_size;
+  std::vector<Block> blocks;
+  std::unordered_map<GLuint, Live> live;
+  GLuint next_id{ 1 };
+};
+
+#endif /* BUFFERARENA_H */
@@ -23,9 +23,10 @@
 /*                                                                   includes
 ----------------------------------------------------------------------------- */
 #include <glslshader.h>
+#include <bufferarena.h>
+#include <meshindex.h>
 #include <string>
 #include <vector>
-#include <list>
 
 struct GLApp {
 
@@ -40,62 +41,133 @@ struct GLApp {
 	  GLenum primitive_type; // which OpenGL primitive to be rendered?
 	  GLuint primitive_cnt; // added for tutorial 2
 	  GLuint vaoid; // handle to VAO
+	  BufferArena::Allocation vtx_alloc, idx_alloc; // ranges of buffer_arena
+	  GLenum idx_type; // type of the indices in idx_alloc
 
 	  GLuint draw_cnt; // added for tutorial 2
+
+	  // per-instance model-to-NDC matrices used by the instanced path
+	  GLuint inst_vbo; // handle to instance VBO
+	  GLuint inst_cap; // number of matrices inst_vbo can hold
+	  std::vector<glm::mat3> inst_xforms; // matrices gathered this frame
+
+	  // function to (re)create inst_vbo with room for capacity matrices
+	  void setup_instance_vbo(GLuint capacity);
+
+	  // function to upload inst_xforms and render all instances of this
+	  // model with a single glDrawElementsInstanced call
+	  void draw_instanced();
   };
 
-  // tutorial 3 - encapsulates state required to update
-  // and render an instance of a model
-  struct GLObject {
-	  // these two variables keep track of the current orientation
-	  // of the object.
+  // tutorial 3 - encapsulates state required to update and render
+  // every instance of a model. Each attribute of the objects is kept in
+  // its own contiguous array (structure of arrays) so that the update
+  // loop streams through memory instead of chasing list nodes.
+  // The arrays are used as a ring buffer with a power-of-two capacity:
+  // the oldest object lives in slot head and the cnt live objects occupy
+  // consecutive slots (modulo capacity). Spawning appends at the tail and
+  // retiring the oldest objects only advances head.
+  struct GLObjects {
+	  // these two arrays keep track of the current orientation
+	  // of each object.
 	  // angle_speed: rate of change of rotation angle per second
 	  // angle_disp: current absolute orientation angle
 	  // all angles refer to rotation about z-axis
-	  GLfloat angle_speed, angle_disp;
+	  std::vector<GLfloat> angle_speed, angle_disp;
+
+	  std::vector<glm::vec2> scaling; // scaling parameters
+	  std::vector<glm::vec2> position; // translation vector coordinates
+
+	  // model-to-NDC transform of each object computed by CPU using
+	  // scaling, rotation, and translation attributes
+	  std::vector<glm::mat3> mdl_to_ndc_xform;
 
-	  glm::vec2 scaling; // scaling parameters
-	  glm::vec2 position; // translation vector coordinates
+	  // index into GLApp::models of the model each object is an instance of
+	  std::vector<GLuint> mdl_ref;
 
-	  // compute object's model transform matrix using scaling,
-	  // rotation, and translation attributes
-	  // computed by CPU and not vertex shader, GPU runs per-vertex which is 
-	  // many times more compared to CPU
-	  glm::mat3 mdl_to_ndc_xform;
+	  // index into GLApp::shdrpgms of the shader program for each object
+	  std::vector<GLuint> shd_ref;
 
-	  // which model is this object an instance of?
-	  // models are contained in a vector, need to keep track of
-	  // the specific model that was instanced by the index into the vector container
-	  GLuint mdl_ref;
+	  // count of live objects that are instances of each model
+	  std::vector<GLuint> objCount;
 
-	  // how to draw this instanced model?
-	  // shader programs are contained in a vector, need to keep track of
-	  // specific shader program using index into vector container
-	  GLuint shd_ref;
+	  // count of objects of each model spawned so far, and the same counts
+	  // as they were right after the object in each slot was spawned,
+	  // stored objCount.size() per slot; retire reads the counts of the
+	  // objects it removes from the slot of the youngest of them
+	  std::vector<GLuint> spawned;
+	  std::vector<GLuint> spawned_at;
 
-	  // static data member to keep track of object count
-	  static std::vector<GLuint> objCount;
+	  size_t head{ 0 }; // slot of the oldest live object
+	  size_t cnt{ 0 };  // number of live objects
+	  size_t mask{ 0 }; // capacity - 1
 
 	  // member functions defined in glapp.cpp
 
-	  // function to initialize object's state
-	  void init();
+	  // function to grow every array to hold at least capacity objects
+	  void reserve(size_t capacity);
+
+	  // slot in the arrays of the i-th oldest live object
+	  size_t slot(size_t i) const { return (head + i) & mask; }
+
+	  size_t size() const { return cnt; }
+	  bool empty() const { return cnt == 0; }
+
+	  // function to append n randomly initialized objects
+	  void spawn(size_t n);
+
+	  // function to remove the n oldest objects
+	  void retire(size_t n);
+
+	  // function to remove every object
+	  void clear();
 
-	  // function to render object's model (specified by index mdl_ref)
-	  // uses model transformation matrix mdl_to_ndc_xform matrix
-	  // and shader program specified by index shd_ref
-	  void draw() const;
+	  // function to randomly initialize the object in slot s
+	  void init(size_t s);
 
-	  // function to update the object's model transformation matrix
+	  // function to update the orientation and model transformation matrix
+	  // of every live object
 	  void update(GLdouble delta_time);
+
+	  // function to update objects in the contiguous slots [first, last)
+	  void update_range(size_t first, size_t last, GLfloat delta_time);
+
+	  // function to render object in slot s using model mdl_ref[s],
+	  // model transformation matrix mdl_to_ndc_xform[s]
+	  // and shader program shd_ref[s]
+	  void draw(size_t s) const;
   };
 
-  static std::list<GLApp::GLObject> objects; // singleton
+  static GLApp::GLObjects objects; // singleton
 
   static std::vector<GLSLShader> shdrpgms; // singleton in tutorial 3
 
   static std::vector<GLModel> models;
 
+  // buffers the vertices and indices of every model are suballocated from
+  static BufferArena buffer_arena;
+
+  // GL_TRUE if objects are rendered with one instanced draw per model
+  static GLboolean instanced;
+
+  // index into GLApp::shdrpgms of the shader program used by instanced path
+  static GLuint const instanced_shd_ref{ 1 };
+
+  // function to render every object in GLApp::objects using either
+  // per-object draws or per-model instanced draws
+  static void draw_objects();
+
+  // function to print frame times of both rendering paths
+  // at 1k, 8k and 32k objects
+  static void benchmark_draw();
+
+  // number of objects updated by each job of the parallel update
+  static size_t const update_grain{ 1024 };
+
+  // function to print update times for every thread count and
+  // whether the results match those of a single thread
+  static void benchmark_update();
+
   static GLApp::GLModel box_model();
 
   static GLApp::GLModel mystery_model();
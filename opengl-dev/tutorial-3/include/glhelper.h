@@ -50,6 +50,15 @@ struct GLHelper
   // this flag is true if button P was toggled from released position to pressed
   static GLboolean keystateP;
 
+  // this flag is true if button I was toggled from released position to pressed
+  static GLboolean keystateI;
+
+  // this flag is true if button B was toggled from released position to pressed
+  static GLboolean keystateB;
+
+  // this flag is true if button T was toggled from released position to pressed
+  static GLboolean keystateT;
+
   // this flag is true if left mouse button is clicked
   static GLboolean leftclickState;
 
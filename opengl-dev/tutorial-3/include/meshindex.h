@@ -0,0 +1,80 @@
+/*!
+* @file    meshindex.h
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/18/2023
+*
+* @brief This file contains the definition of struct MeshIndex that picks the
+*		 index type of a mesh from its vertex count. Mesh builders compute
+*		 32-bit indices and pack them to GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT
+*		 or GL_UNSIGNED_INT, whichever is smallest, so that a mesh is never
+*		 limited to 65536 vertices and small meshes take the least index
+*		 memory. The largest value of each type is kept free because it is
+*		 the restart index of GL_PRIMITIVE_RESTART_FIXED_INDEX, which
+*		 separates the strips or fans of a mesh.
+*//*__________________________________________________________________________*/
+
+/*                                                                      guard
+----------------------------------------------------------------------------- */
+#ifndef MESHINDEX_H
+#define MESHINDEX_H
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <GL/glew.h> // for access to OpenGL API declarations
+#include <vector>
+#include <cstring>
+
+/*  _________________________________________________________________________ */
+struct MeshIndex
+  /*! MeshIndex structure to choose and pack the index type of a mesh.
+  */
+{
+  // written by mesh builders between the strips or fans of a mesh; pack
+  // truncates it to the largest value of the packed type, which is the
+  // restart index of that type
+  static GLuint constexpr restart{ 0xFFFFFFFF };
+
+  // smallest index type whose largest value is above the indices of
+  // vtx_cnt vertices
+  static GLenum type(size_t vtx_cnt)
+  {
+    return (vtx_cnt <= 0xFF) ? GL_UNSIGNED_BYTE
+         : (vtx_cnt <= 0xFFFF) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+  }
+
+  // bytes per index of type; 0 if type is not an index type
+  static GLsizeiptr size(GLenum type)
+  {
+    switch (type) {
+    case GL_UNSIGNED_BYTE:  return 1;
+    case GL_UNSIGNED_SHORT: return 2;
+    case GL_UNSIGNED_INT:   return 4;
+    default:                return 0;
+    }
+  }
+
+  // convert 32-bit indices to type, in the byte layout of an element buffer
+  static std::vector<GLubyte> pack(std::vector<GLuint> const& idx_vtx, GLenum type)
+  {
+    std::vector<GLubyte> bytes(static_cast<size_t>(size(type)) * idx_vtx.size());
+    switch (type) {
+    case GL_UNSIGNED_BYTE:  pack_as<GLubyte>(idx_vtx, bytes.data()); break;
+    case GL_UNSIGNED_SHORT: pack_as<GLushort>(idx_vtx, bytes.data()); break;
+    case GL_UNSIGNED_INT:   pack_as<GLuint>(idx_vtx, bytes.data()); break;
+    }
+    return bytes;
+  }
+
+private:
+  template <typename T>
+  static void pack_as(std::vector<GLuint> const& idx_vtx, GLubyte* out)
+  {
+    for (GLuint idx : idx_vtx) {
+      T const packed{ static_cast<T>(idx) };
+      std::memcpy(out, &packed, sizeof(T));
+      out += sizeof(T);
+    }
+  }
+};
+
+#endif /* MESHINDEX_H */
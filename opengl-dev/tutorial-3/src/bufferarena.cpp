@@ -0,0 +1,205 @@
+/*!
+* @file    bufferarena.cpp
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/17/2023
+*
+* @brief This file implements class BufferArena declared in bufferarena.h.
+*//*__________________________________________________________________________*/
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <bufferarena.h>
+#include <iostream>
+#include <algorithm>
+#include <iterator>
+
+/*  _________________________________________________________________________ */
+/*! BufferArena::allocate
+ * @brief Allocate a range from the first free range of a block it fits in.
+ *
+ * If no block has room, a block of block_size bytes, or of size bytes if
+ * that is larger, is created with glNamedBufferStorage. The data is copied
+ * with glNamedBufferSubData, so blocks have GL_DYNAMIC_STORAGE_BIT.
+ *
+ * @param size[in] Number of bytes.
+ * @param data[in] Data copied to the range, or nullptr.
+ * @param tag[in] Name of the owner printed by report while the range is live.
+ * @param alignment[in] Alignment of the offset of the range in its block.
+ * @return The allocation, with id 0 if size is 0.
+*/
+BufferArena::Allocation BufferArena::allocate(GLsizeiptr size, void const* data,
+                                              std::string const& tag, GLsizeiptr alignment)
+{
+  if (size <= 0) {
+    return Allocation{};
+  }
+
+  auto const align = [alignment](GLintptr offset) {
+    return (offset + alignment - 1) / alignment * alignment;
+  };
+
+  // first fit over the free ranges of every block
+  GLuint b{ 0 };
+  size_t r{ 0 };
+  GLintptr start{ 0 };
+  for (; b < blocks.size(); ++b) {
+    std::vector<Range> const& ranges{ blocks[b].free_ranges };
+    for (r = 0; r < ranges.size(); ++r) {
+      start = align(ranges[r].offset);
+      if (start + size <= ranges[r].offset + ranges[r].size) {
+        break;
+      }
+    }
+    if (r < ranges.size()) {
+      break;
+    }
+  }
+
+  if (b == blocks.size()) {
+    Block block{ 0, std::max(block_size, size), {} };
+    glCreateBuffers(1, &block.buffer);
+    glNamedBufferStorage(block.buffer, block.size, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    block.free_ranges.push_back(Range{ 0, block.size });
+    blocks.push_back(block);
+    r = 0;
+    start = 0;
+  }
+
+  // the padding in front of start stays with the allocation until it is
+  // freed; the rest of the free range remains free
+  Block& block{ blocks[b] };
+  Range& free_range{ block.free_ranges[r] };
+  Range const taken{ free_range.offset, start + size - free_range.offset };
+  free_range.offset += taken.size;
+  free_range.size -= taken.size;
+  if (free_range.size == 0) {
+    block.free_ranges.erase(block.free_ranges.begin() + r);
+  }
+
+  if (data != nullptr) {
+    glNamedBufferSubData(block.buffer, start, size, data);
+  }
+
+  Allocation const alloc{ block.buffer, start, size, next_id++ };
+  live.emplace(alloc.id, Live{ b, taken, size, tag });
+  return alloc;
+}
+
+/*  _________________________________________________________________________ */
+/*! BufferArena::free
+ * @brief Return the range of an allocation to the free list of its block,
+ * merged with the free ranges right before and after it.
+ *
+ * @param alloc[in,out] Allocation to free; reset to an empty allocation.
+ * Freeing an empty allocation does nothing.
+ * @return void
+*/
+void BufferArena::free(Allocation& alloc)
+{
+  auto const it{ live.find(alloc.id) };
+  if (it == live.end()) {
+    alloc = Allocation{};
+    return;
+  }
+
+  std::vector<Range>& ranges{ blocks[it->second.block].free_ranges };
+  Range range{ it->second.range };
+  auto next{ std::lower_bound(ranges.begin(), ranges.end(), range,
+                              [](Range const& lhs, Range const& rhs) { return lhs.offset < rhs.offset; }) };
+  if (next != ranges.end() && range.offset + range.size == next->offset) {
+    range.size += next->size;
+    next = ranges.erase(next);
+  }
+  if (next != ranges.begin() && std::prev(next)->offset + std::prev(next)->size == range.offset) {
+    std::prev(next)->size += range.size;
+  }
+  else {
+    ranges.insert(next, range);
+  }
+
+  live.erase(it);
+  alloc = Allocation{};
+}
+
+/*  _________________________________________________________________________ */
+/*! BufferArena::get_stats
+ * @brief Count the blocks and live allocations and sum their bytes.
+ *
+ * @param none
+ * @return Stats of the arena.
+*/
+BufferArena::Stats BufferArena::get_stats() const
+{
+  Stats stats;
+  GLsizeiptr largest_free{ 0 };
+  for (Block const& block : blocks) {
+    stats.reserved += block.size;
+    for (Range const& range : block.free_ranges) {
+      stats.free += range.size;
+      largest_free = std::max(largest_free, range.size);
+    }
+  }
+  for (auto const& entry : live) {
+    stats.used += entry.second.size;
+    stats.wasted += entry.second.range.size - entry.second.size;
+  }
+  stats.block_cnt = static_cast<GLuint>(blocks.size());
+  stats.alloc_cnt = static_cast<GLuint>(live.size());
+  stats.fragmented = stats.free - largest_free;
+  return stats;
+}
+
+/*  _________________________________________________________________________ */
+/*! BufferArena::report
+ * @brief Print the stats of the arena and each live allocation, oldest first.
+ *
+ * Called right before the arena is destroyed, every allocation printed is
+ * one its owner never freed.
+ *
+ * @param title[in] Printed in front of the stats.
+ * @return Number of live allocations.
+*/
+GLuint BufferArena::report(std::string const& title) const
+{
+  Stats const stats{ get_stats() };
+  std::cout << title << ": " << stats.block_cnt << " buffers, " << stats.reserved << " bytes reserved, "
+            << stats.used << " used, " << stats.wasted << " wasted, " << stats.free << " free ("
+            << stats.fragmented << " fragmented)\n";
+  if (live.empty()) {
+    std::cout << "No live allocations\n";
+    return 0;
+  }
+
+  std::vector<std::pair<GLuint, Live const*>> sorted;
+  for (auto const& entry : live) {
+    sorted.emplace_back(entry.first, &entry.second);
+  }
+  std::sort(sorted.begin(), sorted.end(),
+            [](auto const& lhs, auto const& rhs) { return lhs.first < rhs.first; });
+
+  std::cout << "Id\t|\tBytes\t|\tBuffer\t|\tOffset\t|\tOwner\n";
+  std::cout << "--------------------------------------------------------------------------------\n";
+  for (auto const& entry : sorted) {
+    Live const& l{ *entry.second };
+    std::cout << entry.first << "\t\t" << l.size << "\t\t" << blocks[l.block].buffer << "\t\t"
+              << l.range.offset + l.range.size - l.size << "\t\t" << l.tag << "\n";
+  }
+  std::cout << "--------------------------------------------------------------------------------\n";
+  return stats.alloc_cnt;
+}
+
+/*  _________________________________________________________________________ */
+/*! BufferArena::destroy
+ * @brief Delete the buffers of every block.
+ *
+ * @param none
+ * @return void
+*/
+void BufferArena::destroy()
+{
+  for (Block const& block : blocks) {
+    glDeleteBuffers(1, &block.buffer);
+  }
+  blocks.clear();
+  live.clear();
+}
@@ -15,22 +15,30 @@
 ----------------------------------------------------------------------------- */
 #include <glapp.h>
 #include <glhelper.h>
+#include <xformbatch.h>
+#include <jobsystem.h>
 #include <glm/glm.hpp>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
 #include <random>
+#include <algorithm>
+#include <type_traits>
 #include <glm/gtc/type_ptr.inl> // for glm::value_ptr
 
 /*                                                   objects with file scope
 ----------------------------------------------------------------------------- */
 // defining singleton containers
-std::list<GLApp::GLObject> GLApp::objects{};
+GLApp::GLObjects GLApp::objects{};
 std::vector<GLApp::GLModel> GLApp::models{};
 std::vector<GLSLShader> GLApp::shdrpgms{};
+BufferArena GLApp::buffer_arena{};
 
-// static variables
-std::vector<GLuint> GLApp::GLObject::objCount(2); // count of box_model and mystery_model
+// rendering path toggled with key 'I'
+GLboolean GLApp::instanced{ GL_FALSE };
+
+// handle to uniform variable set by each per-object draw
+static GLSLShader::UniformHandle const uModel_to_NDC{ GLSLShader::GetUniformHandle("uModel_to_NDC") };
 
 // file scope
 std::random_device rd; // random device for seed
@@ -68,6 +76,7 @@ glm::vec3 randColor()
  * 3. Creates shared shader programs from vertex and fragment shader files
  *    and inserts them into the GLApp::shdrpgms container.
  * 4. Creates different geometries and inserts them into the GLApp::models repository container.
+ * 5. Starts one worker thread per hardware thread for the parallel update.
  *
  * @param none
  * @return void
@@ -87,11 +96,15 @@ void GLApp::init()
 	// vertex & fragment shader files
 	GLApp::VPSS shdr_files_names{
 		std::make_pair<std::string, std::string>
-		("../shaders/my-tutorial-3.vert", "../shaders/my-tutorial-3.frag")
+		("../shaders/my-tutorial-3.vert", "../shaders/my-tutorial-3.frag"),
+		std::make_pair<std::string, std::string>
+		("../shaders/my-tutorial-3-instanced.vert", "../shaders/my-tutorial-3.frag")
 	};
 
 	// create shader program from shader files in vector shdr_file_names
-	// and insert each shader program into the container GLApp::shdrpgms
+	// and insert each shader program into the container GLApp::shdrpgms;
+	// linked programs are cached so that later runs skip compiling them
+	GLSLShader::SetBinaryCacheDir("../shader-cache");
 	GLApp::init_shdrpgms_cont(shdr_files_names);
 
 	// Part 4: create different geometries and insert them into
@@ -99,6 +112,14 @@ void GLApp::init()
 	GLApp::init_models_cont();
 
 	// GLApp::objects empty since simulation begins with no objects displayed
+	// reserve room for the maximum object count so that spawning never
+	// reallocates the arrays of the object store
+	GLApp::objects.objCount.assign(GLApp::models.size(), 0);
+	GLApp::objects.spawned.assign(GLApp::models.size(), 0);
+	GLApp::objects.reserve(32768);
+
+	// Part 5: start worker threads used to update objects in parallel
+	JobSystem::init();
 }
 
 /*  _________________________________________________________________________ */
@@ -112,7 +133,9 @@ void GLApp::init()
  * 3. Spawns or kills objects based on the left mouse button press:
  *    - If the maximum object limit is not reached, new objects are spawned.
  *    - If the maximum object limit is reached, the oldest objects are killed.
- * 4. Updates the orientation and attributes of each object in the GLApp::objects container.
+ * 4. Toggles between per-object and instanced rendering if 'I' is pressed and
+ *    prints a frame time comparison of both paths if 'B' is pressed.
+ * 5. Updates the orientation and attributes of each object in the GLApp::objects container.
  *
  * @param none
  * @return void
@@ -165,21 +188,11 @@ void GLApp::update()
 			}
 			else if (objects.empty()) // spawns the first object
 			{
-				GLApp::GLObject obj{};
-				obj.init();
-				objects.emplace_back(obj);
-				++GLObject::objCount[obj.mdl_ref];
+				objects.spawn(1);
 			}
-			else
+			else // doubles the object count
 			{
-				size_t size = objects.size();
-				for (size_t i{ 0 }; i < size; ++i)
-				{
-					GLApp::GLObject obj{};
-					obj.init();
-					objects.emplace_back(obj);
-					++GLObject::objCount[obj.mdl_ref];
-				}
+				objects.spawn(objects.size());
 			}
 		}
 		
@@ -190,35 +203,50 @@ void GLApp::update()
 			if (objects.size() == minLimit)
 			{
 				spawn = GL_TRUE;
-				GLApp::GLObject obj{};
-				obj.init();
-				objects.emplace_back(obj);
-				++GLObject::objCount[obj.mdl_ref];
+				objects.spawn(1);
 			}
-			else
+			else // kills the oldest half of the objects
 			{
-				size_t size = objects.size();
-				for (size_t i{ 0 }; i < size/2; ++i)
-				{
-					--GLObject::objCount[objects.front().mdl_ref];
-					objects.pop_front();
-				}
+				objects.retire(objects.size() / 2);
 			}
 		}
 
 		GLHelper::leftclickState = GL_FALSE;
 	}
 
+	// toggle rendering path if key 'I' is pressed
+	if (GLHelper::keystateI == GL_TRUE)
+	{
+		instanced = instanced ? GL_FALSE : GL_TRUE;
+		GLHelper::keystateI = GL_FALSE;
+	}
+
+	// cycle number of threads updating objects through 1, 2, 4, ...
+	// up to the number of hardware threads if key 'T' is pressed
+	if (GLHelper::keystateT == GL_TRUE)
+	{
+		unsigned const threads{ JobSystem::get_thread_count() };
+		JobSystem::set_thread_count(threads >= JobSystem::max_thread_count() ? 1 : threads * 2);
+		GLHelper::keystateT = GL_FALSE;
+	}
+
+	// compare frame times of both rendering paths, throughput of the
+	// transform kernels and update times per thread count if key 'B' is pressed
+	if (GLHelper::keystateB == GL_TRUE)
+	{
+		GLApp::benchmark_draw();
+		XformBatch::benchmark(32768);
+		GLApp::benchmark_update();
+		GLHelper::keystateB = GL_FALSE;
+	}
+
 	// Part 3:
 	// for each object in container GLApp::objects
 	// Update object's orientation
 	// A more elaborate implementation would animate the object's movement
 	// A much more elaborate implementation would animate the object's size
 	// Using updated attributes, compute world-to-ndc transformation matrix
-	for (auto& tmp : objects)
-	{
-		tmp.update(GLHelper::delta_time);
-	}
+	objects.update(GLHelper::delta_time);
 }
 
 /*  _________________________________________________________________________ */
@@ -231,8 +259,8 @@ void GLApp::update()
  * 2. Clears the back buffer using glClear.
  * 3. Adjusts the diameter of rasterized points or width of rasterized lines based
  *  on the rendering mode.
- * 4. Renders each object in the GLApp::objects container by calling the member
- *    function GLObject::draw() for each object.
+ * 4. Renders each object in the GLApp::objects container by calling
+ *    GLApp::draw_objects().
  *
  * @param none
  * @return void
@@ -250,12 +278,18 @@ void GLApp::draw()
 	std::stringstream title;
 
 	title << "Tutorial 3 | Brandon Ho Jun Jie | " << "Obj: " << objects.size() << " | "
-											      << "Box: " << GLObject::objCount[0] << " | "
-												  << "Mystery: " << GLObject::objCount[1] << " | "
+											      << "Box: " << objects.objCount[0] << " | "
+												  << "Mystery: " << objects.objCount[1] << " | "
+												  << (instanced ? "Instanced" : "Per-object") << " | "
+												  << "Threads: " << JobSystem::get_thread_count() << " | "
+												  << "Lookups avoided: " << GLSLShader::GetLookupsAvoided() << " | "
 												  << std::setprecision(2) << std::fixed << GLHelper::fps;
 	
 	glfwSetWindowTitle(GLHelper::ptr_window, title.str().c_str());
 
+	// count uniform lookups avoided during this frame only
+	GLSLShader::ResetLookupsAvoided();
+
 	// clear back buffer
 	glClear(GL_COLOR_BUFFER_BIT);
 
@@ -284,21 +318,200 @@ void GLApp::draw()
 	}
 
 	// Part 4: Render each object in container GLApp::objects
-	for (auto const& x : GLApp::objects) {
-		x.draw(); // call member function GLObject::draw()
+	GLApp::draw_objects();
+}
+
+/*  _________________________________________________________________________ */
+/*! GLApp::draw_objects
+ * @brief Render every object in the GLApp::objects container.
+ *
+ * If GLApp::instanced is not set, GLObjects::draw() is called for each object.
+ * Otherwise, the model-to-NDC matrices of the objects are grouped by mdl_ref
+ * and each model is rendered with a single instanced draw call using the
+ * shader program GLApp::shdrpgms[instanced_shd_ref].
+ *
+ * @param none
+ * @return void
+*/
+void GLApp::draw_objects()
+{
+	if (!instanced)
+	{
+		for (size_t i{ 0 }; i < objects.size(); ++i) {
+			objects.draw(objects.slot(i)); // call member function GLObjects::draw()
+		}
+		return;
+	}
+
+	// group matrices of objects by the model they are an instance of
+	for (auto& mdl : GLApp::models)
+	{
+		mdl.inst_xforms.clear();
 	}
+
+	for (size_t i{ 0 }; i < objects.size(); ++i)
+	{
+		size_t const s{ objects.slot(i) };
+		models[objects.mdl_ref[s]].inst_xforms.emplace_back(objects.mdl_to_ndc_xform[s]);
+	}
+
+	shdrpgms[instanced_shd_ref].Use();
+
+	for (auto& mdl : GLApp::models)
+	{
+		mdl.draw_instanced();
+	}
+
+	shdrpgms[instanced_shd_ref].UnUse();
+}
+
+/*  _________________________________________________________________________ */
+/*! GLApp::benchmark_draw
+ * @brief Print frame times of the per-object and instanced rendering paths.
+ *
+ * This function replaces the objects in GLApp::objects with 1024, 8192 and
+ * 32768 randomly initialized objects in turn. For each count, both rendering
+ * paths render a number of frames and glFinish is called after each frame so
+ * that the measured time includes the work done by the GPU. The average
+ * frame time of each path is printed to the console and the objects that
+ * existed before the benchmark are restored.
+ *
+ * @param none
+ * @return void
+*/
+void GLApp::benchmark_draw()
+{
+	// keep simulation state so that it can be restored afterwards
+	GLApp::GLObjects saved_objects{ objects };
+	GLboolean saved_mode{ instanced };
+
+	int const frames{ 60 };
+	size_t const counts[]{ 1024, 8192, 32768 };
+
+	std::cout << "Objects\t|\tPer-object (ms)\t|\tInstanced (ms)\n";
+	std::cout << "----------------------------------------------------------------------\n";
+	for (size_t cnt : counts)
+	{
+		objects.clear();
+		objects.spawn(cnt);
+		objects.update(0.0);
+
+		double frame_ms[2]{};
+		for (int mode{ 0 }; mode < 2; ++mode)
+		{
+			instanced = (mode == 1) ? GL_TRUE : GL_FALSE;
+
+			// warm up so that instance buffers are already large enough
+			glClear(GL_COLOR_BUFFER_BIT);
+			GLApp::draw_objects();
+			glFinish();
+
+			double const start{ glfwGetTime() };
+			for (int f{ 0 }; f < frames; ++f)
+			{
+				glClear(GL_COLOR_BUFFER_BIT);
+				GLApp::draw_objects();
+				glFinish();
+			}
+			frame_ms[mode] = (glfwGetTime() - start) * 1000.0 / frames;
+		}
+
+		std::cout << cnt << "\t\t" << std::setprecision(3) << std::fixed
+				  << frame_ms[0] << "\t\t\t" << frame_ms[1] << "\n";
+	}
+	std::cout << "----------------------------------------------------------------------\n";
+
+	objects = saved_objects;
+	instanced = saved_mode;
+}
+
+/*  _________________________________________________________________________ */
+/*! GLApp::benchmark_update
+ * @brief Print update times of 32768 objects for every thread count.
+ *
+ * This function fills GLApp::objects with 32768 randomly initialized objects
+ * and, for 1, 2, 4, ... threads up to the number of hardware threads, times
+ * a number of updates starting from that same state. The transformation
+ * matrices computed with each thread count are compared with those computed
+ * with a single thread. The objects and thread count that existed before
+ * the benchmark are restored.
+ *
+ * @param none
+ * @return void
+*/
+void GLApp::benchmark_update()
+{
+	GLApp::GLObjects saved_objects{ objects };
+	unsigned const saved_threads{ JobSystem::get_thread_count() };
+
+	int const updates{ 100 };
+	GLdouble const delta_time{ 1.0 / 60.0 };
+
+	objects.clear();
+	objects.spawn(32768);
+	GLApp::GLObjects const start_objects{ objects };
+	std::vector<glm::mat3> serial_xforms;
+	double serial_ms{ 0.0 };
+
+	std::cout << "Threads\t|\tUpdate (ms)\t|\tSpeedup\t|\tIdentical\n";
+	std::cout << "----------------------------------------------------------------------\n";
+	for (unsigned threads{ 1 }; threads <= JobSystem::max_thread_count(); threads *= 2)
+	{
+		JobSystem::set_thread_count(threads);
+		objects = start_objects;
+
+		double const start{ glfwGetTime() };
+		for (int u{ 0 }; u < updates; ++u)
+		{
+			objects.update(delta_time);
+		}
+		double const update_ms{ (glfwGetTime() - start) * 1000.0 / updates };
+
+		if (threads == 1)
+		{
+			serial_xforms = objects.mdl_to_ndc_xform;
+			serial_ms = update_ms;
+		}
+		bool const identical{ std::equal(serial_xforms.begin(), serial_xforms.end(),
+										 objects.mdl_to_ndc_xform.begin()) };
+
+		std::cout << threads << "\t\t" << std::setprecision(3) << std::fixed
+				  << update_ms << "\t\t\t" << serial_ms / update_ms << "\t\t"
+				  << (identical ? "yes" : "no") << "\n";
+	}
+	std::cout << "----------------------------------------------------------------------\n";
+
+	objects = saved_objects;
+	JobSystem::set_thread_count(saved_threads);
 }
 
 /*  _________________________________________________________________________ */
 /*! GLApp::cleanup
- * @brief Empty.
+ * @brief Stop the worker threads and free the models, their VBOs and programs.
  * 
  * @param none
  * @return none
 */
 void GLApp::cleanup()
 {
-  // empty for now
+	JobSystem::cleanup();
+
+	for (GLModel& mdl : models)
+	{
+		buffer_arena.free(mdl.vtx_alloc);
+		buffer_arena.free(mdl.idx_alloc);
+		glDeleteBuffers(1, &mdl.inst_vbo);
+		glDeleteVertexArrays(1, &mdl.vaoid);
+	}
+	models.clear();
+	for (GLSLShader& shdr_pgm : shdrpgms)
+	{
+		shdr_pgm.DeleteShaderProgram();
+	}
+	shdrpgms.clear();
+
+	buffer_arena.report("GPU buffer arena at cleanup");
+	buffer_arena.destroy();
 }
 
 /*  _________________________________________________________________________ */
@@ -328,55 +541,77 @@ void GLApp::init_shdrpgms_cont(GLApp::VPSS const& vpss)
 }
 
 /*  _________________________________________________________________________ */
-/*! GLApp::GLObject::draw
- * @brief Draw the GLObject.
+/*! GLApp::GLModel::setup_instance_vbo
+ * @brief Create the instance VBO of the model.
  *
- * This function renders the GLObject by performing the following tasks:
- * 1. Sets the appropriate shader program for rendering the geometry.
- * 2. Sets up the vertex array object (VAO) for the GLObject.
- * 3. Copies the 3x3 model-to-NDC matrix to the vertex shader.
- * 4. Specifies the primitive type and the number of primitives to be rendered.
- * 5. Cleans up by unbinding the VAO and the shader program.
+ * This function (re)creates the buffer that holds the per-instance
+ * model-to-NDC matrices with room for capacity matrices and attaches it to
+ * binding point 2 of the model's VAO. Vertex attributes 2, 3 and 4 hold the
+ * three columns of the matrix and advance once per instance.
  *
- * @param none
+ * @param capacity[in] Number of matrices the buffer can hold.
  * @return void
 */
-void GLApp::GLObject::draw() const
+void GLApp::GLModel::setup_instance_vbo(GLuint capacity)
 {
-	// there are many shader programs initialized - here we're saying
-	// which specific shader program should be used to render geometry
-	shdrpgms[shd_ref].Use();
-
-	// there are many models, each with their own initialized VAO object
-	// here, we're saying which VAO's state should be used to set up pipe
-	glBindVertexArray(models[mdl_ref].vaoid);
+	if (inst_vbo)
+	{
+		glDeleteBuffers(1, &inst_vbo);
+	}
 
-	// Copy object 3x3 model-to-NDC matrix to vertex shader
-	GLint uniform_var_loc1 = glGetUniformLocation(GLApp::shdrpgms[shd_ref].GetHandle(),
-												  "uModel_to_NDC");
+	inst_cap = capacity;
+	glCreateBuffers(1, &inst_vbo);
+	glNamedBufferStorage(inst_vbo, sizeof(glm::mat3) * inst_cap,
+		nullptr, GL_DYNAMIC_STORAGE_BIT);
 
-	if (uniform_var_loc1 >= 0)
+	glVertexArrayVertexBuffer(vaoid, 2, inst_vbo, 0, sizeof(glm::mat3));
+	for (GLuint col{ 0 }; col < 3; ++col)
 	{
-		glUniformMatrix3fv(uniform_var_loc1, 1, GL_FALSE,
-						   glm::value_ptr(GLApp::GLObject::mdl_to_ndc_xform));
+		glEnableVertexArrayAttrib(vaoid, 2 + col);
+		glVertexArrayAttribFormat(vaoid, 2 + col, 3, GL_FLOAT, GL_FALSE,
+			static_cast<GLuint>(sizeof(glm::vec3)) * col);
+		glVertexArrayAttribBinding(vaoid, 2 + col, 2);
 	}
-	else
+	glVertexArrayBindingDivisor(vaoid, 2, 1);
+}
+
+/*  _________________________________________________________________________ */
+/*! GLApp::GLModel::draw_instanced
+ * @brief Draw every instance of the model gathered in inst_xforms.
+ *
+ * This function grows the instance VBO if it cannot hold all the matrices in
+ * inst_xforms, copies the matrices to the VBO and renders all instances with
+ * a single glDrawElementsInstanced call. The shader program must already be
+ * installed by the caller.
+ *
+ * @param none
+ * @return void
+*/
+void GLApp::GLModel::draw_instanced()
+{
+	if (inst_xforms.empty())
 	{
-		std::cout << "Uniform variable doesn't exist!!!\n";
-		std::exit(EXIT_FAILURE);
+		return;
 	}
 
-	// here, we're saying what primitive is to be rendered and how many
-	// such primitives exist.
-	// the graphics driver knows where to get the indices because the VAO
-	// containing this state information has been made current ...
+	GLuint const inst_cnt{ static_cast<GLuint>(inst_xforms.size()) };
+	if (inst_cnt > inst_cap)
+	{
+		GLuint capacity{ inst_cap };
+		while (capacity < inst_cnt)
+		{
+			capacity *= 2;
+		}
+		setup_instance_vbo(capacity);
+	}
 
-	glDrawElements(models[mdl_ref].primitive_type, models[mdl_ref].draw_cnt, GL_UNSIGNED_SHORT, NULL);
-	// after completing the rendering, we tell the driver that VAO
-	// vaoid and current shader program are no longer current
+	glNamedBufferSubData(inst_vbo, 0, sizeof(glm::mat3) * inst_cnt,
+		inst_xforms.data());
 
+	glBindVertexArray(vaoid);
+	glDrawElementsInstanced(primitive_type, draw_cnt, idx_type,
+		reinterpret_cast<GLvoid const*>(idx_alloc.offset), inst_cnt);
 	glBindVertexArray(0);
-	shdrpgms[shd_ref].UnUse();
 }
 
 /*  _________________________________________________________________________ */
@@ -399,7 +634,8 @@ void GLApp::init_models_cont()
  * @brief Create a model representing a square.
  *
  * This function creates a model representing a square by generating vertex and
- * index data, creating a VAO to encapsulate the vertex data, and returning an
+ * index data, allocating them from GLApp::buffer_arena, creating a VAO to
+ * encapsulate the vertex data, and returning an
  * initialized instance of GLApp::GLModel.
  *
  * @param none
@@ -417,46 +653,48 @@ GLApp::GLModel GLApp::box_model()
 		randColor(),randColor() 
 	};
 
-	std::vector<GLushort> idx_vtx{ 0,1,2,2,3,0 };
+	std::vector<GLuint> idx_vtx{ 0,1,2,2,3,0 };
 
 	// Step 3: Generate a VAO handle to encapsulate the VBO(s) and
 	// state of this triangle mesh
 	// define VAO handle
-	GLuint vbo_hdl;
-	glCreateBuffers(1, &vbo_hdl);
-	glNamedBufferStorage(vbo_hdl, sizeof(glm::vec2) * pos_vtx.size() + sizeof(glm::vec3) * clr_vtx.size(),
-		nullptr, GL_DYNAMIC_STORAGE_BIT);
-	glNamedBufferSubData(vbo_hdl, 0,
+	BufferArena::Allocation const vtx_alloc{ buffer_arena.allocate(
+		sizeof(glm::vec2) * pos_vtx.size() + sizeof(glm::vec3) * clr_vtx.size(), nullptr, "box_model vertices") };
+	glNamedBufferSubData(vtx_alloc.buffer, vtx_alloc.offset,
 		sizeof(glm::vec2) * pos_vtx.size(), pos_vtx.data());
-	glNamedBufferSubData(vbo_hdl, sizeof(glm::vec2) * pos_vtx.size(),
+	glNamedBufferSubData(vtx_alloc.buffer, vtx_alloc.offset + sizeof(glm::vec2) * pos_vtx.size(),
 		sizeof(glm::vec3) * clr_vtx.size(), clr_vtx.data());
 
 	GLuint vaoid;
 	glCreateVertexArrays(1, &vaoid);
 	glEnableVertexArrayAttrib(vaoid, 0);
-	glVertexArrayVertexBuffer(vaoid, 0, vbo_hdl, 0, sizeof(glm::vec2));
+	glVertexArrayVertexBuffer(vaoid, 0, vtx_alloc.buffer, vtx_alloc.offset, sizeof(glm::vec2));
 	glVertexArrayAttribFormat(vaoid, 0, 2, GL_FLOAT, GL_FALSE, 0);
 	glVertexArrayAttribBinding(vaoid, 0, 0);
 
 	glEnableVertexArrayAttrib(vaoid, 1);
-	glVertexArrayVertexBuffer(vaoid, 1, vbo_hdl,
-		sizeof(glm::vec2) * pos_vtx.size(), sizeof(glm::vec3));
+	glVertexArrayVertexBuffer(vaoid, 1, vtx_alloc.buffer,
+		vtx_alloc.offset + sizeof(glm::vec2) * pos_vtx.size(), sizeof(glm::vec3));
 	glVertexArrayAttribFormat(vaoid, 1, 3, GL_FLOAT, GL_FALSE, 0);
 	glVertexArrayAttribBinding(vaoid, 1, 1);
 
-	GLuint ebo_hdl;
-	glCreateBuffers(1, &ebo_hdl);
-	glNamedBufferStorage(ebo_hdl, sizeof(GLushort) * idx_vtx.size(),
-		reinterpret_cast<GLvoid*>(idx_vtx.data()),
-		GL_DYNAMIC_STORAGE_BIT);
-	glVertexArrayElementBuffer(vaoid, ebo_hdl);
+	// indices are packed to the smallest type that addresses every vertex
+	GLenum const idx_type{ MeshIndex::type(pos_vtx.size()) };
+	std::vector<GLubyte> const idx_bytes{ MeshIndex::pack(idx_vtx, idx_type) };
+	BufferArena::Allocation const idx_alloc{ buffer_arena.allocate(static_cast<GLsizeiptr>(idx_bytes.size()),
+		idx_bytes.data(), "box_model indices") };
+	glVertexArrayElementBuffer(vaoid, idx_alloc.buffer);
 	glBindVertexArray(0);
 
 	GLApp::GLModel mdl{};
 	mdl.vaoid = vaoid; // set up VAO same as in GLApp::points_model
+	mdl.vtx_alloc = vtx_alloc;
+	mdl.idx_alloc = idx_alloc;
+	mdl.idx_type = idx_type;
 	mdl.primitive_type = GL_TRIANGLES;
 	mdl.draw_cnt = idx_vtx.size(); // number of vertices
 	mdl.primitive_cnt = mdl.draw_cnt / 3; // number of primitives (not used)
+	mdl.setup_instance_vbo(64); // instance VBO grows on demand
 
 	// Step 4: Return an appropriately initialized instance of GLApp::GLModel
 	return mdl;
@@ -467,7 +705,8 @@ GLApp::GLModel GLApp::box_model()
  * @brief Create a model representing a mystery shape.
  *
  * This function creates a model representing a mystery shape by generating
- * vertex and index data, creating a VAO to encapsulate the vertex data,
+ * vertex and index data, allocating them from GLApp::buffer_arena, creating
+ * a VAO to encapsulate the vertex data,
  * and returning an initialized instance of GLApp::GLModel.
  *
  * @param none
@@ -489,124 +728,314 @@ GLApp::GLModel GLApp::mystery_model()
 		randColor()
 	};
 
-	std::vector<GLushort> idx_vtx{ 0,1,2,2,1,3,3,5,6,6,4,3,3,4,2 };
+	std::vector<GLuint> idx_vtx{ 0,1,2,2,1,3,3,5,6,6,4,3,3,4,2 };
 
 	// Step 3: Generate a VAO handle to encapsulate the VBO(s) and
 	// state of this triangle mesh
 	// define VAO handle
-	GLuint vbo_hdl;
-	glCreateBuffers(1, &vbo_hdl);
-	glNamedBufferStorage(vbo_hdl, sizeof(glm::vec2) * pos_vtx.size() + sizeof(glm::vec3) * clr_vtx.size(),
-		nullptr, GL_DYNAMIC_STORAGE_BIT);
-	glNamedBufferSubData(vbo_hdl, 0,
+	BufferArena::Allocation const vtx_alloc{ buffer_arena.allocate(
+		sizeof(glm::vec2) * pos_vtx.size() + sizeof(glm::vec3) * clr_vtx.size(), nullptr, "mystery_model vertices") };
+	glNamedBufferSubData(vtx_alloc.buffer, vtx_alloc.offset,
 		sizeof(glm::vec2) * pos_vtx.size(), pos_vtx.data());
-	glNamedBufferSubData(vbo_hdl, sizeof(glm::vec2) * pos_vtx.size(),
+	glNamedBufferSubData(vtx_alloc.buffer, vtx_alloc.offset + sizeof(glm::vec2) * pos_vtx.size(),
 		sizeof(glm::vec3) * clr_vtx.size(), clr_vtx.data());
 
 	GLuint vaoid;
 	glCreateVertexArrays(1, &vaoid);
 	glEnableVertexArrayAttrib(vaoid, 0);
-	glVertexArrayVertexBuffer(vaoid, 0, vbo_hdl, 0, sizeof(glm::vec2));
+	glVertexArrayVertexBuffer(vaoid, 0, vtx_alloc.buffer, vtx_alloc.offset, sizeof(glm::vec2));
 	glVertexArrayAttribFormat(vaoid, 0, 2, GL_FLOAT, GL_FALSE, 0);
 	glVertexArrayAttribBinding(vaoid, 0, 0);
 
 	glEnableVertexArrayAttrib(vaoid, 1);
-	glVertexArrayVertexBuffer(vaoid, 1, vbo_hdl,
-		sizeof(glm::vec2) * pos_vtx.size(), sizeof(glm::vec3));
+	glVertexArrayVertexBuffer(vaoid, 1, vtx_alloc.buffer,
+		vtx_alloc.offset + sizeof(glm::vec2) * pos_vtx.size(), sizeof(glm::vec3));
 	glVertexArrayAttribFormat(vaoid, 1, 3, GL_FLOAT, GL_FALSE, 0);
 	glVertexArrayAttribBinding(vaoid, 1, 1);
 
-	GLuint ebo_hdl;
-	glCreateBuffers(1, &ebo_hdl);
-	glNamedBufferStorage(ebo_hdl, sizeof(GLushort) * idx_vtx.size(),
-		reinterpret_cast<GLvoid*>(idx_vtx.data()),
-		GL_DYNAMIC_STORAGE_BIT);
-	glVertexArrayElementBuffer(vaoid, ebo_hdl);
+	// indices are packed to the smallest type that addresses every vertex
+	GLenum const idx_type{ MeshIndex::type(pos_vtx.size()) };
+	std::vector<GLubyte> const idx_bytes{ MeshIndex::pack(idx_vtx, idx_type) };
+	BufferArena::Allocation const idx_alloc{ buffer_arena.allocate(static_cast<GLsizeiptr>(idx_bytes.size()),
+		idx_bytes.data(), "mystery_model indices") };
+	glVertexArrayElementBuffer(vaoid, idx_alloc.buffer);
 	glBindVertexArray(0);
 
 	GLApp::GLModel mdl{};
 	mdl.vaoid = vaoid; // set up VAO same as in GLApp::points_model
+	mdl.vtx_alloc = vtx_alloc;
+	mdl.idx_alloc = idx_alloc;
+	mdl.idx_type = idx_type;
 	mdl.primitive_type = GL_TRIANGLES;
 	mdl.draw_cnt = idx_vtx.size(); // number of vertices
 	mdl.primitive_cnt = mdl.draw_cnt; // number of primitives (not used)
+	mdl.setup_instance_vbo(64); // instance VBO grows on demand
 
 	// Step 4: Return an appropriately initialized instance of GLApp::GLModel
 	return mdl;
 }
 
 /*  _________________________________________________________________________ */
-/*! GLApp::GLObject::init()
- * @brief Initialize the GLObject.
+/*! GLApp::GLObjects::draw
+ * @brief Draw the object in slot s.
+ *
+ * This function renders the object in slot s by performing the following tasks:
+ * 1. Sets the appropriate shader program for rendering the geometry.
+ * 2. Sets up the vertex array object (VAO) of the object's model.
+ * 3. Copies the 3x3 model-to-NDC matrix to the vertex shader.
+ * 4. Specifies the primitive type and the number of primitives to be rendered.
+ * 5. Cleans up by unbinding the VAO and the shader program.
+ *
+ * @param s[in] Slot of the object in the arrays of the store.
+ * @return void
+*/
+void GLApp::GLObjects::draw(size_t s) const
+{
+	// there are many shader programs initialized - here we're saying
+	// which specific shader program should be used to render geometry
+	shdrpgms[shd_ref[s]].Use();
+
+	// there are many models, each with their own initialized VAO object
+	// here, we're saying which VAO's state should be used to set up pipe
+	glBindVertexArray(models[mdl_ref[s]].vaoid);
+
+	// Copy object 3x3 model-to-NDC matrix to vertex shader
+	// the handle indexes the uniform locations reflected after linking
+	shdrpgms[shd_ref[s]].SetUniform(uModel_to_NDC, mdl_to_ndc_xform[s]);
+
+	// here, we're saying what primitive is to be rendered and how many
+	// such primitives exist.
+	// the graphics driver knows where to get the indices because the VAO
+	// containing this state information has been made current ...
+
+	glDrawElements(models[mdl_ref[s]].primitive_type, models[mdl_ref[s]].draw_cnt, models[mdl_ref[s]].idx_type,
+		reinterpret_cast<GLvoid const*>(models[mdl_ref[s]].idx_alloc.offset));
+	// after completing the rendering, we tell the driver that VAO
+	// vaoid and current shader program are no longer current
+
+	glBindVertexArray(0);
+	shdrpgms[shd_ref[s]].UnUse();
+}
+
+/*  _________________________________________________________________________ */
+/*! GLApp::GLObjects::reserve
+ * @brief Grow the arrays of the object store.
  *
- * This function initializes the GLObject by assigning random values to its
- * member variables such as mdl_ref, position, scaling, angle_disp, and angle_speed.
+ * This function rounds capacity up to a power of two and, if that is larger
+ * than the current capacity, reallocates every array. The live objects are
+ * copied oldest first to the start of the new arrays so that head becomes 0.
+ *
+ * @param capacity[in] Minimum number of objects the store must hold.
+ * @return void
+*/
+void GLApp::GLObjects::reserve(size_t capacity)
+{
+	size_t new_cap{ 1 };
+	while (new_cap < capacity)
+	{
+		new_cap *= 2;
+	}
+
+	if (new_cap <= mask + 1 && !mdl_ref.empty())
+	{
+		return;
+	}
+
+	// copy live objects oldest first into arrays of the new capacity
+	auto relocate = [&](auto& arr) {
+		std::remove_reference_t<decltype(arr)> tmp(new_cap);
+		for (size_t i{ 0 }; i < cnt; ++i)
+		{
+			tmp[i] = arr[slot(i)];
+		}
+		arr.swap(tmp);
+	};
+
+	relocate(angle_speed);
+	relocate(angle_disp);
+	relocate(scaling);
+	relocate(position);
+	relocate(mdl_to_ndc_xform);
+	relocate(mdl_ref);
+	relocate(shd_ref);
+
+	// spawned_at holds objCount.size() counts per slot
+	size_t const mdl_cnt{ objCount.size() };
+	std::vector<GLuint> tmp(new_cap * mdl_cnt);
+	for (size_t i{ 0 }; i < cnt; ++i)
+	{
+		std::copy_n(spawned_at.begin() + slot(i) * mdl_cnt, mdl_cnt, tmp.begin() + i * mdl_cnt);
+	}
+	spawned_at.swap(tmp);
+
+	head = 0;
+	mask = new_cap - 1;
+}
+
+/*  _________________________________________________________________________ */
+/*! GLApp::GLObjects::spawn
+ * @brief Append n randomly initialized objects.
+ *
+ * This function grows the store if it cannot hold n more objects and then
+ * initializes the n slots that follow the youngest object.
+ *
+ * @param n[in] Number of objects to spawn.
+ * @return void
+*/
+void GLApp::GLObjects::spawn(size_t n)
+{
+	if (cnt + n > mask + 1 || mdl_ref.empty())
+	{
+		reserve(cnt + n);
+	}
+
+	for (size_t i{ 0 }; i < n; ++i)
+	{
+		size_t const s{ slot(cnt + i) };
+		init(s);
+		++objCount[mdl_ref[s]];
+		++spawned[mdl_ref[s]];
+		std::copy(spawned.begin(), spawned.end(), spawned_at.begin() + s * spawned.size());
+	}
+	cnt += n;
+}
+
+/*  _________________________________________________________________________ */
+/*! GLApp::GLObjects::retire
+ * @brief Remove the n oldest objects.
+ *
+ * No memory is released or moved: head is advanced past the retired objects.
+ * The objects of each model left alive are those spawned after the youngest
+ * retired object, so each per-model count is the difference of two spawn
+ * counts and the cost does not depend on n.
+ *
+ * @param n[in] Number of objects to retire.
+ * @return void
+*/
+void GLApp::GLObjects::retire(size_t n)
+{
+	n = (n > cnt) ? cnt : n;
+	if (n == 0)
+	{
+		return;
+	}
+	size_t const last{ slot(n - 1) * spawned.size() };
+	for (size_t m{ 0 }; m < objCount.size(); ++m)
+	{
+		objCount[m] = spawned[m] - spawned_at[last + m];
+	}
+	head = slot(n);
+	cnt -= n;
+}
+
+/*  _________________________________________________________________________ */
+/*! GLApp::GLObjects::clear
+ * @brief Remove every object from the store.
  *
  * @param none
  * @return void
 */
-void GLApp::GLObject::init()
+void GLApp::GLObjects::clear()
+{
+	std::fill(objCount.begin(), objCount.end(), 0);
+	std::fill(spawned.begin(), spawned.end(), 0);
+	head = 0;
+	cnt = 0;
+}
+
+/*  _________________________________________________________________________ */
+/*! GLApp::GLObjects::init()
+ * @brief Initialize the object in slot s.
+ *
+ * This function initializes the object by assigning random values to its
+ * attributes such as mdl_ref, position, scaling, angle_disp, and angle_speed.
+ *
+ * @param s[in] Slot of the object in the arrays of the store.
+ * @return void
+*/
+void GLApp::GLObjects::init(size_t s)
 {
 	// get uniformed distribution for 0 and 1
 	std::uniform_int_distribution<> intDis(0, 1);
 	
-	mdl_ref = intDis(gen);
-	shd_ref = 0;
+	mdl_ref[s] = intDis(gen);
+	shd_ref[s] = 0;
 
 	double const worldRange{ 5000.0 };
 
 	// position of the object in game world in the range [-5000,5000]
-	position = glm::vec2(urdf(gen) * worldRange,
-						 urdf(gen) * worldRange);
+	position[s] = glm::vec2(urdf(gen) * worldRange,
+							urdf(gen) * worldRange);
 
 	// non-uniform scaling of the object from in the range [50.0,400.0]
-	scaling = glm::vec2(((urdf(gen) + 1.f) / 2.f) * (400.f - 50.f) + 50.f,
-						((urdf(gen) + 1.f) / 2.f) * (400.f - 50.f) + 50.f);
+	scaling[s] = glm::vec2(((urdf(gen) + 1.f) / 2.f) * (400.f - 50.f) + 50.f,
+						   ((urdf(gen) + 1.f) / 2.f) * (400.f - 50.f) + 50.f);
 
 	// initialize initial angular displacement and angular speed of the object
-	angle_disp = urdf(gen) * 360.f;
-	angle_speed = urdf(gen) * 30.f;	
+	angle_disp[s] = urdf(gen) * 360.f;
+	angle_speed[s] = urdf(gen) * 30.f;	
 }
 
 /*  _________________________________________________________________________ */
-/*! GLApp::GLObject::update()
- * @brief Update the GLObject.
+/*! GLApp::GLObjects::update()
+ * @brief Update every live object.
  *
- * This function updates the GLObject based on the given delta_time. It calculates
- * the transformation matrix (mdl_to_ndc_xform) of the object using its member 
- * variables such as scaling, position, angle_disp, and angle_speed.
+ * The live objects occupy at most two contiguous runs of slots in the ring
+ * buffer: from head to the end of the arrays and from the start of the
+ * arrays to the youngest object. Each run is split into jobs of update_grain
+ * objects that are passed to update_range on the threads of JobSystem.
+ * Every object is updated independently of the others, so the results do not
+ * depend on the number of threads.
  *
  * @param delta_time The time difference since the last update.
  * @return void
 */
-void GLApp::GLObject::update(GLdouble delta_time)
+void GLApp::GLObjects::update(GLdouble delta_time)
 {
-	glm::mat3 scaleMat{
-		scaling.x, 0.f, 0.f,
-		0.f, scaling.y, 0.f,
-		0.f, 0.f, 1.f
-	};
-
-	angle_disp += angle_speed * static_cast<float>(delta_time);
-	float angleRadians{ glm::radians<float>(angle_disp) };
-
-	glm::mat3 rotMat{
-		glm::cos(angleRadians), glm::sin(angleRadians), 0.f,
-		-glm::sin(angleRadians), glm::cos(angleRadians), 0.f,
-		0.f, 0.f, 1.f
-	};
+	GLfloat const dt{ static_cast<GLfloat>(delta_time) };
+	size_t const first_run{ (cnt < mask + 1 - head) ? cnt : mask + 1 - head };
+
+	JobSystem::parallel_for(first_run, update_grain, [this, dt](size_t first, size_t last) {
+		update_range(head + first, head + last, dt);
+	});
+	JobSystem::parallel_for(cnt - first_run, update_grain, [this, dt](size_t first, size_t last) {
+		update_range(first, last, dt);
+	});
+}
 
-	glm::mat3 transMat{
-		1.f, 0.f, 0.f,
-		0.f, 1.f, 0.f,
-		position.x, position.y, 1.f
-	};
+/*  _________________________________________________________________________ */
+/*! GLApp::GLObjects::update_range()
+ * @brief Update the objects in slots [first, last).
+ *
+ * This function advances angle_disp of each object by angle_speed and
+ * computes the transformation matrices mdl_to_ndc_xform from scaling,
+ * angle_disp and position with the vectorized kernel in XformBatch.
+ *
+ * @param first[in] First slot to update.
+ * @param last[in] One past the last slot to update.
+ * @param delta_time[in] The time difference since the last update.
+ * @return void
+*/
+void GLApp::GLObjects::update_range(size_t first, size_t last, GLfloat delta_time)
+{
+	if (first >= last)
+	{
+		return;
+	}
 
-	glm::mat3 modelMat{
+	glm::mat3 const modelMat{
 		1.f/5000.f, 0.f, 0.f,
 		0.f, 1.f/5000.f, 0.f,
 		0.f, 0.f, 1.f
 	};
 
+	for (size_t s{ first }; s < last; ++s)
+	{
+		angle_disp[s] += angle_speed[s] * delta_time;
+	}
+
 	// matrix to map geometry from model to world to NDC coordinates
-	mdl_to_ndc_xform = modelMat * (transMat * (rotMat * scaleMat));
+	glm::mat3* const out{ mdl_to_ndc_xform.data() + first };
+	XformBatch::compute(position.data() + first, scaling.data() + first,
+						angle_disp.data() + first, last - first, &modelMat, &out, 1);
 }
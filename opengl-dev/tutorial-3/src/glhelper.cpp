@@ -28,6 +28,9 @@ GLdouble GLHelper::delta_time;
 std::string GLHelper::title;
 GLFWwindow* GLHelper::ptr_window;
 GLboolean GLHelper::keystateP = GL_FALSE;
+GLboolean GLHelper::keystateI = GL_FALSE;
+GLboolean GLHelper::keystateB = GL_FALSE;
+GLboolean GLHelper::keystateT = GL_FALSE;
 GLboolean GLHelper::leftclickState = GL_FALSE;
 
 /*  _________________________________________________________________________ */
@@ -156,6 +159,8 @@ This function is called when keyboard buttons are pressed.
 When the ESC key is pressed, the close flag of the window is set.
 When the P key is pressed, keystateP is set, when repeatedly pressed
 or released, keystateP is unset.
+Keys I, B and T set and unset keystateI, keystateB and keystateT in the
+same way.
 */
 void GLHelper::key_cb(GLFWwindow *pwin, int key, int scancode, int action, int mod) {
 
@@ -170,6 +175,9 @@ void GLHelper::key_cb(GLFWwindow *pwin, int key, int scancode, int action, int m
 #endif
 
     keystateP = (key == GLFW_KEY_P) ? GL_TRUE : GL_FALSE;
+    keystateI = (key == GLFW_KEY_I) ? GL_TRUE : GL_FALSE;
+    keystateB = (key == GLFW_KEY_B) ? GL_TRUE : GL_FALSE;
+    keystateT = (key == GLFW_KEY_T) ? GL_TRUE : GL_FALSE;
   } 
   else if (GLFW_REPEAT == action)
   {
@@ -178,6 +186,9 @@ void GLHelper::key_cb(GLFWwindow *pwin, int key, int scancode, int action, int m
 #endif
 
     keystateP = GL_FALSE;
+    keystateI = GL_FALSE;
+    keystateB = GL_FALSE;
+    keystateT = GL_FALSE;
   } 
   else if (GLFW_RELEASE == action)
   {
@@ -186,6 +197,9 @@ void GLHelper::key_cb(GLFWwindow *pwin, int key, int scancode, int action, int m
 #endif
 
     keystateP = GL_FALSE;
+    keystateI = GL_FALSE;
+    keystateB = GL_FALSE;
+    keystateT = GL_FALSE;
   }
 
   if (GLFW_KEY_ESCAPE == key && GLFW_PRESS == action) {
@@ -0,0 +1,772 @@
+/*!
+* @file    xformbatch.cpp
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/1/2023
+*
+* @brief This file implements the batched transform kernel declared in
+*		 xformbatch.h. The model matrix of an object is
+*
+*		 | c*sx  -s*sy  px |
+*		 | s*sx   c*sy  py |
+*		 |  0      0     1 |
+*
+*		 where c and s are the cosine and sine of its orientation, so only
+*		 one sine/cosine pair, four multiplies and the post-multiplication by
+*		 an affine matrix are needed per object instead of building and
+*		 multiplying three glm::mat3. The sine and cosine are evaluated with
+*		 the same minimax polynomials in every instruction set so that SSE2,
+*		 AVX2, AVX-512 and scalar paths produce identical results.
+*//*__________________________________________________________________________*/
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <xformbatch.h>
+#include <immintrin.h>
+#include <cmath>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+#include <algorithm>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+// MSVC allows intrinsics of any instruction set in any function while
+// GCC and Clang require the function to be compiled for that target
+#if defined(_MSC_VER)
+#define XB_TARGET(isa)
+#else
+#define XB_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+// the kernels must not fuse multiplies and adds into FMA instructions, which
+// AVX-512 implies, or their results would differ from the narrower paths
+#if defined(_MSC_VER)
+#pragma fp_contract(off)
+#elif defined(__clang__)
+#pragma clang fp contract(off)
+#else
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+/*                                                   objects with file scope
+----------------------------------------------------------------------------- */
+namespace {
+  // range reduction constants
+  float const INV_360{ 1.f / 360.f };
+  float const DEG_TO_RAD{ 0.0174532925f };
+  float const TWO_OVER_PI{ 0.636619772f };
+  float const PIO2_HI{ 1.57079637f };       // float nearest to pi/2
+  float const PIO2_LO{ -4.37113900e-8f };   // pi/2 - PIO2_HI
+
+  // minimax coefficients of sin and cos on [-pi/4, pi/4]
+  float const S1{ -1.6666654611e-1f };
+  float const S2{ 8.3321608736e-3f };
+  float const S3{ -1.9515295891e-4f };
+  float const C1{ 4.166664568298827e-2f };
+  float const C2{ -1.388731625493765e-3f };
+  float const C3{ 2.443315711809948e-5f };
+
+  // widest batch processed by any kernel
+  size_t const MAX_WIDTH{ 16 };
+
+  // signature shared by the kernels; cnt must be a multiple of the kernel's width
+  using Kernel = void (*)(glm::vec2 const*, glm::vec2 const*, GLfloat const*,
+                          size_t, glm::mat3 const*, glm::mat3* const*, size_t);
+
+  XformBatch::ISA current_isa{ XformBatch::detect() };
+
+  /*  _______________________________________________________________________ */
+  /*! store_lanes
+   * @brief Write cnt matrices whose non-trivial entries are given per lane.
+   *
+   * @param r[in] Entries m00, m10, m01, m11, m02 and m12 of each lane.
+   * @param cnt[in] Number of lanes to write.
+   * @param out[out] Destination matrices.
+   * @return void
+  */
+  inline void store_lanes(float const (*r)[MAX_WIDTH], size_t cnt, glm::mat3* out)
+  {
+    for (size_t l{ 0 }; l < cnt; ++l) {
+      out[l] = glm::mat3{ r[0][l], r[1][l], 0.f,
+                          r[2][l], r[3][l], 0.f,
+                          r[4][l], r[5][l], 1.f };
+    }
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! sincos_deg_scalar
+   * @brief Compute sine and cosine of an angle given in degrees.
+   *
+   * The angle is first reduced to [-180, 180] degrees, converted to radians
+   * and reduced to [-pi/4, pi/4] by subtracting the nearest multiple q of
+   * pi/2. The quadrant q selects and negates the polynomial results.
+   *
+   * @param deg[in] Angle in degrees.
+   * @param s[out] Sine of the angle.
+   * @param c[out] Cosine of the angle.
+   * @return void
+  */
+  inline void sincos_deg_scalar(float deg, float& s, float& c)
+  {
+    float const turns{ static_cast<float>(static_cast<int>(std::nearbyint(deg * INV_360))) };
+    float x{ (deg - turns * 360.f) * DEG_TO_RAD };
+    int const q{ static_cast<int>(std::nearbyint(x * TWO_OVER_PI)) };
+    float const qf{ static_cast<float>(q) };
+    x = x - qf * PIO2_HI;
+    x = x - qf * PIO2_LO;
+    float const z{ x * x };
+
+    float sp{ S3 * z };
+    sp = sp + S2;
+    sp = sp * z;
+    sp = sp + S1;
+    sp = sp * z;
+    sp = sp * x;
+    sp = sp + x;
+
+    float cp{ C3 * z };
+    cp = cp + C2;
+    cp = cp * z;
+    cp = cp + C1;
+    cp = cp * z;
+    cp = cp * z;
+    cp = cp - 0.5f * z;
+    cp = cp + 1.f;
+
+    float const ss{ (q & 1) ? cp : sp };
+    float const cc{ (q & 1) ? sp : cp };
+    s = (q & 2) ? -ss : ss;
+    c = ((q + 1) & 2) ? -cc : cc;
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! kernel_scalar
+   * @brief Compute transforms of cnt objects one at a time.
+  */
+  void kernel_scalar(glm::vec2 const* pos, glm::vec2 const* scl, GLfloat const* ang,
+                     size_t cnt, glm::mat3 const* post, glm::mat3* const* outs,
+                     size_t xform_cnt)
+  {
+    for (size_t i{ 0 }; i < cnt; ++i) {
+      float s, c;
+      sincos_deg_scalar(ang[i], s, c);
+      float const m00{ c * scl[i].x }, m10{ s * scl[i].x };
+      float const m01{ -s * scl[i].y }, m11{ c * scl[i].y };
+
+      for (size_t k{ 0 }; k < xform_cnt; ++k) {
+        glm::mat3 const& w{ post[k] };
+        float r[6][MAX_WIDTH];
+        r[0][0] = w[0][0] * m00 + w[1][0] * m10;
+        r[1][0] = w[0][1] * m00 + w[1][1] * m10;
+        r[2][0] = w[0][0] * m01 + w[1][0] * m11;
+        r[3][0] = w[0][1] * m01 + w[1][1] * m11;
+        r[4][0] = w[0][0] * pos[i].x + w[1][0] * pos[i].y + w[2][0];
+        r[5][0] = w[0][1] * pos[i].x + w[1][1] * pos[i].y + w[2][1];
+        store_lanes(r, 1, outs[k] + i);
+      }
+    }
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! sincos_deg_sse2
+   * @brief SSE2 version of sincos_deg_scalar for 4 angles.
+  */
+  XB_TARGET("sse2")
+  inline void sincos_deg_sse2(__m128 deg, __m128& s, __m128& c)
+  {
+    __m128i const one{ _mm_set1_epi32(1) }, two{ _mm_set1_epi32(2) };
+    __m128 const turns{ _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(deg, _mm_set1_ps(INV_360)))) };
+    __m128 x{ _mm_mul_ps(_mm_sub_ps(deg, _mm_mul_ps(turns, _mm_set1_ps(360.f))),
+                         _mm_set1_ps(DEG_TO_RAD)) };
+    __m128i const q{ _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(TWO_OVER_PI))) };
+    __m128 const qf{ _mm_cvtepi32_ps(q) };
+    x = _mm_sub_ps(x, _mm_mul_ps(qf, _mm_set1_ps(PIO2_HI)));
+    x = _mm_sub_ps(x, _mm_mul_ps(qf, _mm_set1_ps(PIO2_LO)));
+    __m128 const z{ _mm_mul_ps(x, x) };
+
+    __m128 sp{ _mm_mul_ps(_mm_set1_ps(S3), z) };
+    sp = _mm_add_ps(sp, _mm_set1_ps(S2));
+    sp = _mm_mul_ps(sp, z);
+    sp = _mm_add_ps(sp, _mm_set1_ps(S1));
+    sp = _mm_mul_ps(sp, z);
+    sp = _mm_mul_ps(sp, x);
+    sp = _mm_add_ps(sp, x);
+
+    __m128 cp{ _mm_mul_ps(_mm_set1_ps(C3), z) };
+    cp = _mm_add_ps(cp, _mm_set1_ps(C2));
+    cp = _mm_mul_ps(cp, z);
+    cp = _mm_add_ps(cp, _mm_set1_ps(C1));
+    cp = _mm_mul_ps(cp, z);
+    cp = _mm_mul_ps(cp, z);
+    cp = _mm_sub_ps(cp, _mm_mul_ps(_mm_set1_ps(0.5f), z));
+    cp = _mm_add_ps(cp, _mm_set1_ps(1.f));
+
+    __m128 const swap{ _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, one), one)) };
+    s = _mm_or_ps(_mm_and_ps(swap, cp), _mm_andnot_ps(swap, sp));
+    c = _mm_or_ps(_mm_and_ps(swap, sp), _mm_andnot_ps(swap, cp));
+    s = _mm_xor_ps(s, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, two), 30)));
+    c = _mm_xor_ps(c, _mm_castsi128_ps(
+      _mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, one), two), 30)));
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! kernel_sse2
+   * @brief Compute transforms of 4 objects per iteration.
+  */
+  XB_TARGET("sse2")
+  void kernel_sse2(glm::vec2 const* pos, glm::vec2 const* scl, GLfloat const* ang,
+                   size_t cnt, glm::mat3 const* post, glm::mat3* const* outs,
+                   size_t xform_cnt)
+  {
+    alignas(64) float r[6][MAX_WIDTH];
+    for (size_t i{ 0 }; i < cnt; i += 4) {
+      // de-interleave x and y of 4 glm::vec2
+      __m128 const pa{ _mm_loadu_ps(&pos[i].x) }, pb{ _mm_loadu_ps(&pos[i + 2].x) };
+      __m128 const px{ _mm_shuffle_ps(pa, pb, _MM_SHUFFLE(2, 0, 2, 0)) };
+      __m128 const py{ _mm_shuffle_ps(pa, pb, _MM_SHUFFLE(3, 1, 3, 1)) };
+      __m128 const sa{ _mm_loadu_ps(&scl[i].x) }, sb{ _mm_loadu_ps(&scl[i + 2].x) };
+      __m128 const sx{ _mm_shuffle_ps(sa, sb, _MM_SHUFFLE(2, 0, 2, 0)) };
+      __m128 const sy{ _mm_shuffle_ps(sa, sb, _MM_SHUFFLE(3, 1, 3, 1)) };
+
+      __m128 s, c;
+      sincos_deg_sse2(_mm_loadu_ps(ang + i), s, c);
+      __m128 const m00{ _mm_mul_ps(c, sx) }, m10{ _mm_mul_ps(s, sx) };
+      __m128 const m01{ _mm_mul_ps(_mm_xor_ps(s, _mm_set1_ps(-0.f)), sy) };
+      __m128 const m11{ _mm_mul_ps(c, sy) };
+
+      for (size_t k{ 0 }; k < xform_cnt; ++k) {
+        glm::mat3 const& w{ post[k] };
+        __m128 const w00{ _mm_set1_ps(w[0][0]) }, w10{ _mm_set1_ps(w[0][1]) };
+        __m128 const w01{ _mm_set1_ps(w[1][0]) }, w11{ _mm_set1_ps(w[1][1]) };
+        _mm_store_ps(r[0], _mm_add_ps(_mm_mul_ps(w00, m00), _mm_mul_ps(w01, m10)));
+        _mm_store_ps(r[1], _mm_add_ps(_mm_mul_ps(w10, m00), _mm_mul_ps(w11, m10)));
+        _mm_store_ps(r[2], _mm_add_ps(_mm_mul_ps(w00, m01), _mm_mul_ps(w01, m11)));
+        _mm_store_ps(r[3], _mm_add_ps(_mm_mul_ps(w10, m01), _mm_mul_ps(w11, m11)));
+        _mm_store_ps(r[4], _mm_add_ps(_mm_add_ps(_mm_mul_ps(w00, px), _mm_mul_ps(w01, py)),
+                                      _mm_set1_ps(w[2][0])));
+        _mm_store_ps(r[5], _mm_add_ps(_mm_add_ps(_mm_mul_ps(w10, px), _mm_mul_ps(w11, py)),
+                                      _mm_set1_ps(w[2][1])));
+        store_lanes(r, 4, outs[k] + i);
+      }
+    }
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! sincos_deg_avx2
+   * @brief AVX2 version of sincos_deg_scalar for 8 angles.
+  */
+  XB_TARGET("avx2")
+  inline void sincos_deg_avx2(__m256 deg, __m256& s, __m256& c)
+  {
+    __m256i const one{ _mm256_set1_epi32(1) }, two{ _mm256_set1_epi32(2) };
+    __m256 const turns{ _mm256_cvtepi32_ps(_mm256_cvtps_epi32(_mm256_mul_ps(deg, _mm256_set1_ps(INV_360)))) };
+    __m256 x{ _mm256_mul_ps(_mm256_sub_ps(deg, _mm256_mul_ps(turns, _mm256_set1_ps(360.f))),
+                            _mm256_set1_ps(DEG_TO_RAD)) };
+    __m256i const q{ _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(TWO_OVER_PI))) };
+    __m256 const qf{ _mm256_cvtepi32_ps(q) };
+    x = _mm256_sub_ps(x, _mm256_mul_ps(qf, _mm256_set1_ps(PIO2_HI)));
+    x = _mm256_sub_ps(x, _mm256_mul_ps(qf, _mm256_set1_ps(PIO2_LO)));
+    __m256 const z{ _mm256_mul_ps(x, x) };
+
+    __m256 sp{ _mm256_mul_ps(_mm256_set1_ps(S3), z) };
+    sp = _mm256_add_ps(sp, _mm256_set1_ps(S2));
+    sp = _mm256_mul_ps(sp, z);
+    sp = _mm256_add_ps(sp, _mm256_set1_ps(S1));
+    sp = _mm256_mul_ps(sp, z);
+    sp = _mm256_mul_ps(sp, x);
+    sp = _mm256_add_ps(sp, x);
+
+    __m256 cp{ _mm256_mul_ps(_mm256_set1_ps(C3), z) };
+    cp = _mm256_add_ps(cp, _mm256_set1_ps(C2));
+    cp = _mm256_mul_ps(cp, z);
+    cp = _mm256_add_ps(cp, _mm256_set1_ps(C1));
+    cp = _mm256_mul_ps(cp, z);
+    cp = _mm256_mul_ps(cp, z);
+    cp = _mm256_sub_ps(cp, _mm256_mul_ps(_mm256_set1_ps(0.5f), z));
+    cp = _mm256_add_ps(cp, _mm256_set1_ps(1.f));
+
+    __m256 const swap{ _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, one), one)) };
+    s = _mm256_blendv_ps(sp, cp, swap);
+    c = _mm256_blendv_ps(cp, sp, swap);
+    s = _mm256_xor_ps(s, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, two), 30)));
+    c = _mm256_xor_ps(c, _mm256_castsi256_ps(
+      _mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(q, one), two), 30)));
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! deinterleave_avx2
+   * @brief Split 8 consecutive glm::vec2 into a vector of x and a vector of y.
+  */
+  XB_TARGET("avx2")
+  inline void deinterleave_avx2(glm::vec2 const* v, __m256& x, __m256& y)
+  {
+    __m256 const a{ _mm256_loadu_ps(&v[0].x) }, b{ _mm256_loadu_ps(&v[4].x) };
+    // shuffle works within 128-bit halves: x0 x1 x4 x5 | x2 x3 x6 x7
+    __m256 const xs{ _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)) };
+    __m256 const ys{ _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)) };
+    x = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(xs), _MM_SHUFFLE(3, 1, 2, 0)));
+    y = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(ys), _MM_SHUFFLE(3, 1, 2, 0)));
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! kernel_avx2
+   * @brief Compute transforms of 8 objects per iteration.
+  */
+  XB_TARGET("avx2")
+  void kernel_avx2(glm::vec2 const* pos, glm::vec2 const* scl, GLfloat const* ang,
+                   size_t cnt, glm::mat3 const* post, glm::mat3* const* outs,
+                   size_t xform_cnt)
+  {
+    alignas(64) float r[6][MAX_WIDTH];
+    for (size_t i{ 0 }; i < cnt; i += 8) {
+      __m256 px, py, sx, sy;
+      deinterleave_avx2(pos + i, px, py);
+      deinterleave_avx2(scl + i, sx, sy);
+
+      __m256 s, c;
+      sincos_deg_avx2(_mm256_loadu_ps(ang + i), s, c);
+      __m256 const m00{ _mm256_mul_ps(c, sx) }, m10{ _mm256_mul_ps(s, sx) };
+      __m256 const m01{ _mm256_mul_ps(_mm256_xor_ps(s, _mm256_set1_ps(-0.f)), sy) };
+      __m256 const m11{ _mm256_mul_ps(c, sy) };
+
+      for (size_t k{ 0 }; k < xform_cnt; ++k) {
+        glm::mat3 const& w{ post[k] };
+        __m256 const w00{ _mm256_set1_ps(w[0][0]) }, w10{ _mm256_set1_ps(w[0][1]) };
+        __m256 const w01{ _mm256_set1_ps(w[1][0]) }, w11{ _mm256_set1_ps(w[1][1]) };
+        _mm256_store_ps(r[0], _mm256_add_ps(_mm256_mul_ps(w00, m00), _mm256_mul_ps(w01, m10)));
+        _mm256_store_ps(r[1], _mm256_add_ps(_mm256_mul_ps(w10, m00), _mm256_mul_ps(w11, m10)));
+        _mm256_store_ps(r[2], _mm256_add_ps(_mm256_mul_ps(w00, m01), _mm256_mul_ps(w01, m11)));
+        _mm256_store_ps(r[3], _mm256_add_ps(_mm256_mul_ps(w10, m01), _mm256_mul_ps(w11, m11)));
+        _mm256_store_ps(r[4], _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(w00, px), _mm256_mul_ps(w01, py)),
+                                            _mm256_set1_ps(w[2][0])));
+        _mm256_store_ps(r[5], _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(w10, px), _mm256_mul_ps(w11, py)),
+                                            _mm256_set1_ps(w[2][1])));
+        store_lanes(r, 8, outs[k] + i);
+      }
+    }
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! sincos_deg_avx512
+   * @brief AVX-512 version of sincos_deg_scalar for 16 angles.
+  */
+  XB_TARGET("avx512f")
+  inline void sincos_deg_avx512(__m512 deg, __m512& s, __m512& c)
+  {
+    __m512i const one{ _mm512_set1_epi32(1) }, two{ _mm512_set1_epi32(2) };
+    __m512 const turns{ _mm512_cvtepi32_ps(_mm512_cvtps_epi32(_mm512_mul_ps(deg, _mm512_set1_ps(INV_360)))) };
+    __m512 x{ _mm512_mul_ps(_mm512_sub_ps(deg, _mm512_mul_ps(turns, _mm512_set1_ps(360.f))),
+                            _mm512_set1_ps(DEG_TO_RAD)) };
+    __m512i const q{ _mm512_cvtps_epi32(_mm512_mul_ps(x, _mm512_set1_ps(TWO_OVER_PI))) };
+    __m512 const qf{ _mm512_cvtepi32_ps(q) };
+    x = _mm512_sub_ps(x, _mm512_mul_ps(qf, _mm512_set1_ps(PIO2_HI)));
+    x = _mm512_sub_ps(x, _mm512_mul_ps(qf, _mm512_set1_ps(PIO2_LO)));
+    __m512 const z{ _mm512_mul_ps(x, x) };
+
+    __m512 sp{ _mm512_mul_ps(_mm512_set1_ps(S3), z) };
+    sp = _mm512_add_ps(sp, _mm512_set1_ps(S2));
+    sp = _mm512_mul_ps(sp, z);
+    sp = _mm512_add_ps(sp, _mm512_set1_ps(S1));
+    sp = _mm512_mul_ps(sp, z);
+    sp = _mm512_mul_ps(sp, x);
+    sp = _mm512_add_ps(sp, x);
+
+    __m512 cp{ _mm512_mul_ps(_mm512_set1_ps(C3), z) };
+    cp = _mm512_add_ps(cp, _mm512_set1_ps(C2));
+    cp = _mm512_mul_ps(cp, z);
+    cp = _mm512_add_ps(cp, _mm512_set1_ps(C1));
+    cp = _mm512_mul_ps(cp, z);
+    cp = _mm512_mul_ps(cp, z);
+    cp = _mm512_sub_ps(cp, _mm512_mul_ps(_mm512_set1_ps(0.5f), z));
+    cp = _mm512_add_ps(cp, _mm512_set1_ps(1.f));
+
+    __mmask16 const swap{ _mm512_test_epi32_mask(q, one) };
+    s = _mm512_mask_blend_ps(swap, sp, cp);
+    c = _mm512_mask_blend_ps(swap, cp, sp);
+    s = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(s),
+      _mm512_slli_epi32(_mm512_and_si512(q, two), 30)));
+    c = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(c),
+      _mm512_slli_epi32(_mm512_and_si512(_mm512_add_epi32(q, one), two), 30)));
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! deinterleave_avx512
+   * @brief Split 16 consecutive glm::vec2 into a vector of x and a vector of y.
+  */
+  XB_TARGET("avx512f")
+  inline void deinterleave_avx512(glm::vec2 const* v, __m512& x, __m512& y)
+  {
+    __m512 const a{ _mm512_loadu_ps(&v[0].x) }, b{ _mm512_loadu_ps(&v[8].x) };
+    __m512i const even{ _mm512_set_epi32(30, 28, 26, 24, 22, 20, 18, 16,
+                                         14, 12, 10, 8, 6, 4, 2, 0) };
+    __m512i const odd{ _mm512_add_epi32(even, _mm512_set1_epi32(1)) };
+    x = _mm512_permutex2var_ps(a, even, b);
+    y = _mm512_permutex2var_ps(a, odd, b);
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! kernel_avx512
+   * @brief Compute transforms of 16 objects per iteration.
+  */
+  XB_TARGET("avx512f")
+  void kernel_avx512(glm::vec2 const* pos, glm::vec2 const* scl, GLfloat const* ang,
+                     size_t cnt, glm::mat3 const* post, glm::mat3* const* outs,
+                     size_t xform_cnt)
+  {
+    alignas(64) float r[6][MAX_WIDTH];
+    __m512i const sign{ _mm512_set1_epi32(static_cast<int>(0x80000000u)) };
+    for (size_t i{ 0 }; i < cnt; i += 16) {
+      __m512 px, py, sx, sy;
+      deinterleave_avx512(pos + i, px, py);
+      deinterleave_avx512(scl + i, sx, sy);
+
+      __m512 s, c;
+      sincos_deg_avx512(_mm512_loadu_ps(ang + i), s, c);
+      __m512 const m00{ _mm512_mul_ps(c, sx) }, m10{ _mm512_mul_ps(s, sx) };
+      __m512 const m01{ _mm512_mul_ps(_mm512_castsi512_ps(
+        _mm512_xor_si512(_mm512_castps_si512(s), sign)), sy) };
+      __m512 const m11{ _mm512_mul_ps(c, sy) };
+
+      for (size_t k{ 0 }; k < xform_cnt; ++k) {
+        glm::mat3 const& w{ post[k] };
+        __m512 const w00{ _mm512_set1_ps(w[0][0]) }, w10{ _mm512_set1_ps(w[0][1]) };
+        __m512 const w01{ _mm512_set1_ps(w[1][0]) }, w11{ _mm512_set1_ps(w[1][1]) };
+        _mm512_store_ps(r[0], _mm512_add_ps(_mm512_mul_ps(w00, m00), _mm512_mul_ps(w01, m10)));
+        _mm512_store_ps(r[1], _mm512_add_ps(_mm512_mul_ps(w10, m00), _mm512_mul_ps(w11, m10)));
+        _mm512_store_ps(r[2], _mm512_add_ps(_mm512_mul_ps(w00, m01), _mm512_mul_ps(w01, m11)));
+        _mm512_store_ps(r[3], _mm512_add_ps(_mm512_mul_ps(w10, m01), _mm512_mul_ps(w11, m11)));
+        _mm512_store_ps(r[4], _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(w00, px), _mm512_mul_ps(w01, py)),
+                                            _mm512_set1_ps(w[2][0])));
+        _mm512_store_ps(r[5], _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(w10, px), _mm512_mul_ps(w11, py)),
+                                            _mm512_set1_ps(w[2][1])));
+        store_lanes(r, 16, outs[k] + i);
+      }
+    }
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! kernel_for
+   * @brief Return the kernel compiled for isa.
+  */
+  Kernel kernel_for(XformBatch::ISA isa)
+  {
+    switch (isa) {
+    case XformBatch::SSE2: return kernel_sse2;
+    case XformBatch::AVX2: return kernel_avx2;
+    case XformBatch::AVX512: return kernel_avx512;
+    default: return kernel_scalar;
+    }
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! read_xcr0
+   * @brief Return the register describing which vector state the OS saves.
+  */
+  XB_TARGET("xsave")
+  unsigned long long read_xcr0()
+  {
+    return _xgetbv(0);
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! cpuid
+   * @brief Execute CPUID with the given leaf and subleaf.
+  */
+  void cpuid(unsigned int leaf, unsigned int subleaf, unsigned int (&regs)[4])
+  {
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuidex(r, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i{ 0 }; i < 4; ++i) {
+      regs[i] = static_cast<unsigned int>(r[i]);
+    }
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! XformBatch::compute
+ * @brief Compute transforms of cnt objects using the current instruction set.
+ *
+ * Whole batches are handed to the kernel directly. The remaining objects are
+ * copied into padded arrays so that they are processed by the same kernel
+ * instead of a different code path.
+ *
+ * @param position[in] Position of each object.
+ * @param scaling[in] Scaling of each object.
+ * @param angle_disp[in] Orientation of each object in degrees.
+ * @param cnt[in] Number of objects.
+ * @param post_xforms[in] Affine matrices applied after the model transform.
+ * @param outs[out] For each post transform, an array of cnt matrices.
+ * @param xform_cnt[in] Number of post transforms.
+ * @return void
+*/
+void XformBatch::compute(glm::vec2 const* position, glm::vec2 const* scaling,
+                         GLfloat const* angle_disp, size_t cnt,
+                         glm::mat3 const* post_xforms, glm::mat3* const* outs,
+                         size_t xform_cnt)
+{
+  Kernel const kernel{ kernel_for(current_isa) };
+  size_t const w{ width(current_isa) };
+  size_t const whole{ cnt - cnt % w };
+
+  if (whole > 0) {
+    kernel(position, scaling, angle_disp, whole, post_xforms, outs, xform_cnt);
+  }
+  if (whole == cnt) {
+    return;
+  }
+
+  // pad the remaining objects to a whole batch
+  size_t const rem{ cnt - whole };
+  glm::vec2 pos[MAX_WIDTH]{}, scl[MAX_WIDTH]{};
+  GLfloat ang[MAX_WIDTH]{};
+  std::copy(position + whole, position + cnt, pos);
+  std::copy(scaling + whole, scaling + cnt, scl);
+  std::copy(angle_disp + whole, angle_disp + cnt, ang);
+
+  std::vector<glm::mat3> tail(w * xform_cnt);
+  std::vector<glm::mat3*> tail_outs(xform_cnt);
+  for (size_t k{ 0 }; k < xform_cnt; ++k) {
+    tail_outs[k] = tail.data() + k * w;
+  }
+
+  kernel(pos, scl, ang, w, post_xforms, tail_outs.data(), xform_cnt);
+
+  for (size_t k{ 0 }; k < xform_cnt; ++k) {
+    std::copy(tail_outs[k], tail_outs[k] + rem, outs[k] + whole);
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! XformBatch::compute_glm
+ * @brief Compute transforms of cnt objects one at a time with glm.
+ *
+ * This is the computation previously done by GLObject::update: scale,
+ * rotation and translation matrices are built and multiplied for every
+ * object, and glm::cos and glm::sin are called per object.
+ *
+ * @param position[in] Position of each object.
+ * @param scaling[in] Scaling of each object.
+ * @param angle_disp[in] Orientation of each object in degrees.
+ * @param cnt[in] Number of objects.
+ * @param post_xforms[in] Affine matrices applied after the model transform.
+ * @param outs[out] For each post transform, an array of cnt matrices.
+ * @param xform_cnt[in] Number of post transforms.
+ * @return void
+*/
+void XformBatch::compute_glm(glm::vec2 const* position, glm::vec2 const* scaling,
+                             GLfloat const* angle_disp, size_t cnt,
+                             glm::mat3 const* post_xforms, glm::mat3* const* outs,
+                             size_t xform_cnt)
+{
+  for (size_t i{ 0 }; i < cnt; ++i) {
+    glm::mat3 scaleMat{
+      scaling[i].x, 0.f, 0.f,
+      0.f, scaling[i].y, 0.f,
+      0.f, 0.f, 1.f
+    };
+
+    float angleRadians{ glm::radians<float>(angle_disp[i]) };
+
+    glm::mat3 rotMat{
+      glm::cos(angleRadians), glm::sin(angleRadians), 0.f,
+      -glm::sin(angleRadians), glm::cos(angleRadians), 0.f,
+      0.f, 0.f, 1.f
+    };
+
+    glm::mat3 transMat{
+      1.f, 0.f, 0.f,
+      0.f, 1.f, 0.f,
+      position[i].x, position[i].y, 1.f
+    };
+
+    for (size_t k{ 0 }; k < xform_cnt; ++k) {
+      outs[k][i] = post_xforms[k] * (transMat * (rotMat * scaleMat));
+    }
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! XformBatch::detect
+ * @brief Return the widest instruction set supported by the CPU and the OS.
+ *
+ * AVX2 and AVX-512 also require the OS to save the wider registers on a
+ * context switch, which is reported through XCR0.
+ *
+ * @param none
+ * @return The widest usable instruction set.
+*/
+XformBatch::ISA XformBatch::detect()
+{
+  unsigned int regs[4];
+  cpuid(0, 0, regs);
+  unsigned int const max_leaf{ regs[0] };
+
+  cpuid(1, 0, regs);
+  bool const has_sse2{ (regs[3] & (1u << 26)) != 0 };
+  bool const has_osxsave{ (regs[2] & (1u << 27)) != 0 };
+  if (!has_sse2) {
+    return SCALAR;
+  }
+  if (!has_osxsave || max_leaf < 7) {
+    return SSE2;
+  }
+
+  unsigned long long const xcr0{ read_xcr0() };
+  bool const os_avx{ (xcr0 & 0x6) == 0x6 };
+  bool const os_avx512{ (xcr0 & 0xE6) == 0xE6 };
+
+  cpuid(7, 0, regs);
+  bool const has_avx2{ (regs[1] & (1u << 5)) != 0 };
+  bool const has_avx512f{ (regs[1] & (1u << 16)) != 0 };
+
+  if (has_avx512f && os_avx512) {
+    return AVX512;
+  }
+  if (has_avx2 && os_avx) {
+    return AVX2;
+  }
+  return SSE2;
+}
+
+/*  _________________________________________________________________________ */
+/*! XformBatch::get_isa
+ * @brief Return the instruction set currently used by compute.
+*/
+XformBatch::ISA XformBatch::get_isa()
+{
+  return current_isa;
+}
+
+/*  _________________________________________________________________________ */
+/*! XformBatch::set_isa
+ * @brief Make compute use isa if the CPU supports it.
+*/
+void XformBatch::set_isa(ISA isa)
+{
+  if (isa <= detect()) {
+    current_isa = isa;
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! XformBatch::width
+ * @brief Return the number of objects processed per iteration by isa.
+*/
+size_t XformBatch::width(ISA isa)
+{
+  switch (isa) {
+  case SSE2: return 4;
+  case AVX2: return 8;
+  case AVX512: return 16;
+  default: return 1;
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! XformBatch::name
+ * @brief Return a printable name of isa.
+*/
+char const* XformBatch::name(ISA isa)
+{
+  switch (isa) {
+  case SSE2: return "SSE2";
+  case AVX2: return "AVX2";
+  case AVX512: return "AVX-512";
+  default: return "Scalar";
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! XformBatch::benchmark
+ * @brief Print throughput of the per-object glm path and of every kernel.
+ *
+ * cnt objects with random position, scaling and orientation are generated.
+ * Each path computes their model-to-NDC transforms repeatedly and the number
+ * of objects processed per second is printed together with the largest
+ * absolute difference from the glm path.
+ *
+ * @param cnt[in] Number of objects.
+ * @return void
+*/
+void XformBatch::benchmark(size_t cnt)
+{
+  std::default_random_engine gen(2023);
+  std::uniform_real_distribution<float> pos_dis(-5000.f, 5000.f);
+  std::uniform_real_distribution<float> scl_dis(50.f, 400.f);
+  std::uniform_real_distribution<float> ang_dis(-3600.f, 3600.f);
+
+  std::vector<glm::vec2> position(cnt), scaling(cnt);
+  std::vector<GLfloat> angle_disp(cnt);
+  for (size_t i{ 0 }; i < cnt; ++i) {
+    position[i] = glm::vec2{ pos_dis(gen), pos_dis(gen) };
+    scaling[i] = glm::vec2{ scl_dis(gen), scl_dis(gen) };
+    angle_disp[i] = ang_dis(gen);
+  }
+
+  glm::mat3 const world_to_ndc{
+    1.f / 5000.f, 0.f, 0.f,
+    0.f, 1.f / 5000.f, 0.f,
+    0.f, 0.f, 1.f
+  };
+  std::vector<glm::mat3> reference(cnt), result(cnt);
+  glm::mat3* ref_out{ reference.data() };
+  glm::mat3* res_out{ result.data() };
+  int const reps{ 20 };
+
+  // time reps calls of f and return objects per second
+  auto throughput = [&](auto f) {
+    f();
+    auto const start{ std::chrono::steady_clock::now() };
+    for (int r{ 0 }; r < reps; ++r) {
+      f();
+    }
+    std::chrono::duration<double> const secs{ std::chrono::steady_clock::now() - start };
+    return static_cast<double>(cnt) * reps / secs.count();
+  };
+
+  std::cout << "Transform kernel benchmark with " << cnt << " objects\n";
+  std::cout << "Path\t\t|\tObjects/s\t|\tMax error\n";
+  std::cout << "----------------------------------------------------------------------\n";
+
+  double const glm_rate{ throughput([&] {
+    compute_glm(position.data(), scaling.data(), angle_disp.data(), cnt,
+                &world_to_ndc, &ref_out, 1);
+  }) };
+  std::cout << "glm\t\t|\t" << std::scientific << std::setprecision(3)
+            << glm_rate << "\t|\t-\n";
+
+  ISA const saved_isa{ current_isa };
+  for (int isa{ SCALAR }; isa <= detect(); ++isa) {
+    current_isa = static_cast<ISA>(isa);
+    double const rate{ throughput([&] {
+      compute(position.data(), scaling.data(), angle_disp.data(), cnt,
+              &world_to_ndc, &res_out, 1);
+    }) };
+
+    float max_err{ 0.f };
+    for (size_t i{ 0 }; i < cnt; ++i) {
+      for (int col{ 0 }; col < 3; ++col) {
+        for (int row{ 0 }; row < 3; ++row) {
+          max_err = std::max(max_err, std::abs(result[i][col][row] - reference[i][col][row]));
+        }
+      }
+    }
+
+    std::cout << name(current_isa) << "\t\t|\t" << rate << "\t|\t" << max_err
+              << " (x" << std::fixed << std::setprecision(2) << rate / glm_rate
+              << ")\n" << std::scientific << std::setprecision(3);
+  }
+  current_isa = saved_isa;
+
+  std::cout << "----------------------------------------------------------------------\n";
+  std::cout << std::defaultfloat;
+}
@@ -29,8 +29,15 @@
 ----------------------------------------------------------------------------- */
 #include <glslshader.h>
 #include <glhelper.h>
+#include <spatialgrid.h>
+#include <slotmap.h>
+#include <renderqueue.h>
+#include <mesharena.h>
+#include <meshbin.h>
+#include <ringbuffer.h>
 #include <string>
-#include <map>
+#include <unordered_map>
+#include <vector>
 
 struct GLApp {
 
@@ -44,8 +51,21 @@ struct GLApp {
   struct GLModel {
 	  GLenum primitive_type; // openGL primitive type to render
 	  GLuint primitive_cnt; // number of primitives drawn
-	  GLuint vaoid; // handle to VAO
+	  MeshBin::GPUMesh mesh; // VAO and ranges of buffer_arena
 	  GLuint draw_cnt; // number of time draw calls made
+	  glm::vec2 bbox_min, bbox_max; // bounding box of vertices in model space
+	  MeshArena::Range arena_range; // location of the model in mesh_arena
+	  std::vector<MeshLod::Level> lods; // levels of detail in the indices of mesh,
+										// finest first; draw_cnt is that of the first
+
+	  // member functions defined in glapp.cpp
+
+	  // level of detail to draw with at px_per_unit pixels per model space
+	  // unit; the finest level while GLApp::lod_enabled is GL_FALSE
+	  MeshLod::Level const& lod(GLfloat px_per_unit) const;
+
+	  // offset in bytes of the first index of a level in the element buffer
+	  GLintptr idx_offset(MeshLod::Level const& level) const;
   };
 
   // encapsulates state required to update
@@ -65,12 +85,21 @@ struct GLApp {
 	  glm::mat3 mdl_to_ndc_xform{ 0.f };  // model-to-ndc transformation 
 	  glm::mat3 mdl_xform{ 0.f };		  // model-to-world transformation
 	  glm::mat3 mdl_to_map_xform{ 0.f };  // mini map view transformation
+	  glm::vec2 bbox_min{ 0.f };		  // bounding box in world space
+	  glm::vec2 bbox_max{ 0.f };		  // computed from mdl_xform
+	  GLuint grid_id{ 0 };				  // id of bounding box in object_grid
+
+	  // versions used to rebuild matrices only when their inputs change
+	  GLuint state_version{ 1 };  // incremented when position, scaling or orientation.x change
+	  GLuint mdl_version{ 0 };	  // state_version mdl_xform was computed from
+	  GLuint view_version{ 0 };	  // camera2d.view_version mdl_to_ndc_xform and
+								  // mdl_to_map_xform were computed from
 
-	  // reference to model that object is an instance of
-	  std::map<std::string, GLApp::GLModel>::iterator mdl_ref;
+	  // handle to model that object is an instance of
+	  SlotMap<GLModel>::Handle mdl_ref;
 
-	  // reference to shader program used to render the model
-	  std::map<std::string, GLSLShader>::iterator shd_ref;
+	  // handle to shader program used to render the model
+	  SlotMap<GLSLShader>::Handle shd_ref;
 
 	  // member functions defined in glapp.cpp
 
@@ -79,12 +108,30 @@ struct GLApp {
 	  // and shader program specified by index shd_ref
 	  void draw(GLboolean draw_map) const;
 
+	  // function to render object's model in the main and mini map viewports
+	  // with one draw call, using the shader program of the multiview path
+	  // and the per-draw data at index draw_idx of the bound storage buffer
+	  void draw_multiview(GLuint draw_idx) const;
+
+	  // function to compute the pixels per model space unit of the object
+	  // in the main viewport, or in the mini map viewport if draw_map is
+	  // GL_TRUE, which picks the level of detail of its model
+	  GLfloat px_per_unit(GLboolean draw_map) const;
+
 	  // function to update the object's model transformation matrix
 	  void update(GLdouble delta_time);
+
+	  // function to update the object's world space bounding box
+	  // from mdl_xform and the bounding box of its model
+	  void update_bounds();
   };
 
+  using ObjectHandle = SlotMap<GLObject>::Handle;
+
   struct Camera2D {
-	  GLObject* pgo; // pointer to game object with camera
+	  ObjectHandle obj;	// handle to game object with camera
+	  GLObject* pgo;	// pointer to game object with camera, resolved
+						// from obj at the start of every update
 	  glm::vec2 right, up; // camera orientation vectors
 	  glm::mat3 view_xform, camwin_to_ndc_xform, world_to_ndc_xform;
 
@@ -100,6 +147,16 @@ struct GLApp {
 	  // mini map matrices
 	  glm::mat3 map_to_ndc_xform, world_map_to_ndc_xform;
 
+	  // world space bounding boxes of the camera window and the
+	  // mini map window used to cull objects
+	  glm::vec2 win_min, win_max, map_min, map_max;
+
+	  // incremented when world_to_ndc_xform changes
+	  GLuint view_version{ 1 };
+
+	  // GLHelper::fbsize_version the aspect ratio ar was computed for
+	  GLuint fb_version{ 0 };
+
 	  // window change parameters
 	  GLint min_height{ 500 }, max_height{ 2000 };
 
@@ -119,27 +176,115 @@ struct GLApp {
 	  GLboolean right_turn_flag{ GL_FALSE }; // button K
 	  GLboolean move_flag{ GL_FALSE };		 // button U
 
-	  void init(GLFWwindow* pWindow, GLObject* ptr);
+	  void init(GLFWwindow* pWindow, ObjectHandle handle);
 	  void update(GLFWwindow*);
+
+	  // function to update win_min, win_max, map_min and map_max
+	  // from world_to_ndc_xform and world_map_to_ndc_xform
+	  void update_bounds();
+  };
+
+  // number of objects submitted and skipped in a viewport last frame
+  struct CullStats {
+	  GLuint visible{ 0 };
+	  GLuint culled{ 0 };
+  };
+
+  // bounding boxes of every object except for the camera, indexed to find
+  // the objects near a point or in a rectangle
+  static SpatialGrid object_grid;
+
+  // number of matrices rebuilt and left as they were last frame
+  struct XformStats {
+	  GLuint rebuilt{ 0 };
+	  GLuint skipped{ 0 };
   };
 
+  static XformStats mdl_xform_stats;	// model-to-world matrices of objects
+  static XformStats view_xform_stats;	// model-to-NDC and model-to-map matrix pairs of objects
+  static XformStats camera_xform_stats; // window-to-NDC and world-to-NDC matrices of camera
+
+  static CullStats main_cull_stats; // main viewport
+  static CullStats map_cull_stats;  // mini map viewport
+
+  // objects outside a viewport are not drawn in it while GL_TRUE
+  static GLboolean cull_enabled;
+
+  // models are drawn at the level of detail their projected size needs
+  // while GL_TRUE, and at full detail otherwise; toggled with key L
+  static GLboolean lod_enabled;
+
+  // indices drawn by the last call to draw_objects, which shrinks as the
+  // camera zooms out and coarser levels of detail are picked
+  static GLuint submitted_idx_cnt;
+
+  // function to collect the objects visible in each viewport
+  static void cull();
+
+  // ways draw_objects renders the main view and mini map, cycled with key M
+  enum class DrawPath : GLuint {
+	  two_pass,		// one draw call per object and viewport
+	  single_pass,	// one draw call per object; a geometry shader emits
+					// each triangle to both viewports
+	  indirect		// as single_pass, but one glMultiDrawElementsIndirect
+					// call per primitive type draws every object
+  };
+  static DrawPath draw_path;
+
+  // buffers the vertices and indices of every model are suballocated from
+  static BufferArena buffer_arena;
+
+  // vertex and index buffers of every model, drawn from by the indirect path
+  static MeshArena mesh_arena;
+
+  // draw calls made and CPU time in seconds spent by the last call to
+  // draw_objects
+  static GLuint draw_call_cnt;
+  static GLdouble draw_cpu_time;
+
+  // draw calls, and program and VAO binds made and skipped, by the render
+  // queue during the last call to draw_objects
+  static RenderQueue::Stats queue_stats;
+
+  // function to render the visible objects in both viewports along
+  // draw_path
+  static void draw_objects();
+
+  // function to print draw calls and CPU time of every rendering path
+  static void benchmark_draw();
+
+  // function to print the per-frame cost of visiting every object of a
+  // string-keyed std::map and of a slot map
+  static void benchmark_objects();
+
   static Camera2D camera2d;
 
-  // stores <object name, object data>
-  static std::map<std::string, GLObject> objects; // singleton, stores instanced objects data
+  // stores object data, in the order of their names in the scene file
+  static SlotMap<GLObject> objects; // singleton, stores instanced objects data
 
-  // stores <model name, model data>
-  static std::map<std::string, GLApp::GLModel> models; // singleton that stores models data
+  // stores model data
+  static SlotMap<GLApp::GLModel> models; // singleton that stores models data
 
-  // stores <shader program name, shader program>
-  static std::map<std::string, GLSLShader> shdrpgms; // singleton that stores shader programs
+  // stores shader programs
+  static SlotMap<GLSLShader> shdrpgms; // singleton that stores shader programs
+
+  // <name, handle> of objects, models and shader programs; only used while
+  // loading so that per-frame code never looks up a string
+  static std::unordered_map<std::string, ObjectHandle> object_names;
+  static std::unordered_map<std::string, SlotMap<GLModel>::Handle> model_names;
+  static std::unordered_map<std::string, SlotMap<GLSLShader>::Handle> shdrpgm_names;
 
   static void init_models_cont(std::string);
 
-  // function to insert shader program into container GLApp::shdrpgms
-  static void init_shdrpgms(std::string, std::string, std::string);
+  // function to insert shader program into container GLApp::shdrpgms;
+  // the geometry shader is optional
+  static void init_shdrpgms(std::string, std::string, std::string, std::string = "");
 
   // function to parse scene file
   static void init_scene(std::string);
+
+  // number of objects whose transforms are computed by each job
+  // of the parallel update
+  static size_t const update_grain{ 256 };
 };
 #endif /* GLAPP_H */
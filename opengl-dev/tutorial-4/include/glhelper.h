@@ -42,6 +42,7 @@ struct GLHelper
   static void update_time(double fpsCalcInt = 1.0);
 
   static GLint width, height;
+  static GLuint fbsize_version; // incremented each time the framebuffer is resized
   static GLdouble fps;
   static GLdouble delta_time; // time taken to complete most recent game loop
   static std::string title;
@@ -53,6 +54,11 @@ struct GLHelper
   static GLboolean keystateU;
   static GLboolean keystateV;
   static GLboolean keystateZ;
+  static GLboolean keystateB; // benchmark transform kernels
+  static GLboolean keystateT; // cycle update thread count
+  static GLboolean keystateC; // toggle viewport culling
+  static GLboolean keystateM; // cycle minimap rendering paths
+  static GLboolean keystateL; // toggle level of detail
 
   // this flag is true if left mouse button is clicked
   static GLboolean leftclickState;
@@ -141,6 +141,7 @@ public:
   // variables of different types for the current program object
   void SetUniform(GLchar const *name, GLboolean val);
   void SetUniform(GLchar const *name, GLint val);
+  void SetUniform(GLchar const *name, GLuint val);
   void SetUniform(GLchar const *name, GLfloat val);
   void SetUniform(GLchar const *name, GLfloat x, GLfloat y);
   void SetUniform(GLchar const *name, GLfloat x, GLfloat y, GLfloat z);
@@ -151,6 +152,51 @@ public:
   void SetUniform(GLchar const *name, glm::mat3 const& val);
   void SetUniform(GLchar const *name, glm::mat4 const& val);
 
+  // handle naming a uniform variable by index instead of by string. A handle
+  // is not tied to a program object: the same handle selects the uniform
+  // variable with that name in every program object
+  struct UniformHandle {
+    GLuint id;
+  };
+
+  // return the handle of uniform variable "name"; obtain it once, e.g. during
+  // initialization, and pass it to SetUniform instead of the name
+  static UniformHandle GetUniformHandle(GLchar const *name);
+
+  // same as the overloads above, but the location is read from the table of
+  // active uniform variables reflected after Link() by indexing it with the
+  // handle, so no string is compared or passed to OpenGL
+  void SetUniform(UniformHandle handle, GLboolean val);
+  void SetUniform(UniformHandle handle, GLint val);
+  void SetUniform(UniformHandle handle, GLuint val);
+  void SetUniform(UniformHandle handle, GLfloat val);
+  void SetUniform(UniformHandle handle, GLfloat x, GLfloat y);
+  void SetUniform(UniformHandle handle, GLfloat x, GLfloat y, GLfloat z);
+  void SetUniform(UniformHandle handle, GLfloat x, GLfloat y, GLfloat z, GLfloat w);
+  void SetUniform(UniformHandle handle, glm::vec2 const& val);
+  void SetUniform(UniformHandle handle, glm::vec3 const& val);
+  void SetUniform(UniformHandle handle, glm::vec4 const& val);
+  void SetUniform(UniformHandle handle, glm::mat3 const& val);
+  void SetUniform(UniformHandle handle, glm::mat4 const& val);
+
+  // number of calls to glGetUniformLocation avoided by reading locations
+  // from the reflected table since the last call to ResetLookupsAvoided();
+  // applications reset it once per frame to get a per-frame count
+  static GLuint GetLookupsAvoided();
+  static void ResetLookupsAvoided();
+
+  // Enable the on-disk cache of linked program binaries used by
+  // CompileLinkValidate(). Each binary is stored in directory "dir" under a
+  // key hashed from the shader sources and the driver's vendor, renderer and
+  // version strings, so editing a shader or updating the driver selects a new
+  // key. A binary that the driver rejects is ignored and the program is
+  // compiled and linked from source. An empty directory disables the cache.
+  static void SetBinaryCacheDir(std::string const& dir);
+
+  // number of programs loaded from and missing in the binary cache
+  static GLuint GetBinaryCacheHits();
+  static GLuint GetBinaryCacheMisses();
+
   // display the list of active vertex attributes used by vertex shader
   void PrintActiveAttribs() const;
 
@@ -173,10 +219,47 @@ private:
   GLboolean is_linked = GL_FALSE; // has the program successfully linked?
   std::string log_string; // log for OpenGL compiler and linker messages
 
+  // location of every active uniform variable, reflected after Link().
+  // std::less<> allows lookups by GLchar const* without creating a string
+  std::map<std::string, GLint, std::less<>> uniform_locs;
+
+  // location of the uniform variable named by each handle id; filled from
+  // uniform_locs the first time a handle is used with this program object
+  std::vector<GLint> handle_locs;
+
+  // glGetUniformLocation calls avoided since the last reset
+  static GLuint lookups_avoided;
+
+  // directory of cached program binaries; empty if the cache is disabled
+  static std::string binary_cache_dir;
+  static GLuint binary_cache_hits, binary_cache_misses;
+
 private:
-  // use OpenGL API to return the location of an uniform variable with
-  // name "name" using program handle encapsulated by object of this class type
+  // return the location of uniform variable with name "name" from the table
+  // of active uniform variables of the program object, or -1 if it is not
+  // an active uniform variable
   GLint GetUniformLocation(GLchar const *name);
+
+  // return the location in this program object of the uniform variable
+  // named by handle, or -1 if it is not an active uniform variable
+  GLint GetUniformLocation(UniformHandle handle);
+
+  // fill uniform_locs with the location of every active uniform variable
+  void ReflectUniforms();
+
+  // names of the uniform variables that have a handle, indexed by handle id
+  static std::vector<std::string>& HandleNames();
+
+  // return the path of the cached binary of the program built from the
+  // shader files in vec, or an empty string if the cache cannot be used
+  static std::string BinaryCacheFile(std::vector<std::pair<GLenum, std::string>> const& vec);
+
+  // replace the program object with the binary in file_name; returns
+  // GL_FALSE, leaving no program object, if the binary is missing or rejected
+  GLboolean LoadBinary(std::string const& file_name);
+
+  // write the binary of the linked program object to file_name
+  void SaveBinary(std::string const& file_name);
   
   // return true if file (given in relative path) exists, false otherwise
   GLboolean FileExists(std::string const& file_name);
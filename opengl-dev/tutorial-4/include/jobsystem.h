@@ -0,0 +1,56 @@
+/*!
+* @file    jobsystem.h
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/3/2023
+*
+* @brief This file contains the declaration of struct JobSystem that
+*		 encapsulates a pool of worker threads used to split loops over many
+*		 objects into chunks that are processed on every core. Each thread owns
+*		 a queue of chunks; a thread that runs out of chunks steals from the
+*		 front of another thread's queue so that the load stays balanced even
+*		 when chunks take different amounts of time.
+*//*__________________________________________________________________________*/
+
+/*                                                                      guard
+----------------------------------------------------------------------------- */
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <cstddef>
+#include <functional>
+
+/*  _________________________________________________________________________ */
+struct JobSystem
+  /*! JobSystem structure to encapsulate the worker threads ...
+  */
+{
+  // function called with a range [first, last) of loop indices
+  using Task = std::function<void(size_t first, size_t last)>;
+
+  // start thread_cnt - 1 worker threads; the calling thread is the last one.
+  // thread_cnt of 0 uses every hardware thread
+  static void init(unsigned thread_cnt = 0);
+
+  // stop and join the worker threads
+  static void cleanup();
+
+  // number of threads that run tasks, including the calling thread
+  static unsigned get_thread_count();
+
+  // restart the pool with thread_cnt threads, clamped to [1, max_thread_count()]
+  static void set_thread_count(unsigned thread_cnt);
+
+  // number of hardware threads
+  static unsigned max_thread_count();
+
+  // split [0, cnt) into chunks of grain indices and call task once for each
+  // chunk. Returns after every chunk is done. Chunks are fixed by cnt and
+  // grain alone, so tasks writing only to their own indices give the same
+  // results for any thread count. With a single thread the chunks run in
+  // order on the calling thread.
+  static void parallel_for(size_t cnt, size_t grain, Task const& task);
+};
+
+#endif /* JOBSYSTEM_H */
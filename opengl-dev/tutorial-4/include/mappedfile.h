@@ -0,0 +1,60 @@
+/*!
+* @file    mappedfile.h
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/5/2023
+*
+* @brief This file contains the declaration of class MappedFile that maps a
+*		 whole file read-only into the address space of the application so
+*		 that its contents can be used in place, e.g. passed directly to
+*		 glNamedBufferStorage, without reading them into an intermediate
+*		 buffer first. The mapping is created with CreateFileMapping on
+*		 Windows and mmap elsewhere.
+*//*__________________________________________________________________________*/
+
+/*                                                                      guard
+----------------------------------------------------------------------------- */
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <GL/glew.h> // for access to OpenGL API declarations
+#include <string>
+#include <cstddef>
+
+/*  _________________________________________________________________________ */
+class MappedFile
+  /*! MappedFile class.
+  */
+{
+public:
+  MappedFile() = default;
+  ~MappedFile() { close(); }
+
+  // a mapping is owned by exactly one object
+  MappedFile(MappedFile const&) = delete;
+  MappedFile& operator=(MappedFile const&) = delete;
+
+  // map the contents of file_name; any previous mapping is closed first.
+  // Returns GL_FALSE if the file cannot be opened or is empty
+  GLboolean open(std::string const& file_name);
+
+  // unmap the file
+  void close();
+
+  // first byte of the mapped file, or nullptr if nothing is mapped
+  void const* data() const { return view; }
+
+  // size of the mapped file in bytes
+  size_t size() const { return length; }
+
+private:
+  void const* view{ nullptr }; // start of the mapped view
+  size_t length{ 0 };          // size of the mapped view in bytes
+#ifdef _WIN32
+  void* file_handle{ nullptr };    // HANDLE of the opened file
+  void* mapping_handle{ nullptr }; // HANDLE of the file mapping object
+#endif
+};
+
+#endif /* MAPPEDFILE_H */
@@ -0,0 +1,85 @@
+/*!
+* @file    mesharena.h
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/14/2023
+*
+* @brief This file contains the declaration of class MeshArena that packs the
+*		 vertex and index buffers of many models into one vertex buffer, one
+*		 element buffer and one VAO. Each model keeps its own indices and is
+*		 located by the range of the element buffer holding them and the
+*		 offset of its first vertex, which is what a draw command of
+*		 glMultiDrawElementsIndirect needs to draw it. Models are copied from
+*		 the BufferArena ranges they were uploaded to, on the GPU. Since a
+*		 multi-draw reads a single index type, indices of each type go to an
+*		 element buffer and VAO of their own, which share the vertex buffer.
+*//*__________________________________________________________________________*/
+
+/*                                                                      guard
+----------------------------------------------------------------------------- */
+#ifndef MESHARENA_H
+#define MESHARENA_H
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <GL/glew.h> // for access to OpenGL API declarations
+#include <bufferarena.h>
+#include <meshindex.h>
+#include <vector>
+
+/*  _________________________________________________________________________ */
+class MeshArena
+  /*! MeshArena class.
+  */
+{
+public:
+  // location of a model in the arena
+  struct Range {
+    GLuint first_index{ 0 }; // first index of the model in the element buffer
+    GLuint idx_cnt{ 0 };     // number of indices of the model
+    GLint base_vertex{ 0 };  // added to each index of the model
+    GLenum idx_type{ GL_UNSIGNED_SHORT }; // element buffer holding the indices
+  };
+
+  // add the model whose vec2 positions and indices of type idx_type are
+  // held by ranges vtx_alloc and idx_alloc; the model is copied by every
+  // call to build, so the ranges must stay live until the model is removed
+  Range add(BufferArena::Allocation const& vtx_alloc, BufferArena::Allocation const& idx_alloc,
+            GLenum idx_type);
+
+  // remove the model added at range, so that build no longer copies it and
+  // its ranges may be freed; its space in the arena is not reused
+  void remove(Range const& range);
+
+  // create the buffers and VAOs of the arena and copy every model added so far
+  void build();
+
+  // delete the buffers and VAOs of the arena and forget every model
+  void destroy();
+
+  // VAO with position attribute 0 and the element buffer of the indices of
+  // type idx_type
+  GLuint get_vaoid(GLenum idx_type) const { return vaoids[slot(idx_type)]; }
+
+  GLuint get_vtx_count() const { return vtx_cnt; }
+  GLuint get_idx_count(GLenum idx_type) const { return idx_cnts[slot(idx_type)]; }
+
+private:
+  struct Source {
+    BufferArena::Allocation vtx_alloc, idx_alloc; // ranges the model was uploaded to
+    GLuint vtx_cnt;  // number of vertices of the model
+    Range range;
+  };
+
+  // GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT and GL_UNSIGNED_INT
+  static GLuint constexpr idx_type_cnt{ 3 };
+  static GLuint slot(GLenum idx_type)
+  {
+    return (idx_type == GL_UNSIGNED_BYTE) ? 0 : (idx_type == GL_UNSIGNED_SHORT) ? 1 : 2;
+  }
+
+  std::vector<Source> sources;
+  GLuint vtx_cnt{ 0 }, idx_cnts[idx_type_cnt]{};
+  GLuint vbo{ 0 }, ebos[idx_type_cnt]{}, vaoids[idx_type_cnt]{};
+};
+
+#endif /* MESHARENA_H */
@@ -0,0 +1,136 @@
+/*!
+* @file    meshbin.h
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/5/2023
+*
+* @brief This file contains the declaration of struct MeshBin that
+*		 encapsulates the binary mesh format used in place of the text .msh
+*		 files. A binary mesh file (.mshb) consists of
+*
+*		 Header             fixed-size description of the mesh
+*		 vertex blob        Header::vtx_cnt glm::vec2 positions
+*		 index blob         Header::idx_cnt indices of type Header::idx_type
+*
+*		 The index type is the smallest one able to address every vertex
+*		 (see MeshIndex), so a mesh may have more than 65536 vertices. Both
+*		 blobs start at offsets given in the header that are multiples
+*		 of 4 bytes so that the memory-mapped file can be handed to
+*		 glNamedBufferSubData as is. Binary files are converted from the text
+*		 files whenever they are missing or older than the text file. The
+*		 conversion runs MeshOpt on the mesh, so binary meshes are triangle
+*		 lists ordered for the vertex cache and the header keeps the ACMR
+*		 of the mesh before and after. Meshes of triangle fans are curved
+*		 and first get coarser levels of detail from MeshLod; the index blob
+*		 holds the levels end to end and the header their ranges.
+*//*__________________________________________________________________________*/
+
+/*                                                                      guard
+----------------------------------------------------------------------------- */
+#ifndef MESHBIN_H
+#define MESHBIN_H
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <GL/glew.h> // for access to OpenGL API declarations
+#include <bufferarena.h>
+#include <meshindex.h>
+#include <meshopt.h>
+#include <meshlod.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/*  _________________________________________________________________________ */
+struct MeshBin
+  /*! MeshBin structure to encapsulate the binary mesh format ...
+  */
+{
+  // first bytes of every binary mesh file: "MSHB"
+  static std::uint32_t const MAGIC{ 0x4248534D };
+  static std::uint32_t const VERSION{ 4 };
+
+  struct Header {
+    std::uint32_t magic;          // MAGIC
+    std::uint32_t version;        // VERSION
+    std::uint32_t primitive_type; // GLenum used to render the mesh
+    std::uint32_t vtx_cnt;        // number of glm::vec2 positions
+    std::uint32_t idx_cnt;        // number of indices
+    std::uint32_t idx_type;       // GL_UNSIGNED_BYTE, _SHORT or _INT
+    std::uint32_t vtx_offset;     // offset in bytes of vertex blob
+    std::uint32_t idx_offset;     // offset in bytes of index blob
+    float acmr_before;            // ACMR of the text mesh
+    float acmr_after;             // ACMR of the index blob
+    std::uint32_t lod_cnt;        // number of levels of detail in lods
+    MeshLod::Level lods[MeshLod::max_levels]; // finest first
+    char name[36];                // null-terminated model name
+  };
+
+  // parse the text mesh file msh_file as init_models_cont always did;
+  // returns GL_FALSE if the file cannot be opened
+  static GLboolean parse_text(std::string const& msh_file, std::string& name,
+                              GLenum& primitive_type, std::vector<glm::vec2>& pos_vtx,
+                              std::vector<GLuint>& idx_vtx);
+
+  // build the levels of detail of a parsed mesh if it is made of fans and
+  // optimize them with MeshOpt::optimize; idx_vtx receives the indices of
+  // every level end to end and lods the range and error of each level
+  static MeshOpt::Report prepare(GLenum& primitive_type, std::vector<glm::vec2>& pos_vtx,
+                                 std::vector<GLuint>& idx_vtx, std::vector<MeshLod::Level>& lods);
+
+  // write a binary mesh file with idx_vtx packed to the smallest index
+  // type, its levels of detail and the ACMR of report; returns GL_FALSE if
+  // the file cannot be written
+  static GLboolean write(std::string const& bin_file, std::string const& name,
+                         GLenum primitive_type, std::vector<glm::vec2> const& pos_vtx,
+                         std::vector<GLuint> const& idx_vtx, std::vector<MeshLod::Level> const& lods,
+                         MeshOpt::Report const& report);
+
+  // convert text mesh file msh_file to binary mesh file bin_file, with
+  // the levels of detail and optimization of prepare
+  static GLboolean convert(std::string const& msh_file, std::string const& bin_file);
+
+  // path of the binary mesh file converted from msh_file
+  static std::string binary_path(std::string const& msh_file);
+
+  // return path of an up-to-date binary mesh file for msh_file,
+  // converting msh_file first if required; empty if conversion failed
+  static std::string ensure_binary(std::string const& msh_file);
+
+  // VAO of an uploaded mesh and the ranges of a BufferArena holding its
+  // vertices and indices; draw calls start at idx_alloc.offset and read
+  // indices of type idx_type
+  struct GPUMesh {
+    GLuint vaoid{ 0 };
+    BufferArena::Allocation vtx_alloc, idx_alloc;
+    GLenum idx_type{ GL_UNSIGNED_SHORT };
+  };
+
+  // memory-map bin_file and upload a mesh whose vertex and index ranges of
+  // arena are initialized directly from the mapped blobs; bbox_min and
+  // bbox_max receive the bounding box of the vertex positions, lods the
+  // levels of detail and report the ACMR stored by convert
+  static GLboolean load(std::string const& bin_file, BufferArena& arena, std::string& name,
+                        GLenum& primitive_type, GPUMesh& mesh, GLuint& draw_cnt,
+                        glm::vec2& bbox_min, glm::vec2& bbox_max, std::vector<MeshLod::Level>& lods,
+                        MeshOpt::Report& report);
+
+  // bounding box of vtx_cnt vertex positions; zero if vtx_cnt is 0
+  static void bounds(glm::vec2 const* pos_vtx, size_t vtx_cnt,
+                     glm::vec2& bbox_min, glm::vec2& bbox_max);
+
+  // allocate the vertices and the idx_cnt indices of type idx_type from
+  // arena, tagged with name, and create a VAO with position attribute 0
+  // and the element buffer
+  static GPUMesh upload(BufferArena& arena, std::string const& name,
+                        glm::vec2 const* pos_vtx, size_t vtx_cnt,
+                        void const* idx_vtx, size_t idx_cnt, GLenum idx_type);
+
+  // delete the VAO of a mesh created by upload and free its ranges
+  static void destroy(BufferArena& arena, GPUMesh& mesh);
+
+  // print load times of text and binary mesh files of generated grids
+  static void benchmark();
+};
+
+#endif /* MESHBIN_H */
@@ -0,0 +1,75 @@
+/*!
+* @file    meshopt.h
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/19/2023
+*
+* @brief This file contains the declaration of struct MeshOpt that reorders
+*		 the triangles and vertices of a mesh for the GPU. Meshes keep the
+*		 order they were authored in, which rarely suits the post-transform
+*		 vertex cache: a vertex shaded for one triangle is shaded again if it
+*		 was evicted before the next triangle using it. MeshOpt converts
+*		 triangle fans to indexed triangle lists, reorders the triangles with
+*		 Forsyth's linear-speed vertex cache optimization and then renumbers
+*		 the vertices in the order they are first used, so that vertex
+*		 fetches walk the vertex buffer forward. The quality of an order is
+*		 measured as its ACMR (average cache miss ratio): vertices shaded per
+*		 triangle with a FIFO cache of cache_size vertices.
+*//*__________________________________________________________________________*/
+
+/*                                                                      guard
+----------------------------------------------------------------------------- */
+#ifndef MESHOPT_H
+#define MESHOPT_H
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <GL/glew.h> // for access to OpenGL API declarations
+#include <glm/glm.hpp>
+#include <vector>
+
+/*  _________________________________________________________________________ */
+struct MeshOpt
+  /*! MeshOpt structure to optimize the triangle and vertex order of meshes.
+  */
+{
+  // entries of the FIFO post-transform cache simulated by acmr
+  static GLuint constexpr cache_size{ 16 };
+
+  // triangles of an optimized mesh and ACMR of their order before and after
+  // optimization; tri_cnt is 0 if the mesh was not optimized
+  struct Report {
+    GLuint tri_cnt{ 0 };
+    GLfloat acmr_before{ 0.f }, acmr_after{ 0.f };
+  };
+
+  // convert fans separated by MeshIndex::restart to a triangle list with
+  // the same winding, dropping degenerate triangles
+  static std::vector<GLuint> fan_to_list(std::vector<GLuint> const& idx_vtx);
+
+  // reorder the triangles of a triangle list indexing vtx_cnt vertices for
+  // the post-transform vertex cache
+  static void optimize_vertex_cache(std::vector<GLuint>& idx_vtx, size_t vtx_cnt);
+
+  // renumber the vertices in the order the indices first use them and
+  // drop the vertices no index uses
+  static void optimize_vertex_fetch(std::vector<glm::vec2>& pos_vtx, std::vector<GLuint>& idx_vtx);
+
+  // vertices shaded per triangle drawing a triangle list with a FIFO cache
+  static GLfloat acmr(std::vector<GLuint> const& idx_vtx, size_t vtx_cnt);
+
+  // run every pass above on a mesh of GL_TRIANGLES or GL_TRIANGLE_FAN;
+  // fans become GL_TRIANGLES. Meshes of other primitive types or with
+  // indices past the last vertex are left as they are
+  static Report optimize(GLenum& primitive_type, std::vector<glm::vec2>& pos_vtx,
+                         std::vector<GLuint>& idx_vtx);
+
+  // as above for the levels of detail of a mesh, which index the same
+  // vertices; the report is that of the first level
+  static Report optimize(GLenum& primitive_type, std::vector<glm::vec2>& pos_vtx,
+                         std::vector<std::vector<GLuint>>& levels);
+
+  // print ACMR and optimization time of generated grids
+  static void benchmark();
+};
+
+#endif /* MESHOPT_H */
@@ -0,0 +1,80 @@
+/*!
+* @file    renderqueue.h
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/12/2023
+*
+* @brief This file contains the declaration of class RenderQueue that collects
+*		 the draw calls of a frame and submits them changing the program and
+*		 VAO only when consecutive draw calls need different ones. Draw
+*		 calls are made in the order they were pushed in: the 2D scenes are
+*		 drawn without a depth test, so that order decides which of two
+*		 overlapping objects is on top.
+*//*__________________________________________________________________________*/
+
+/*                                                                      guard
+----------------------------------------------------------------------------- */
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <glslshader.h>
+#include <vector>
+
+/*  _________________________________________________________________________ */
+class RenderQueue
+  /*! RenderQueue class.
+  */
+{
+public:
+  // one draw call; xform and color must stay valid until submit, and
+  // draw_idx is only used by the submit taking an index uniform
+  struct Item {
+    GLSLShader* shdr_pgm;   // shader program used to render the model
+    GLuint vaoid;           // VAO of the model
+    GLenum primitive_type;  // primitive type of the model
+    GLuint draw_cnt;        // number of indices drawn
+    GLintptr idx_offset;    // offset of the first index in the element buffer
+    GLenum idx_type;        // type of the indices
+    glm::vec3 const* color; // copied to uniform variable uColor
+    glm::mat3 const* xform; // copied to the transform uniform of submit
+    GLuint draw_idx;        // copied to the index uniform of submit
+  };
+
+  // number of draw calls made and of program and VAO binds made and
+  // skipped by the last call to submit
+  struct Stats {
+    GLuint draws{ 0 };
+    GLuint pgm_binds{ 0 }, pgm_skipped{ 0 };
+    GLuint vao_binds{ 0 }, vao_skipped{ 0 };
+  };
+
+  // remove every draw call
+  void clear() { items.clear(); }
+
+  // add a draw call
+  void push(Item const& item) { items.push_back(item); }
+
+  // make the draw calls in order, setting uniform color_uniform to
+  // the color and xform_uniform to the transform of each draw call; the
+  // program and VAO are unbound afterwards
+  void submit(GLSLShader::UniformHandle color_uniform, GLSLShader::UniformHandle xform_uniform);
+
+  // as above, but only uniform idx_uniform is set, to the draw_idx of each
+  // draw call, for shaders that fetch the per-draw data from a buffer
+  void submit(GLSLShader::UniformHandle idx_uniform);
+
+  size_t size() const { return items.size(); }
+  Stats const& get_stats() const { return stats; }
+
+private:
+  // make the draw calls in order, calling set_uniforms(pgm, item) before
+  // each one
+  template <typename SetUniforms>
+  void submit_items(SetUniforms const& set_uniforms);
+
+  std::vector<Item> items;
+  Stats stats;
+};
+
+#endif /* RENDERQUEUE_H */
@@ -0,0 +1,91 @@
+/*!
+* @file    ringbuffer.h
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/16/2023
+*
+* @brief This file contains the declaration of class RingBuffer, an allocator
+*		 of per-frame data over a buffer that stays mapped for its whole
+*		 lifetime (GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT). The buffer is
+*		 split into one region per frame in flight. A frame allocates from
+*		 its region and writes straight into the mapped memory, so data reaches
+*		 the GPU without glBufferSubData and without a copy by the driver. A
+*		 fence placed after the commands of a frame guards its region, which is
+*		 reused only once the GPU has passed that fence.
+*//*__________________________________________________________________________*/
+
+/*                                                                      guard
+----------------------------------------------------------------------------- */
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <GL/glew.h> // for access to OpenGL API declarations
+#include <vector>
+
+/*  _________________________________________________________________________ */
+class RingBuffer
+  /*! RingBuffer class.
+  */
+{
+public:
+  // memory allocated for the current frame; ptr is nullptr if the region
+  // of the frame is full
+  struct Allocation {
+    void* ptr;        // mapped address to write the data to
+    GLintptr offset;  // offset of the data in the buffer
+  };
+
+  // every region starts at a multiple of this many bytes, which satisfies
+  // the offset alignment of uniform and shader storage buffer bindings
+  static GLsizeiptr constexpr region_alignment{ 256 };
+
+  RingBuffer() = default;
+  RingBuffer(RingBuffer const&) = delete;
+  RingBuffer& operator=(RingBuffer const&) = delete;
+  ~RingBuffer() { destroy(); }
+
+  // create and map a buffer of cnt regions of at least size bytes
+  void init(GLsizeiptr size, GLuint cnt = 3);
+
+  // unmap and delete the buffer after the GPU is done with it
+  void destroy();
+
+  // move on to the next region, waiting until the GPU is done with it
+  void begin_frame();
+
+  // fence the commands issued since begin_frame
+  void end_frame();
+
+  // make sure size bytes can be allocated in the current frame, replacing
+  // the buffer with a larger one if required; call it right after
+  // begin_frame, before the first allocation of the frame
+  void reserve(GLsizeiptr size);
+
+  // allocate size bytes at an offset that is a multiple of alignment
+  Allocation allocate(GLsizeiptr size, GLsizeiptr alignment);
+
+  GLuint get_buffer() const { return buffer; }
+  GLsizeiptr get_region_size() const { return region_size; }
+
+  // number of times the GPU had not finished with a region when it was needed
+  GLuint get_stall_count() const { return stall_cnt; }
+
+  // print the CPU and total time per frame of streaming xform_cnt
+  // transforms with glNamedBufferSubData and with a ring buffer
+  static void benchmark(GLuint xform_cnt);
+
+private:
+  void wait(GLuint i);
+
+  GLuint buffer{ 0 };
+  char* base{ nullptr };         // mapped address of the buffer
+  GLsizeiptr region_size{ 0 };
+  GLuint frame_cnt{ 0 };
+  GLuint region{ 0 };            // region of the current frame
+  GLsizeiptr head{ 0 };          // bytes allocated in the current region
+  std::vector<GLsync> fences;    // fence of the last frame of each region
+  GLuint stall_cnt{ 0 };
+};
+
+#endif /* RINGBUFFER_H */
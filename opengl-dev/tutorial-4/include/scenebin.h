@@ -0,0 +1,129 @@
+/*!
+* @file    scenebin.h
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/6/2023
+*
+* @brief This file contains the declaration of struct SceneBin that
+*		 encapsulates the binary scene format used in place of the text .scn
+*		 files. A binary scene file (.scnb) consists of
+*
+*		 Header             fixed-size description of the scene
+*		 string table       null-terminated strings, each stored once
+*		 model table        Header::model_cnt string offsets
+*		 shader table       Header::shdrpgm_cnt ShdrPgmRecord
+*		 object table       Header::object_cnt ObjectRecord sorted by name
+*
+*		 Names and shader paths are interned in the string table and
+*		 referenced by byte offset, so the paths shared by every object are
+*		 stored once. Objects refer to models and shader programs by index.
+*		 Every table starts at an offset that is a multiple of 4 bytes so
+*		 that the records can be read in place from the memory-mapped file.
+*//*__________________________________________________________________________*/
+
+/*                                                                      guard
+----------------------------------------------------------------------------- */
+#ifndef SCENEBIN_H
+#define SCENEBIN_H
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <GL/glew.h> // for access to OpenGL API declarations
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/*  _________________________________________________________________________ */
+struct SceneBin
+  /*! SceneBin structure to encapsulate the binary scene format ...
+  */
+{
+  // first bytes of every binary scene file: "SCNB"
+  static std::uint32_t const MAGIC{ 0x424E4353 };
+  static std::uint32_t const VERSION{ 1 };
+
+  struct Header {
+    std::uint32_t magic;           // MAGIC
+    std::uint32_t version;         // VERSION
+    std::uint32_t model_cnt;       // number of models
+    std::uint32_t shdrpgm_cnt;     // number of shader programs
+    std::uint32_t object_cnt;      // number of objects
+    std::uint32_t strings_offset;  // offset in bytes of string table
+    std::uint32_t strings_size;    // size in bytes of string table
+    std::uint32_t models_offset;   // offset in bytes of model table
+    std::uint32_t shdrpgms_offset; // offset in bytes of shader table
+    std::uint32_t objects_offset;  // offset in bytes of object table
+  };
+
+  struct ShdrPgmRecord {
+    std::uint32_t name;     // string offset of shader program name
+    std::uint32_t vtx_shdr; // string offset of vertex shader path
+    std::uint32_t frg_shdr; // string offset of fragment shader path
+  };
+
+  struct ObjectRecord {
+    std::uint32_t name;    // string offset of object name
+    std::uint32_t model;   // index into model table
+    std::uint32_t shdrpgm; // index into shader table
+    float color[3];
+    float scaling[2];
+    float orientation[2];
+    float position[2];
+  };
+
+  // shader program as listed in a scene file
+  struct ShdrPgm {
+    std::string name, vtx_shdr, frg_shdr;
+    bool operator==(ShdrPgm const&) const = default;
+  };
+
+  // object as listed in a scene file; model and shdrpgm index Scene::models
+  // and Scene::shdrpgms
+  struct Object {
+    std::string name;
+    GLuint model{ 0 }, shdrpgm{ 0 };
+    glm::vec3 color{ 0.f };
+    glm::vec2 scaling{ 0.f }, orientation{ 0.f }, position{ 0.f };
+    bool operator==(Object const&) const = default;
+  };
+
+  // contents of a scene file with every model and shader program listed once
+  struct Scene {
+    std::vector<std::string> models;
+    std::vector<ShdrPgm> shdrpgms;
+    std::vector<Object> objects;
+    bool operator==(Scene const&) const = default;
+  };
+
+  // parse the text scene file scn_file; returns GL_FALSE if the file cannot
+  // be opened
+  static GLboolean read_text(std::string const& scn_file, Scene& scene);
+
+  // write scene in the text scene format; returns GL_FALSE if the file
+  // cannot be written
+  static GLboolean write_text(std::string const& scn_file, Scene const& scene);
+
+  // memory-map the binary scene file bin_file and read it into scene;
+  // returns GL_FALSE if the file cannot be mapped or is invalid
+  static GLboolean read(std::string const& bin_file, Scene& scene);
+
+  // write scene in the binary scene format with objects sorted by name;
+  // returns GL_FALSE if the file cannot be written
+  static GLboolean write(std::string const& bin_file, Scene const& scene);
+
+  // convert text scene file scn_file to binary scene file bin_file
+  static GLboolean convert(std::string const& scn_file, std::string const& bin_file);
+
+  // path of the binary scene file converted from scn_file
+  static std::string binary_path(std::string const& scn_file);
+
+  // return path of an up-to-date binary scene file for scn_file,
+  // converting scn_file first if required; empty if conversion failed
+  static std::string ensure_binary(std::string const& scn_file);
+
+  // write generated scenes as text, convert them and read them back,
+  // printing load times and whether the scenes survive the round trip
+  static void benchmark();
+};
+
+#endif /* SCENEBIN_H */
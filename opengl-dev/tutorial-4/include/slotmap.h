@@ -0,0 +1,187 @@
+/*!
+* @file    slotmap.h
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/10/2023
+*
+* @brief This file contains the declaration and definition of class template
+*		 SlotMap, a container that stores its values contiguously and hands
+*		 out handles to them. A handle is the index of a slot and the
+*		 generation of that slot when the value was inserted; the slot holds
+*		 the position of the value in the contiguous array. Erasing a value
+*		 moves the last value into its place and increments the generation of
+*		 its slot, so handles to erased values are detected instead of
+*		 reaching another value. Pointers and references to values are only
+*		 valid until the next insert or erase; handles stay valid until their
+*		 own value is erased.
+*//*__________________________________________________________________________*/
+
+/*                                                                      guard
+----------------------------------------------------------------------------- */
+#ifndef SLOTMAP_H
+#define SLOTMAP_H
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <GL/glew.h> // for access to OpenGL API declarations
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+/*  _________________________________________________________________________ */
+template <typename T>
+class SlotMap
+  /*! SlotMap class template.
+  */
+{
+public:
+  static GLuint constexpr invalid_index{ 0xFFFFFFFFu };
+
+  // refers to a value of the slot map; a default handle refers to no value
+  struct Handle {
+    GLuint index{ invalid_index }; // slot of the value
+    GLuint generation{ 0 };        // generation of the slot when the value was inserted
+
+    bool operator==(Handle const&) const = default;
+  };
+
+  using iterator = typename std::vector<T>::iterator;
+  using const_iterator = typename std::vector<T>::const_iterator;
+
+  // add a value and return its handle; slots of erased values are reused
+  Handle insert(T value);
+
+  // remove the value of handle h; does nothing if h is not valid
+  void erase(Handle h);
+
+  // GL_TRUE if h refers to a value of the slot map
+  GLboolean contains(Handle h) const;
+
+  // pointer to the value of handle h, or nullptr if h is not valid
+  T* get(Handle h) { return contains(h) ? &values[slots[h.index].dense] : nullptr; }
+  T const* get(Handle h) const { return contains(h) ? &values[slots[h.index].dense] : nullptr; }
+
+  // value of handle h, which must be valid
+  T& operator[](Handle h) { return values[slots[h.index].dense]; }
+  T const& operator[](Handle h) const { return values[slots[h.index].dense]; }
+
+  // handle of the value at position i of the contiguous array
+  Handle handle_at(size_t i) const { return Handle{ dense_slot[i], slots[dense_slot[i]].generation }; }
+
+  // remove every value; handles given out before are no longer valid
+  void clear();
+
+  void reserve(size_t cnt) { values.reserve(cnt); dense_slot.reserve(cnt); slots.reserve(cnt); }
+  size_t size() const { return values.size(); }
+  GLboolean empty() const { return values.empty() ? GL_TRUE : GL_FALSE; }
+
+  // iterate over the values in the contiguous array; the order is that of
+  // insertion until a value other than the last one is erased
+  iterator begin() { return values.begin(); }
+  iterator end() { return values.end(); }
+  const_iterator begin() const { return values.begin(); }
+  const_iterator end() const { return values.end(); }
+
+private:
+  struct Slot {
+    GLuint dense;      // position of the value, or next free slot if the slot is free
+    GLuint generation; // incremented each time the value of the slot is erased
+  };
+
+  std::vector<T> values;          // values in contiguous memory
+  std::vector<GLuint> dense_slot; // slot of each value
+  std::vector<Slot> slots;        // indexed by Handle::index
+  GLuint free_head{ invalid_index }; // first free slot
+};
+
+/*  _________________________________________________________________________ */
+/*! SlotMap::insert
+ * @brief Add a value at the end of the contiguous array.
+ *
+ * @param value[in] Value to add.
+ * @return Handle of the value.
+*/
+template <typename T>
+typename SlotMap<T>::Handle SlotMap<T>::insert(T value)
+{
+  GLuint index;
+  if (free_head == invalid_index) {
+    index = static_cast<GLuint>(slots.size());
+    slots.push_back(Slot{ 0, 0 });
+  }
+  else {
+    index = free_head;
+    free_head = slots[index].dense;
+  }
+
+  slots[index].dense = static_cast<GLuint>(values.size());
+  values.push_back(std::move(value));
+  dense_slot.push_back(index);
+  return Handle{ index, slots[index].generation };
+}
+
+/*  _________________________________________________________________________ */
+/*! SlotMap::erase
+ * @brief Remove a value by moving the last value into its place.
+ *
+ * @param h[in] Handle of the value.
+ * @return void
+*/
+template <typename T>
+void SlotMap<T>::erase(Handle h)
+{
+  if (GL_FALSE == contains(h)) {
+    return;
+  }
+
+  GLuint const dense{ slots[h.index].dense };
+  GLuint const last{ static_cast<GLuint>(values.size() - 1) };
+  if (dense != last) {
+    values[dense] = std::move(values[last]);
+    dense_slot[dense] = dense_slot[last];
+    slots[dense_slot[dense]].dense = dense;
+  }
+  values.pop_back();
+  dense_slot.pop_back();
+
+  ++slots[h.index].generation;
+  slots[h.index].dense = free_head;
+  free_head = h.index;
+}
+
+/*  _________________________________________________________________________ */
+/*! SlotMap::contains
+ * @brief Check whether a handle refers to a value of the slot map.
+ *
+ * @param h[in] Handle to check.
+ * @return GL_TRUE if the slot of h exists and has the generation of h.
+*/
+template <typename T>
+GLboolean SlotMap<T>::contains(Handle h) const
+{
+  return (h.index < slots.size() && slots[h.index].generation == h.generation) ? GL_TRUE : GL_FALSE;
+}
+
+/*  _________________________________________________________________________ */
+/*! SlotMap::clear
+ * @brief Remove every value.
+ *
+ * The slots are kept with their generations incremented so that no handle
+ * given out before refers to a value inserted later.
+ *
+ * @param none
+ * @return void
+*/
+template <typename T>
+void SlotMap<T>::clear()
+{
+  values.clear();
+  dense_slot.clear();
+  free_head = invalid_index;
+  for (GLuint i{ static_cast<GLuint>(slots.size()) }; i-- > 0;) {
+    ++slots[i].generation;
+    slots[i].dense = free_head;
+    free_head = i;
+  }
+}
+
+#endif /* SLOTMAP_H */
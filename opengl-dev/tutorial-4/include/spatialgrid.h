@@ -0,0 +1,87 @@
+/*!
+* @file    spatialgrid.h
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/7/2023
+*
+* @brief This file contains the declaration of class SpatialGrid, a uniform
+*		 grid over the world that indexes axis-aligned bounding boxes so
+*		 that the boxes near a point or overlapping a rectangle can be found
+*		 without visiting every box. Cells are square and are stored in a
+*		 hash table keyed by cell coordinates, so the grid has no fixed
+*		 extent and empty cells take no memory. A box is listed in every cell
+*		 it overlaps and is moved between cells only when an update changes
+*		 the range of cells it overlaps.
+*//*__________________________________________________________________________*/
+
+/*                                                                      guard
+----------------------------------------------------------------------------- */
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <GL/glew.h> // for access to OpenGL API declarations
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+/*  _________________________________________________________________________ */
+class SpatialGrid
+  /*! SpatialGrid class.
+  */
+{
+public:
+  explicit SpatialGrid(GLfloat cell_size = 512.f) { clear(cell_size); }
+
+  // remove every box and use square cells cell_size world units wide
+  void clear(GLfloat cell_size);
+
+  // add a box and return its id; ids of removed boxes are reused
+  GLuint insert(glm::vec2 const& bbox_min, glm::vec2 const& bbox_max);
+
+  // change the bounds of box id
+  void update(GLuint id, glm::vec2 const& bbox_min, glm::vec2 const& bbox_max);
+
+  // remove box id
+  void remove(GLuint id);
+
+  // append to ids the id of every box overlapping the rectangle [lo, hi],
+  // each id once and in no particular order
+  void query_rect(glm::vec2 const& lo, glm::vec2 const& hi, std::vector<GLuint>& ids) const;
+
+  // append to ids the id of every box containing point p
+  void query_point(glm::vec2 const& p, std::vector<GLuint>& ids) const;
+
+  // number of boxes in the grid
+  size_t size() const { return box_cnt; }
+
+  // number of updates that moved a box to other cells and of updates that
+  // only changed its bounds since the last call to clear
+  size_t get_moved_count() const { return moved_cnt; }
+  size_t get_kept_count() const { return kept_cnt; }
+
+  // print the cost of building and querying grids of 1k to 1M boxes
+  // against a linear scan over the same boxes
+  static void benchmark();
+
+private:
+  struct Box {
+    glm::vec2 bbox_min, bbox_max;
+    GLint x0, y0, x1, y1; // range of overlapped cells, inclusive
+  };
+
+  GLint cell_coord(GLfloat x) const;
+  static std::uint64_t cell_key(GLint x, GLint y);
+  void link(GLuint id);
+  void unlink(GLuint id);
+
+  std::unordered_map<std::uint64_t, std::vector<GLuint>> cells; // ids listed in each cell
+  std::vector<Box> boxes;                                       // indexed by id
+  std::vector<GLuint> free_ids;                                 // ids of removed boxes
+  GLfloat inv_cell_size{ 0.f };
+  size_t box_cnt{ 0 };
+  size_t moved_cnt{ 0 }, kept_cnt{ 0 };
+};
+
+#endif /* SPATIALGRID_H */
@@ -0,0 +1,77 @@
+/*!
+* @file    xformbatch.h
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/1/2023
+*
+* @brief This file contains the declaration of struct XformBatch that
+*		 encapsulates a batched, vectorized kernel computing model transforms
+*		 of many objects at once from arrays of position, scaling and
+*		 orientation. The kernel processes 4 (SSE2), 8 (AVX2) or 16 (AVX-512)
+*		 objects per iteration; the instruction set is picked at runtime from
+*		 the capabilities of the CPU and a scalar loop is used as fallback.
+*		 Every path evaluates the same sequence of float operations so that
+*		 results are identical regardless of the instruction set used.
+*//*__________________________________________________________________________*/
+
+/*                                                                      guard
+----------------------------------------------------------------------------- */
+#ifndef XFORMBATCH_H
+#define XFORMBATCH_H
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <GL/glew.h> // for access to OpenGL API declarations
+#include <glm/glm.hpp>
+#include <cstddef>
+
+/*  _________________________________________________________________________ */
+struct XformBatch
+  /*! XformBatch structure to encapsulate batched transform computations ...
+  */
+{
+  // instruction sets the kernel can be compiled for
+  enum ISA {
+    SCALAR = 0,
+    SSE2 = 1,
+    AVX2 = 2,
+    AVX512 = 3
+  };
+
+  // For each object i in [0, cnt), computes the model-to-world transform
+  //   T(position[i]) * R(angle_disp[i]) * S(scaling[i])
+  // with angle_disp in degrees, and for each k in [0, xform_cnt) writes
+  //   post_xforms[k] * model-to-world
+  // to outs[k][i]. post_xforms must be affine (last row 0, 0, 1).
+  // Only the six non-trivial entries of each 2D affine matrix are computed.
+  static void compute(glm::vec2 const* position, glm::vec2 const* scaling,
+                      GLfloat const* angle_disp, size_t cnt,
+                      glm::mat3 const* post_xforms, glm::mat3* const* outs,
+                      size_t xform_cnt);
+
+  // per-object reference implementation that builds the scale, rotation
+  // and translation matrices with glm and multiplies them
+  static void compute_glm(glm::vec2 const* position, glm::vec2 const* scaling,
+                          GLfloat const* angle_disp, size_t cnt,
+                          glm::mat3 const* post_xforms, glm::mat3* const* outs,
+                          size_t xform_cnt);
+
+  // widest instruction set supported by both the CPU and the OS
+  static ISA detect();
+
+  // instruction set currently used by compute; defaults to detect()
+  static ISA get_isa();
+
+  // force compute to use isa; ignored if isa is not supported
+  static void set_isa(ISA isa);
+
+  // number of objects processed per iteration by isa
+  static size_t width(ISA isa);
+
+  static char const* name(ISA isa);
+
+  // print objects per second of compute_glm and of compute for every
+  // supported instruction set using cnt randomly generated objects
+  static void benchmark(size_t cnt);
+};
+
+#endif /* XFORMBATCH_H */
@@ -20,6 +20,15 @@
 ----------------------------------------------------------------------------- */
 #include <glapp.h>
 #include <glhelper.h>
+#include <xformbatch.h>
+#include <jobsystem.h>
+#include <meshbin.h>
+#include <meshopt.h>
+#include <scenebin.h>
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
 #include <glm/glm.hpp>
 #include <iostream>
 #include <fstream>
@@ -31,12 +40,107 @@
 /*                                                   objects with file scope
 ----------------------------------------------------------------------------- */
 // defining singleton containers
-std::map<std::string, GLApp::GLObject> GLApp::objects;
-std::map<std::string, GLApp::GLModel> GLApp::models{};
-std::map<std::string, GLSLShader> GLApp::shdrpgms{};
+SlotMap<GLApp::GLObject> GLApp::objects;
+SlotMap<GLApp::GLModel> GLApp::models{};
+SlotMap<GLSLShader> GLApp::shdrpgms{};
+std::unordered_map<std::string, GLApp::ObjectHandle> GLApp::object_names{};
+std::unordered_map<std::string, SlotMap<GLApp::GLModel>::Handle> GLApp::model_names{};
+std::unordered_map<std::string, SlotMap<GLSLShader>::Handle> GLApp::shdrpgm_names{};
 
 // static variables
 GLApp::Camera2D GLApp::camera2d{};
+SpatialGrid GLApp::object_grid{};
+GLApp::CullStats GLApp::main_cull_stats{};
+GLApp::CullStats GLApp::map_cull_stats{};
+GLboolean GLApp::cull_enabled{ GL_TRUE };
+GLboolean GLApp::lod_enabled{ GL_TRUE };
+GLuint GLApp::submitted_idx_cnt{ 0 };
+GLApp::DrawPath GLApp::draw_path{ GLApp::DrawPath::two_pass };
+BufferArena GLApp::buffer_arena{};
+MeshArena GLApp::mesh_arena{};
+GLApp::XformStats GLApp::mdl_xform_stats{};
+GLApp::XformStats GLApp::view_xform_stats{};
+GLApp::XformStats GLApp::camera_xform_stats{};
+GLuint GLApp::draw_call_cnt{ 0 };
+RenderQueue::Stats GLApp::queue_stats{};
+GLdouble GLApp::draw_cpu_time{ 0.0 };
+
+// draw calls of the objects other than the camera, in draw order
+static RenderQueue render_queue;
+
+// shader program of the multiview path
+static SlotMap<GLSLShader>::Handle multiview_shd_ref;
+
+// persistently mapped buffer holding the per-frame data of the single-pass
+// and indirect paths, and the offset alignments of the bindings it is
+// bound to
+static RingBuffer frame_ring;
+static GLsizeiptr ubo_alignment{ 256 }, ssbo_alignment{ 256 };
+
+// objects other than the camera drawn in the main and mini map viewports,
+// and in either of them
+static std::vector<GLApp::GLObject const*> main_visible, map_visible, both_visible;
+
+// handles to objects indexed by their id in GLApp::object_grid
+static std::vector<GLApp::ObjectHandle> grid_objs;
+
+// ids returned by GLApp::object_grid queries
+static std::vector<GLuint> grid_ids;
+
+// scratch arrays gathering the attributes of the objects updated in a batch
+static std::vector<GLApp::GLObject*> batch_objs;
+static std::vector<glm::vec2> batch_position, batch_scaling;
+static std::vector<GLfloat> batch_angle;
+static std::vector<glm::mat3> batch_mdl, batch_ndc, batch_map;
+
+// set for the objects in a batch whose bounding box changed
+static std::vector<GLubyte> batch_moved;
+
+// objects whose model-to-ndc and model-to-map matrices alone are rebuilt
+static std::vector<GLApp::GLObject*> view_objs;
+
+// seconds spent creating shader programs in GLApp::init_shdrpgms
+static GLdouble shdrpgm_time{ 0.0 };
+
+// seconds spent reading the scene file in GLApp::init_scene
+static GLdouble scene_time{ 0.0 };
+
+// shader program of the multi-draw indirect path
+static SlotMap<GLSLShader>::Handle indirect_shd_ref;
+static GLboolean indirect_supported{ GL_FALSE };
+
+// command read by glMultiDrawElementsIndirect
+struct DrawCommand {
+	GLuint count, instance_cnt, first_index;
+	GLint base_vertex;
+	GLuint base_instance;
+};
+
+// per-draw data read by my-tutorial-4-multiview.vert and
+// my-tutorial-4-indirect.vert; std430 layout, so each mat3 column takes a vec4
+struct DrawData {
+	glm::vec4 mdl_to_world[3];
+	glm::vec4 color;
+};
+
+// commands of one glMultiDrawElementsIndirect call: a run of consecutive
+// objects sharing a primitive type and index type
+struct DrawBatch {
+	GLenum primitive_type, idx_type;
+	GLsizei first, cnt;
+};
+
+// calls of the indirect path built each frame
+static std::vector<DrawBatch> draw_batches;
+
+// names of the rendering paths indexed by GLApp::DrawPath
+static char const* const draw_path_names[]{ "Two passes", "Single pass", "Indirect" };
+
+// handles to uniform variables set by each object draw
+static GLSLShader::UniformHandle const uColor{ GLSLShader::GetUniformHandle("uColor") };
+static GLSLShader::UniformHandle const uModel_to_NDC{ GLSLShader::GetUniformHandle("uModel_to_NDC") };
+static GLSLShader::UniformHandle const uDrawIndex{ GLSLShader::GetUniformHandle("uDrawIndex") };
+static GLSLShader::UniformHandle const uDrawOffset{ GLSLShader::GetUniformHandle("uDrawOffset") };
 
 /*  _________________________________________________________________________ */
 /*! GLApp::init
@@ -45,8 +149,20 @@ GLApp::Camera2D GLApp::camera2d{};
  * This function initializes the GLApp by performing the following tasks:
  * 1. Clears the color buffer to white using glClearColor.
  * 2. Sets the viewport to use the entire window.
- * 3. Parses the scene file and stores models, shader programs and objects in containers.
+ * 3. Parses the scene file and stores models, shader programs and objects in
+ *    containers, and creates the shader program of the single-pass
+ *    multi-viewport path and the persistently mapped ring buffer its
+ *    per-frame data is streamed through. If GL_ARB_shader_draw_parameters is
+ *    supported, creates the shader program of the multi-draw indirect path
+ *    too. Copies every model into GLApp::mesh_arena.
  * 4. Initializes the 2D camera.
+ * 5. Adds the bounding box of each object except for the camera to
+ *    GLApp::object_grid.
+ * 6. Starts one worker thread per hardware thread for the parallel update.
+ *
+ * Shader programs are loaded from the binary cache in ../shader-cache when
+ * possible. The time spent creating them is printed so that a cold start,
+ * which compiles every program, can be compared with a warm start.
  *
  * @param none
  * @return void
@@ -60,16 +176,76 @@ void GLApp::init()
 	// Part 2: use the entire window as viewport
 	glViewport(0, 0, GLHelper::width, GLHelper::height);
 
+	// the largest value of each index type separates the fans of a mesh;
+	// MeshIndex keeps it free in meshes without fans
+	glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+
 	// Part 3: parse scene file $(SolutionDir)scenes/tutorial-4.scn
 	// and store repositories of models of type GLModel in container
 	// GLApp::models, store shader programs of type GLSLShader in
 	// container GLApp::shdrpgms, and store repositories of objects of
 	// type GLObject in container GLApp::objects
+	GLSLShader::SetBinaryCacheDir("../shader-cache");
 	GLApp::init_scene("../scenes/tutorial-4.scn");
 
+	// shader program used to render both viewports in a single pass, and
+	// the ring buffer its per-frame data is written to, starting at 1 MiB
+	// per frame in flight
+	GLApp::init_shdrpgms("tutorial4-multiview", "../shaders/my-tutorial-4-multiview.vert",
+		"../shaders/my-tutorial-4-multiview.frag", "../shaders/my-tutorial-4-multiview.geom");
+	multiview_shd_ref = shdrpgm_names.at("tutorial4-multiview");
+	GLint alignment;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	ubo_alignment = alignment;
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	ssbo_alignment = alignment;
+	frame_ring.init(1 << 20);
+
+	// shader program of the multi-draw indirect path, whose vertex shader
+	// needs gl_DrawIDARB and which shares the geometry and fragment shaders
+	// of the multiview path, and the arena holding every model it draws
+	indirect_supported = GLEW_ARB_shader_draw_parameters ? GL_TRUE : GL_FALSE;
+	if (indirect_supported == GL_TRUE)
+	{
+		GLApp::init_shdrpgms("tutorial4-indirect", "../shaders/my-tutorial-4-indirect.vert",
+			"../shaders/my-tutorial-4-multiview.frag", "../shaders/my-tutorial-4-multiview.geom");
+		indirect_shd_ref = shdrpgm_names.at("tutorial4-indirect");
+	}
+	else
+	{
+		std::cout << "GL_ARB_shader_draw_parameters is not supported; "
+				  << "the indirect rendering path is disabled\n";
+	}
+	mesh_arena.build();
+
+	std::cout << "Scene: " << objects.size() << " objects read in "
+			  << std::setprecision(3) << std::fixed << scene_time * 1000.0 << " ms\n";
+	std::cout << "Shader programs: " << shdrpgms.size() << " created in "
+			  << std::setprecision(3) << std::fixed << shdrpgm_time * 1000.0 << " ms"
+			  << " (binary cache hits: " << GLSLShader::GetBinaryCacheHits()
+			  << ", misses: " << GLSLShader::GetBinaryCacheMisses() << ")\n";
+	std::cout << std::defaultfloat;
+
 	// Part 4: initialize camera
 	GLApp::camera2d.init(GLHelper::ptr_window,
-						 &GLApp::objects.at("Camera"));
+						 GLApp::object_names.at("Camera"));
+
+	// Part 5: index bounding boxes of objects other than the camera;
+	// ids follow the order of GLApp::objects
+	for (size_t i{ 0 }; i < objects.size(); ++i)
+	{
+		ObjectHandle const handle{ objects.handle_at(i) };
+		if (handle != camera2d.obj)
+		{
+			GLObject& obj{ objects[handle] };
+			obj.grid_id = object_grid.insert(obj.bbox_min, obj.bbox_max);
+			grid_objs.resize(std::max<size_t>(grid_objs.size(), obj.grid_id + 1));
+			grid_objs[obj.grid_id] = handle;
+		}
+	}
+
+	// Part 6: start worker threads used to update objects in parallel
+	JobSystem::init();
 }
 
 /*  _________________________________________________________________________ */
@@ -78,8 +254,29 @@ void GLApp::init()
  *
  * This function updates the GLApp by performing the following tasks:
  * 1. Updates the 2D camera using the GLHelper::ptr_window.
- * 2. Iterates through the objects container and calls the update function for
- *    each object, except for the camera object.
+ * 2. Advances the orientation of each object, except for the camera object.
+ *    Objects whose state_version differs from their mdl_version are gathered
+ *    with their position, scaling and orientation into arrays; objects whose
+ *    view_version alone differs from that of the camera are gathered into a
+ *    second array. The others keep their matrices.
+ * 3. Computes the model-to-world, model-to-NDC and model-to-map matrices of
+ *    the objects of the first array with XformBatch::compute and copies them
+ *    back to the objects together with their world space bounding boxes.
+ *    This gives the same matrices as GLObject::update. The objects are split
+ *    into jobs of update_grain objects run on the threads of JobSystem; each
+ *    job only writes to its own objects, so the results do not depend on the
+ *    number of threads. The model-to-NDC and model-to-map matrices of the
+ *    objects of the second array are computed from their current
+ *    model-to-world matrices.
+ * 4. Updates the bounding boxes that changed in GLApp::object_grid.
+ * 5. Cycles the number of threads if key T was pressed.
+ * 6. Cycles through the two-pass, single-pass and indirect rendering paths if
+ *    key M was pressed.
+ * 7. Switches viewport culling on or off if key C was pressed.
+ * 8. Switches levels of detail on or off if key L was pressed.
+ * 9. Prints benchmarks of the transform kernels, mesh loader and optimizer,
+ *    scene loader, spatial grid, rendering paths, object containers and
+ *    transform streaming if key B was pressed.
  *
  * @param none
  * @return void
@@ -87,19 +284,154 @@ void GLApp::init()
 void GLApp::update() 
 {
 		
+		// count matrices rebuilt and skipped during this frame only
+		mdl_xform_stats = XformStats{};
+		view_xform_stats = XformStats{};
+		camera_xform_stats = XformStats{};
+
 		// update camera
 		GLApp::camera2d.update(GLHelper::ptr_window);
 
 		// iterate through objects container
-		// for each object
-		for (auto& it : objects)
+		// gather every object except for camera object whose model-to-world
+		// matrix must be rebuilt, and separately those whose model-to-world
+		// matrix is current but whose model-to-ndc and model-to-map matrices
+		// were computed for an older camera
+		batch_objs.clear();
+		batch_position.clear();
+		batch_scaling.clear();
+		batch_angle.clear();
+		view_objs.clear();
+		for (GLObject& obj : objects)
+		{
+			if (&obj != camera2d.pgo)
+			{
+				if (obj.orientation.y != 0.f && GLHelper::delta_time != 0.0)
+				{
+					obj.orientation.x += obj.orientation.y * static_cast<float>(GLHelper::delta_time);
+					++obj.state_version;
+				}
+
+				if (obj.state_version != obj.mdl_version)
+				{
+					batch_objs.push_back(&obj);
+					batch_position.push_back(obj.position);
+					batch_scaling.push_back(obj.scaling);
+					batch_angle.push_back(obj.orientation.x);
+				}
+				else if (obj.view_version != camera2d.view_version)
+				{
+					view_objs.push_back(&obj);
+				}
+			}
+		}
+
+		size_t const cnt{ batch_objs.size() };
+		size_t const obj_cnt{ objects.size() - 1 };
+		mdl_xform_stats.rebuilt += static_cast<GLuint>(cnt);
+		mdl_xform_stats.skipped += static_cast<GLuint>(obj_cnt - cnt);
+		view_xform_stats.rebuilt += static_cast<GLuint>(cnt + view_objs.size());
+		view_xform_stats.skipped += static_cast<GLuint>(obj_cnt - cnt - view_objs.size());
+
+		batch_mdl.resize(cnt);
+		batch_ndc.resize(cnt);
+		batch_map.resize(cnt);
+		batch_moved.resize(cnt);
+
+		// model-to-world, model-to-ndc and model-to-map matrices
+		glm::mat3 const post_xforms[]{
+			glm::mat3{ 1.f },
+			camera2d.world_to_ndc_xform,
+			camera2d.world_map_to_ndc_xform
+		};
+		JobSystem::parallel_for(cnt, update_grain, [&post_xforms](size_t first, size_t last) {
+			glm::mat3* const outs[]{ batch_mdl.data() + first, batch_ndc.data() + first,
+									 batch_map.data() + first };
+			XformBatch::compute(batch_position.data() + first, batch_scaling.data() + first,
+								batch_angle.data() + first, last - first, post_xforms, outs, 3);
+
+			for (size_t i{ first }; i < last; ++i)
+			{
+				batch_objs[i]->mdl_xform = batch_mdl[i];
+				batch_objs[i]->mdl_to_ndc_xform = batch_ndc[i];
+				batch_objs[i]->mdl_to_map_xform = batch_map[i];
+				batch_objs[i]->mdl_version = batch_objs[i]->state_version;
+				batch_objs[i]->view_version = camera2d.view_version;
+
+				glm::vec2 const bbox_min{ batch_objs[i]->bbox_min }, bbox_max{ batch_objs[i]->bbox_max };
+				batch_objs[i]->update_bounds();
+				batch_moved[i] = (bbox_min != batch_objs[i]->bbox_min || bbox_max != batch_objs[i]->bbox_max);
+			}
+		});
+
+		// model-to-ndc and model-to-map matrices only
+		JobSystem::parallel_for(view_objs.size(), update_grain, [](size_t first, size_t last) {
+			for (size_t i{ first }; i < last; ++i)
+			{
+				GLObject& obj{ *view_objs[i] };
+				obj.mdl_to_ndc_xform = camera2d.world_to_ndc_xform * obj.mdl_xform;
+				obj.mdl_to_map_xform = camera2d.world_map_to_ndc_xform * obj.mdl_xform;
+				obj.view_version = camera2d.view_version;
+			}
+		});
+
+		// move the bounding boxes that changed in the spatial grid
+		for (size_t i{ 0 }; i < cnt; ++i)
 		{
-			// call update except for camera object
-			if (it.first != "Camera")
+			if (batch_moved[i])
 			{
-				it.second.update(GLHelper::delta_time);
+				object_grid.update(batch_objs[i]->grid_id, batch_objs[i]->bbox_min, batch_objs[i]->bbox_max);
 			}
 		}
+
+		// cycle number of threads updating objects through 1, 2, 4, ...
+		// up to the number of hardware threads if key 'T' is pressed
+		if (GLHelper::keystateT == GL_TRUE)
+		{
+			unsigned const threads{ JobSystem::get_thread_count() };
+			JobSystem::set_thread_count(threads >= JobSystem::max_thread_count() ? 1 : threads * 2);
+			GLHelper::keystateT = GL_FALSE;
+		}
+
+		// cycle through the two-pass, single-pass and indirect rendering
+		// of the main view and mini map if key 'M' is pressed
+		if (GLHelper::keystateM == GL_TRUE)
+		{
+			draw_path = (draw_path == DrawPath::two_pass) ? DrawPath::single_pass
+				: (draw_path == DrawPath::single_pass && indirect_supported == GL_TRUE) ? DrawPath::indirect
+				: DrawPath::two_pass;
+			GLHelper::keystateM = GL_FALSE;
+		}
+
+		// switch viewport culling on or off if key 'C' is pressed
+		if (GLHelper::keystateC == GL_TRUE)
+		{
+			cull_enabled = (cull_enabled == GL_TRUE) ? GL_FALSE : GL_TRUE;
+			GLHelper::keystateC = GL_FALSE;
+		}
+
+		// switch levels of detail on or off if key 'L' is pressed
+		if (GLHelper::keystateL == GL_TRUE)
+		{
+			lod_enabled = (lod_enabled == GL_TRUE) ? GL_FALSE : GL_TRUE;
+			GLHelper::keystateL = GL_FALSE;
+		}
+
+		// print throughput of the transform kernels, mesh loader and
+		// optimizer, scene loader, spatial grid, rendering paths, object
+		// containers and transform streaming if key 'B' is pressed
+		if (GLHelper::keystateB == GL_TRUE)
+		{
+			XformBatch::benchmark(32768);
+			MeshBin::benchmark();
+			MeshOpt::benchmark();
+			SceneBin::benchmark();
+			SpatialGrid::benchmark();
+			GLApp::benchmark_draw();
+			GLApp::benchmark_objects();
+			RingBuffer::benchmark(32768);
+			GLHelper::keystateB = GL_FALSE;
+		}
 }
 
 /*  _________________________________________________________________________ */
@@ -107,81 +439,550 @@ void GLApp::update()
  * @brief Draw the GLApp.
  *
  * This function draws the GLApp by performing the following tasks:
- * 1. Writes the window title with various information.
- * 2. Clears the back buffer.
- * 3. Sets the full viewport size.
- * 4. Renders each object in the GLApp::objects container, except for the camera object.
- * 5. Renders the camera object.
- * 6. Sets the map viewport size using GL_SCISSOR_TEST and glScissor.
- * 7. Clears the color and depth buffers.
- * 8. Renders each object in the GLApp::objects container, except for the camera object, in the map viewport.
- * 9. Renders the camera object in the map viewport.
- * 10. Disables GL_SCISSOR_TEST.
+ * 1. Collects the objects visible in each viewport with GLApp::cull.
+ * 2. Writes the window title with various information.
+ * 3. Clears the back buffer.
+ * 4. Renders the visible objects in the main and map viewports with
+ *    GLApp::draw_objects and records the CPU time it takes.
  *
  * @param none
  * @return void
 */
 void GLApp::draw()
 {
+	// skip objects outside of each viewport
+	GLApp::cull();
+
 	// write window title
 	std::stringstream title;
 
 	title << "Tutorial 4 | Brandon Ho Jun Jie | Camera Position (" << std::setprecision(2)
 		  << std::fixed << camera2d.cam_pos.x << ", " << std::setprecision(2)
-		  << camera2d.cam_pos.y << ") | Orientation: " << std::setprecision(0) << camera2d.pgo->orientation.x
-		  << " degrees | Window height: " << camera2d.height << " | FPS: " << std::setprecision(2) << GLHelper::fps;
+		  << camera2d.cam_pos.y << ") | Orientation: " << std::setprecision(0) << objects[camera2d.obj].orientation.x
+		  << " degrees | Window height: " << camera2d.height << " | Threads: " << JobSystem::get_thread_count()
+		  << " | Lookups avoided: " << GLSLShader::GetLookupsAvoided()
+		  << " | Visible: " << main_cull_stats.visible << " (culled " << main_cull_stats.culled
+		  << "), map: " << map_cull_stats.visible << " (culled " << map_cull_stats.culled << ")"
+		  << (cull_enabled == GL_TRUE ? "" : " [culling off]")
+		  << " | " << draw_path_names[static_cast<GLuint>(draw_path)] << ": " << draw_call_cnt
+		  << " draws, " << submitted_idx_cnt << " indices"
+		  << (lod_enabled == GL_TRUE ? "" : " [LOD off]")
+		  << ", " << std::setprecision(3) << draw_cpu_time * 1000.0 << " ms"
+		  << " | Binds skipped: program " << queue_stats.pgm_skipped << "/" << queue_stats.draws
+		  << ", VAO " << queue_stats.vao_skipped << "/" << queue_stats.draws
+		  << " | Ring stalls: " << frame_ring.get_stall_count()
+		  << " | Rebuilt/skipped: model " << mdl_xform_stats.rebuilt << "/" << mdl_xform_stats.skipped
+		  << ", view " << view_xform_stats.rebuilt << "/" << view_xform_stats.skipped
+		  << ", camera " << camera_xform_stats.rebuilt << "/" << camera_xform_stats.skipped
+		  << " | FPS: " << std::setprecision(2) << GLHelper::fps;
 	
 	glfwSetWindowTitle(GLHelper::ptr_window, title.str().c_str());
 
+	// count uniform lookups avoided during this frame only
+	GLSLShader::ResetLookupsAvoided();
+
 	// clear back buffer
 	glClear(GL_COLOR_BUFFER_BIT);
 
-	// set full viewport size
-	glViewport(0, 0, GLHelper::width, GLHelper::height);
+	GLdouble const start{ glfwGetTime() };
+	GLApp::draw_objects();
+	draw_cpu_time = glfwGetTime() - start;
+}
+
+/*  _________________________________________________________________________ */
+/*! GLApp::draw_objects
+ * @brief Render the visible objects in the main and map viewports.
+ *
+ * If GLApp::draw_path is DrawPath::two_pass, the objects are rendered in two passes:
+ * 1. Sets the full viewport size.
+ * 2. Renders each object visible in the main viewport, except for the camera object.
+ * 3. Renders the camera object.
+ * 4. Sets the map viewport size using GL_SCISSOR_TEST and glScissor.
+ * 5. Clears the color and depth buffers.
+ * 6. Renders each object visible in the map viewport, except for the camera object.
+ * 7. Renders the camera object in the map viewport.
+ * 8. Disables GL_SCISSOR_TEST.
+ *
+ * Otherwise the world-to-NDC matrices of both viewports and the map rectangle
+ * are written to the region of this frame of a persistently mapped RingBuffer
+ * and bound as a uniform buffer range, viewport 0 is set to the whole window and
+ * viewport 1 to the map, and each object is rendered with a single draw call
+ * whose geometry shader emits every triangle to both viewports. The objects
+ * submitted are those visible in either viewport, merged from main_visible
+ * and map_visible in the order of their ids. Their model-to-world matrices
+ * and colors, followed by the camera's, are written to the same region and
+ * bound as a shader storage buffer range, so each draw call only sets the
+ * index of its object's data, which the vertex shader fetches. The fragment
+ * shader keeps the main view out of the map rectangle, which replaces the
+ * scissored clear of the two-pass path.
+ *
+ * With DrawPath::indirect the same viewports and geometry shader are used, but
+ * instead of one draw call per object a command per object, drawing the
+ * object's range of GLApp::mesh_arena, is written to the same region, which
+ * is then bound as the GL_DRAW_INDIRECT_BUFFER. The region is fenced after
+ * the last draw call, so it is only rewritten once the GPU has read it,
+ * while the CPU fills the regions of the next frames. One
+ * glMultiDrawElementsIndirect call draws each run of consecutive objects
+ * sharing a primitive type and index type; the vertex shader fetches the
+ * per-object data with gl_DrawIDARB.
+ *
+ * In the other paths the objects other than the camera are not drawn one by
+ * one but pushed to a RenderQueue, which installs a program or binds a VAO
+ * only when it differs from that of the previous draw call. There is no
+ * depth test, so no path reorders the objects: they are drawn in the order
+ * of their ids, which follows their names, and the camera object is drawn
+ * last so that it stays on top.
+ *
+ * Every object is drawn at the level of detail of its model picked from the
+ * pixels a model space unit of the object covers in the viewport: per
+ * viewport in the two-pass path, and for the viewport needing the finer
+ * level in the other paths, whose single draw reaches both viewports.
+ *
+ * The number of draw calls made is stored in GLApp::draw_call_cnt, the
+ * indices they draw in GLApp::submitted_idx_cnt, and the binds made and
+ * skipped by the render queue in GLApp::queue_stats.
+ *
+ * @param none
+ * @return void
+*/
+void GLApp::draw_objects()
+{
+	draw_call_cnt = 0;
+	submitted_idx_cnt = 0;
+	queue_stats = RenderQueue::Stats{};
+
+	// add a draw call of obj at the level of detail of px_per_unit to the
+	// render queue
+	auto queue_object = [](GLObject const& obj, GLSLShader& shdr_pgm, glm::mat3 const& xform,
+		GLfloat px_per_unit, GLuint draw_idx = 0)
+	{
+		GLModel const& model{ models[obj.mdl_ref] };
+		MeshLod::Level const& lod{ model.lod(px_per_unit) };
+		render_queue.push(RenderQueue::Item{ &shdr_pgm, model.mesh.vaoid,
+			model.primitive_type, lod.cnt, model.idx_offset(lod), model.mesh.idx_type,
+			&obj.color, &xform, draw_idx });
+		submitted_idx_cnt += lod.cnt;
+	};
+
+	// make the draw calls of the render queue, passing uniforms on to
+	// RenderQueue::submit, and add up its statistics
+	auto submit_queue = [](auto... uniforms)
+	{
+		render_queue.submit(uniforms...);
+		RenderQueue::Stats const& stats{ render_queue.get_stats() };
+		queue_stats.draws += stats.draws;
+		queue_stats.pgm_binds += stats.pgm_binds;
+		queue_stats.pgm_skipped += stats.pgm_skipped;
+		queue_stats.vao_binds += stats.vao_binds;
+		queue_stats.vao_skipped += stats.vao_skipped;
+		draw_call_cnt += stats.draws;
+	};
+
+	GLint const map_x{ GLHelper::width - GLHelper::width / 4 };
+	GLint const map_w{ GLHelper::width / 4 }, map_h{ GLHelper::height / 4 };
+
+	if (draw_path != DrawPath::two_pass)
+	{
+		// objects visible in either viewport, each rendered once
+		both_visible.clear();
+		std::set_union(main_visible.begin(), main_visible.end(), map_visible.begin(), map_visible.end(),
+			std::back_inserter(both_visible), [](GLObject const* lhs, GLObject const* rhs) {
+				return lhs->grid_id < rhs->grid_id;
+			});
+
+		// per-frame data is written straight into the region of this frame
+		// of frame_ring; reserve room for the views, per-draw data for every
+		// object and the camera and, in the indirect path, a command for
+		// every object
+		GLsizeiptr const views_size{ sizeof(GLfloat) * 28 };
+		GLsizeiptr const data_size{ static_cast<GLsizeiptr>(sizeof(DrawData) * (both_visible.size() + 1)) };
+		GLsizeiptr frame_size{ views_size + data_size + 2 * RingBuffer::region_alignment };
+		if (draw_path == DrawPath::indirect)
+		{
+			frame_size += static_cast<GLsizeiptr>(sizeof(DrawCommand) * both_visible.size())
+				+ RingBuffer::region_alignment;
+		}
+		frame_ring.begin_frame();
+		frame_ring.reserve(frame_size);
+
+		// std140 layout: each mat3 column takes a vec4
+		RingBuffer::Allocation const views_alloc{ frame_ring.allocate(views_size, ubo_alignment) };
+		GLfloat* const views{ static_cast<GLfloat*>(views_alloc.ptr) };
+		glm::mat3 const* const xforms[]{ &camera2d.world_to_ndc_xform, &camera2d.world_map_to_ndc_xform };
+		for (int v{ 0 }; v < 2; ++v)
+		{
+			for (int c{ 0 }; c < 3; ++c)
+			{
+				for (int r{ 0 }; r < 3; ++r)
+				{
+					views[v * 12 + c * 4 + r] = (*xforms[v])[c][r];
+				}
+			}
+		}
+		views[24] = static_cast<GLfloat>(map_x);
+		views[25] = 0.f;
+		views[26] = static_cast<GLfloat>(map_x + map_w);
+		views[27] = static_cast<GLfloat>(map_h);
+		glBindBufferRange(GL_UNIFORM_BUFFER, 0, frame_ring.get_buffer(), views_alloc.offset, views_size);
+
+		glViewportIndexedf(0, 0.f, 0.f, static_cast<GLfloat>(GLHelper::width), static_cast<GLfloat>(GLHelper::height));
+		glViewportIndexedf(1, static_cast<GLfloat>(map_x), 0.f, static_cast<GLfloat>(map_w), static_cast<GLfloat>(map_h));
+
+		// model-to-world matrix and color of each object, fetched by the
+		// vertex shader; the camera's follow those of both_visible
+		RingBuffer::Allocation const data_alloc{ frame_ring.allocate(data_size, ssbo_alignment) };
+		DrawData* const data{ static_cast<DrawData*>(data_alloc.ptr) };
+		auto const write_data = [](DrawData& draw, GLObject const& obj) {
+			draw.mdl_to_world[0] = glm::vec4{ obj.mdl_xform[0], 0.f };
+			draw.mdl_to_world[1] = glm::vec4{ obj.mdl_xform[1], 0.f };
+			draw.mdl_to_world[2] = glm::vec4{ obj.mdl_xform[2], 0.f };
+			draw.color = glm::vec4{ obj.color, 1.f };
+		};
+		GLuint const camera_idx{ static_cast<GLuint>(both_visible.size()) };
+		write_data(data[camera_idx], objects[camera2d.obj]);
+		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 1, frame_ring.get_buffer(), data_alloc.offset, data_size);
 
-	// Render each object in container GLApp::objects
-	for (auto const& obj : objects) {
-		if (obj.first != "Camera")
+		if (draw_path == DrawPath::single_pass)
 		{
-			obj.second.draw(GL_FALSE); // call member function GLObject::draw()
+			GLSLShader& shdr_pgm{ shdrpgms[multiview_shd_ref] };
+			render_queue.clear();
+			for (GLuint i{ 0 }; i < camera_idx; ++i) {
+				GLObject const& obj{ *both_visible[i] };
+				write_data(data[i], obj);
+				queue_object(obj, shdr_pgm, obj.mdl_xform,
+					std::max(obj.px_per_unit(GL_FALSE), obj.px_per_unit(GL_TRUE)), i);
+			}
+			submit_queue(uDrawIndex);
+		}
+		else
+		{
+			// command i draws object i; each glMultiDrawElementsIndirect call
+			// draws a single primitive type from the element buffer of a
+			// single index type, so a call is made per run of objects
+			// sharing both, which keeps the order of the objects
+			GLsizei const cnt{ static_cast<GLsizei>(camera_idx) };
+			if (cnt > 0)
+			{
+				RingBuffer::Allocation const cmd_alloc{ frame_ring.allocate(sizeof(DrawCommand) * cnt, sizeof(GLuint)) };
+				DrawCommand* const cmds{ static_cast<DrawCommand*>(cmd_alloc.ptr) };
+				draw_batches.clear();
+				for (GLsizei i{ 0 }; i < cnt; ++i)
+				{
+					GLObject const& obj{ *both_visible[i] };
+					GLModel const& model{ models[obj.mdl_ref] };
+					MeshArena::Range const& range{ model.arena_range };
+					if (draw_batches.empty() || draw_batches.back().primitive_type != model.primitive_type ||
+						draw_batches.back().idx_type != range.idx_type)
+					{
+						draw_batches.push_back(DrawBatch{ model.primitive_type, range.idx_type, i, 0 });
+					}
+					++draw_batches.back().cnt;
+
+					MeshLod::Level const& lod{ model.lod(
+						std::max(obj.px_per_unit(GL_FALSE), obj.px_per_unit(GL_TRUE))) };
+					cmds[i] = DrawCommand{ lod.cnt, 1, range.first_index + lod.first, range.base_vertex, 0 };
+					submitted_idx_cnt += lod.cnt;
+					write_data(data[i], obj);
+				}
+
+				GLSLShader& shdr_pgm{ shdrpgms[indirect_shd_ref] };
+				shdr_pgm.Use();
+				glBindBuffer(GL_DRAW_INDIRECT_BUFFER, frame_ring.get_buffer());
+				for (DrawBatch const& batch : draw_batches)
+				{
+					// gl_DrawIDARB restarts at 0 in every call
+					shdr_pgm.SetUniform(uDrawOffset, static_cast<GLuint>(batch.first));
+					glBindVertexArray(mesh_arena.get_vaoid(batch.idx_type));
+					glMultiDrawElementsIndirect(batch.primitive_type, batch.idx_type,
+						reinterpret_cast<void const*>(cmd_alloc.offset + sizeof(DrawCommand) * batch.first),
+						batch.cnt, 0);
+					++draw_call_cnt;
+				}
+				glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+				glBindVertexArray(0);
+				shdr_pgm.UnUse();
+			}
 		}
+
+		objects[camera2d.obj].draw_multiview(camera_idx);
+		frame_ring.end_frame();
+
+		// set every viewport back to the full window
+		glViewport(0, 0, GLHelper::width, GLHelper::height);
+		return;
+	}
+
+	// set full viewport size
+	glViewport(0, 0, GLHelper::width, GLHelper::height);
+
+	// Render each object visible in the main viewport
+	render_queue.clear();
+	for (GLObject const* obj : main_visible) {
+		queue_object(*obj, shdrpgms[obj->shd_ref], obj->mdl_to_ndc_xform,
+			obj->px_per_unit(GL_FALSE));
 	}
+	submit_queue(uColor, uModel_to_NDC);
 
-	objects["Camera"].draw(GL_FALSE);
+	objects[camera2d.obj].draw(GL_FALSE);
 
 	// set map viewport size
 	glEnable(GL_SCISSOR_TEST);
 
 	// restricts rendering to designated area
-	glScissor(GLHelper::width - GLHelper::width / 4, 0, GLHelper::width / 4, GLHelper::height / 4);
+	glScissor(map_x, 0, map_w, map_h);
 
 	// set viewport size to bottom right corner of the window
-	glViewport(GLHelper::width - GLHelper::width / 4, 0, GLHelper::width / 4, GLHelper::height / 4);
+	glViewport(map_x, 0, map_w, map_h);
 
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	// Render each object again in the minimap area
-	for (auto const& obj : objects) {
-		if (obj.first != "Camera")
+	// Render each object visible in the minimap area
+	render_queue.clear();
+	for (GLObject const* obj : map_visible) {
+		queue_object(*obj, shdrpgms[obj->shd_ref], obj->mdl_to_map_xform,
+			obj->px_per_unit(GL_TRUE));
+	}
+	submit_queue(uColor, uModel_to_NDC);
+
+	objects[camera2d.obj].draw(GL_TRUE);
+	glDisable(GL_SCISSOR_TEST);
+}
+
+/*  _________________________________________________________________________ */
+/*! GLApp::benchmark_draw
+ * @brief Print draw calls and CPU time of every rendering path.
+ *
+ * This function adds 1024, 8192 and then 100000 copies of the objects other
+ * than the camera to GLApp::objects, taking each object in turn so that
+ * every model is drawn, placed at random where the camera and mini map
+ * windows overlap so that they are visible in both viewports, or in the
+ * camera window if the windows do not overlap. Each rendering path renders
+ * a number of frames and the average number of draw calls and CPU time spent
+ * in GLApp::draw_objects per frame are printed. glFinish is called after
+ * each frame, outside of the measured time, so that the GPU does not fall
+ * behind.
+ * The copies are removed afterwards.
+ *
+ * @param none
+ * @return void
+*/
+void GLApp::benchmark_draw()
+{
+	DrawPath const saved_path{ draw_path };
+	int const frames{ 60 };
+	size_t const counts[]{ 1024, 8192, 100000 };
+	int const path_cnt{ indirect_supported == GL_TRUE ? 3 : 2 };
+
+	std::vector<GLObject> prototypes;
+	for (ObjectHandle handle : grid_objs)
+	{
+		prototypes.push_back(objects[handle]);
+	}
+	if (prototypes.empty())
+	{
+		return;
+	}
+
+	// area where the copies are placed
+	glm::vec2 lo{ glm::max(camera2d.win_min, camera2d.map_min) };
+	glm::vec2 hi{ glm::min(camera2d.win_max, camera2d.map_max) };
+	if (lo.x > hi.x || lo.y > hi.y)
+	{
+		lo = camera2d.win_min;
+		hi = camera2d.win_max;
+	}
+	size_t const grid_cnt{ grid_objs.size() };
+
+	std::uint32_t seed{ 1 };
+	auto random = [&seed](float lo, float hi) {
+		seed = seed * 1664525u + 1013904223u;
+		return lo + (hi - lo) * static_cast<float>(seed >> 8) / 16777216.f;
+	};
+
+	std::cout << "Objects\t|\tTwo-pass draws\t|\tCPU (ms)\t|\tSingle-pass draws\t|\tCPU (ms)"
+			  << "\t|\tIndirect draws\t|\tCPU (ms)\n";
+	std::cout << "------------------------------------------------------------------------------------------------------------------------------------\n";
+	for (size_t cnt : counts)
+	{
+		std::vector<ObjectHandle> added;
+		for (size_t i{ 0 }; i < cnt; ++i)
+		{
+			GLObject obj{ prototypes[i % prototypes.size()] };
+			obj.position = glm::vec2{ random(lo.x, hi.x), random(lo.y, hi.y) };
+			++obj.state_version;
+			obj.update(0.0);
+			obj.grid_id = object_grid.insert(obj.bbox_min, obj.bbox_max);
+
+			added.push_back(objects.insert(obj));
+			grid_objs.resize(std::max<size_t>(grid_objs.size(), obj.grid_id + 1));
+			grid_objs[obj.grid_id] = added.back();
+		}
+		GLApp::cull();
+
+		GLuint draws[3]{};
+		double cpu_ms[3]{};
+		for (int mode{ 0 }; mode < path_cnt; ++mode)
+		{
+			draw_path = static_cast<DrawPath>(mode);
+
+			double cpu_time{ 0.0 };
+			for (int f{ 0 }; f < frames; ++f)
+			{
+				glClear(GL_COLOR_BUFFER_BIT);
+				double const start{ glfwGetTime() };
+				GLApp::draw_objects();
+				cpu_time += glfwGetTime() - start;
+				glFinish();
+			}
+			draws[mode] = draw_call_cnt;
+			cpu_ms[mode] = cpu_time * 1000.0 / frames;
+		}
+
+		std::cout << cnt << "\t\t" << draws[0] << "\t\t\t" << std::setprecision(3) << std::fixed
+				  << cpu_ms[0] << "\t\t" << draws[1] << "\t\t\t" << cpu_ms[1] << "\t\t";
+		if (path_cnt > 2)
+		{
+			std::cout << draws[2] << "\t\t\t" << cpu_ms[2] << "\n";
+		}
+		else
 		{
-			obj.second.draw(GL_TRUE); // call member function GLObject::draw()
+			std::cout << "-\t\t\t-\n";
 		}
+
+		// remove the copies last to first, which keeps the order of the
+		// other objects
+		for (auto it{ added.rbegin() }; it != added.rend(); ++it)
+		{
+			object_grid.remove(objects[*it].grid_id);
+			objects.erase(*it);
+		}
+		grid_objs.resize(grid_cnt);
 	}
+	std::cout << "------------------------------------------------------------------------------------------------------------------------------------\n";
+	std::cout << std::defaultfloat;
 
-	objects["Camera"].draw(GL_TRUE);
-	glDisable(GL_SCISSOR_TEST);
+	draw_path = saved_path;
+	GLApp::cull();
+}
+
+/*  _________________________________________________________________________ */
+/*! GLApp::benchmark_objects
+ * @brief Print the per-frame cost of visiting every object of a string-keyed
+ * std::map and of a slot map.
+ *
+ * For 1k, 10k and 100k copies of the first object and a camera object, each
+ * container is visited the way GLApp::update and GLObject::update visited
+ * it. With the std::map every object is compared with the name "Camera" and
+ * looks up the camera object by name, as GLObject::update did before objects
+ * were stored in a slot map. With the slot map every object is compared with
+ * the address of the camera object and its model is found through its
+ * handle. Both visits advance the orientation of every object and add up the
+ * draw counts of their models, which must agree. The average time of a frame
+ * is printed for each container.
+ *
+ * @param none
+ * @return void
+*/
+void GLApp::benchmark_objects()
+{
+	if (grid_objs.empty())
+	{
+		return;
+	}
+	GLObject const prototype{ objects[grid_objs.front()] };
+	GLModel const model{ models[prototype.mdl_ref] };
+	int const frames{ 30 };
+	size_t const counts[]{ 1000, 10000, 100000 };
+	GLfloat const dt{ 1.f / 60.f };
+
+	std::cout << "Objects\t|\tstd::map (ms/frame)\t|\tSlotMap (ms/frame)\t|\tSpeedup\t|\tSame result\n";
+	std::cout << "------------------------------------------------------------------------------------------------------------\n";
+	for (size_t cnt : counts)
+	{
+		// containers as they were and as they are
+		std::map<std::string, GLModel> map_models{ { "model", model } };
+		std::map<std::string, GLObject> map_objs;
+		SlotMap<GLModel> slot_models;
+		SlotMap<GLObject> slot_objs;
+		GLObject obj{ prototype };
+		obj.mdl_ref = slot_models.insert(model);
+		slot_objs.reserve(cnt + 1);
+
+		std::map<std::string, GLModel>::iterator const map_mdl{ map_models.begin() };
+		std::string const digits{ std::to_string(cnt) };
+		for (size_t i{ 0 }; i < cnt; ++i)
+		{
+			std::string const num{ std::to_string(i) };
+			map_objs.emplace("Object" + std::string(digits.size() - num.size(), '0') + num, obj);
+			slot_objs.insert(obj);
+		}
+		map_objs.emplace("Camera", obj);
+		ObjectHandle const camera{ slot_objs.insert(obj) };
+
+		std::uint64_t map_sum{ 0 }, slot_sum{ 0 };
+		GLdouble start{ glfwGetTime() };
+		for (int f{ 0 }; f < frames; ++f)
+		{
+			for (auto& it : map_objs)
+			{
+				if (it.first != "Camera")
+				{
+					GLObject& o{ it.second };
+					if (&map_objs["Camera"] != &o)
+					{
+						o.orientation.x += o.orientation.y * dt;
+						++o.state_version;
+					}
+					map_sum += map_mdl->second.draw_cnt;
+				}
+			}
+		}
+		GLdouble const map_ms{ (glfwGetTime() - start) * 1000.0 / frames };
+
+		start = glfwGetTime();
+		for (int f{ 0 }; f < frames; ++f)
+		{
+			GLObject const* const cam{ &slot_objs[camera] };
+			for (GLObject& o : slot_objs)
+			{
+				if (&o != cam)
+				{
+					o.orientation.x += o.orientation.y * dt;
+					++o.state_version;
+					slot_sum += slot_models[o.mdl_ref].draw_cnt;
+				}
+			}
+		}
+		GLdouble const slot_ms{ (glfwGetTime() - start) * 1000.0 / frames };
+
+		std::cout << cnt << "\t\t" << std::setprecision(3) << std::fixed << map_ms << "\t\t\t"
+				  << slot_ms << "\t\t\t" << std::setprecision(1) << map_ms / slot_ms << "x\t\t"
+				  << (map_sum == slot_sum ? "yes" : "NO") << "\n";
+	}
+	std::cout << "------------------------------------------------------------------------------------------------------------\n";
+	std::cout << std::defaultfloat;
 }
 
 /*  _________________________________________________________________________ */
 /*! GLApp::cleanup
- * @brief Empty.
+ * @brief Stop the worker threads and free the frame ring, arenas and models.
  * 
  * @param none
  * @return none
 */
 void GLApp::cleanup()
 {
-  // empty for now
+  JobSystem::cleanup();
+  frame_ring.destroy();
+  mesh_arena.destroy();
+
+  for (GLModel& model : models) {
+    MeshBin::destroy(buffer_arena, model.mesh);
+  }
+  models.clear();
+  model_names.clear();
+  buffer_arena.report("GPU buffer arena at cleanup");
+  buffer_arena.destroy();
 }
 
 
@@ -196,19 +997,28 @@ void GLApp::cleanup()
  * @param[in] shdr_pgm_name The name of the shader program.
  * @param[in] vtx_shdr_name The name of the vertex shader file.
  * @param[in] frg_shdr_name The name of the fragment shader file.
+ * @param[in] geom_shdr_name The name of the geometry shader file, or an empty
+ * string if the shader program has no geometry shader.
  * @return void
 */
 void GLApp::init_shdrpgms(std::string shdr_pgm_name,
 	std::string vtx_shdr_name,
-	std::string frg_shdr_name)
+	std::string frg_shdr_name,
+	std::string geom_shdr_name)
 {
 	std::vector<std::pair<GLenum, std::string>> shdr_files{
 		std::make_pair(GL_VERTEX_SHADER, vtx_shdr_name),
 		std::make_pair(GL_FRAGMENT_SHADER, frg_shdr_name)
 	};
+	if (!geom_shdr_name.empty())
+	{
+		shdr_files.emplace_back(std::make_pair(GL_GEOMETRY_SHADER, geom_shdr_name));
+	}
 
+	GLdouble const start{ glfwGetTime() };
 	GLSLShader shdr_pgm;
 	shdr_pgm.CompileLinkValidate(shdr_files);
+	shdrpgm_time += glfwGetTime() - start;
 	if (GL_FALSE == shdr_pgm.IsLinked())
 	{
 		std::cout << "Unable to compile/link/validate shader programs\n";
@@ -217,105 +1027,117 @@ void GLApp::init_shdrpgms(std::string shdr_pgm_name,
 	}
 
 	// add compiled, linked and validated shader program to
-	// std::map container GLApp::shdrpgms
-	GLApp::shdrpgms[shdr_pgm_name] = shdr_pgm;
+	// slot map GLApp::shdrpgms, replacing a program of the same name
+	auto const it{ shdrpgm_names.find(shdr_pgm_name) };
+	if (it != shdrpgm_names.end())
+	{
+		shdrpgms[it->second] = shdr_pgm;
+		return;
+	}
+	shdrpgm_names.emplace(std::move(shdr_pgm_name), shdrpgms.insert(shdr_pgm));
 }
 
 /*  _________________________________________________________________________ */
 /*! GLApp::init_scene
 *@brief Initialize the scene from a scene file.
 *
-* This function initializes the scene by reading and parsing a scene file.It reads
-* each object's parameters from the file and performs the following tasks:
-* 1. Instantiates a GLObject.
-* 2. Reads object parameters.
-* 3. If model name is not in the GLApp::models container, it adds the model by
-*    calling GLApp::init_models_cont().
-* 4. If shader program name is not in the GLApp::shdrpgms container, it adds the
-*    shader program by calling GLApp::init_shdrpgms().
-* 5. Sets the object's model reference (mdl_ref) to point to the corresponding
-*    model in the GLApp::models container.
-* 6. Sets the object's shader reference (shd_ref) to point to the corresponding
-*    shader program in the GLApp::shdrpgms container.
-* 7. Inserts the instantiated object into the GLApp::objects container.
+* This function initializes the scene from a scene file. It performs the
+* following tasks:
+* 1. Converts the text scene file to a binary scene file (.scnb) next to it if
+*    the binary file is missing or older than the text file, and reads the
+*    memory-mapped binary file. If no binary scene file can be produced, the
+*    text scene file is read instead.
+* 2. If a model of the scene is not in the GLApp::models container, it adds
+*    the model by calling GLApp::init_models_cont().
+* 3. If a shader program of the scene is not in the GLApp::shdrpgms container,
+*    it adds the shader program by calling GLApp::init_shdrpgms().
+* 4. Instantiates a GLObject for each object and sets its parameters.
+* 5. Sets the object's model handle (mdl_ref) to the corresponding model in
+*    the GLApp::models container.
+* 6. Sets the object's shader handle (shd_ref) to the corresponding shader
+*    program in the GLApp::shdrpgms container.
+* 7. Inserts the instantiated object into the GLApp::objects container and
+*    indexes its handle by name in GLApp::object_names.
+*
+* Models and shader programs are found by name through GLApp::model_names
+* and GLApp::shdrpgm_names. Objects are inserted in the order of their names,
+* which is the order they are updated and drawn in; objects of a binary scene
+* file are already sorted by name.
 *
 * @param[in] scene_filename The name of the scene file.
 * @return void
 */
 void GLApp::init_scene(std::string scene_filename)
 {
-	std::ifstream ifs{ scene_filename, std::ios::in };
+	GLdouble const start{ glfwGetTime() };
 
-	if (!ifs)
+	SceneBin::Scene scene;
+	std::string const bin_filename{ SceneBin::ensure_binary(scene_filename) };
+	if (bin_filename.empty() || GL_FALSE == SceneBin::read(bin_filename, scene))
 	{
-		std::cout << "ERROR: Unable to open scene file: "
-				  << scene_filename << "\n";
-		exit(EXIT_FAILURE);
+		// fall back to the text scene file
+		if (GL_FALSE == SceneBin::read_text(scene_filename, scene))
+		{
+			std::cout << "ERROR: Unable to open scene file: "
+					  << scene_filename << "\n";
+			exit(EXIT_FAILURE);
+		}
 	}
+	scene_time = glfwGetTime() - start;
 
-	ifs.seekg(0, std::ios::beg);
-
-	std::string line;
-	std::getline(ifs, line); // first line is count of objects in scene
-	std::istringstream line_sstm{ line };
-	int obj_cnt;
-	line_sstm >> obj_cnt; // read count of objects in scene
-	while (obj_cnt--) // read each object's parameters
+	// if a model is not in models container, add it
+	std::vector<SlotMap<GLModel>::Handle> mdl_refs;
+	for (std::string const& model_name : scene.models)
 	{
-		GLObject obj{};
-
-		std::getline(ifs, line); // 1st parameter - model name
-		std::istringstream line_modelname{ line };
-		std::string model_name;
-		line_modelname >> model_name;
-
-		std::getline(ifs, line); // 2nd parameter - object name
-		std::istringstream line_objectname{ line };
-		std::string object_name;
-		line_objectname >> object_name;
-
-		std::getline(ifs, line); // 3rd parameter - shader program details
-		std::istringstream line_shdr_pgm{ line };
-		std::string shdr_pgm_name, vtx_shdr_filename, frg_shdr_filename;
-		line_shdr_pgm >> shdr_pgm_name >> 
-		vtx_shdr_filename >> frg_shdr_filename;
-
-		std::getline(ifs, line); // 4th parameter - object rgb parameters
-		std::istringstream  line_rgb{ line };
-		line_rgb >> obj.color.r >> obj.color.g >> obj.color.b;
-		
-		std::getline(ifs, line);  // 5th parameter - object scaling factors
-		std::istringstream line_scale{ line };
-		line_scale >> obj.scaling.x >> obj.scaling.y;
-
-		std::getline(ifs, line); // 6th parameter - object orientation factors
-		std::istringstream line_ort{ line };
-		line_ort >> obj.orientation.x >> obj.orientation.y;
-
-		std::getline(ifs, line); // 7th parameter - object position in world
-		std::istringstream line_pos{ line };
-		line_pos >> obj.position.x >> obj.position.y;
-
-		// if model_name is not in models container, add it
-		if (!GLApp::models.contains(model_name))
+		if (!GLApp::model_names.contains(model_name))
 		{
 			GLApp::init_models_cont("../meshes/" + model_name + ".msh");
-		}		
+		}
+		mdl_refs.emplace_back(model_names.at(model_name));
+	}
 
-		// if shdr_pgm_name is not in shdrpgms container, add it
-		if (!GLApp::shdrpgms.contains(shdr_pgm_name))
+	// if a shader program is not in shdrpgms container, add it
+	std::vector<SlotMap<GLSLShader>::Handle> shd_refs;
+	for (SceneBin::ShdrPgm const& shdr_pgm : scene.shdrpgms)
+	{
+		if (!GLApp::shdrpgm_names.contains(shdr_pgm.name))
 		{
-			GLApp::init_shdrpgms(shdr_pgm_name, vtx_shdr_filename, frg_shdr_filename);
+			GLApp::init_shdrpgms(shdr_pgm.name, shdr_pgm.vtx_shdr, shdr_pgm.frg_shdr);
 		}
+		shd_refs.emplace_back(shdrpgm_names.at(shdr_pgm.name));
+	}
+
+	// objects are drawn in the order of their names; a binary scene file
+	// is already sorted
+	std::stable_sort(scene.objects.begin(), scene.objects.end(),
+		[](SceneBin::Object const& lhs, SceneBin::Object const& rhs) { return lhs.name < rhs.name; });
+	objects.reserve(objects.size() + scene.objects.size());
+
+	for (SceneBin::Object& scene_obj : scene.objects)
+	{
+		GLObject obj{};
+		obj.color = scene_obj.color;
+		obj.scaling = scene_obj.scaling;
+		obj.orientation = scene_obj.orientation;
+		obj.position = scene_obj.position;
 
-		// set mdl_ref to point to model 
-		obj.mdl_ref = models.find(model_name);
+		// set mdl_ref to point to model
+		obj.mdl_ref = mdl_refs[scene_obj.model];
 
 		// set shd_ref to point to shader program
-		obj.shd_ref = shdrpgms.find(shdr_pgm_name);
+		obj.shd_ref = shd_refs[scene_obj.shdrpgm];
 
-		// insert instantiated object into objects container
-		objects[object_name] = obj;		
+		// insert instantiated object into objects container; an object
+		// with the name of an earlier object replaces it
+		auto const it{ object_names.find(scene_obj.name) };
+		if (it != object_names.end())
+		{
+			objects[it->second] = obj;
+		}
+		else
+		{
+			object_names.emplace(std::move(scene_obj.name), objects.insert(obj));
+		}
 	}
 }
 
@@ -323,118 +1145,89 @@ void GLApp::init_scene(std::string scene_filename)
 /*! GLApp::init_models_cont()
  * @brief Initialize the models container from a model file.
  *
- * This function initializes the models container by reading and parsing a model file.
- * It reads each vertex and index data from the file and performs the following tasks:
- * 1. Reads the vertex and index data from the file.
- * 2. Creates and stores the vertex buffer object (VBO) and vertex array object (VAO) for the model.
- * 3. Generates a VAO handle to encapsulate the VBO(s) and state of this triangle mesh.
- * 4. Defines the VAO handle, enables vertex array attribute 0, and sets up vertex attribute format and binding.
- * 5. Creates and stores the element buffer object (EBO) for the model.
- * 6. Binds the VAO and EBO to the vertex array.
- * 7. Sets the VAO ID, draw count, and primitive count for the model.
- * 8. Inserts the model into the GLApp::models container with the key model_name.
+ * This function initializes the models container from a model file. It
+ * performs the following tasks:
+ * 1. Converts the text model file to a binary model file (.mshb) next to it
+ *    if the binary file is missing or older than the text file. Conversion
+ *    builds coarser levels of detail of models made of triangle fans
+ *    (MeshLod::decimate_fans), turns the fans into triangle lists and
+ *    reorders the triangles and vertices for the vertex cache
+ *    (MeshBin::prepare).
+ * 2. Memory-maps the binary model file, allocates the vertex and index
+ *    ranges of the model from GLApp::buffer_arena directly from the mapped
+ *    vertex and index data, and creates the VAO of the model.
+ * 3. If no binary model file can be produced, reads the vertex and index data
+ *    from the text model file, optimizes it the same way and uploads it.
+ *    Either way the indices are of the smallest type able to address every
+ *    vertex of the model (MeshIndex::type).
+ * 4. Prints the ACMR of the model before and after optimization and its
+ *    levels of detail, sets the draw count and primitive count for the
+ *    model from its finest level, and adds it to GLApp::mesh_arena, which
+ *    copies every level when it is built.
+ * 5. Inserts the model into the GLApp::models container and indexes its
+ *    handle by model_name in GLApp::model_names. A model of the same name
+ *    loaded before is replaced, removed from GLApp::mesh_arena and its
+ *    ranges are freed.
  *
  * @param[in] model_filename The name of the model file.
  * @return void
 */
 void GLApp::init_models_cont(std::string model_filename)
 {
-	std::ifstream ifs{model_filename, std::ios::in };
-
-	if (!ifs)
-	{
-		std::cout << "ERROR: Unable to open scene file: "
-			<< model_filename << "\n";
-		exit(EXIT_FAILURE);
-	}
-
-	ifs.seekg(0, std::ios::beg);
-
-	std::string line;
 	std::string model_name;
 	GLApp::GLModel model{};
-	std::vector<glm::vec2> pos_vtx;
-	std::vector<GLushort> idx_vtx;
+	MeshOpt::Report report;
 
-	// read each model parameters
-	while (std::getline(ifs, line))
+	std::string const bin_filename{ MeshBin::ensure_binary(model_filename) };
+	if (bin_filename.empty() || GL_FALSE == MeshBin::load(bin_filename, buffer_arena, model_name,
+		model.primitive_type, model.mesh, model.draw_cnt, model.bbox_min, model.bbox_max, model.lods, report))
 	{
-		std::istringstream line_iss{ line };
-		GLchar prefix;
-		
-		line_iss >> prefix;
-		
-		// checks for type of data to be read
-		switch(prefix)
+		// fall back to the text model file
+		std::vector<glm::vec2> pos_vtx;
+		std::vector<GLuint> idx_vtx;
+		if (GL_FALSE == MeshBin::parse_text(model_filename, model_name,
+			model.primitive_type, pos_vtx, idx_vtx))
 		{
-		case 'v': // vertex data
-			GLfloat x, y;
-			line_iss >> x >> y;
-			pos_vtx.emplace_back(glm::vec2{ x, y });
-			break;
-		case 't': // triangle indices
-			model.primitive_type = GL_TRIANGLES;
-
-			{
-				GLushort idx1, idx2, idx3;
-				line_iss >> idx1 >> idx2 >> idx3;
-				idx_vtx.emplace_back(idx1);
-				idx_vtx.emplace_back(idx2);
-				idx_vtx.emplace_back(idx3);
-			}
-			break;
-		case 'f': // triangle fan indices
-			model.primitive_type = GL_TRIANGLE_FAN;
-
-			if (idx_vtx.empty()) // if index array is empty
-			{
-				GLushort idx1, idx2, idx3;
-				line_iss >> idx1 >> idx2 >> idx3;
-				idx_vtx.emplace_back(idx1);
-				idx_vtx.emplace_back(idx2);
-				idx_vtx.emplace_back(idx3);
-			}
-			else
-			{
-				GLushort idx;
-				line_iss >> idx;
-				idx_vtx.emplace_back(idx);
-			}
-			break;
-		case 'n': // name of model
-			line_iss >> model_name;
-			break;
-		}			
-	}
-
-	// Step 3: Generate a VAO handle to encapsulate the VBO(s) and
-	// state of this triangle mesh
-	// define VAO handle
-	GLuint vbo_hdl;
-	glCreateBuffers(1, &vbo_hdl);
-	glNamedBufferStorage(vbo_hdl, sizeof(glm::vec2) * pos_vtx.size(),
-		pos_vtx.data(), GL_DYNAMIC_STORAGE_BIT);
-
-	GLuint vaoid;
-	glCreateVertexArrays(1, &vaoid);
-	glEnableVertexArrayAttrib(vaoid, 0);
-	glVertexArrayVertexBuffer(vaoid, 0, vbo_hdl, 0, sizeof(glm::vec2));
-	glVertexArrayAttribFormat(vaoid, 0, 2, GL_FLOAT, GL_FALSE, 0);
-	glVertexArrayAttribBinding(vaoid, 0, 0);
-
-	GLuint ebo_hdl;
-	glCreateBuffers(1, &ebo_hdl);
-	glNamedBufferStorage(ebo_hdl, sizeof(GLushort) * idx_vtx.size(),
-		reinterpret_cast<GLvoid*>(idx_vtx.data()),
-		GL_DYNAMIC_STORAGE_BIT);
-	glVertexArrayElementBuffer(vaoid, ebo_hdl);
-	glBindVertexArray(0);
-
-	model.vaoid = vaoid; // set up VAO same as in GLApp::points_model
-	model.draw_cnt = idx_vtx.size(); // number of vertices
+			std::cout << "ERROR: Unable to open scene file: "
+				<< model_filename << "\n";
+			exit(EXIT_FAILURE);
+		}
+		report = MeshBin::prepare(model.primitive_type, pos_vtx, idx_vtx, model.lods);
+		GLenum const idx_type{ MeshIndex::type(pos_vtx.size()) };
+		std::vector<GLubyte> const idx_bytes{ MeshIndex::pack(idx_vtx, idx_type) };
+		model.mesh = MeshBin::upload(buffer_arena, model_name, pos_vtx.data(), pos_vtx.size(),
+			idx_bytes.data(), idx_vtx.size(), idx_type);
+		MeshBin::bounds(pos_vtx.data(), pos_vtx.size(), model.bbox_min, model.bbox_max);
+	}
+	if (report.tri_cnt > 0)
+	{
+		std::cout << "Model " << model_name << ": " << report.tri_cnt << " triangles, ACMR "
+			<< std::setprecision(3) << std::fixed << report.acmr_before << " -> "
+			<< report.acmr_after << std::defaultfloat << "\n";
+	}
+	if (model.lods.size() > 1)
+	{
+		std::cout << "Model " << model_name << ": levels of detail (triangles/error)";
+		for (MeshLod::Level const& lod : model.lods)
+		{
+			std::cout << " " << lod.cnt / 3 << "/" << lod.error;
+		}
+		std::cout << "\n";
+	}
+	model.draw_cnt = model.lods[0].cnt; // number of indices of the finest level
 	model.primitive_cnt = model.draw_cnt / 3; // number of primitives (not used)
+	model.arena_range = mesh_arena.add(model.mesh.vtx_alloc, model.mesh.idx_alloc, model.mesh.idx_type);
 
-	models[model_name] = model; // insert model into map with key model_name
+	// insert model into slot map and index its handle by model_name
+	auto const it{ model_names.find(model_name) };
+	if (it != model_names.end())
+	{
+		mesh_arena.remove(models[it->second].arena_range);
+		MeshBin::destroy(buffer_arena, models[it->second].mesh);
+		models[it->second] = model;
+		return;
+	}
+	model_names.emplace(std::move(model_name), models.insert(model));
 }
 
 /*  _________________________________________________________________________ */
@@ -443,58 +1236,159 @@ void GLApp::init_models_cont(std::string model_filename)
  *
  * This method updates the object's transformation matrix based on the delta time.
  * It performs the following tasks:
- * 1. Constructs a scale matrix using the object's scaling factors.
- * 2. Updates the object's orientation based on the delta time.
- * 3. Constructs a rotation matrix using the updated orientation.
- * 4. Constructs a translation matrix using the object's position.
- * 5. Computes the model transformation matrix by multiplying the scale, rotation,
- *    and translation matrices.
- * 6. Computes the model-to-NDC transformation matrix by multiplying the world-to-NDC
- *    transformation matrix of the 2D camera and the model transformation matrix.
- * 7. Computes the model-to-map transformation matrix by multiplying the world-to-NDC
- *    map transformation matrix of the 2D camera and the model transformation matrix.
+ * 1. Updates the object's orientation based on the delta time, and increments
+ *    state_version if the orientation changed.
+ * 2. If state_version differs from mdl_version:
+ *    a. Constructs scale, rotation and translation matrices using the object's
+ *       scaling factors, orientation and position.
+ *    b. Computes the model transformation matrix by multiplying the scale, rotation,
+ *       and translation matrices, and updates the bounding box of the object.
+ * 3. If the model transformation matrix was computed or view_version differs
+ *    from the view_version of the 2D camera:
+ *    a. Computes the model-to-NDC transformation matrix by multiplying the world-to-NDC
+ *       transformation matrix of the 2D camera and the model transformation matrix.
+ *    b. Computes the model-to-map transformation matrix by multiplying the world-to-NDC
+ *       map transformation matrix of the 2D camera and the model transformation matrix.
+ * Matrices that are not computed are counted as skipped in
+ * GLApp::mdl_xform_stats and GLApp::view_xform_stats.
  *
  * @param[in] delta_time The time difference between the current frame and the previous frame.
  * @return void
 */
 void GLApp::GLObject::update(GLdouble delta_time)
 {
-	// compute scale matrix
-	glm::mat3 scaleMat{
-		scaling.x, 0.f, 0.f,
-		0.f, scaling.y, 0.f,
-		0.f, 0.f, 1.f
-	};
-
 	// updates all objects orientation except for the Camera object
-	if (&objects["Camera"] != this)
+	if (camera2d.pgo != this && orientation.y != 0.f && delta_time != 0.0)
 	{
 		orientation.x += orientation.y * static_cast<float>(delta_time);
+		++state_version;
 	}
 
-	float angleRadians{ glm::radians<float>(orientation.x) };
+	GLboolean const mdl_dirty{ state_version != mdl_version };
+	if (mdl_dirty)
+	{
+		// compute scale matrix
+		glm::mat3 scaleMat{
+			scaling.x, 0.f, 0.f,
+			0.f, scaling.y, 0.f,
+			0.f, 0.f, 1.f
+		};
 
-	// compute rotation matrix
-	glm::mat3 rotMat{
-		glm::cos(angleRadians), glm::sin(angleRadians), 0.f,
-		-glm::sin(angleRadians), glm::cos(angleRadians), 0.f,
-		0.f, 0.f, 1.f
-	};
-	// compute translation matrix
-	glm::mat3 transMat{
-		1.f, 0.f, 0.f,
-		0.f, 1.f, 0.f,
-		position.x, position.y, 1.f
+		float angleRadians{ glm::radians<float>(orientation.x) };
+
+		// compute rotation matrix
+		glm::mat3 rotMat{
+			glm::cos(angleRadians), glm::sin(angleRadians), 0.f,
+			-glm::sin(angleRadians), glm::cos(angleRadians), 0.f,
+			0.f, 0.f, 1.f
+		};
+		// compute translation matrix
+		glm::mat3 transMat{
+			1.f, 0.f, 0.f,
+			0.f, 1.f, 0.f,
+			position.x, position.y, 1.f
+		};
+
+		// compute model to world matrix
+		mdl_xform = transMat * (rotMat * scaleMat);
+		mdl_version = state_version;
+		update_bounds();
+		++mdl_xform_stats.rebuilt;
+	}
+	else
+	{
+		++mdl_xform_stats.skipped;
+	}
+
+	if (mdl_dirty || view_version != camera2d.view_version)
+	{
+		// compute model to ndc matrix
+		mdl_to_ndc_xform = camera2d.world_to_ndc_xform * mdl_xform;
+
+		// compute model to ndc using map view
+		mdl_to_map_xform = camera2d.world_map_to_ndc_xform * mdl_xform;
+		view_version = camera2d.view_version;
+		++view_xform_stats.rebuilt;
+	}
+	else
+	{
+		++view_xform_stats.skipped;
+	}
+}
+
+/*  _________________________________________________________________________ */
+/*! GLApp::GLObject::update_bounds()
+ * @brief Update the object's bounding box in world space.
+ *
+ * The bounding box of the model is transformed by mdl_xform and the
+ * bounding box of the transformed box is stored. It encloses the object at
+ * any orientation, so it is safe to use for culling.
+ *
+ * @param none
+ * @return void
+*/
+void GLApp::GLObject::update_bounds()
+{
+	GLModel const& model{ models[mdl_ref] };
+	glm::vec2 const center{ 0.5f * (model.bbox_min + model.bbox_max) };
+	glm::vec2 const half{ 0.5f * (model.bbox_max - model.bbox_min) };
+
+	// transform center and project half extents onto world axes
+	glm::vec3 const world_center{ mdl_xform * glm::vec3{ center, 1.f } };
+	glm::vec2 const world_half{
+		glm::abs(mdl_xform[0][0]) * half.x + glm::abs(mdl_xform[1][0]) * half.y,
+		glm::abs(mdl_xform[0][1]) * half.x + glm::abs(mdl_xform[1][1]) * half.y
 	};
 
-	// compute model to world matrix
-	mdl_xform = transMat * (rotMat * scaleMat);
+	bbox_min = glm::vec2{ world_center.x, world_center.y } - world_half;
+	bbox_max = glm::vec2{ world_center.x, world_center.y } + world_half;
+}
+
+/*  _________________________________________________________________________ */
+/*! GLApp::GLObject::px_per_unit
+ * @brief Compute the pixels per model space unit of the object in a viewport.
+ *
+ * The main viewport is the whole window, in which the object is drawn with
+ * mdl_to_ndc_xform; the mini map viewport is a quarter of the window in
+ * each direction, in which it is drawn with mdl_to_map_xform.
+ *
+ * @param[in] draw_map GL_TRUE for the mini map viewport.
+ * @return Pixels per model space unit along the longer axis of the object.
+*/
+GLfloat GLApp::GLObject::px_per_unit(GLboolean draw_map) const
+{
+	if (draw_map == GL_TRUE)
+	{
+		return MeshLod::pixels_per_unit(mdl_to_map_xform,
+			static_cast<GLfloat>(GLHelper::width / 4), static_cast<GLfloat>(GLHelper::height / 4));
+	}
+	return MeshLod::pixels_per_unit(mdl_to_ndc_xform,
+		static_cast<GLfloat>(GLHelper::width), static_cast<GLfloat>(GLHelper::height));
+}
 
-	// compute model to ndc matrix
-	mdl_to_ndc_xform = camera2d.world_to_ndc_xform * mdl_xform;
+/*  _________________________________________________________________________ */
+/*! GLApp::GLModel::lod
+ * @brief Pick the level of detail of the model to draw.
+ *
+ * @param[in] px_per_unit Pixels per model space unit of the object drawn.
+ * @return Coarsest level whose error is at most MeshLod::tolerance pixels,
+ * or the finest level while GLApp::lod_enabled is GL_FALSE.
+*/
+MeshLod::Level const& GLApp::GLModel::lod(GLfloat px_per_unit) const
+{
+	return lods[(lod_enabled == GL_TRUE) ? MeshLod::select(lods.data(), lods.size(), px_per_unit) : 0];
+}
 
-	// compute model to ndc using map view
-	mdl_to_map_xform = camera2d.world_map_to_ndc_xform * mdl_xform;
+/*  _________________________________________________________________________ */
+/*! GLApp::GLModel::idx_offset
+ * @brief Compute the offset of the first index of a level of detail.
+ *
+ * @param[in] level Level of detail of the model.
+ * @return Offset in bytes in the element buffer of the VAO of mesh.
+*/
+GLintptr GLApp::GLModel::idx_offset(MeshLod::Level const& level) const
+{
+	return mesh.idx_alloc.offset + MeshIndex::size(mesh.idx_type) * static_cast<GLintptr>(level.first);
 }
 
 /*  _________________________________________________________________________ */
@@ -518,59 +1412,67 @@ void GLApp::GLObject::draw(GLboolean draw_map) const
 {
 	// there are many shader programs initialized - here we're saying
 	// which specific shader program should be used to render geometry
-	shd_ref->second.Use();
+	GLSLShader& shdr_pgm{ shdrpgms[shd_ref] };
+	GLModel const& model{ models[mdl_ref] };
+	shdr_pgm.Use();
 
 	// there are many models, each with their own initialized VAO object
 	// here, we're saying which VAO's state should be used to set up pipe
-	glBindVertexArray(mdl_ref->second.vaoid);
+	glBindVertexArray(model.mesh.vaoid);
 
 	// copy object color to fragment shader
-	GLint uniform_var_col_loc = glGetUniformLocation(shd_ref->second.GetHandle(),
-												 "uColor");
-
-	if (uniform_var_col_loc >= 0)
-	{
-		glUniform3fv(uniform_var_col_loc, 1, glm::value_ptr(color));
-	}
-	else
-	{
-		std::cout << "Uniform variable doesn't exist!!!\n";
-		std::exit(EXIT_FAILURE);
-	}
+	// the handles index the uniform locations reflected after linking
+	shdr_pgm.SetUniform(uColor, color);
 
 	// Copy object 3x3 model-to-NDC matrix to vertex shader
-	GLint uniform_var_mtx_loc = glGetUniformLocation(shd_ref->second.GetHandle(),
-												  "uModel_to_NDC");
-	if (uniform_var_mtx_loc >= 0)
-	{
-		// draws object with matrix depending on the viewport to render to
-		if (draw_map)
-		{
-			glUniformMatrix3fv(uniform_var_mtx_loc, 1, GL_FALSE,
-				glm::value_ptr(this->mdl_to_map_xform));
-		}
-		else
-		{
-			glUniformMatrix3fv(uniform_var_mtx_loc, 1, GL_FALSE,
-				glm::value_ptr(this->mdl_to_ndc_xform));
-		}
-	}
-	else
-	{
-		std::cout << "Uniform variable doesn't exist!!!\n";
-		std::exit(EXIT_FAILURE);
-	}
+	// draws object with matrix depending on the viewport to render to
+	shdr_pgm.SetUniform(uModel_to_NDC, draw_map ? mdl_to_map_xform : mdl_to_ndc_xform);
 
 	// here, we're saying what primitive is to be rendered and how many
-	// such primitives exist.
+	// such primitives exist, at the level of detail of the viewport.
 	// the graphics driver knows where to get the indices because the VAO
 	// containing this state information has been made current ...
-	glDrawElements(mdl_ref->second.primitive_type, mdl_ref->second.draw_cnt, GL_UNSIGNED_SHORT, NULL);
+	MeshLod::Level const& lod{ model.lod(px_per_unit(draw_map)) };
+	glDrawElements(model.primitive_type, lod.cnt, model.mesh.idx_type,
+		reinterpret_cast<GLvoid const*>(model.idx_offset(lod)));
+	++draw_call_cnt;
+	submitted_idx_cnt += lod.cnt;
 
 	// after completing the rendering, we tell the driver that VAO
 	// vaoid and current shader program are no longer current
 	glBindVertexArray(0);
-	shd_ref->second.UnUse();
+	shdr_pgm.UnUse();
+}
+
+/*  _________________________________________________________________________ */
+/*! GLApp::GLObject::draw_multiview
+ * @brief Draw the object in the main and mini map viewports with one draw call.
+ *
+ * The shader program of the multiview path fetches the object's
+ * model-to-world matrix and color at index draw_idx of the shader storage
+ * buffer bound by GLApp::draw_objects, and its geometry shader applies the
+ * world-to-NDC matrix of each viewport from the uniform buffer bound there.
+ *
+ * @param draw_idx[in] Index of the object's per-draw data.
+ * @return void
+*/
+void GLApp::GLObject::draw_multiview(GLuint draw_idx) const
+{
+	GLSLShader& shdr_pgm{ shdrpgms[multiview_shd_ref] };
+	GLModel const& model{ models[mdl_ref] };
+	shdr_pgm.Use();
+	glBindVertexArray(model.mesh.vaoid);
+
+	shdr_pgm.SetUniform(uDrawIndex, draw_idx);
+
+	MeshLod::Level const& lod{ model.lod(std::max(px_per_unit(GL_FALSE), px_per_unit(GL_TRUE))) };
+	glDrawElements(model.primitive_type, lod.cnt, model.mesh.idx_type,
+		reinterpret_cast<GLvoid const*>(model.idx_offset(lod)));
+	++draw_call_cnt;
+	submitted_idx_cnt += lod.cnt;
+
+	glBindVertexArray(0);
+	shdr_pgm.UnUse();
 }
 
 /*  _________________________________________________________________________ */
@@ -578,7 +1480,7 @@ void GLApp::GLObject::draw(GLboolean draw_map) const
  * @brief Initialize the 2D camera with the provided parameters.
  *
  * This method initializes the 2D camera with the provided parameters. It performs the following tasks:
- * 1. Assigns the address of *ptr to pgo.
+ * 1. Stores handle in obj and the address of the object it refers to in pgo.
  * 2. Computes the aspect ratio of the camera window based on the framebuffer size.
  * 3. Computes the camera's up and right vectors based on the object's orientation.
  * 4. Initializes the camera's view transformation matrix to a free camera position.
@@ -590,19 +1492,21 @@ void GLApp::GLObject::draw(GLboolean draw_map) const
  *    to NDC transformation matrix and the view transformation matrix.
  *
  * @param[in] pWindow A pointer to the GLFW window.
- * @param[in] ptr A pointer to the GLObject representing the camera.
+ * @param[in] handle A handle to the GLObject representing the camera.
  * @return void
 */
-void GLApp::Camera2D::init(GLFWwindow* pWindow, GLObject* ptr)
+void GLApp::Camera2D::init(GLFWwindow* pWindow, ObjectHandle handle)
 {
-	// assign address of object with object named "Camera" in std::map
-	// container GLApp::objects
-	pgo = ptr;
+	// assign handle and address of object with object named "Camera" in
+	// slot map GLApp::objects
+	obj = handle;
+	pgo = &GLApp::objects[obj];
 
 	// compute camera window's aspect ratio
 	GLsizei fb_width, fb_height;
 	glfwGetFramebufferSize(pWindow, &fb_width, &fb_height);
 	ar = static_cast<GLfloat>(fb_width) / fb_height;
+	fb_version = GLHelper::fbsize_version;
 
 	// compute camera trap parameters
 	cam_pos = pgo->position;
@@ -640,6 +1544,8 @@ void GLApp::Camera2D::init(GLFWwindow* pWindow, GLObject* ptr)
 	};
 
 	world_map_to_ndc_xform = map_to_ndc_xform * view_xform;
+
+	update_bounds();
 }
 
 /*  _________________________________________________________________________ */
@@ -648,17 +1554,22 @@ void GLApp::Camera2D::init(GLFWwindow* pWindow, GLObject* ptr)
  *
  * This method updates the 2D camera based on the current state and window parameters.
  * It performs the following tasks:
- * 1. Checks the keyboard button presses to enable camera interactivity.
- * 2. Updates the camera's aspect ratio based on the current framebuffer size.
+ * 1. Checks the keyboard button presses to enable camera interactivity, and
+ *    resolves pgo from the handle of the camera object.
+ * 2. Updates the camera's aspect ratio if GLHelper::fbsize_version shows that
+ *    the framebuffer was resized since the last update.
  * 3. Updates the camera's orientation if the left or right turn flags are set.
  * 4. Updates the camera's up and right vectors if the left or right turn flags are set.
  * 5. Updates the camera's position if the move flag is set.
  * 6. Updates the camera's position for the follow camera effect.
  * 7. Updates the camera's view transformation matrix based on the camera type
  * 8. Implements the camera's zoom effect if the zoom flag is set.
- * 9. Updates the camera's world-to-camera view transformation matrix, window-to-NDC
- *    transformation matrix, and world-to-NDC transformation matrix.
- * 10. Calls the `update()` method of the associated GLObject to update its transformation.
+ * 9. Calls the `update()` method of the associated GLObject to update its transformation.
+ * 10. Rebuilds the window-to-NDC transformation matrix only if the aspect ratio
+ *    or window height changed, and the world-to-NDC transformation matrix only
+ *    if either it or the view transformation matrix changed. view_version is
+ *    incremented whenever the world-to-NDC matrix is rebuilt so that objects
+ *    know to rebuild their model-to-NDC matrices.
  *
  * @param[in] pWindow A pointer to the GLFW window.
  * @return void
@@ -672,24 +1583,36 @@ void GLApp::Camera2D::update(GLFWwindow* pWindow)
 	(GLHelper::keystateK == GL_TRUE) ? right_turn_flag = GL_TRUE : right_turn_flag = GL_FALSE;
 	(GLHelper::keystateU == GL_TRUE) ? move_flag = GL_TRUE : move_flag = GL_FALSE;
 
-	// update camera aspect ratio - this must be done every frame	
-	// because it is possible for the user to change viewport
-	// dimensions
-	GLsizei fb_width, fb_height;
-	glfwGetFramebufferSize(pWindow, &fb_width, &fb_height);
-	ar = static_cast<GLfloat>(fb_width) / fb_height;
+	// objects may have been added or removed since the last update, which
+	// moves the camera object in GLApp::objects
+	pgo = &GLApp::objects[obj];
+
+	// update camera aspect ratio - the user may change the viewport
+	// dimensions at any time, but the framebuffer size is only queried
+	// after GLHelper::fbsize_cb reported a change
+	GLboolean camwin_dirty{ GL_FALSE };
+	if (fb_version != GLHelper::fbsize_version)
+	{
+		GLsizei fb_width, fb_height;
+		glfwGetFramebufferSize(pWindow, &fb_width, &fb_height);
+		ar = static_cast<GLfloat>(fb_width) / fb_height;
+		fb_version = GLHelper::fbsize_version;
+		camwin_dirty = GL_TRUE;
+	}
 	
 	// update camera's orientation (if required)
 	if (left_turn_flag)
 	{
 		pgo->orientation.x += pgo->orientation.y * static_cast<float>(GLHelper::delta_time) * 150.f;
 		pgo->orientation.x = pgo->orientation.x >= 360.f ? 0.f : pgo->orientation.x;
+		++pgo->state_version;
 	}
 	
 	if (right_turn_flag)
 	{
 		pgo->orientation.x -= pgo->orientation.y * static_cast<float>(GLHelper::delta_time) * 150.f;
 		pgo->orientation.x = pgo->orientation.x <= -360.f ? 0.f : pgo->orientation.x;
+		++pgo->state_version;
 	}
 
 	// update camera's up and right vectors (if required)
@@ -707,6 +1630,7 @@ void GLApp::Camera2D::update(GLFWwindow* pWindow)
 	if (move_flag)
 	{
 		pgo->position += linear_speed * up * static_cast<float>(GLHelper::delta_time) * 150.f;
+		++pgo->state_version;
 	}
 
 	// interpolates camera position to camera object position
@@ -714,9 +1638,10 @@ void GLApp::Camera2D::update(GLFWwindow* pWindow)
 	cam_pos = (1 - interpolation) * cam_pos + interpolation * pgo->position ;
 
 	// update camera type
+	glm::mat3 new_view_xform;
 	if (camtype_flag) // first-person
 	{
-		view_xform = glm::mat3{
+		new_view_xform = glm::mat3{
 			right.x, up.x, 0.f,
 			right.y, up.y, 0.f,
 			glm::dot(-right, pgo->position), glm::dot(-up, pgo->position), 1.f
@@ -724,18 +1649,21 @@ void GLApp::Camera2D::update(GLFWwindow* pWindow)
 	}
 	else // third-person with cam follow
 	{
-		view_xform = glm::mat3{
+		new_view_xform = glm::mat3{
 			1.f, 0.f, 0.f,
 			0.f, 1.f, 0.f,
 			-cam_pos.x, -cam_pos.y, 1.f
 		};
 	}
+	GLboolean view_dirty{ new_view_xform != view_xform };
+	view_xform = new_view_xform;
 
 	// implement camera's zoom effect (if required)
 	if (zoom_flag)
 	{
 		height_chg_dir = (height <= min_height ? 1 : (height >= max_height ? -1 : height_chg_dir));
 		height += height_chg_val * height_chg_dir;
+		camwin_dirty = GL_TRUE;
 	}
 
 	// compute appropriate world-to-camera view transformation matrix
@@ -743,11 +1671,124 @@ void GLApp::Camera2D::update(GLFWwindow* pWindow)
 	// compute world-to-NDC transformation matrix
 	pgo->update(GLHelper::delta_time);
 
-	camwin_to_ndc_xform = glm::mat3{
-		2.f / (ar * height), 0.f, 0.f,
-		0.f, 2.f / height, 0.f,
-		0.f, 0.f, 1.f
+	if (camwin_dirty)
+	{
+		camwin_to_ndc_xform = glm::mat3{
+			2.f / (ar * height), 0.f, 0.f,
+			0.f, 2.f / height, 0.f,
+			0.f, 0.f, 1.f
+		};
+		++GLApp::camera_xform_stats.rebuilt;
+	}
+	else
+	{
+		++GLApp::camera_xform_stats.skipped;
+	}
+
+	// objects compare view_version against their own copy to know when
+	// their model-to-NDC matrices must be rebuilt
+	if (camwin_dirty || view_dirty)
+	{
+		world_to_ndc_xform = camwin_to_ndc_xform * view_xform;
+		++view_version;
+		update_bounds();
+		++GLApp::camera_xform_stats.rebuilt;
+	}
+	else
+	{
+		++GLApp::camera_xform_stats.skipped;
+	}
+}
+
+/*  _________________________________________________________________________ */
+/*! GLApp::Camera2D::update_bounds
+ * @brief Update the world space bounding boxes of the camera windows.
+ *
+ * A window is the part of the world mapped to [-1, 1] x [-1, 1] in NDC by
+ * its world-to-NDC matrix: world_to_ndc_xform for the camera window and
+ * world_map_to_ndc_xform for the mini map window. The center and corners of
+ * the NDC square are taken back to world space with the inverse of the
+ * matrix, and the stored boxes enclose the possibly rotated windows.
+ *
+ * @param none
+ * @return void
+*/
+void GLApp::Camera2D::update_bounds()
+{
+	auto window_bounds = [](glm::mat3 const& xform, glm::vec2& lo, glm::vec2& hi)
+	{
+		// xform maps world point w to A * w + t in NDC
+		GLfloat const a{ xform[0][0] }, b{ xform[0][1] }, c{ xform[1][0] }, d{ xform[1][1] };
+		GLfloat const inv_det{ 1.f / (a * d - b * c) };
+		glm::vec2 const t{ xform[2][0], xform[2][1] };
+
+		// world point mapped to the center of NDC: inverse(A) * -t
+		glm::vec2 const center{
+			-(d * t.x - c * t.y) * inv_det,
+			-(a * t.y - b * t.x) * inv_det
+		};
+
+		// half extents of inverse(A) applied to the NDC square
+		glm::vec2 const half{
+			(glm::abs(d) + glm::abs(c)) * glm::abs(inv_det),
+			(glm::abs(b) + glm::abs(a)) * glm::abs(inv_det)
+		};
+		lo = center - half;
+		hi = center + half;
 	};
 
-	world_to_ndc_xform = camwin_to_ndc_xform * view_xform;
+	window_bounds(world_to_ndc_xform, win_min, win_max);
+	window_bounds(world_map_to_ndc_xform, map_min, map_max);
+}
+
+/*  _________________________________________________________________________ */
+/*! GLApp::cull
+ * @brief Collect the objects visible in the main and mini map viewports.
+ *
+ * An object is visible in a viewport if its world space bounding box overlaps
+ * the world space bounding box of the viewport's camera window. The
+ * overlapping boxes are found with a query of GLApp::object_grid and sorted
+ * by id, which keeps the drawing order of GLApp::objects. Pointers to the
+ * visible objects, resolved from their handles, are stored in main_visible
+ * and map_visible and stay valid until an object is added or removed. The number of
+ * visible and culled objects of each viewport in main_cull_stats and
+ * map_cull_stats. The camera object is always drawn and is not counted. If
+ * cull_enabled is GL_FALSE every object is visible.
+ *
+ * @param none
+ * @return void
+*/
+void GLApp::cull()
+{
+	auto query = [](glm::vec2 const& lo, glm::vec2 const& hi, std::vector<GLObject const*>& visible)
+	{
+		if (cull_enabled == GL_FALSE)
+		{
+			visible.clear();
+			for (ObjectHandle handle : grid_objs)
+			{
+				visible.push_back(&objects[handle]);
+			}
+			return;
+		}
+
+		grid_ids.clear();
+		object_grid.query_rect(lo, hi, grid_ids);
+		std::sort(grid_ids.begin(), grid_ids.end());
+
+		visible.clear();
+		for (GLuint id : grid_ids)
+		{
+			visible.push_back(&objects[grid_objs[id]]);
+		}
+	};
+
+	query(camera2d.win_min, camera2d.win_max, main_visible);
+	query(camera2d.map_min, camera2d.map_max, map_visible);
+
+	GLuint const cnt{ static_cast<GLuint>(object_grid.size()) };
+	main_cull_stats.visible = static_cast<GLuint>(main_visible.size());
+	main_cull_stats.culled = cnt - main_cull_stats.visible;
+	map_cull_stats.visible = static_cast<GLuint>(map_visible.size());
+	map_cull_stats.culled = cnt - map_cull_stats.visible;
 }
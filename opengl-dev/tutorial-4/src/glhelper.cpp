@@ -23,6 +23,7 @@
 // static data members declared in GLHelper
 GLint GLHelper::width;
 GLint GLHelper::height;
+GLuint GLHelper::fbsize_version{ 1 };
 GLdouble GLHelper::fps;
 GLdouble GLHelper::delta_time;
 std::string GLHelper::title;
@@ -32,6 +33,11 @@ GLboolean GLHelper::keystateK = GL_FALSE;
 GLboolean GLHelper::keystateU = GL_FALSE;
 GLboolean GLHelper::keystateV = GL_FALSE;
 GLboolean GLHelper::keystateZ = GL_FALSE;
+GLboolean GLHelper::keystateB = GL_FALSE;
+GLboolean GLHelper::keystateT = GL_FALSE;
+GLboolean GLHelper::keystateC = GL_FALSE;
+GLboolean GLHelper::keystateM = GL_FALSE;
+GLboolean GLHelper::keystateL = GL_FALSE;
 GLboolean GLHelper::leftclickState = GL_FALSE;
 
 /*  _________________________________________________________________________ */
@@ -178,6 +184,11 @@ void GLHelper::key_cb(GLFWwindow *pwin, int key, int scancode, int action, int m
     keystateU = (key == GLFW_KEY_U) ? GL_TRUE : keystateU;
     keystateV = (key == GLFW_KEY_V) ? ((keystateV == GL_TRUE) ? GL_FALSE : GL_TRUE) : keystateV;
     keystateZ = (key == GLFW_KEY_Z) ? GL_TRUE : keystateZ;
+    keystateB = (key == GLFW_KEY_B) ? GL_TRUE : keystateB;
+    keystateT = (key == GLFW_KEY_T) ? GL_TRUE : keystateT;
+    keystateC = (key == GLFW_KEY_C) ? GL_TRUE : keystateC;
+    keystateM = (key == GLFW_KEY_M) ? GL_TRUE : keystateM;
+    keystateL = (key == GLFW_KEY_L) ? GL_TRUE : keystateL;
   } 
   else if (GLFW_REPEAT == action)
   {
@@ -195,6 +206,11 @@ void GLHelper::key_cb(GLFWwindow *pwin, int key, int scancode, int action, int m
     keystateK = (key == GLFW_KEY_K) ? GL_FALSE : keystateK;
     keystateU = (key == GLFW_KEY_U) ? GL_FALSE : keystateU;
     keystateZ = (key == GLFW_KEY_Z) ? GL_FALSE : keystateZ;
+    keystateB = (key == GLFW_KEY_B) ? GL_FALSE : keystateB;
+    keystateT = (key == GLFW_KEY_T) ? GL_FALSE : keystateT;
+    keystateC = (key == GLFW_KEY_C) ? GL_FALSE : keystateC;
+    keystateM = (key == GLFW_KEY_M) ? GL_FALSE : keystateM;
+    keystateL = (key == GLFW_KEY_L) ? GL_FALSE : keystateL;
   }
 
   if (GLFW_KEY_ESCAPE == key && GLFW_PRESS == action) {
@@ -358,6 +374,8 @@ void GLHelper::fbsize_cb(GLFWwindow *ptr_win, int w, int h) {
 #endif
   // use the entire framebuffer as drawing region
   glViewport(0, 0, w, h);
+  // let users of the framebuffer size know that it has changed
+  ++fbsize_version;
   // later, if working in 3D, we'll have to set the projection matrix here ...
 }
 
@@ -0,0 +1,252 @@
+/*!
+* @file    jobsystem.cpp
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/3/2023
+*
+* @brief This file implements the work-stealing job system declared in
+*		 jobsystem.h. parallel_for deals the chunks of a loop round-robin into
+*		 the queue of each thread. Every thread pops chunks from the back of
+*		 its own queue and, once it is empty, steals chunks from the front of
+*		 the other queues. The calling thread takes part in the work until the
+*		 count of unfinished chunks reaches zero.
+*//*__________________________________________________________________________*/
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <jobsystem.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*                                                   objects with file scope
+----------------------------------------------------------------------------- */
+namespace {
+  // chunk [first, last) of the loop currently run by parallel_for
+  struct Job {
+    JobSystem::Task const* task;
+    size_t first, last;
+  };
+
+  // queue of chunks owned by one thread
+  struct JobQueue {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+  };
+
+  // queues[0] belongs to the thread calling parallel_for and
+  // queues[i] to workers[i - 1]
+  std::vector<std::unique_ptr<JobQueue>> queues;
+  std::vector<std::thread> workers;
+
+  std::mutex wake_mutex;
+  std::condition_variable wake_cv;
+  std::atomic<size_t> queued{ 0 };     // chunks waiting in any queue
+  std::atomic<size_t> unfinished{ 0 }; // chunks not completed yet
+  bool stop{ false };                  // guarded by wake_mutex
+
+  /*  _______________________________________________________________________ */
+  /*! pop_job
+   * @brief Take a chunk for the thread owning queues[self].
+   *
+   * The newest chunk of the thread's own queue is taken first. Otherwise the
+   * oldest chunk of the other queues is stolen, starting from the next queue
+   * so that thieves spread out over their victims.
+   *
+   * @param self[in] Index of the thread's queue.
+   * @param job[out] The chunk taken.
+   * @return true if a chunk was taken.
+  */
+  bool pop_job(size_t self, Job& job)
+  {
+    {
+      JobQueue& own{ *queues[self] };
+      std::lock_guard<std::mutex> lock{ own.mutex };
+      if (!own.jobs.empty()) {
+        job = own.jobs.back();
+        own.jobs.pop_back();
+        --queued;
+        return true;
+      }
+    }
+
+    for (size_t i{ 1 }; i < queues.size(); ++i) {
+      JobQueue& victim{ *queues[(self + i) % queues.size()] };
+      std::lock_guard<std::mutex> lock{ victim.mutex };
+      if (!victim.jobs.empty()) {
+        job = victim.jobs.front();
+        victim.jobs.pop_front();
+        --queued;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! run_job
+   * @brief Run a chunk and mark it completed.
+  */
+  void run_job(Job const& job)
+  {
+    (*job.task)(job.first, job.last);
+    unfinished.fetch_sub(1, std::memory_order_acq_rel);
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! worker_main
+   * @brief Run chunks until the pool is stopped, sleeping while none are queued.
+   *
+   * @param self[in] Index of the worker's queue.
+   * @return void
+  */
+  void worker_main(size_t self)
+  {
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock{ wake_mutex };
+        wake_cv.wait(lock, [] { return stop || queued.load() > 0; });
+        if (stop) {
+          return;
+        }
+      }
+
+      Job job;
+      while (pop_job(self, job)) {
+        run_job(job);
+      }
+    }
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! JobSystem::init
+ * @brief Start the worker threads.
+ *
+ * @param thread_cnt[in] Number of threads running tasks including the calling
+ * thread, or 0 to use every hardware thread.
+ * @return void
+*/
+void JobSystem::init(unsigned thread_cnt)
+{
+  cleanup();
+
+  if (thread_cnt == 0) {
+    thread_cnt = max_thread_count();
+  }
+
+  for (unsigned i{ 0 }; i < thread_cnt; ++i) {
+    queues.push_back(std::make_unique<JobQueue>());
+  }
+  for (unsigned i{ 1 }; i < thread_cnt; ++i) {
+    workers.emplace_back(worker_main, static_cast<size_t>(i));
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! JobSystem::cleanup
+ * @brief Stop and join the worker threads.
+*/
+void JobSystem::cleanup()
+{
+  {
+    std::lock_guard<std::mutex> lock{ wake_mutex };
+    stop = true;
+  }
+  wake_cv.notify_all();
+
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  workers.clear();
+  queues.clear();
+
+  std::lock_guard<std::mutex> lock{ wake_mutex };
+  stop = false;
+}
+
+/*  _________________________________________________________________________ */
+/*! JobSystem::get_thread_count
+ * @brief Return the number of threads that run tasks.
+*/
+unsigned JobSystem::get_thread_count()
+{
+  return queues.empty() ? 1 : static_cast<unsigned>(queues.size());
+}
+
+/*  _________________________________________________________________________ */
+/*! JobSystem::set_thread_count
+ * @brief Restart the pool with thread_cnt threads.
+*/
+void JobSystem::set_thread_count(unsigned thread_cnt)
+{
+  init(std::clamp(thread_cnt, 1u, max_thread_count()));
+}
+
+/*  _________________________________________________________________________ */
+/*! JobSystem::max_thread_count
+ * @brief Return the number of hardware threads.
+*/
+unsigned JobSystem::max_thread_count()
+{
+  return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+/*  _________________________________________________________________________ */
+/*! JobSystem::parallel_for
+ * @brief Call task on every chunk of [0, cnt) using all threads.
+ *
+ * @param cnt[in] Number of loop indices.
+ * @param grain[in] Number of indices per chunk; the last chunk may be shorter.
+ * @param task[in] Function called with the first and one past the last index
+ * of each chunk.
+ * @return void
+*/
+void JobSystem::parallel_for(size_t cnt, size_t grain, Task const& task)
+{
+  if (cnt == 0) {
+    return;
+  }
+  grain = std::max<size_t>(grain, 1);
+
+  // run in order on the calling thread if there is nothing to split
+  if (queues.size() <= 1 || cnt <= grain) {
+    for (size_t first{ 0 }; first < cnt; first += grain) {
+      task(first, std::min(first + grain, cnt));
+    }
+    return;
+  }
+
+  size_t const job_cnt{ (cnt + grain - 1) / grain };
+  unfinished.store(job_cnt);
+
+  // count the chunks before queueing them so that queued never drops below
+  // the number of chunks actually waiting
+  {
+    std::lock_guard<std::mutex> lock{ wake_mutex };
+    queued.fetch_add(job_cnt);
+  }
+
+  // deal the chunks round-robin so every thread starts with local work
+  for (size_t j{ 0 }; j < job_cnt; ++j) {
+    JobQueue& q{ *queues[j % queues.size()] };
+    std::lock_guard<std::mutex> lock{ q.mutex };
+    q.jobs.push_back(Job{ &task, j * grain, std::min((j + 1) * grain, cnt) });
+  }
+  wake_cv.notify_all();
+
+  // help until every chunk is done
+  Job job;
+  while (unfinished.load(std::memory_order_acquire) > 0) {
+    if (pop_job(0, job)) {
+      run_job(job);
+    }
+    else {
+      std::this_thread::yield();
+    }
+  }
+}
@@ -0,0 +1,115 @@
+/*!
+* @file    mappedfile.cpp
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/5/2023
+*
+* @brief This file implements class MappedFile declared in mappedfile.h.
+*//*__________________________________________________________________________*/
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <mappedfile.h>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*  _________________________________________________________________________ */
+/*! MappedFile::open
+ * @brief Map the contents of a file read-only.
+ *
+ * @param file_name[in] Path of the file to map.
+ * @return GL_TRUE if the file was mapped, GL_FALSE otherwise.
+*/
+GLboolean MappedFile::open(std::string const& file_name)
+{
+  close();
+
+#ifdef _WIN32
+  HANDLE file{ CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                           OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL) };
+  if (file == INVALID_HANDLE_VALUE) {
+    return GL_FALSE;
+  }
+  file_handle = file;
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+    close();
+    return GL_FALSE;
+  }
+
+  HANDLE mapping{ CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL) };
+  if (mapping == NULL) {
+    close();
+    return GL_FALSE;
+  }
+  mapping_handle = mapping;
+
+  view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (view == nullptr) {
+    close();
+    return GL_FALSE;
+  }
+  length = static_cast<size_t>(file_size.QuadPart);
+#else
+  int const fd{ ::open(file_name.c_str(), O_RDONLY) };
+  if (fd < 0) {
+    return GL_FALSE;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    ::close(fd);
+    return GL_FALSE;
+  }
+
+  // the mapping stays valid after the descriptor is closed
+  void* const addr{ mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0) };
+  ::close(fd);
+  if (addr == MAP_FAILED) {
+    return GL_FALSE;
+  }
+  view = addr;
+  length = static_cast<size_t>(st.st_size);
+#endif
+
+  return GL_TRUE;
+}
+
+/*  _________________________________________________________________________ */
+/*! MappedFile::close
+ * @brief Unmap the file and release every handle.
+*/
+void MappedFile::close()
+{
+#ifdef _WIN32
+  if (view != nullptr) {
+    UnmapViewOfFile(view);
+  }
+  if (mapping_handle != nullptr) {
+    CloseHandle(mapping_handle);
+    mapping_handle = nullptr;
+  }
+  if (file_handle != nullptr) {
+    CloseHandle(file_handle);
+    file_handle = nullptr;
+  }
+#else
+  if (view != nullptr) {
+    munmap(const_cast<void*>(view), length);
+  }
+#endif
+  view = nullptr;
+  length = 0;
+}
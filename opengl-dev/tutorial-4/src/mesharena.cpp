@@ -0,0 +1,136 @@
+/*!
+* @file    mesharena.cpp
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/14/2023
+*
+* @brief This file implements class MeshArena declared in mesharena.h.
+*//*__________________________________________________________________________*/
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <mesharena.h>
+#include <glm/glm.hpp>
+
+/*  _________________________________________________________________________ */
+/*! MeshArena::add
+ * @brief Reserve space for a model at the end of the arena and of the
+ * element buffer of its index type.
+ *
+ * The sizes of the model's vertices and indices are those of the ranges
+ * holding them, so the model data does not have to be kept in memory.
+ *
+ * @param vtx_alloc[in] Range holding the vertex positions of the model.
+ * @param idx_alloc[in] Range holding the indices of the model.
+ * @param idx_type[in] Type of the indices of the model.
+ * @return Location of the model in the arena.
+*/
+MeshArena::Range MeshArena::add(BufferArena::Allocation const& vtx_alloc,
+                                BufferArena::Allocation const& idx_alloc, GLenum idx_type)
+{
+  GLuint& idx_cnt{ idx_cnts[slot(idx_type)] };
+  Source src{ vtx_alloc, idx_alloc, static_cast<GLuint>(vtx_alloc.size / sizeof(glm::vec2)), Range{} };
+  src.range.first_index = idx_cnt;
+  src.range.idx_cnt = static_cast<GLuint>(idx_alloc.size / MeshIndex::size(idx_type));
+  src.range.base_vertex = static_cast<GLint>(vtx_cnt);
+  src.range.idx_type = idx_type;
+  sources.push_back(src);
+
+  vtx_cnt += src.vtx_cnt;
+  idx_cnt += src.range.idx_cnt;
+  return src.range;
+}
+
+/*  _________________________________________________________________________ */
+/*! MeshArena::remove
+ * @brief Forget the model added at range.
+ *
+ * Build copies every model from the ranges it was added with, so a model
+ * whose ranges are about to be freed, e.g. because it is replaced, must be
+ * removed first. Its vertices and indices are left out of the next build;
+ * the space reserved for them stays unused so that the other models keep
+ * their ranges.
+ *
+ * @param range[in] Location of the model returned by add.
+ * @return void
+*/
+void MeshArena::remove(Range const& range)
+{
+  for (auto it{ sources.begin() }; it != sources.end(); ++it) {
+    if (it->range.idx_type == range.idx_type && it->range.first_index == range.first_index) {
+      sources.erase(it);
+      return;
+    }
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! MeshArena::build
+ * @brief Create the buffers and VAOs of the arena and copy the models into
+ * them with glCopyNamedBufferSubData.
+ *
+ * An element buffer and a VAO are created for each index type used by at
+ * least one model. A previous arena is deleted first, so models may be
+ * added after a build and the arena built again.
+ *
+ * @param none
+ * @return void
+*/
+void MeshArena::build()
+{
+  if (vbo != 0) {
+    glDeleteBuffers(1, &vbo);
+    glDeleteBuffers(idx_type_cnt, ebos);
+    glDeleteVertexArrays(idx_type_cnt, vaoids);
+  }
+
+  glCreateBuffers(1, &vbo);
+  glNamedBufferStorage(vbo, sizeof(glm::vec2) * vtx_cnt, nullptr, 0);
+
+  GLenum const idx_types[idx_type_cnt]{ GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_UNSIGNED_INT };
+  for (GLuint i{ 0 }; i < idx_type_cnt; ++i) {
+    ebos[i] = vaoids[i] = 0;
+    if (idx_cnts[i] == 0) {
+      continue;
+    }
+
+    glCreateBuffers(1, &ebos[i]);
+    glNamedBufferStorage(ebos[i], MeshIndex::size(idx_types[i]) * idx_cnts[i], nullptr, 0);
+
+    glCreateVertexArrays(1, &vaoids[i]);
+    glEnableVertexArrayAttrib(vaoids[i], 0);
+    glVertexArrayVertexBuffer(vaoids[i], 0, vbo, 0, sizeof(glm::vec2));
+    glVertexArrayAttribFormat(vaoids[i], 0, 2, GL_FLOAT, GL_FALSE, 0);
+    glVertexArrayAttribBinding(vaoids[i], 0, 0);
+    glVertexArrayElementBuffer(vaoids[i], ebos[i]);
+  }
+
+  for (Source const& src : sources) {
+    GLsizeiptr const idx_size{ MeshIndex::size(src.range.idx_type) };
+    glCopyNamedBufferSubData(src.vtx_alloc.buffer, vbo, src.vtx_alloc.offset,
+                             sizeof(glm::vec2) * src.range.base_vertex, sizeof(glm::vec2) * src.vtx_cnt);
+    glCopyNamedBufferSubData(src.idx_alloc.buffer, ebos[slot(src.range.idx_type)], src.idx_alloc.offset,
+                             idx_size * src.range.first_index, idx_size * src.range.idx_cnt);
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! MeshArena::destroy
+ * @brief Delete the buffers and VAOs of the arena.
+ *
+ * @param none
+ * @return void
+*/
+void MeshArena::destroy()
+{
+  if (vbo != 0) {
+    glDeleteBuffers(1, &vbo);
+    glDeleteBuffers(idx_type_cnt, ebos);
+    glDeleteVertexArrays(idx_type_cnt, vaoids);
+  }
+  sources.clear();
+  vtx_cnt = 0;
+  for (GLuint i{ 0 }; i < idx_type_cnt; ++i) {
+    idx_cnts[i] = ebos[i] = vaoids[i] = 0;
+  }
+  vbo = 0;
+}
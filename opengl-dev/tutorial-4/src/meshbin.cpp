@@ -0,0 +1,512 @@
+/*!
+* @file    meshbin.cpp
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/5/2023
+*
+* @brief This file implements the conversion of text mesh files to binary mesh
+*		 files and the memory-mapped loading of binary mesh files declared in
+*		 meshbin.h.
+*//*__________________________________________________________________________*/
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <meshbin.h>
+#include <mappedfile.h>
+#include <GLFW/glfw3.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstring>
+
+/*                                                   objects with file scope
+----------------------------------------------------------------------------- */
+namespace {
+  // round offset up to the next multiple of 4 bytes
+  std::uint32_t align4(size_t offset)
+  {
+    return static_cast<std::uint32_t>((offset + 3) & ~size_t{ 3 });
+  }
+
+  // format version of a binary mesh file; 0 if it cannot be read
+  std::uint32_t binary_version(std::string const& bin_file)
+  {
+    std::ifstream ifs{ bin_file, std::ios::in | std::ios::binary };
+    MeshBin::Header header{};
+    if (!ifs.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != MeshBin::MAGIC) {
+      return 0;
+    }
+    return header.version;
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! MeshBin::parse_text
+ * @brief Read a text mesh file.
+ *
+ * Lines starting with n give the model name, lines starting with v a vertex
+ * position, lines starting with t three triangle indices and lines starting
+ * with f the indices of a triangle fan: three on the first f line and one
+ * on each following line. A line starting with r ends the current fan; a
+ * MeshIndex::restart index is added and the next f line starts a new fan
+ * with three indices, so a mesh can hold several fans.
+ *
+ * @param msh_file[in] Path of the text mesh file.
+ * @param name[out] Model name.
+ * @param primitive_type[out] GL_TRIANGLES or GL_TRIANGLE_FAN.
+ * @param pos_vtx[out] Vertex positions.
+ * @param idx_vtx[out] Vertex indices.
+ * @return GL_TRUE if the file was read.
+*/
+GLboolean MeshBin::parse_text(std::string const& msh_file, std::string& name,
+                              GLenum& primitive_type, std::vector<glm::vec2>& pos_vtx,
+                              std::vector<GLuint>& idx_vtx)
+{
+  std::ifstream ifs{ msh_file, std::ios::in };
+  if (!ifs) {
+    return GL_FALSE;
+  }
+
+  pos_vtx.clear();
+  idx_vtx.clear();
+  primitive_type = GL_TRIANGLES;
+  bool fan_start{ true }; // next f line is the first of a fan
+
+  std::string line;
+  while (std::getline(ifs, line)) {
+    std::istringstream line_iss{ line };
+    GLchar prefix;
+
+    line_iss >> prefix;
+
+    // checks for type of data to be read
+    switch (prefix) {
+    case 'v': // vertex data
+      GLfloat x, y;
+      line_iss >> x >> y;
+      pos_vtx.emplace_back(glm::vec2{ x, y });
+      break;
+    case 't': // triangle indices
+      primitive_type = GL_TRIANGLES;
+      {
+        GLuint idx1, idx2, idx3;
+        line_iss >> idx1 >> idx2 >> idx3;
+        idx_vtx.emplace_back(idx1);
+        idx_vtx.emplace_back(idx2);
+        idx_vtx.emplace_back(idx3);
+      }
+      break;
+    case 'f': // triangle fan indices
+      primitive_type = GL_TRIANGLE_FAN;
+      if (fan_start) { // first line of a fan
+        GLuint idx1, idx2, idx3;
+        line_iss >> idx1 >> idx2 >> idx3;
+        idx_vtx.emplace_back(idx1);
+        idx_vtx.emplace_back(idx2);
+        idx_vtx.emplace_back(idx3);
+        fan_start = false;
+      }
+      else {
+        GLuint idx;
+        line_iss >> idx;
+        idx_vtx.emplace_back(idx);
+      }
+      break;
+    case 'r': // end of a fan
+      if (!fan_start) {
+        idx_vtx.emplace_back(MeshIndex::restart);
+        fan_start = true;
+      }
+      break;
+    case 'n': // name of model
+      line_iss >> name;
+      break;
+    }
+  }
+  return GL_TRUE;
+}
+
+/*  _________________________________________________________________________ */
+/*! MeshBin::prepare
+ * @brief Build the levels of detail of a mesh and optimize them.
+ *
+ * Only meshes of triangle fans get coarser levels, with
+ * MeshLod::decimate_fans; other meshes have a single level. Every level is
+ * then converted to a triangle list and reordered by MeshOpt::optimize.
+ *
+ * @param primitive_type[in,out] Primitive type of the mesh; GL_TRIANGLES
+ * once optimized.
+ * @param pos_vtx[in,out] Vertex positions, reordered.
+ * @param idx_vtx[in,out] Vertex indices; the indices of every level end to
+ * end.
+ * @param lods[out] First index, index count and error of each level.
+ * @return ACMR of the first level before and after optimization.
+*/
+MeshOpt::Report MeshBin::prepare(GLenum& primitive_type, std::vector<glm::vec2>& pos_vtx,
+                                 std::vector<GLuint>& idx_vtx, std::vector<MeshLod::Level>& lods)
+{
+  std::vector<GLfloat> errors(1, 0.f);
+  std::vector<std::vector<GLuint>> levels;
+  if (primitive_type == GL_TRIANGLE_FAN) {
+    levels = MeshLod::decimate_fans(pos_vtx, idx_vtx, errors);
+  }
+  else {
+    levels.push_back(idx_vtx);
+  }
+  MeshOpt::Report const report{ MeshOpt::optimize(primitive_type, pos_vtx, levels) };
+
+  idx_vtx.clear();
+  lods.clear();
+  for (size_t i{ 0 }; i < levels.size(); ++i) {
+    lods.push_back(MeshLod::Level{ static_cast<GLuint>(idx_vtx.size()), static_cast<GLuint>(levels[i].size()),
+                                   errors[i] });
+    idx_vtx.insert(idx_vtx.end(), levels[i].begin(), levels[i].end());
+  }
+  return report;
+}
+
+/*  _________________________________________________________________________ */
+/*! MeshBin::write
+ * @brief Write a binary mesh file.
+ *
+ * @param bin_file[in] Path of the binary mesh file.
+ * @param name[in] Model name; at most 35 characters are stored.
+ * @param primitive_type[in] Primitive type used to render the mesh.
+ * @param pos_vtx[in] Vertex positions.
+ * @param idx_vtx[in] Vertex indices, packed to MeshIndex::type of the vertex
+ * count.
+ * @param lods[in] Levels of detail in idx_vtx; at most MeshLod::max_levels
+ * are stored.
+ * @param report[in] ACMR of the mesh before and after optimization.
+ * @return GL_TRUE if the file was written.
+*/
+GLboolean MeshBin::write(std::string const& bin_file, std::string const& name,
+                         GLenum primitive_type, std::vector<glm::vec2> const& pos_vtx,
+                         std::vector<GLuint> const& idx_vtx, std::vector<MeshLod::Level> const& lods,
+                         MeshOpt::Report const& report)
+{
+  GLenum const idx_type{ MeshIndex::type(pos_vtx.size()) };
+  std::vector<GLubyte> const idx_bytes{ MeshIndex::pack(idx_vtx, idx_type) };
+
+  Header header{};
+  header.magic = MAGIC;
+  header.version = VERSION;
+  header.primitive_type = primitive_type;
+  header.vtx_cnt = static_cast<std::uint32_t>(pos_vtx.size());
+  header.idx_cnt = static_cast<std::uint32_t>(idx_vtx.size());
+  header.idx_type = idx_type;
+  header.vtx_offset = align4(sizeof(Header));
+  header.idx_offset = align4(header.vtx_offset + sizeof(glm::vec2) * pos_vtx.size());
+  header.acmr_before = report.acmr_before;
+  header.acmr_after = report.acmr_after;
+  header.lod_cnt = static_cast<std::uint32_t>(std::min<size_t>(lods.size(), MeshLod::max_levels));
+  std::copy(lods.begin(), lods.begin() + header.lod_cnt, header.lods);
+  std::strncpy(header.name, name.c_str(), sizeof(header.name) - 1);
+
+  std::ofstream ofs{ bin_file, std::ios::out | std::ios::binary };
+  if (!ofs) {
+    return GL_FALSE;
+  }
+
+  char const padding[4]{};
+  ofs.write(reinterpret_cast<char const*>(&header), sizeof(header));
+  ofs.write(padding, header.vtx_offset - sizeof(header));
+  ofs.write(reinterpret_cast<char const*>(pos_vtx.data()),
+            static_cast<std::streamsize>(sizeof(glm::vec2) * pos_vtx.size()));
+  ofs.write(padding, header.idx_offset - header.vtx_offset - sizeof(glm::vec2) * pos_vtx.size());
+  ofs.write(reinterpret_cast<char const*>(idx_bytes.data()),
+            static_cast<std::streamsize>(idx_bytes.size()));
+  return ofs.good() ? GL_TRUE : GL_FALSE;
+}
+
+/*  _________________________________________________________________________ */
+/*! MeshBin::convert
+ * @brief Convert a text mesh file to a binary mesh file, building its levels
+ * of detail and reordering its triangles and vertices with prepare on the
+ * way.
+*/
+GLboolean MeshBin::convert(std::string const& msh_file, std::string const& bin_file)
+{
+  std::string name;
+  GLenum primitive_type;
+  std::vector<glm::vec2> pos_vtx;
+  std::vector<GLuint> idx_vtx;
+  if (GL_FALSE == parse_text(msh_file, name, primitive_type, pos_vtx, idx_vtx)) {
+    return GL_FALSE;
+  }
+  std::vector<MeshLod::Level> lods;
+  MeshOpt::Report const report{ prepare(primitive_type, pos_vtx, idx_vtx, lods) };
+  return write(bin_file, name, primitive_type, pos_vtx, idx_vtx, lods, report);
+}
+
+/*  _________________________________________________________________________ */
+/*! MeshBin::binary_path
+ * @brief Return msh_file with its extension replaced by .mshb.
+*/
+std::string MeshBin::binary_path(std::string const& msh_file)
+{
+  std::filesystem::path path{ msh_file };
+  path.replace_extension(".mshb");
+  return path.string();
+}
+
+/*  _________________________________________________________________________ */
+/*! MeshBin::ensure_binary
+ * @brief Convert msh_file if its binary mesh file is missing, out of date or
+ * of an older format version.
+ *
+ * @param msh_file[in] Path of the text mesh file.
+ * @return Path of the binary mesh file, or an empty string if the text mesh
+ * file does not exist and no binary mesh file was converted before.
+*/
+std::string MeshBin::ensure_binary(std::string const& msh_file)
+{
+  std::string const bin_file{ binary_path(msh_file) };
+  std::error_code ec;
+  bool const has_text{ std::filesystem::exists(msh_file, ec) };
+  bool const has_binary{ std::filesystem::exists(bin_file, ec) };
+
+  if (has_text && (!has_binary || std::filesystem::last_write_time(bin_file, ec) <
+                                  std::filesystem::last_write_time(msh_file, ec) ||
+                   binary_version(bin_file) != VERSION)) {
+    if (GL_FALSE == convert(msh_file, bin_file)) {
+      return std::string();
+    }
+  }
+  else if (!has_binary) {
+    return std::string();
+  }
+  return bin_file;
+}
+
+/*  _________________________________________________________________________ */
+/*! MeshBin::load
+ * @brief Upload a mesh from a binary mesh file.
+ *
+ * The file is memory-mapped and its vertex and index blobs are passed to
+ * glNamedBufferSubData directly, so the data is never copied by the
+ * application.
+ *
+ * @param bin_file[in] Path of the binary mesh file.
+ * @param arena[in,out] Arena the vertices and indices are allocated from.
+ * @param name[out] Model name.
+ * @param primitive_type[out] Primitive type used to render the mesh.
+ * @param mesh[out] VAO and ranges of the uploaded mesh.
+ * @param draw_cnt[out] Number of indices.
+ * @param bbox_min[out] Minimum corner of the bounding box of the mesh.
+ * @param bbox_max[out] Maximum corner of the bounding box of the mesh.
+ * @param lods[out] Levels of detail, finest first; a single level of every
+ * index if the file has none.
+ * @param report[out] ACMR of the mesh before and after optimization; the
+ * triangle count, that of the finest level, is 0 if convert could not
+ * optimize the mesh.
+ * @return GL_TRUE if the file was valid and the mesh was uploaded.
+*/
+GLboolean MeshBin::load(std::string const& bin_file, BufferArena& arena, std::string& name,
+                        GLenum& primitive_type, GPUMesh& mesh, GLuint& draw_cnt,
+                        glm::vec2& bbox_min, glm::vec2& bbox_max, std::vector<MeshLod::Level>& lods,
+                        MeshOpt::Report& report)
+{
+  MappedFile file;
+  if (GL_FALSE == file.open(bin_file) || file.size() < sizeof(Header)) {
+    return GL_FALSE;
+  }
+
+  char const* const bytes{ static_cast<char const*>(file.data()) };
+  Header header;
+  std::memcpy(&header, bytes, sizeof(header));
+  size_t const idx_size{ static_cast<size_t>(MeshIndex::size(header.idx_type)) };
+  if (header.magic != MAGIC || header.version != VERSION || idx_size == 0 ||
+      header.vtx_offset + sizeof(glm::vec2) * header.vtx_cnt > file.size() ||
+      header.idx_offset + idx_size * header.idx_cnt > file.size() || header.lod_cnt > MeshLod::max_levels ||
+      std::any_of(header.lods, header.lods + header.lod_cnt, [&header](MeshLod::Level const& lod) {
+        return lod.first + static_cast<size_t>(lod.cnt) > header.idx_cnt;
+      })) {
+    return GL_FALSE;
+  }
+
+  header.name[sizeof(header.name) - 1] = '\0';
+  name = header.name;
+  primitive_type = header.primitive_type;
+  draw_cnt = header.idx_cnt;
+  report.acmr_before = header.acmr_before;
+  report.acmr_after = header.acmr_after;
+  lods.assign(header.lods, header.lods + header.lod_cnt);
+  if (lods.empty()) {
+    lods.push_back(MeshLod::Level{ 0, header.idx_cnt, 0.f });
+  }
+  report.tri_cnt = (header.acmr_after > 0.f) ? lods.front().cnt / 3 : 0;
+  glm::vec2 const* const pos_vtx{ reinterpret_cast<glm::vec2 const*>(bytes + header.vtx_offset) };
+  bounds(pos_vtx, header.vtx_cnt, bbox_min, bbox_max);
+  mesh = upload(arena, name, pos_vtx, header.vtx_cnt,
+                bytes + header.idx_offset, header.idx_cnt, header.idx_type);
+  return GL_TRUE;
+}
+
+/*  _________________________________________________________________________ */
+/*! MeshBin::bounds
+ * @brief Compute the bounding box of vertex positions.
+ *
+ * @param pos_vtx[in] Vertex positions.
+ * @param vtx_cnt[in] Number of vertex positions.
+ * @param bbox_min[out] Minimum corner of the bounding box.
+ * @param bbox_max[out] Maximum corner of the bounding box.
+ * @return void
+*/
+void MeshBin::bounds(glm::vec2 const* pos_vtx, size_t vtx_cnt,
+                     glm::vec2& bbox_min, glm::vec2& bbox_max)
+{
+  bbox_min = bbox_max = (vtx_cnt > 0) ? pos_vtx[0] : glm::vec2{ 0.f };
+  for (size_t i{ 1 }; i < vtx_cnt; ++i) {
+    bbox_min = glm::min(bbox_min, pos_vtx[i]);
+    bbox_max = glm::max(bbox_max, pos_vtx[i]);
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! MeshBin::upload
+ * @brief Allocate the vertices and indices of a mesh from an arena and
+ * create a VAO reading position attribute 0 and the indices from them.
+ *
+ * @param arena[in,out] Arena the vertices and indices are allocated from.
+ * @param name[in] Model name the ranges are tagged with.
+ * @param pos_vtx[in] Vertex positions.
+ * @param vtx_cnt[in] Number of vertex positions.
+ * @param idx_vtx[in] Vertex indices.
+ * @param idx_cnt[in] Number of vertex indices.
+ * @param idx_type[in] Type of the vertex indices.
+ * @return VAO and ranges of the mesh.
+*/
+MeshBin::GPUMesh MeshBin::upload(BufferArena& arena, std::string const& name,
+                                 glm::vec2 const* pos_vtx, size_t vtx_cnt,
+                                 void const* idx_vtx, size_t idx_cnt, GLenum idx_type)
+{
+  GPUMesh mesh;
+  mesh.vtx_alloc = arena.allocate(static_cast<GLsizeiptr>(sizeof(glm::vec2) * vtx_cnt), pos_vtx,
+                                  name + " vertices");
+  mesh.idx_alloc = arena.allocate(MeshIndex::size(idx_type) * static_cast<GLsizeiptr>(idx_cnt), idx_vtx,
+                                  name + " indices");
+  mesh.idx_type = idx_type;
+
+  glCreateVertexArrays(1, &mesh.vaoid);
+  glEnableVertexArrayAttrib(mesh.vaoid, 0);
+  glVertexArrayVertexBuffer(mesh.vaoid, 0, mesh.vtx_alloc.buffer, mesh.vtx_alloc.offset, sizeof(glm::vec2));
+  glVertexArrayAttribFormat(mesh.vaoid, 0, 2, GL_FLOAT, GL_FALSE, 0);
+  glVertexArrayAttribBinding(mesh.vaoid, 0, 0);
+  glVertexArrayElementBuffer(mesh.vaoid, mesh.idx_alloc.buffer);
+
+  return mesh;
+}
+
+/*  _________________________________________________________________________ */
+/*! MeshBin::destroy
+ * @brief Delete the VAO of a mesh created by upload and return its vertex
+ * and index ranges to the arena.
+*/
+void MeshBin::destroy(BufferArena& arena, GPUMesh& mesh)
+{
+  arena.free(mesh.vtx_alloc);
+  arena.free(mesh.idx_alloc);
+  glDeleteVertexArrays(1, &mesh.vaoid);
+  mesh.vaoid = 0;
+}
+
+/*  _________________________________________________________________________ */
+/*! MeshBin::benchmark
+ * @brief Print load times of text and binary mesh files.
+ *
+ * Grids of n x n vertices split into 2 (n-1)^2 triangles are written to the
+ * temporary directory as text and as binary mesh files. Each file is then
+ * loaded a number of times, including creation of the VAO and allocation
+ * of its ranges from a BufferArena that is reused by every load, and
+ * the average time of each format is printed. glFinish is called after each
+ * load so that the time includes the upload of the data.
+ *
+ * @param none
+ * @return void
+*/
+void MeshBin::benchmark()
+{
+  int const reps{ 5 };
+  GLuint const sizes[]{ 8, 64, 255, 384 }; // 8-, 16-, 16- and 32-bit indices
+  std::filesystem::path const dir{ std::filesystem::temp_directory_path() };
+  BufferArena arena;
+
+  std::cout << "Vertices\t|\tIndex bits\t|\tText (ms)\t|\tBinary (ms)\t|\tSpeedup\n";
+  std::cout << "--------------------------------------------------------------------------------------\n";
+  for (GLuint n : sizes) {
+    std::vector<glm::vec2> pos_vtx;
+    std::vector<GLuint> idx_vtx;
+    for (GLuint row{ 0 }; row < n; ++row) {
+      for (GLuint col{ 0 }; col < n; ++col) {
+        pos_vtx.emplace_back(glm::vec2{ col / (n - 1.f) - 0.5f, row / (n - 1.f) - 0.5f });
+      }
+    }
+    for (GLuint row{ 0 }; row + 1 < n; ++row) {
+      for (GLuint col{ 0 }; col + 1 < n; ++col) {
+        GLuint const i0{ row * n + col };
+        GLuint const i1{ i0 + 1 };
+        GLuint const i2{ i0 + n };
+        GLuint const i3{ i2 + 1 };
+        GLuint const tris[]{ i0, i1, i3, i3, i2, i0 };
+        idx_vtx.insert(idx_vtx.end(), std::begin(tris), std::end(tris));
+      }
+    }
+
+    std::string const msh_file{ (dir / ("meshbin-bench-" + std::to_string(n) + ".msh")).string() };
+    {
+      std::ofstream ofs{ msh_file };
+      ofs << "n grid\n";
+      for (glm::vec2 const& v : pos_vtx) {
+        ofs << "v " << v.x << " " << v.y << "\n";
+      }
+      for (size_t i{ 0 }; i < idx_vtx.size(); i += 3) {
+        ofs << "t " << idx_vtx[i] << " " << idx_vtx[i + 1] << " " << idx_vtx[i + 2] << "\n";
+      }
+    }
+    std::string const bin_file{ binary_path(msh_file) };
+    convert(msh_file, bin_file);
+
+    double const text_start{ glfwGetTime() };
+    for (int r{ 0 }; r < reps; ++r) {
+      std::string name;
+      GLenum primitive_type;
+      parse_text(msh_file, name, primitive_type, pos_vtx, idx_vtx);
+      GLenum const idx_type{ MeshIndex::type(pos_vtx.size()) };
+      std::vector<GLubyte> const idx_bytes{ MeshIndex::pack(idx_vtx, idx_type) };
+      GPUMesh mesh{ upload(arena, name, pos_vtx.data(), pos_vtx.size(), idx_bytes.data(), idx_vtx.size(),
+                           idx_type) };
+      glFinish();
+      destroy(arena, mesh);
+    }
+    double const text_ms{ (glfwGetTime() - text_start) * 1000.0 / reps };
+
+    double const bin_start{ glfwGetTime() };
+    for (int r{ 0 }; r < reps; ++r) {
+      std::string name;
+      GLenum primitive_type;
+      GPUMesh mesh;
+      GLuint draw_cnt;
+      glm::vec2 bbox_min, bbox_max;
+      std::vector<MeshLod::Level> lods;
+      MeshOpt::Report report;
+      load(bin_file, arena, name, primitive_type, mesh, draw_cnt, bbox_min, bbox_max, lods, report);
+      glFinish();
+      destroy(arena, mesh);
+    }
+    double const bin_ms{ (glfwGetTime() - bin_start) * 1000.0 / reps };
+
+    std::cout << n * n << "\t\t" << 8 * MeshIndex::size(MeshIndex::type(n * n)) << "\t\t\t"
+              << std::setprecision(3) << std::fixed << text_ms << "\t\t\t"
+              << bin_ms << "\t\t\t" << text_ms / bin_ms << "\n";
+
+    std::error_code ec;
+    std::filesystem::remove(msh_file, ec);
+    std::filesystem::remove(bin_file, ec);
+  }
+  std::cout << "--------------------------------------------------------------------------------------\n";
+  std::cout << std::defaultfloat;
+  arena.destroy();
+}
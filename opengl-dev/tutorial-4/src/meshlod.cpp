@@ -0,0 +1,134 @@
+/*!
+* @file    meshlod.cpp
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/20/2023
+*
+* @brief This file implements the level of detail functions of struct MeshLod
+*		 declared in meshlod.h.
+*//*__________________________________________________________________________*/
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <meshlod.h>
+#include <meshindex.h>
+#include <algorithm>
+
+/*  _________________________________________________________________________ */
+/*! MeshLod::decimate_fans
+ * @brief Build coarser levels of triangle fans.
+ *
+ * Level k keeps rim vertices 0, 2^k, 2 * 2^k, ... and the last rim vertex
+ * of every fan, so the rim of a fan stays closed. The error of a level is
+ * the largest distance of a rim vertex it drops to the rim edge replacing
+ * it, which is where the coarse rim is farthest from the full one.
+ *
+ * @param pos_vtx[in] Vertex positions.
+ * @param idx_vtx[in] Indices of fans separated by MeshIndex::restart.
+ * @param errors[out] Error of each level in model space; 0 for the first.
+ * @return Indices of each level, finest first. Only idx_vtx itself if an
+ * index is past the last vertex.
+*/
+std::vector<std::vector<GLuint>> MeshLod::decimate_fans(std::vector<glm::vec2> const& pos_vtx,
+                                                        std::vector<GLuint> const& idx_vtx,
+                                                        std::vector<GLfloat>& errors)
+{
+  std::vector<std::vector<GLuint>> levels{ idx_vtx };
+  errors.assign(1, 0.f);
+
+  // [first, end) of each fan in idx_vtx; idx_vtx[first] is its center
+  std::vector<std::pair<size_t, size_t>> fans;
+  size_t start{ 0 };
+  for (size_t i{ 0 }; i <= idx_vtx.size(); ++i) {
+    if (i < idx_vtx.size() && idx_vtx[i] != MeshIndex::restart) {
+      if (idx_vtx[i] >= pos_vtx.size()) {
+        return levels;
+      }
+      continue;
+    }
+    if (i >= start + 3) {
+      fans.emplace_back(start, i);
+    }
+    start = i + 1;
+  }
+  if (fans.empty()) {
+    return levels;
+  }
+
+  auto const distance = [](glm::vec2 const& p, glm::vec2 const& a, glm::vec2 const& b) {
+    glm::vec2 const ab{ b - a };
+    GLfloat const len2{ glm::dot(ab, ab) };
+    GLfloat const t{ (len2 > 0.f) ? glm::clamp(glm::dot(p - a, ab) / len2, 0.f, 1.f) : 0.f };
+    return glm::length(p - (a + t * ab));
+  };
+
+  for (size_t step{ 2 }; levels.size() < max_levels; step *= 2) {
+    if (std::any_of(fans.begin(), fans.end(), [step](std::pair<size_t, size_t> const& fan) {
+          return (fan.second - fan.first - 2 + step - 1) / step < min_edges;
+        })) {
+      break;
+    }
+
+    std::vector<GLuint> level;
+    GLfloat error{ 0.f };
+    for (std::pair<size_t, size_t> const& fan : fans) {
+      if (!level.empty()) {
+        level.push_back(MeshIndex::restart);
+      }
+      level.push_back(idx_vtx[fan.first]);
+
+      GLuint const* const rim{ idx_vtx.data() + fan.first + 1 };
+      size_t const edges{ fan.second - fan.first - 2 };
+      for (size_t e{ 0 }; e < edges; e += step) {
+        size_t const next{ std::min(e + step, edges) };
+        level.push_back(rim[e]);
+        for (size_t j{ e + 1 }; j < next; ++j) {
+          error = std::max(error, distance(pos_vtx[rim[j]], pos_vtx[rim[e]], pos_vtx[rim[next]]));
+        }
+      }
+      level.push_back(rim[edges]);
+    }
+    levels.push_back(std::move(level));
+    errors.push_back(error);
+  }
+  return levels;
+}
+
+/*  _________________________________________________________________________ */
+/*! MeshLod::pixels_per_unit
+ * @brief Compute the length in pixels of a model space unit.
+ *
+ * The x and y axes of model space are taken to NDC by the first two columns
+ * of mdl_to_ndc and to pixels by half the viewport size; the longer of the
+ * two is returned so that non-uniformly scaled objects get the level their
+ * longer axis needs.
+ *
+ * @param mdl_to_ndc[in] Model-to-NDC transformation of the object.
+ * @param vp_width[in] Width of the viewport in pixels.
+ * @param vp_height[in] Height of the viewport in pixels.
+ * @return Pixels per model space unit.
+*/
+GLfloat MeshLod::pixels_per_unit(glm::mat3 const& mdl_to_ndc, GLfloat vp_width, GLfloat vp_height)
+{
+  glm::vec2 const x_axis{ mdl_to_ndc[0][0] * vp_width * 0.5f, mdl_to_ndc[0][1] * vp_height * 0.5f };
+  glm::vec2 const y_axis{ mdl_to_ndc[1][0] * vp_width * 0.5f, mdl_to_ndc[1][1] * vp_height * 0.5f };
+  return std::max(glm::length(x_axis), glm::length(y_axis));
+}
+
+/*  _________________________________________________________________________ */
+/*! MeshLod::select
+ * @brief Pick the level of detail to draw.
+ *
+ * @param levels[in] Levels of a mesh, finest first, with growing errors.
+ * @param level_cnt[in] Number of levels.
+ * @param px_per_unit[in] Pixels per model space unit, from pixels_per_unit.
+ * @return Index of the coarsest level whose projected error is at most
+ * tolerance pixels; 0 if there are no levels.
+*/
+GLuint MeshLod::select(Level const* levels, size_t level_cnt, GLfloat px_per_unit)
+{
+  GLuint lod{ 0 };
+  while (lod + 1 < level_cnt && levels[lod + 1].error * px_per_unit <= tolerance) {
+    ++lod;
+  }
+  return lod;
+}
@@ -0,0 +1,403 @@
+/*!
+* @file    meshopt.cpp
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/19/2023
+*
+* @brief This file implements the triangle and vertex reordering of struct
+*		 MeshOpt declared in meshopt.h.
+*//*__________________________________________________________________________*/
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <meshopt.h>
+#include <meshindex.h>
+#include <GLFW/glfw3.h>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+
+/*                                                   objects with file scope
+----------------------------------------------------------------------------- */
+namespace {
+  // parameters of Forsyth's vertex score; the cache modeled while scoring
+  // is an LRU cache larger than the FIFO cache of MeshOpt::acmr, as
+  // Forsyth recommends, since the order then suits most cache sizes
+  size_t constexpr score_cache_size{ 32 };
+  GLfloat constexpr cache_decay_power{ 1.5f };
+  GLfloat constexpr last_tri_score{ 0.75f };
+  GLfloat constexpr valence_boost_scale{ 2.f };
+  GLfloat constexpr valence_boost_power{ 0.5f };
+
+  // score of a vertex at position cache_pos of the LRU cache, or outside of
+  // it if cache_pos is -1, that is still used by live_cnt triangles to emit;
+  // vertices of the last triangle score the same so that the next triangle
+  // does not favor either edge, and vertices used by few triangles are
+  // boosted so that they are finished off before they are evicted
+  GLfloat vertex_score(int cache_pos, GLuint live_cnt)
+  {
+    if (live_cnt == 0) {
+      return -1.f;
+    }
+
+    GLfloat score{ 0.f };
+    if (cache_pos >= 0) {
+      score = (cache_pos < 3) ? last_tri_score
+            : std::pow(1.f - static_cast<GLfloat>(cache_pos - 3) / (score_cache_size - 3), cache_decay_power);
+    }
+    return score + valence_boost_scale * std::pow(static_cast<GLfloat>(live_cnt), -valence_boost_power);
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! MeshOpt::fan_to_list
+ * @brief Convert triangle fans to a triangle list.
+ *
+ * Consecutive indices i, i + 1 of a fan starting with index c become
+ * triangle c, i, i + 1, which has the winding of the fan. Triangles with
+ * two equal indices cover no pixels and are dropped.
+ *
+ * @param idx_vtx[in] Indices of fans separated by MeshIndex::restart.
+ * @return Indices of the triangle list.
+*/
+std::vector<GLuint> MeshOpt::fan_to_list(std::vector<GLuint> const& idx_vtx)
+{
+  std::vector<GLuint> tri_idx;
+  tri_idx.reserve(idx_vtx.size() * 3);
+
+  size_t start{ 0 }; // first index of the current fan
+  for (size_t i{ 0 }; i <= idx_vtx.size(); ++i) {
+    if (i < idx_vtx.size() && idx_vtx[i] != MeshIndex::restart) {
+      continue;
+    }
+    for (size_t j{ start + 2 }; j < i; ++j) {
+      GLuint const a{ idx_vtx[start] }, b{ idx_vtx[j - 1] }, c{ idx_vtx[j] };
+      if (a != b && b != c && c != a) {
+        tri_idx.insert(tri_idx.end(), { a, b, c });
+      }
+    }
+    start = i + 1;
+  }
+  return tri_idx;
+}
+
+/*  _________________________________________________________________________ */
+/*! MeshOpt::optimize_vertex_cache
+ * @brief Reorder the triangles of a triangle list with Forsyth's linear-speed
+ * vertex cache optimization.
+ *
+ * Each vertex is scored by its position in a modeled LRU cache and by the
+ * number of its triangles not yet emitted, and each triangle by the sum of
+ * the scores of its vertices. The triangle emitted next is the best scoring
+ * one using a vertex in the cache; after it is emitted its vertices move to
+ * the front of the cache and only the vertices that were in the cache are
+ * rescored. If no triangle uses a cached vertex, the first triangle not yet
+ * emitted is taken, so the whole reordering stays close to linear time.
+ *
+ * @param idx_vtx[in,out] Indices of the triangle list; a trailing partial
+ * triangle is dropped.
+ * @param vtx_cnt[in] Number of vertices; every index must be below it.
+ * @return void
+*/
+void MeshOpt::optimize_vertex_cache(std::vector<GLuint>& idx_vtx, size_t vtx_cnt)
+{
+  size_t const tri_cnt{ idx_vtx.size() / 3 };
+  if (tri_cnt == 0) {
+    idx_vtx.clear();
+    return;
+  }
+
+  // triangles of vertex v not yet emitted are vtx_tris[tri_first[v]] up to
+  // vtx_tris[tri_first[v] + live_cnt[v] - 1]; emitted ones are swapped past
+  std::vector<GLuint> live_cnt(vtx_cnt, 0), tri_first(vtx_cnt + 1, 0);
+  for (size_t i{ 0 }; i < 3 * tri_cnt; ++i) {
+    ++live_cnt[idx_vtx[i]];
+  }
+  for (size_t v{ 0 }; v < vtx_cnt; ++v) {
+    tri_first[v + 1] = tri_first[v] + live_cnt[v];
+  }
+  std::vector<GLuint> vtx_tris(3 * tri_cnt);
+  {
+    std::vector<GLuint> fill(tri_first.begin(), tri_first.end() - 1);
+    for (size_t i{ 0 }; i < 3 * tri_cnt; ++i) {
+      vtx_tris[fill[idx_vtx[i]]++] = static_cast<GLuint>(i / 3);
+    }
+  }
+
+  std::vector<GLfloat> vtx_score(vtx_cnt), tri_score(tri_cnt, 0.f);
+  for (size_t v{ 0 }; v < vtx_cnt; ++v) {
+    vtx_score[v] = vertex_score(-1, live_cnt[v]);
+  }
+  for (size_t i{ 0 }; i < 3 * tri_cnt; ++i) {
+    tri_score[i / 3] += vtx_score[idx_vtx[i]];
+  }
+
+  std::vector<bool> emitted(tri_cnt, false);
+  std::vector<GLuint> cache, next_cache;
+  std::vector<GLuint> tri_idx;
+  tri_idx.reserve(3 * tri_cnt);
+  size_t best{ static_cast<size_t>(std::max_element(tri_score.begin(), tri_score.end()) - tri_score.begin()) };
+  size_t next_unemitted{ 0 };
+
+  while (tri_idx.size() < 3 * tri_cnt) {
+    if (best == tri_cnt) {
+      while (emitted[next_unemitted]) {
+        ++next_unemitted;
+      }
+      best = next_unemitted;
+    }
+
+    // emit the triangle and put its vertices in front of the cache
+    emitted[best] = true;
+    next_cache.clear();
+    for (size_t k{ 0 }; k < 3; ++k) {
+      GLuint const v{ idx_vtx[3 * best + k] };
+      tri_idx.push_back(v);
+
+      GLuint* const first{ vtx_tris.data() + tri_first[v] };
+      GLuint* const last{ first + live_cnt[v] };
+      *std::find(first, last, static_cast<GLuint>(best)) = *(last - 1);
+      --live_cnt[v];
+
+      if (std::find(next_cache.begin(), next_cache.end(), v) == next_cache.end()) {
+        next_cache.push_back(v);
+      }
+    }
+    for (GLuint v : cache) {
+      if (std::find(next_cache.begin(), next_cache.end(), v) == next_cache.end()) {
+        next_cache.push_back(v);
+      }
+    }
+
+    // rescore the vertices that were in the cache, including those just
+    // evicted, and their triangles
+    for (size_t pos{ 0 }; pos < next_cache.size(); ++pos) {
+      GLuint const v{ next_cache[pos] };
+      GLfloat const score{ vertex_score(pos < score_cache_size ? static_cast<int>(pos) : -1, live_cnt[v]) };
+      GLfloat const delta{ score - vtx_score[v] };
+      vtx_score[v] = score;
+      for (GLuint j{ tri_first[v] }; j < tri_first[v] + live_cnt[v]; ++j) {
+        tri_score[vtx_tris[j]] += delta;
+      }
+    }
+    if (next_cache.size() > score_cache_size) {
+      next_cache.resize(score_cache_size);
+    }
+    cache.swap(next_cache);
+
+    // best triangle using a cached vertex
+    best = tri_cnt;
+    GLfloat best_score{ -1.f };
+    for (GLuint v : cache) {
+      for (GLuint j{ tri_first[v] }; j < tri_first[v] + live_cnt[v]; ++j) {
+        GLuint const t{ vtx_tris[j] };
+        if (tri_score[t] > best_score) {
+          best_score = tri_score[t];
+          best = t;
+        }
+      }
+    }
+  }
+  idx_vtx.swap(tri_idx);
+}
+
+/*  _________________________________________________________________________ */
+/*! MeshOpt::optimize_vertex_fetch
+ * @brief Renumber the vertices in the order they are first used.
+ *
+ * Run after optimize_vertex_cache, so that the vertices a cache miss
+ * fetches are mostly next to the ones fetched before it.
+ *
+ * @param pos_vtx[in,out] Vertex positions; reordered, and vertices that no
+ * index uses are removed.
+ * @param idx_vtx[in,out] Indices of a triangle list, renumbered.
+ * @return void
+*/
+void MeshOpt::optimize_vertex_fetch(std::vector<glm::vec2>& pos_vtx, std::vector<GLuint>& idx_vtx)
+{
+  std::vector<GLuint> remap(pos_vtx.size(), MeshIndex::restart);
+  std::vector<glm::vec2> fetched;
+  fetched.reserve(pos_vtx.size());
+  for (GLuint& idx : idx_vtx) {
+    if (remap[idx] == MeshIndex::restart) {
+      remap[idx] = static_cast<GLuint>(fetched.size());
+      fetched.push_back(pos_vtx[idx]);
+    }
+    idx = remap[idx];
+  }
+  pos_vtx.swap(fetched);
+}
+
+/*  _________________________________________________________________________ */
+/*! MeshOpt::acmr
+ * @brief Compute the average cache miss ratio of a triangle list.
+ *
+ * The post-transform cache is simulated as a FIFO of cache_size vertices.
+ * A vertex is a hit while fewer than cache_size misses followed the miss
+ * that brought it into the cache. The ratio is between 3 (no vertex reused
+ * from the cache) and about 0.5 (a large regular grid).
+ *
+ * @param idx_vtx[in] Indices of the triangle list.
+ * @param vtx_cnt[in] Number of vertices; every index must be below it.
+ * @return Cache misses per triangle; 0 if there are no triangles.
+*/
+GLfloat MeshOpt::acmr(std::vector<GLuint> const& idx_vtx, size_t vtx_cnt)
+{
+  size_t const tri_cnt{ idx_vtx.size() / 3 };
+  if (tri_cnt == 0) {
+    return 0.f;
+  }
+
+  // number of misses when each vertex last entered the cache; 0 if never
+  std::vector<size_t> entered(vtx_cnt, 0);
+  size_t misses{ 0 };
+  for (size_t i{ 0 }; i < 3 * tri_cnt; ++i) {
+    GLuint const v{ idx_vtx[i] };
+    if (entered[v] == 0 || misses - entered[v] >= cache_size) {
+      entered[v] = ++misses;
+    }
+  }
+  return static_cast<GLfloat>(misses) / static_cast<GLfloat>(tri_cnt);
+}
+
+/*  _________________________________________________________________________ */
+/*! MeshOpt::optimize
+ * @brief Convert a mesh to a triangle list ordered for the vertex cache and
+ * vertex fetch.
+ *
+ * @param primitive_type[in,out] GL_TRIANGLES or GL_TRIANGLE_FAN; becomes
+ * GL_TRIANGLES.
+ * @param pos_vtx[in,out] Vertex positions.
+ * @param idx_vtx[in,out] Vertex indices; fans may be separated by
+ * MeshIndex::restart.
+ * @return Triangle count and ACMR before and after; all 0 if the mesh was
+ * left as it is.
+*/
+MeshOpt::Report MeshOpt::optimize(GLenum& primitive_type, std::vector<glm::vec2>& pos_vtx,
+                                  std::vector<GLuint>& idx_vtx)
+{
+  std::vector<std::vector<GLuint>> levels(1);
+  levels[0].swap(idx_vtx);
+  Report const report{ optimize(primitive_type, pos_vtx, levels) };
+  idx_vtx.swap(levels[0]);
+  return report;
+}
+
+/*  _________________________________________________________________________ */
+/*! MeshOpt::optimize
+ * @brief Convert the levels of detail of a mesh to triangle lists ordered
+ * for the vertex cache and vertex fetch.
+ *
+ * The triangles of each level are reordered on their own. The ACMR before
+ * is that of the first level in the order it was authored, after fans are
+ * converted, which the fans themselves share. The authored order of a level
+ * is kept if optimize_vertex_cache does not lower it, which happens for
+ * meshes small enough to fit the cache. Since the levels share the
+ * vertices, these are renumbered in the order the levels, finest first,
+ * use them.
+ *
+ * @param primitive_type[in,out] GL_TRIANGLES or GL_TRIANGLE_FAN; becomes
+ * GL_TRIANGLES.
+ * @param pos_vtx[in,out] Vertex positions.
+ * @param levels[in,out] Vertex indices of each level; fans may be separated
+ * by MeshIndex::restart.
+ * @return Triangle count and ACMR before and after of the first level; all 0
+ * if the mesh was left as it is.
+*/
+MeshOpt::Report MeshOpt::optimize(GLenum& primitive_type, std::vector<glm::vec2>& pos_vtx,
+                                  std::vector<std::vector<GLuint>>& levels)
+{
+  Report report;
+  if (levels.empty() || (primitive_type != GL_TRIANGLES && primitive_type != GL_TRIANGLE_FAN)) {
+    return report;
+  }
+  for (std::vector<GLuint> const& idx_vtx : levels) {
+    for (GLuint idx : idx_vtx) {
+      if (idx >= pos_vtx.size() && !(primitive_type == GL_TRIANGLE_FAN && idx == MeshIndex::restart)) {
+        return report;
+      }
+    }
+  }
+
+  for (std::vector<GLuint>& idx_vtx : levels) {
+    if (primitive_type == GL_TRIANGLE_FAN) {
+      idx_vtx = fan_to_list(idx_vtx);
+    }
+
+    GLfloat const acmr_before{ acmr(idx_vtx, pos_vtx.size()) };
+    if (&idx_vtx == &levels[0]) {
+      report.tri_cnt = static_cast<GLuint>(idx_vtx.size() / 3);
+      report.acmr_before = acmr_before;
+    }
+
+    // small meshes may already be in a better order than the greedy one
+    std::vector<GLuint> reordered{ idx_vtx };
+    optimize_vertex_cache(reordered, pos_vtx.size());
+    if (acmr(reordered, pos_vtx.size()) < acmr_before) {
+      idx_vtx.swap(reordered);
+    }
+  }
+  primitive_type = GL_TRIANGLES;
+
+  // renumber the vertices over the levels put end to end
+  std::vector<GLuint> all_idx;
+  for (std::vector<GLuint> const& idx_vtx : levels) {
+    all_idx.insert(all_idx.end(), idx_vtx.begin(), idx_vtx.end());
+  }
+  optimize_vertex_fetch(pos_vtx, all_idx);
+  std::vector<GLuint>::const_iterator it{ all_idx.begin() };
+  for (std::vector<GLuint>& idx_vtx : levels) {
+    std::copy(it, it + idx_vtx.size(), idx_vtx.begin());
+    it += idx_vtx.size();
+  }
+
+  report.acmr_after = acmr(levels[0], pos_vtx.size());
+  return report;
+}
+
+/*  _________________________________________________________________________ */
+/*! MeshOpt::benchmark
+ * @brief Print the ACMR of grids before and after optimization and the time
+ * optimize takes.
+ *
+ * Grids of n x n vertices are split into 2 (n-1)^2 triangles row by row, so
+ * once a row has more vertices than the cache, every vertex is shaded twice.
+ *
+ * @param none
+ * @return void
+*/
+void MeshOpt::benchmark()
+{
+  GLuint const sizes[]{ 8, 16, 64, 256 };
+
+  std::cout << "Triangles\t|\tACMR before\t|\tACMR after\t|\tTime (ms)\n";
+  std::cout << "--------------------------------------------------------------------------\n";
+  for (GLuint n : sizes) {
+    std::vector<glm::vec2> pos_vtx;
+    std::vector<GLuint> idx_vtx;
+    for (GLuint row{ 0 }; row < n; ++row) {
+      for (GLuint col{ 0 }; col < n; ++col) {
+        pos_vtx.emplace_back(glm::vec2{ col / (n - 1.f) - 0.5f, row / (n - 1.f) - 0.5f });
+      }
+    }
+    for (GLuint row{ 0 }; row + 1 < n; ++row) {
+      for (GLuint col{ 0 }; col + 1 < n; ++col) {
+        GLuint const i0{ row * n + col };
+        GLuint const i1{ i0 + 1 };
+        GLuint const i2{ i0 + n };
+        GLuint const i3{ i2 + 1 };
+        idx_vtx.insert(idx_vtx.end(), { i0, i1, i3, i3, i2, i0 });
+      }
+    }
+
+    GLenum primitive_type{ GL_TRIANGLES };
+    double const start{ glfwGetTime() };
+    Report const report{ optimize(primitive_type, pos_vtx, idx_vtx) };
+    double const ms{ (glfwGetTime() - start) * 1000.0 };
+
+    std::cout << report.tri_cnt << "\t\t" << std::setprecision(3) << std::fixed
+              << report.acmr_before << "\t\t\t" << report.acmr_after << "\t\t\t" << ms << "\n";
+  }
+  std::cout << "--------------------------------------------------------------------------\n";
+  std::cout << std::defaultfloat;
+}
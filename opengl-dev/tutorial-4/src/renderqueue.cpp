@@ -0,0 +1,93 @@
+/*!
+* @file    renderqueue.cpp
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/12/2023
+*
+* @brief This file implements class RenderQueue declared in renderqueue.h.
+*//*__________________________________________________________________________*/
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <renderqueue.h>
+
+/*  _________________________________________________________________________ */
+/*! RenderQueue::submit_items
+ * @brief Make the draw calls in the order they were pushed in.
+ *
+ * The program is installed only when it differs from that of the previous
+ * draw call, and likewise the VAO is bound only when it differs, so only
+ * runs of draw calls sharing them are batched; nothing is reordered. Binds
+ * made and skipped are counted in stats.
+ *
+ * @param set_uniforms[in] Called with the installed program and the item
+ * before each draw call to set its uniform variables.
+ * @return void
+*/
+template <typename SetUniforms>
+void RenderQueue::submit_items(SetUniforms const& set_uniforms)
+{
+  stats = Stats{};
+
+  GLSLShader* cur_pgm{ nullptr };
+  GLuint cur_vao{ 0 };
+  for (Item const& item : items) {
+    if (item.shdr_pgm != cur_pgm) {
+      cur_pgm = item.shdr_pgm;
+      cur_pgm->Use();
+      ++stats.pgm_binds;
+    }
+    else {
+      ++stats.pgm_skipped;
+    }
+
+    if (item.vaoid != cur_vao) {
+      cur_vao = item.vaoid;
+      glBindVertexArray(cur_vao);
+      ++stats.vao_binds;
+    }
+    else {
+      ++stats.vao_skipped;
+    }
+
+    set_uniforms(*cur_pgm, item);
+    glDrawElements(item.primitive_type, item.draw_cnt, item.idx_type,
+                   reinterpret_cast<GLvoid const*>(item.idx_offset));
+    ++stats.draws;
+  }
+
+  if (cur_pgm != nullptr) {
+    glBindVertexArray(0);
+    cur_pgm->UnUse();
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! RenderQueue::submit
+ * @brief Make the draw calls, setting the color and transform of each.
+ *
+ * @param color_uniform[in] Handle of the color uniform variable.
+ * @param xform_uniform[in] Handle of the transform uniform variable.
+ * @return void
+*/
+void RenderQueue::submit(GLSLShader::UniformHandle color_uniform, GLSLShader::UniformHandle xform_uniform)
+{
+  submit_items([=](GLSLShader& pgm, Item const& item) {
+    pgm.SetUniform(color_uniform, *item.color);
+    pgm.SetUniform(xform_uniform, *item.xform);
+  });
+}
+
+/*  _________________________________________________________________________ */
+/*! RenderQueue::submit
+ * @brief Make the draw calls, setting only the index of the per-draw data
+ * of each.
+ *
+ * @param idx_uniform[in] Handle of the index uniform variable.
+ * @return void
+*/
+void RenderQueue::submit(GLSLShader::UniformHandle idx_uniform)
+{
+  submit_items([=](GLSLShader& pgm, Item const& item) {
+    pgm.SetUniform(idx_uniform, item.draw_idx);
+  });
+}
@@ -0,0 +1,251 @@
+/*!
+* @file    ringbuffer.cpp
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/16/2023
+*
+* @brief This file implements class RingBuffer declared in ringbuffer.h.
+*//*__________________________________________________________________________*/
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <ringbuffer.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+/*  _________________________________________________________________________ */
+/*! RingBuffer::init
+ * @brief Create the buffer with immutable storage and map it persistently.
+ *
+ * @param size[in] Minimum size in bytes of the region of a frame; rounded
+ * up to a multiple of region_alignment.
+ * @param cnt[in] Number of frames that may be in flight.
+ * @return void
+*/
+void RingBuffer::init(GLsizeiptr size, GLuint cnt)
+{
+  destroy();
+
+  region_size = (std::max<GLsizeiptr>(size, 1) + region_alignment - 1) / region_alignment * region_alignment;
+  frame_cnt = std::max<GLuint>(cnt, 1);
+  GLbitfield const flags{ GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT };
+
+  glCreateBuffers(1, &buffer);
+  glNamedBufferStorage(buffer, region_size * frame_cnt, nullptr, flags);
+  base = static_cast<char*>(glMapNamedBufferRange(buffer, 0, region_size * frame_cnt, flags));
+  if (base == nullptr) {
+    std::cout << "ERROR: Unable to map ring buffer of " << region_size * frame_cnt << " bytes\n";
+    std::exit(EXIT_FAILURE);
+  }
+
+  fences.assign(frame_cnt, nullptr);
+  region = frame_cnt - 1;
+  head = region_size; // nothing can be allocated before begin_frame
+}
+
+/*  _________________________________________________________________________ */
+/*! RingBuffer::destroy
+ * @brief Wait for the GPU to finish with every region, then unmap and delete
+ * the buffer.
+ *
+ * @param none
+ * @return void
+*/
+void RingBuffer::destroy()
+{
+  if (buffer == 0) {
+    return;
+  }
+
+  for (GLuint i{ 0 }; i < frame_cnt; ++i) {
+    wait(i);
+  }
+  glUnmapNamedBuffer(buffer);
+  glDeleteBuffers(1, &buffer);
+  buffer = 0;
+  base = nullptr;
+}
+
+/*  _________________________________________________________________________ */
+/*! RingBuffer::wait
+ * @brief Wait until the GPU passed the fence of a region and delete it.
+ *
+ * The fence is first polled without waiting; only if it has not been
+ * signaled yet is the wait counted as a stall.
+ *
+ * @param i[in] Region to wait for.
+ * @return void
+*/
+void RingBuffer::wait(GLuint i)
+{
+  if (fences[i] == nullptr) {
+    return;
+  }
+
+  GLenum result{ glClientWaitSync(fences[i], 0, 0) };
+  if (result == GL_TIMEOUT_EXPIRED) {
+    ++stall_cnt;
+    do {
+      result = glClientWaitSync(fences[i], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+    } while (result == GL_TIMEOUT_EXPIRED);
+  }
+  glDeleteSync(fences[i]);
+  fences[i] = nullptr;
+}
+
+/*  _________________________________________________________________________ */
+/*! RingBuffer::begin_frame
+ * @brief Start allocating from the next region.
+ *
+ * @param none
+ * @return void
+*/
+void RingBuffer::begin_frame()
+{
+  region = (region + 1) % frame_cnt;
+  wait(region);
+  head = 0;
+}
+
+/*  _________________________________________________________________________ */
+/*! RingBuffer::end_frame
+ * @brief Fence the commands that read the region of the current frame.
+ *
+ * @param none
+ * @return void
+*/
+void RingBuffer::end_frame()
+{
+  fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+/*  _________________________________________________________________________ */
+/*! RingBuffer::reserve
+ * @brief Grow the buffer if a frame needs more than a region.
+ *
+ * The new regions are twice as large as the old ones, or size bytes if that
+ * is larger. Replacing the buffer waits for every frame in flight, so the
+ * regions should be large enough for this to happen rarely.
+ *
+ * @param size[in] Bytes the current frame will allocate, including padding.
+ * @return void
+*/
+void RingBuffer::reserve(GLsizeiptr size)
+{
+  if (size <= region_size - head) {
+    return;
+  }
+
+  init(std::max(size, 2 * region_size), frame_cnt);
+  begin_frame();
+}
+
+/*  _________________________________________________________________________ */
+/*! RingBuffer::allocate
+ * @brief Allocate memory in the region of the current frame.
+ *
+ * @param size[in] Number of bytes.
+ * @param alignment[in] Alignment of the offset in the buffer; at most
+ * region_alignment.
+ * @return Mapped address and offset of the memory, or a null address if the
+ * region is full.
+*/
+RingBuffer::Allocation RingBuffer::allocate(GLsizeiptr size, GLsizeiptr alignment)
+{
+  GLsizeiptr const start{ (head + alignment - 1) / alignment * alignment };
+  if (start + size > region_size) {
+    return Allocation{ nullptr, 0 };
+  }
+
+  head = start + size;
+  GLintptr const offset{ region * region_size + start };
+  return Allocation{ base + offset, offset };
+}
+
+/*  _________________________________________________________________________ */
+/*! RingBuffer::benchmark
+ * @brief Print the cost of streaming transforms with glNamedBufferSubData and
+ * with a ring buffer.
+ *
+ * Each frame writes xform_cnt model-to-world matrices, as three vec4 columns,
+ * and has the GPU read them by copying them to another buffer, as a shader
+ * reading them would. With glNamedBufferSubData the matrices are written to
+ * an array and the driver copies them to a buffer the GPU may still be
+ * reading. With the ring buffer they are written to the mapped region of the
+ * frame. The CPU time per frame is measured before glFinish and the total
+ * time per frame after it.
+ *
+ * @param xform_cnt[in] Number of transforms streamed per frame.
+ * @return void
+*/
+void RingBuffer::benchmark(GLuint xform_cnt)
+{
+  int const frames{ 120 };
+  GLsizeiptr const bytes{ static_cast<GLsizeiptr>(sizeof(glm::vec4) * 3 * xform_cnt) };
+
+  // same transforms for both methods, written in order
+  auto write_xforms = [xform_cnt](glm::vec4* out, int frame) {
+    for (GLuint i{ 0 }; i < xform_cnt; ++i) {
+      GLfloat const angle{ 0.001f * static_cast<GLfloat>(i + frame) };
+      GLfloat const c{ std::cos(angle) }, s{ std::sin(angle) };
+      out[3 * i] = glm::vec4{ 100.f * c, 100.f * s, 0.f, 0.f };
+      out[3 * i + 1] = glm::vec4{ -100.f * s, 100.f * c, 0.f, 0.f };
+      out[3 * i + 2] = glm::vec4{ static_cast<GLfloat>(i % 256), static_cast<GLfloat>(i / 256), 1.f, 0.f };
+    }
+  };
+
+  GLuint sink;
+  glCreateBuffers(1, &sink);
+  glNamedBufferStorage(sink, bytes, nullptr, 0);
+
+  // glNamedBufferSubData from an array
+  GLuint src;
+  glCreateBuffers(1, &src);
+  glNamedBufferStorage(src, bytes, nullptr, GL_DYNAMIC_STORAGE_BIT);
+  std::vector<glm::vec4> staging(3 * static_cast<size_t>(xform_cnt));
+
+  glFinish();
+  double start{ glfwGetTime() };
+  for (int f{ 0 }; f < frames; ++f) {
+    write_xforms(staging.data(), f);
+    glNamedBufferSubData(src, 0, bytes, staging.data());
+    glCopyNamedBufferSubData(src, sink, 0, 0, bytes);
+  }
+  double const sub_cpu_ms{ (glfwGetTime() - start) * 1000.0 / frames };
+  glFinish();
+  double const sub_total_ms{ (glfwGetTime() - start) * 1000.0 / frames };
+  glDeleteBuffers(1, &src);
+
+  // persistently mapped ring buffer
+  RingBuffer ring;
+  ring.init(bytes);
+
+  glFinish();
+  start = glfwGetTime();
+  for (int f{ 0 }; f < frames; ++f) {
+    ring.begin_frame();
+    Allocation const xforms{ ring.allocate(bytes, sizeof(glm::vec4)) };
+    write_xforms(static_cast<glm::vec4*>(xforms.ptr), f);
+    glCopyNamedBufferSubData(ring.get_buffer(), sink, xforms.offset, 0, bytes);
+    ring.end_frame();
+  }
+  double const ring_cpu_ms{ (glfwGetTime() - start) * 1000.0 / frames };
+  glFinish();
+  double const ring_total_ms{ (glfwGetTime() - start) * 1000.0 / frames };
+  GLuint const stalls{ ring.get_stall_count() };
+  ring.destroy();
+  glDeleteBuffers(1, &sink);
+
+  std::cout << "Transforms per frame: " << xform_cnt << "\n";
+  std::cout << "Method\t\t\t|\tCPU (ms/frame)\t|\tTotal (ms/frame)\t|\tStalls\n";
+  std::cout << "----------------------------------------------------------------------------------------\n";
+  std::cout << "glNamedBufferSubData\t" << std::setprecision(3) << std::fixed << sub_cpu_ms << "\t\t\t"
+            << sub_total_ms << "\t\t\t\t-\n";
+  std::cout << "Ring buffer\t\t" << ring_cpu_ms << "\t\t\t" << ring_total_ms << "\t\t\t\t" << stalls << "\n";
+  std::cout << "----------------------------------------------------------------------------------------\n";
+  std::cout << std::defaultfloat;
+}
@@ -0,0 +1,460 @@
+/*!
+* @file    scenebin.cpp
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/6/2023
+*
+* @brief This file implements the conversion of text scene files to binary
+*		 scene files and the memory-mapped loading of binary scene files
+*		 declared in scenebin.h.
+*//*__________________________________________________________________________*/
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <scenebin.h>
+#include <mappedfile.h>
+#include <GLFW/glfw3.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <unordered_map>
+#include <algorithm>
+#include <numeric>
+#include <cstring>
+
+/*                                                   objects with file scope
+----------------------------------------------------------------------------- */
+namespace {
+  static_assert(sizeof(SceneBin::Header) == 40);
+  static_assert(sizeof(SceneBin::ShdrPgmRecord) == 12);
+  static_assert(sizeof(SceneBin::ObjectRecord) == 48);
+
+  // round offset up to the next multiple of 4 bytes
+  std::uint32_t align4(size_t offset)
+  {
+    return static_cast<std::uint32_t>((offset + 3) & ~size_t{ 3 });
+  }
+
+  // string table that stores each distinct string once
+  struct StringTable {
+    std::string blob;
+    std::unordered_map<std::string, std::uint32_t> offsets;
+
+    std::uint32_t intern(std::string const& str)
+    {
+      auto [it, inserted] = offsets.try_emplace(str, static_cast<std::uint32_t>(blob.size()));
+      if (inserted) {
+        blob.append(str);
+        blob.push_back('\0');
+      }
+      return it->second;
+    }
+  };
+
+  // whether bin_file starts with the magic and version this build writes
+  bool current_format(std::string const& bin_file)
+  {
+    SceneBin::Header header{};
+    std::ifstream ifs{ bin_file, std::ios::binary };
+    ifs.read(reinterpret_cast<char*>(&header), sizeof(header));
+    return ifs && header.magic == SceneBin::MAGIC && header.version == SceneBin::VERSION;
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! SceneBin::read_text
+ * @brief Read a text scene file.
+ *
+ * The first line holds the number of objects. Each object is described by
+ * seven lines: model name, object name, shader program name with vertex and
+ * fragment shader paths, color, scaling, orientation and position. Models and
+ * shader programs are added to the scene the first time they are named.
+ *
+ * @param scn_file[in] Path of the text scene file.
+ * @param scene[out] Contents of the scene file.
+ * @return GL_TRUE if the file was read.
+*/
+GLboolean SceneBin::read_text(std::string const& scn_file, Scene& scene)
+{
+  std::ifstream ifs{ scn_file, std::ios::in };
+  if (!ifs) {
+    return GL_FALSE;
+  }
+
+  scene = Scene{};
+  std::unordered_map<std::string, GLuint> model_idx, shdrpgm_idx;
+
+  std::string line;
+  std::getline(ifs, line); // first line is count of objects in scene
+  std::istringstream line_sstm{ line };
+  int obj_cnt{ 0 };
+  line_sstm >> obj_cnt; // read count of objects in scene
+  scene.objects.reserve(static_cast<size_t>(std::max(obj_cnt, 0)));
+  while (obj_cnt-- > 0) { // read each object's parameters
+    Object obj;
+
+    std::getline(ifs, line); // 1st parameter - model name
+    std::istringstream line_modelname{ line };
+    std::string model_name;
+    line_modelname >> model_name;
+
+    std::getline(ifs, line); // 2nd parameter - object name
+    std::istringstream line_objectname{ line };
+    line_objectname >> obj.name;
+
+    std::getline(ifs, line); // 3rd parameter - shader program details
+    std::istringstream line_shdr_pgm{ line };
+    ShdrPgm shdrpgm;
+    line_shdr_pgm >> shdrpgm.name >> shdrpgm.vtx_shdr >> shdrpgm.frg_shdr;
+
+    std::getline(ifs, line); // 4th parameter - object rgb parameters
+    std::istringstream line_rgb{ line };
+    line_rgb >> obj.color.r >> obj.color.g >> obj.color.b;
+
+    std::getline(ifs, line); // 5th parameter - object scaling factors
+    std::istringstream line_scale{ line };
+    line_scale >> obj.scaling.x >> obj.scaling.y;
+
+    std::getline(ifs, line); // 6th parameter - object orientation factors
+    std::istringstream line_ort{ line };
+    line_ort >> obj.orientation.x >> obj.orientation.y;
+
+    std::getline(ifs, line); // 7th parameter - object position in world
+    std::istringstream line_pos{ line };
+    line_pos >> obj.position.x >> obj.position.y;
+
+    auto [mdl_it, new_model] = model_idx.try_emplace(model_name, static_cast<GLuint>(scene.models.size()));
+    if (new_model) {
+      scene.models.emplace_back(model_name);
+    }
+    obj.model = mdl_it->second;
+
+    auto [shd_it, new_shdrpgm] = shdrpgm_idx.try_emplace(shdrpgm.name, static_cast<GLuint>(scene.shdrpgms.size()));
+    if (new_shdrpgm) {
+      scene.shdrpgms.emplace_back(std::move(shdrpgm));
+    }
+    obj.shdrpgm = shd_it->second;
+
+    scene.objects.emplace_back(std::move(obj));
+  }
+  return GL_TRUE;
+}
+
+/*  _________________________________________________________________________ */
+/*! SceneBin::write_text
+ * @brief Write a scene in the text scene format.
+ *
+ * Floating-point values are written with enough digits to be read back
+ * without change.
+ *
+ * @param scn_file[in] Path of the text scene file.
+ * @param scene[in] Scene to write.
+ * @return GL_TRUE if the file was written.
+*/
+GLboolean SceneBin::write_text(std::string const& scn_file, Scene const& scene)
+{
+  std::ofstream ofs{ scn_file, std::ios::out };
+  if (!ofs) {
+    return GL_FALSE;
+  }
+
+  ofs << std::setprecision(9);
+  ofs << scene.objects.size() << "\n";
+  for (Object const& obj : scene.objects) {
+    ShdrPgm const& shdrpgm{ scene.shdrpgms[obj.shdrpgm] };
+    ofs << scene.models[obj.model] << "\n"
+        << obj.name << "\n"
+        << shdrpgm.name << " " << shdrpgm.vtx_shdr << " " << shdrpgm.frg_shdr << "\n"
+        << obj.color.r << " " << obj.color.g << " " << obj.color.b << "\n"
+        << obj.scaling.x << " " << obj.scaling.y << "\n"
+        << obj.orientation.x << " " << obj.orientation.y << "\n"
+        << obj.position.x << " " << obj.position.y << "\n";
+  }
+  return ofs.good() ? GL_TRUE : GL_FALSE;
+}
+
+/*  _________________________________________________________________________ */
+/*! SceneBin::read
+ * @brief Read a binary scene file.
+ *
+ * The file is memory-mapped and its tables are read in place. Every offset
+ * and index is checked against the size of the file before it is used.
+ *
+ * @param bin_file[in] Path of the binary scene file.
+ * @param scene[out] Contents of the scene file.
+ * @return GL_TRUE if the file was valid.
+*/
+GLboolean SceneBin::read(std::string const& bin_file, Scene& scene)
+{
+  MappedFile file;
+  if (GL_FALSE == file.open(bin_file) || file.size() < sizeof(Header)) {
+    return GL_FALSE;
+  }
+
+  char const* const bytes{ static_cast<char const*>(file.data()) };
+  size_t const size{ file.size() };
+  Header header;
+  std::memcpy(&header, bytes, sizeof(header));
+  if (header.magic != MAGIC || header.version != VERSION ||
+      size_t{ header.strings_offset } + header.strings_size > size ||
+      size_t{ header.models_offset } + sizeof(std::uint32_t) * header.model_cnt > size ||
+      size_t{ header.shdrpgms_offset } + sizeof(ShdrPgmRecord) * header.shdrpgm_cnt > size ||
+      size_t{ header.objects_offset } + sizeof(ObjectRecord) * header.object_cnt > size ||
+      header.strings_size == 0 || bytes[header.strings_offset + header.strings_size - 1] != '\0') {
+    return GL_FALSE;
+  }
+
+  // every string ends at the latest with the last byte of the string table
+  char const* const strings{ bytes + header.strings_offset };
+  GLboolean valid{ GL_TRUE };
+  auto string_at = [&](std::uint32_t offset) {
+    if (offset >= header.strings_size) {
+      valid = GL_FALSE;
+      return std::string();
+    }
+    return std::string(strings + offset);
+  };
+
+  scene = Scene{};
+  auto const models{ reinterpret_cast<std::uint32_t const*>(bytes + header.models_offset) };
+  scene.models.reserve(header.model_cnt);
+  for (std::uint32_t i{ 0 }; i < header.model_cnt; ++i) {
+    scene.models.emplace_back(string_at(models[i]));
+  }
+
+  auto const shdrpgms{ reinterpret_cast<ShdrPgmRecord const*>(bytes + header.shdrpgms_offset) };
+  scene.shdrpgms.reserve(header.shdrpgm_cnt);
+  for (std::uint32_t i{ 0 }; i < header.shdrpgm_cnt; ++i) {
+    scene.shdrpgms.emplace_back(ShdrPgm{ string_at(shdrpgms[i].name),
+                                         string_at(shdrpgms[i].vtx_shdr),
+                                         string_at(shdrpgms[i].frg_shdr) });
+  }
+
+  auto const objects{ reinterpret_cast<ObjectRecord const*>(bytes + header.objects_offset) };
+  scene.objects.resize(header.object_cnt);
+  for (std::uint32_t i{ 0 }; i < header.object_cnt; ++i) {
+    ObjectRecord const& rec{ objects[i] };
+    Object& obj{ scene.objects[i] };
+    if (rec.model >= header.model_cnt || rec.shdrpgm >= header.shdrpgm_cnt) {
+      return GL_FALSE;
+    }
+    obj.name = string_at(rec.name);
+    obj.model = rec.model;
+    obj.shdrpgm = rec.shdrpgm;
+    obj.color = glm::vec3{ rec.color[0], rec.color[1], rec.color[2] };
+    obj.scaling = glm::vec2{ rec.scaling[0], rec.scaling[1] };
+    obj.orientation = glm::vec2{ rec.orientation[0], rec.orientation[1] };
+    obj.position = glm::vec2{ rec.position[0], rec.position[1] };
+  }
+  return valid;
+}
+
+/*  _________________________________________________________________________ */
+/*! SceneBin::write
+ * @brief Write a scene in the binary scene format.
+ *
+ * Objects are written sorted by name so that they can be appended to a
+ * sorted container one after the other. Objects with the same name keep
+ * their relative order.
+ *
+ * @param bin_file[in] Path of the binary scene file.
+ * @param scene[in] Scene to write.
+ * @return GL_TRUE if the file was written.
+*/
+GLboolean SceneBin::write(std::string const& bin_file, Scene const& scene)
+{
+  StringTable strings;
+
+  std::vector<std::uint32_t> models;
+  models.reserve(scene.models.size());
+  for (std::string const& model : scene.models) {
+    models.emplace_back(strings.intern(model));
+  }
+
+  std::vector<ShdrPgmRecord> shdrpgms;
+  shdrpgms.reserve(scene.shdrpgms.size());
+  for (ShdrPgm const& shdrpgm : scene.shdrpgms) {
+    shdrpgms.emplace_back(ShdrPgmRecord{ strings.intern(shdrpgm.name),
+                                         strings.intern(shdrpgm.vtx_shdr),
+                                         strings.intern(shdrpgm.frg_shdr) });
+  }
+
+  std::vector<size_t> order(scene.objects.size());
+  std::iota(order.begin(), order.end(), size_t{ 0 });
+  std::stable_sort(order.begin(), order.end(), [&scene](size_t lhs, size_t rhs) {
+    return scene.objects[lhs].name < scene.objects[rhs].name;
+  });
+
+  std::vector<ObjectRecord> objects;
+  objects.reserve(scene.objects.size());
+  for (size_t i : order) {
+    Object const& obj{ scene.objects[i] };
+    objects.emplace_back(ObjectRecord{ strings.intern(obj.name), obj.model, obj.shdrpgm,
+                                       { obj.color.r, obj.color.g, obj.color.b },
+                                       { obj.scaling.x, obj.scaling.y },
+                                       { obj.orientation.x, obj.orientation.y },
+                                       { obj.position.x, obj.position.y } });
+  }
+
+  Header header{};
+  header.magic = MAGIC;
+  header.version = VERSION;
+  header.model_cnt = static_cast<std::uint32_t>(models.size());
+  header.shdrpgm_cnt = static_cast<std::uint32_t>(shdrpgms.size());
+  header.object_cnt = static_cast<std::uint32_t>(objects.size());
+  header.strings_offset = align4(sizeof(Header));
+  header.strings_size = static_cast<std::uint32_t>(strings.blob.size());
+  header.models_offset = align4(size_t{ header.strings_offset } + header.strings_size);
+  header.shdrpgms_offset = align4(header.models_offset + sizeof(std::uint32_t) * models.size());
+  header.objects_offset = align4(header.shdrpgms_offset + sizeof(ShdrPgmRecord) * shdrpgms.size());
+
+  std::ofstream ofs{ bin_file, std::ios::out | std::ios::binary };
+  if (!ofs) {
+    return GL_FALSE;
+  }
+
+  char const padding[4]{};
+  auto write_at = [&ofs, &padding](std::uint32_t offset, void const* data, size_t size) {
+    ofs.write(padding, offset - static_cast<std::streamoff>(ofs.tellp()));
+    ofs.write(static_cast<char const*>(data), static_cast<std::streamsize>(size));
+  };
+  write_at(0, &header, sizeof(header));
+  write_at(header.strings_offset, strings.blob.data(), strings.blob.size());
+  write_at(header.models_offset, models.data(), sizeof(std::uint32_t) * models.size());
+  write_at(header.shdrpgms_offset, shdrpgms.data(), sizeof(ShdrPgmRecord) * shdrpgms.size());
+  write_at(header.objects_offset, objects.data(), sizeof(ObjectRecord) * objects.size());
+  return ofs.good() ? GL_TRUE : GL_FALSE;
+}
+
+/*  _________________________________________________________________________ */
+/*! SceneBin::convert
+ * @brief Convert a text scene file to a binary scene file.
+*/
+GLboolean SceneBin::convert(std::string const& scn_file, std::string const& bin_file)
+{
+  Scene scene;
+  if (GL_FALSE == read_text(scn_file, scene)) {
+    return GL_FALSE;
+  }
+  return write(bin_file, scene);
+}
+
+/*  _________________________________________________________________________ */
+/*! SceneBin::binary_path
+ * @brief Return scn_file with its extension replaced by .scnb.
+*/
+std::string SceneBin::binary_path(std::string const& scn_file)
+{
+  std::filesystem::path path{ scn_file };
+  path.replace_extension(".scnb");
+  return path.string();
+}
+
+/*  _________________________________________________________________________ */
+/*! SceneBin::ensure_binary
+ * @brief Convert scn_file if its binary scene file is missing or out of date.
+ *
+ * The binary scene file is out of date if it is older than scn_file or if
+ * its magic or version differs from those this build writes, which read
+ * would reject.
+ *
+ * @param scn_file[in] Path of the text scene file.
+ * @return Path of the binary scene file, or an empty string if the text
+ * scene file does not exist and no binary scene file was converted before.
+*/
+std::string SceneBin::ensure_binary(std::string const& scn_file)
+{
+  std::string const bin_file{ binary_path(scn_file) };
+  std::error_code ec;
+  bool const has_text{ std::filesystem::exists(scn_file, ec) };
+  bool const has_binary{ std::filesystem::exists(bin_file, ec) };
+
+  if (has_text && (!has_binary || !current_format(bin_file) ||
+                   std::filesystem::last_write_time(bin_file, ec) <
+                   std::filesystem::last_write_time(scn_file, ec))) {
+    if (GL_FALSE == convert(scn_file, bin_file)) {
+      return std::string();
+    }
+  }
+  else if (!has_binary) {
+    return std::string();
+  }
+  return bin_file;
+}
+
+/*  _________________________________________________________________________ */
+/*! SceneBin::benchmark
+ * @brief Print load times of text and binary scene files.
+ *
+ * Scenes of 1k, 10k and 100k objects are generated and written to the
+ * temporary directory as text scene files, which are then converted to
+ * binary scene files. Both files are read back a number of times and the
+ * average time of each format is printed. The round trip passes if the
+ * scenes read from both files equal the generated scene.
+ *
+ * @param none
+ * @return void
+*/
+void SceneBin::benchmark()
+{
+  int const reps{ 3 };
+  size_t const sizes[]{ 1000, 10000, 100000 };
+  std::filesystem::path const dir{ std::filesystem::temp_directory_path() };
+
+  std::cout << "Objects\t\t|\tText (ms)\t|\tBinary (ms)\t|\tSpeedup\t\t|\tRound trip\n";
+  std::cout << "----------------------------------------------------------------------------------------------\n";
+  for (size_t n : sizes) {
+    // objects are generated in name order, which is the order of the binary file
+    Scene generated;
+    generated.models = { "square", "triangle", "circle" };
+    generated.shdrpgms = { ShdrPgm{ "tutorial4-shdrpgm", "../shaders/my-tutorial-4.vert",
+                                    "../shaders/my-tutorial-4.frag" } };
+    std::uint32_t seed{ 1 };
+    auto random = [&seed](float lo, float hi) {
+      seed = seed * 1664525u + 1013904223u;
+      return lo + (hi - lo) * static_cast<float>(seed >> 8) / 16777216.f;
+    };
+    for (size_t i{ 0 }; i < n; ++i) {
+      std::ostringstream name;
+      name << "Object" << std::setw(7) << std::setfill('0') << i;
+      Object obj;
+      obj.name = name.str();
+      obj.model = static_cast<GLuint>(i % generated.models.size());
+      obj.color = glm::vec3{ random(0.f, 1.f), random(0.f, 1.f), random(0.f, 1.f) };
+      obj.scaling = glm::vec2{ random(50.f, 250.f), random(50.f, 250.f) };
+      obj.orientation = glm::vec2{ random(0.f, 360.f), random(-30.f, 30.f) };
+      obj.position = glm::vec2{ random(-20000.f, 20000.f), random(-20000.f, 20000.f) };
+      generated.objects.emplace_back(std::move(obj));
+    }
+
+    std::string const scn_file{ (dir / ("scenebin-bench-" + std::to_string(n) + ".scn")).string() };
+    std::string const bin_file{ binary_path(scn_file) };
+    write_text(scn_file, generated);
+    convert(scn_file, bin_file);
+
+    Scene from_text, from_binary;
+    double const text_start{ glfwGetTime() };
+    for (int r{ 0 }; r < reps; ++r) {
+      read_text(scn_file, from_text);
+    }
+    double const text_ms{ (glfwGetTime() - text_start) * 1000.0 / reps };
+
+    double const bin_start{ glfwGetTime() };
+    for (int r{ 0 }; r < reps; ++r) {
+      read(bin_file, from_binary);
+    }
+    double const bin_ms{ (glfwGetTime() - bin_start) * 1000.0 / reps };
+
+    bool const round_trip{ from_text == generated && from_binary == generated };
+    std::cout << n << "\t\t" << std::setprecision(3) << std::fixed << text_ms << "\t\t\t"
+              << bin_ms << "\t\t\t" << text_ms / bin_ms << "\t\t\t"
+              << (round_trip ? "passed" : "FAILED") << "\n";
+
+    std::error_code ec;
+    std::filesystem::remove(scn_file, ec);
+    std::filesystem::remove(bin_file, ec);
+  }
+  std::cout << "----------------------------------------------------------------------------------------------\n";
+  std::cout << std::defaultfloat;
+}
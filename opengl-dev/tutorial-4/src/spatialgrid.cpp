@@ -0,0 +1,347 @@
+/*!
+* @file    spatialgrid.cpp
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/7/2023
+*
+* @brief This file implements class SpatialGrid declared in spatialgrid.h.
+*//*__________________________________________________________________________*/
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <spatialgrid.h>
+#include <GLFW/glfw3.h>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+
+/*  _________________________________________________________________________ */
+/*! SpatialGrid::clear
+ * @brief Remove every box and set the size of the cells.
+ *
+ * @param cell_size[in] Width and height of a cell in world units.
+ * @return void
+*/
+void SpatialGrid::clear(GLfloat cell_size)
+{
+  cells.clear();
+  boxes.clear();
+  free_ids.clear();
+  inv_cell_size = 1.f / cell_size;
+  box_cnt = 0;
+  moved_cnt = kept_cnt = 0;
+}
+
+/*  _________________________________________________________________________ */
+/*! SpatialGrid::insert
+ * @brief Add a box to the grid.
+ *
+ * @param bbox_min[in] Minimum corner of the box.
+ * @param bbox_max[in] Maximum corner of the box.
+ * @return Id of the box.
+*/
+GLuint SpatialGrid::insert(glm::vec2 const& bbox_min, glm::vec2 const& bbox_max)
+{
+  GLuint id;
+  if (free_ids.empty()) {
+    id = static_cast<GLuint>(boxes.size());
+    boxes.emplace_back();
+  }
+  else {
+    id = free_ids.back();
+    free_ids.pop_back();
+  }
+
+  Box& box{ boxes[id] };
+  box.bbox_min = bbox_min;
+  box.bbox_max = bbox_max;
+  box.x0 = cell_coord(bbox_min.x);
+  box.y0 = cell_coord(bbox_min.y);
+  box.x1 = cell_coord(bbox_max.x);
+  box.y1 = cell_coord(bbox_max.y);
+  link(id);
+  ++box_cnt;
+  return id;
+}
+
+/*  _________________________________________________________________________ */
+/*! SpatialGrid::update
+ * @brief Change the bounds of a box.
+ *
+ * The box is only moved to other cells if the range of cells it overlaps
+ * changes; otherwise just its bounds are stored.
+ *
+ * @param id[in] Id of the box.
+ * @param bbox_min[in] New minimum corner of the box.
+ * @param bbox_max[in] New maximum corner of the box.
+ * @return void
+*/
+void SpatialGrid::update(GLuint id, glm::vec2 const& bbox_min, glm::vec2 const& bbox_max)
+{
+  Box& box{ boxes[id] };
+  box.bbox_min = bbox_min;
+  box.bbox_max = bbox_max;
+
+  GLint const x0{ cell_coord(bbox_min.x) }, y0{ cell_coord(bbox_min.y) };
+  GLint const x1{ cell_coord(bbox_max.x) }, y1{ cell_coord(bbox_max.y) };
+  if (x0 == box.x0 && y0 == box.y0 && x1 == box.x1 && y1 == box.y1) {
+    ++kept_cnt;
+    return;
+  }
+
+  unlink(id);
+  box.x0 = x0;
+  box.y0 = y0;
+  box.x1 = x1;
+  box.y1 = y1;
+  link(id);
+  ++moved_cnt;
+}
+
+/*  _________________________________________________________________________ */
+/*! SpatialGrid::remove
+ * @brief Remove a box from the grid.
+ *
+ * Its id is reused by a later insert.
+ *
+ * @param id[in] Id of the box.
+ * @return void
+*/
+void SpatialGrid::remove(GLuint id)
+{
+  unlink(id);
+  free_ids.push_back(id);
+  --box_cnt;
+}
+
+/*  _________________________________________________________________________ */
+/*! SpatialGrid::query_rect
+ * @brief Find the boxes overlapping a rectangle.
+ *
+ * Every cell overlapped by the rectangle is visited. A box overlapping
+ * several of these cells is reported only from the first of them, the cell
+ * at the minimum corner of the cells shared by the box and the rectangle,
+ * so no id is reported twice.
+ *
+ * @param lo[in] Minimum corner of the rectangle.
+ * @param hi[in] Maximum corner of the rectangle.
+ * @param ids[out] Ids of the boxes found are appended here.
+ * @return void
+*/
+void SpatialGrid::query_rect(glm::vec2 const& lo, glm::vec2 const& hi,
+                             std::vector<GLuint>& ids) const
+{
+  GLint const qx0{ cell_coord(lo.x) }, qy0{ cell_coord(lo.y) };
+  GLint const qx1{ cell_coord(hi.x) }, qy1{ cell_coord(hi.y) };
+
+  for (GLint y{ qy0 }; y <= qy1; ++y) {
+    for (GLint x{ qx0 }; x <= qx1; ++x) {
+      auto const cell{ cells.find(cell_key(x, y)) };
+      if (cell == cells.end()) {
+        continue;
+      }
+      for (GLuint id : cell->second) {
+        Box const& box{ boxes[id] };
+        if (x == std::max(box.x0, qx0) && y == std::max(box.y0, qy0) &&
+            box.bbox_max.x >= lo.x && box.bbox_min.x <= hi.x &&
+            box.bbox_max.y >= lo.y && box.bbox_min.y <= hi.y) {
+          ids.push_back(id);
+        }
+      }
+    }
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! SpatialGrid::query_point
+ * @brief Find the boxes containing a point.
+ *
+ * @param p[in] Point in world space.
+ * @param ids[out] Ids of the boxes found are appended here.
+ * @return void
+*/
+void SpatialGrid::query_point(glm::vec2 const& p, std::vector<GLuint>& ids) const
+{
+  auto const cell{ cells.find(cell_key(cell_coord(p.x), cell_coord(p.y))) };
+  if (cell == cells.end()) {
+    return;
+  }
+  for (GLuint id : cell->second) {
+    Box const& box{ boxes[id] };
+    if (p.x >= box.bbox_min.x && p.x <= box.bbox_max.x &&
+        p.y >= box.bbox_min.y && p.y <= box.bbox_max.y) {
+      ids.push_back(id);
+    }
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! SpatialGrid::cell_coord
+ * @brief Return the coordinate of the cell containing world coordinate x.
+*/
+GLint SpatialGrid::cell_coord(GLfloat x) const
+{
+  return static_cast<GLint>(std::floor(x * inv_cell_size));
+}
+
+/*  _________________________________________________________________________ */
+/*! SpatialGrid::cell_key
+ * @brief Return the hash table key of cell (x, y).
+*/
+std::uint64_t SpatialGrid::cell_key(GLint x, GLint y)
+{
+  return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) |
+         static_cast<std::uint32_t>(y);
+}
+
+/*  _________________________________________________________________________ */
+/*! SpatialGrid::link
+ * @brief List box id in every cell of its cell range.
+*/
+void SpatialGrid::link(GLuint id)
+{
+  Box const& box{ boxes[id] };
+  for (GLint y{ box.y0 }; y <= box.y1; ++y) {
+    for (GLint x{ box.x0 }; x <= box.x1; ++x) {
+      cells[cell_key(x, y)].push_back(id);
+    }
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! SpatialGrid::unlink
+ * @brief Remove box id from every cell of its cell range.
+ *
+ * Cells left without boxes are erased from the hash table.
+*/
+void SpatialGrid::unlink(GLuint id)
+{
+  Box const& box{ boxes[id] };
+  for (GLint y{ box.y0 }; y <= box.y1; ++y) {
+    for (GLint x{ box.x0 }; x <= box.x1; ++x) {
+      auto const cell{ cells.find(cell_key(x, y)) };
+      if (cell == cells.end()) {
+        continue;
+      }
+      std::vector<GLuint>& ids{ cell->second };
+      auto const it{ std::find(ids.begin(), ids.end(), id) };
+      if (it != ids.end()) {
+        *it = ids.back();
+        ids.pop_back();
+      }
+      if (ids.empty()) {
+        cells.erase(cell);
+      }
+    }
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! SpatialGrid::benchmark
+ * @brief Print the cost of grid queries and updates against a linear scan.
+ *
+ * For 1k, 10k, 100k and 1M boxes 50 to 250 units wide, placed at random in
+ * the 40000 x 40000 world of the tutorial-4 scene, the time to build the
+ * grid, to move every box by a few units, to run a rectangle query the size
+ * of the camera window and to run a point query is printed next to the
+ * time to find the same rectangle by testing every box. The query columns
+ * also give the average number of boxes found, and the last column checks
+ * that the grid and the linear scan found the same boxes.
+ *
+ * @param none
+ * @return void
+*/
+void SpatialGrid::benchmark()
+{
+  int const queries{ 1000 };
+  size_t const sizes[]{ 1000, 10000, 100000, 1000000 };
+  glm::vec2 const window{ 1333.f, 1000.f };
+
+  std::uint32_t seed{ 1 };
+  auto random = [&seed](float lo, float hi) {
+    seed = seed * 1664525u + 1013904223u;
+    return lo + (hi - lo) * static_cast<float>(seed >> 8) / 16777216.f;
+  };
+
+  std::cout << "Boxes\t\t|\tBuild (ms)\t|\tMove (ns/box)\t|\tRect (us)\t|\tPoint (us)\t|\tScan (us)\t|\tMatch\n";
+  std::cout << "--------------------------------------------------------------------------------------------------------------------------\n";
+  for (size_t n : sizes) {
+    std::vector<glm::vec2> lo(n), hi(n);
+    for (size_t i{ 0 }; i < n; ++i) {
+      glm::vec2 const center{ random(-20000.f, 20000.f), random(-20000.f, 20000.f) };
+      glm::vec2 const half{ random(25.f, 125.f), random(25.f, 125.f) };
+      lo[i] = center - half;
+      hi[i] = center + half;
+    }
+
+    SpatialGrid grid;
+    double const build_start{ glfwGetTime() };
+    for (size_t i{ 0 }; i < n; ++i) {
+      grid.insert(lo[i], hi[i]);
+    }
+    double const build_ms{ (glfwGetTime() - build_start) * 1000.0 };
+
+    double const move_start{ glfwGetTime() };
+    for (size_t i{ 0 }; i < n; ++i) {
+      glm::vec2 const offset{ random(-5.f, 5.f), random(-5.f, 5.f) };
+      lo[i] += offset;
+      hi[i] += offset;
+      grid.update(static_cast<GLuint>(i), lo[i], hi[i]);
+    }
+    double const move_ns{ (glfwGetTime() - move_start) * 1e9 / static_cast<double>(n) };
+
+    std::vector<glm::vec2> centers(queries);
+    for (glm::vec2& c : centers) {
+      c = glm::vec2{ random(-20000.f, 20000.f), random(-20000.f, 20000.f) };
+    }
+
+    std::vector<GLuint> ids;
+    size_t rect_hits{ 0 };
+    double const rect_start{ glfwGetTime() };
+    for (glm::vec2 const& c : centers) {
+      ids.clear();
+      grid.query_rect(c - 0.5f * window, c + 0.5f * window, ids);
+      rect_hits += ids.size();
+    }
+    double const rect_us{ (glfwGetTime() - rect_start) * 1e6 / queries };
+
+    size_t point_hits{ 0 };
+    double const point_start{ glfwGetTime() };
+    for (glm::vec2 const& c : centers) {
+      ids.clear();
+      grid.query_point(c, ids);
+      point_hits += ids.size();
+    }
+    double const point_us{ (glfwGetTime() - point_start) * 1e6 / queries };
+
+    // a linear scan is slow with many boxes, so fewer rectangles are tested
+    int const scans{ n > 100000 ? 10 : 100 };
+    bool match{ true };
+    double scan_time{ 0.0 };
+    std::vector<GLuint> scan_ids;
+    for (int q{ 0 }; q < scans; ++q) {
+      glm::vec2 const qlo{ centers[q] - 0.5f * window }, qhi{ centers[q] + 0.5f * window };
+      scan_ids.clear();
+      double const scan_start{ glfwGetTime() };
+      for (size_t i{ 0 }; i < n; ++i) {
+        if (hi[i].x >= qlo.x && lo[i].x <= qhi.x && hi[i].y >= qlo.y && lo[i].y <= qhi.y) {
+          scan_ids.push_back(static_cast<GLuint>(i));
+        }
+      }
+      scan_time += glfwGetTime() - scan_start;
+
+      ids.clear();
+      grid.query_rect(qlo, qhi, ids);
+      std::sort(ids.begin(), ids.end());
+      match = match && ids == scan_ids;
+    }
+    double const scan_us{ scan_time * 1e6 / scans };
+
+    std::cout << n << "\t\t" << std::setprecision(3) << std::fixed << build_ms << "\t\t\t"
+              << move_ns << "\t\t\t" << rect_us << " (" << rect_hits / queries << " hits)\t"
+              << point_us << " (" << point_hits / queries << " hits)\t"
+              << scan_us << "\t\t\t" << (match ? "yes" : "NO") << "\n";
+  }
+  std::cout << "--------------------------------------------------------------------------------------------------------------------------\n";
+  std::cout << std::defaultfloat;
+}
@@ -34,6 +34,7 @@
 /*                                                                   includes
 ----------------------------------------------------------------------------- */
 #include <glslshader.h>
+#include <texloader.h>
 
 struct GLApp {
 
@@ -84,12 +85,17 @@ struct GLApp {
   // tileSize for task 2
   static GLfloat tileSize;
 
-  // texture variables
-  static GLuint texobj1;
-  static GLuint texobj2;
+  // texture variables; handles of TexLoader, bound through TexLoader::texture
+  static TexLoader::Handle texobj1;
+  static TexLoader::Handle texobj2;
 
-  // initializes texobj with texture file
-  static GLuint setup_texobj(std::string pathname);
+  // requests the texture file from TexLoader, or the file convert_textures
+  // wrote for it if there is one, and returns its handle
+  static TexLoader::Handle setup_texobj(std::string pathname);
+
+  // writes the mipmap chain of every texture file next to it, as RGBA8
+  // and as BC7 blocks
+  static void convert_textures();
 };
 
 
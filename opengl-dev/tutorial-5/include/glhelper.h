@@ -49,6 +49,8 @@ struct GLHelper
 
 	// this flags are true if button was toggled from released position to pressed
 	static GLboolean keystateA;
+	static GLboolean keystateB;
+	static GLboolean keystateC;
 	static GLboolean keystateM;
 	static GLboolean keystateT;
 
@@ -0,0 +1,97 @@
+/*!
+* @file    texbc.h
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/22/2023
+*
+* @brief This file contains the declaration of struct TexBC that compresses
+*		 RGBA8 images to the block formats GPUs sample directly. Each block
+*		 of 4 x 4 texels stores two endpoint colors and, per texel, the index
+*		 of a color interpolated between them:
+*		 - BC1: 8 bytes a block, RGB565 endpoints, 4 colors, no alpha.
+*		 - BC3: 16 bytes a block, a BC1 block for RGB and 8-bit alpha
+*		   endpoints with 8 interpolated values.
+*		 - BC7: 16 bytes a block; modes 5 and 6 are written. Mode 6 has
+*		   RGBA endpoints of 7 bits plus a low bit and 16 interpolated
+*		   colors, mode 5 7-bit RGB and 8-bit alpha endpoints with 4
+*		   interpolated colors and 4 alphas chosen separately.
+*		 BC1 takes an eighth and BC3 and BC7 a quarter of the memory of
+*		 RGBA8, on disk and in VRAM.
+*
+*		 The encoder finds the endpoints along the principal axis of the
+*		 colors of a block, refits them by least squares to the indices they
+*		 give and then moves each quantized endpoint channel by one step while
+*		 that lowers the error. The error of a pair of endpoints, the sum of
+*		 the squared distances of the texels to their nearest interpolated
+*		 color, is measured for 4 texels at once with SSE2. Blocks are
+*		 encoded on the threads of JobSystem.
+*
+*		 Compressed mipmap chains are written to .tex files with a Header of
+*		 magic "TEXB", which TexLoader uploads with
+*		 glCompressedTextureSubImage2D.
+*//*__________________________________________________________________________*/
+
+/*                                                                      guard
+----------------------------------------------------------------------------- */
+#ifndef TEXBC_H
+#define TEXBC_H
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <GL/glew.h> // for access to OpenGL API declarations
+#include <string>
+#include <vector>
+
+/*  _________________________________________________________________________ */
+struct TexBC
+  /*! TexBC structure to compress images to and from block formats.
+  */
+{
+  enum class Format {
+    BC1, // opaque RGB
+    BC3, // RGB and smooth alpha
+    BC7  // RGBA, highest quality
+  };
+
+  // header of a block-compressed .tex file, followed by the blocks of
+  // levels levels, each level row by row of blocks
+  struct Header {
+    char magic[4];          // "TEXB"
+    GLuint width;
+    GLuint height;
+    GLuint levels;
+    GLenum internal_format; // of the texture, from internal_format
+  };
+
+  // blocks of a level are compressed in jobs of this many blocks
+  static size_t constexpr grain{ 64 };
+
+  // internal format of textures holding blocks of format
+  static GLenum internal_format(Format format);
+
+  // bytes per block of internal_format; 0 if it is not a format of TexBC
+  static GLsizeiptr block_bytes(GLenum internal_format);
+
+  // byte offset of level in a chain of blocks of an image of
+  // width x height texels; the bytes of the chain if level is the count
+  static GLsizeiptr level_offset(GLenum internal_format, GLuint width, GLuint height, GLuint level);
+
+  // compress the RGBA8 image rgba to the blocks of format, written to
+  // blocks. Texels past the edges of partial blocks repeat the edge
+  static void compress(GLubyte const* rgba, GLuint width, GLuint height, Format format,
+                       GLubyte* blocks);
+
+  // decompress blocks written by compress to width x height RGBA8 texels;
+  // BC7 blocks of modes other than 5 and 6 decode to transparent black
+  static void decompress(GLubyte const* blocks, GLuint width, GLuint height, Format format,
+                         GLubyte* rgba);
+
+  // read the .tex file src, build its full chain with TexMip and write it
+  // compressed to dst; false with the reason in error if it fails
+  static bool convert(std::string const& src, std::string const& dst, Format format,
+                      std::string& error);
+
+  // print compression throughput, PSNR and VRAM of each format for the images
+  static void benchmark(std::vector<std::string> const& pathnames);
+};
+
+#endif /* TEXBC_H */
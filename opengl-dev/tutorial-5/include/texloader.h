@@ -0,0 +1,109 @@
+/*!
+* @file    texloader.h
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/21/2023
+*
+* @brief This file contains the declaration of struct TexLoader that loads
+*		 textures without stalling the render loop. A request returns at
+*		 once with a handle; worker threads read and decode the file
+*		 straight into a persistently mapped pixel unpack buffer, and update,
+*		 called once per frame, copies decoded images to their texture
+*		 objects from that buffer within a byte budget. The staging memory of
+*		 an upload is reused once its fence signals, which is also when the
+*		 texture becomes resident. Until then texture returns a checkerboard
+*		 placeholder, so a handle can be bound from the first frame.
+*
+*		 A .tex file may start with a Header giving its dimensions and bytes
+*		 per texel; files without one hold square RGBA8 images whose
+*		 dimensions follow from the file size. Both get a mipmap chain built
+*		 by TexMip on the worker; files with a TexMip::Header already hold
+*		 one, and all its levels are uploaded from one staging region. Files
+*		 with a TexBC::Header hold a chain of compressed blocks, uploaded
+*		 the same way with glCompressedTextureSubImage2D.
+*//*__________________________________________________________________________*/
+
+/*                                                                      guard
+----------------------------------------------------------------------------- */
+#ifndef TEXLOADER_H
+#define TEXLOADER_H
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <GL/glew.h> // for access to OpenGL API declarations
+#include <texmip.h>
+#include <string>
+#include <vector>
+
+/*  _________________________________________________________________________ */
+struct TexLoader
+  /*! TexLoader structure to stream textures from files on worker threads.
+  */
+{
+  // identifies a requested texture until cleanup
+  using Handle = GLuint;
+
+  enum class State {
+    QUEUED,    // waiting for or being read by a worker
+    DECODED,   // texels are in the staging buffer, waiting for update
+    UPLOADING, // copy to the texture object issued, fence not signaled yet
+    RESIDENT,  // texture returns the texture object
+    FAILED,    // file missing or malformed; texture returns the placeholder
+    RELEASED   // released; request may return the handle again
+  };
+
+  // optional header of a .tex file, followed by width * height texels of
+  // channels bytes stored row by row
+  struct Header {
+    char magic[4];   // "TEX1"
+    GLuint width;
+    GLuint height;
+    GLuint channels; // 1 (gray), 3 (RGB) or 4 (RGBA)
+  };
+
+  // bytes of the mapped pixel unpack buffer images are decoded into;
+  // larger images are decoded into client memory and uploaded from there
+  static GLsizeiptr constexpr staging_size{ 32 << 20 };
+
+  // bytes update starts uploading per call; one image is always started
+  static GLsizeiptr constexpr upload_budget{ 8 << 20 };
+
+  // filter of the chains built while loading
+  static TexMip::Filter constexpr mip_filter{ TexMip::Filter::BOX };
+
+  // create the placeholder and staging buffer and start thread_cnt workers
+  static void init(unsigned thread_cnt = 2);
+
+  // stop the workers and delete every texture object and buffer
+  static void cleanup();
+
+  // queue pathname for loading and return its handle; a mipmap chain is
+  // built for it unless it has one or mipmaps is GL_FALSE
+  static Handle request(std::string const& pathname, GLboolean mipmaps = GL_TRUE);
+
+  // delete the texture of h, or cancel its loading, and free its staging
+  // memory; h may be returned by a later request and must not be used
+  // afterwards
+  static void release(Handle h);
+  // upload decoded images, retire finished uploads and report failures
+  static void update();
+
+  // texture object of h if it is resident, the placeholder otherwise
+  static GLuint texture(Handle h);
+
+  static State state(Handle h);
+
+  // number of requests neither resident, failed nor released
+  static GLuint pending();
+
+  // read the image, or the first level of the chain, of a .tex file to
+  // RGBA8; false with the reason in error if it cannot be read or is
+  // block-compressed
+  static bool read(std::string const& pathname, GLuint& width, GLuint& height,
+                   std::vector<GLubyte>& rgba, std::string& error);
+
+  // write a .tex file with a header; false if it cannot be written
+  static bool write(std::string const& pathname, GLuint width, GLuint height,
+                    GLuint channels, void const* texels);
+};
+
+#endif /* TEXLOADER_H */
@@ -0,0 +1,78 @@
+/*!
+* @file    texmip.h
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/21/2023
+*
+* @brief This file contains the declaration of struct TexMip that builds
+*		 mipmap chains of RGBA8 images on the CPU. The color channels of the
+*		 images are sRGB encoded, so each level is filtered in linear space:
+*		 texels are decoded to linear floats once, every level is filtered
+*		 from the float level above it, and only the result is encoded back
+*		 to sRGB bytes. Averaging the bytes directly, as an RGBA8 texture
+*		 filtered by glGenerateTextureMipmap is, darkens detailed and high
+*		 contrast areas in smaller levels. Alpha is filtered as is. The
+*		 filters process the four channels of a texel at once with SSE2.
+*
+*		 A chain is stored finest level first, each level of
+*		 max(1, width >> l) x max(1, height >> l) texels following the one
+*		 before it. Chains are written to .tex files with a Header of magic
+*		 "TEXM", which TexLoader uploads without filtering.
+*//*__________________________________________________________________________*/
+
+/*                                                                      guard
+----------------------------------------------------------------------------- */
+#ifndef TEXMIP_H
+#define TEXMIP_H
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <GL/glew.h> // for access to OpenGL API declarations
+#include <string>
+#include <vector>
+
+/*  _________________________________________________________________________ */
+struct TexMip
+  /*! TexMip structure to build and store mipmap chains of RGBA8 images.
+  */
+{
+  enum class Filter {
+    BOX,   // average of 2 x 2 texels
+    KAISER // 6 x 6 taps of a Kaiser windowed sinc; sharper, may ring
+  };
+
+  // header of a mip-chained .tex file, followed by the RGBA8 texels of
+  // levels levels
+  struct Header {
+    char magic[4]; // "TEXM"
+    GLuint width;
+    GLuint height;
+    GLuint levels;
+  };
+
+  // levels of a full chain of width x height texels, down to 1 x 1
+  static GLuint level_count(GLuint width, GLuint height);
+
+  // byte offset of level in a chain of an image of width x height texels
+  static GLsizeiptr level_offset(GLuint width, GLuint height, GLuint level);
+
+  // width or height of level of an image width or height texels across
+  static GLuint level_size(GLuint size, GLuint level);
+
+  // build levels levels of a chain of the RGBA8 image rgba and write them
+  // to chain, which must hold level_offset(width, height, levels) bytes.
+  // chain is only written to, so it may be mapped memory
+  static void build(GLubyte const* rgba, GLuint width, GLuint height, GLuint levels,
+                    Filter filter, GLubyte* chain);
+
+  // read the .tex file src, build its full chain and write it to dst;
+  // false with the reason in error if either file fails
+  static bool convert(std::string const& src, std::string const& dst, Filter filter,
+                      std::string& error);
+
+  // print the time to build chains of the images on the CPU and on the
+  // GPU with glGenerateTextureMipmap, and how far the GPU levels are from
+  // the gamma-correct ones
+  static void benchmark(std::vector<std::string> const& pathnames);
+};
+
+#endif /* TEXMIP_H */
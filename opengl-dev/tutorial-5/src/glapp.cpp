@@ -28,10 +28,12 @@
 ----------------------------------------------------------------------------- */
 #include <glapp.h>
 #include <glhelper.h>
+#include <texbc.h>
+#include <jobsystem.h>
 #include <glm/glm.hpp>
+#include <filesystem>
 #include <vector>
 #include <string>
-#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -59,8 +61,36 @@ GLfloat GLApp::animElapsedTime{ 0.f };
 GLfloat GLApp::tileSize{ 0.f };
 
 // texture variables
-GLuint GLApp::texobj1{};
-GLuint GLApp::texobj2{};
+TexLoader::Handle GLApp::texobj1{};
+TexLoader::Handle GLApp::texobj2{};
+
+// texture files benchmarked and converted by GLApp::update
+static std::vector<std::string> const tex_files{ "../images/duck-rgba-256.tex",
+	"../images/grate-rgba-256.tex", "../images/water-rgba-256.tex" };
+
+// handles to uniform variables set every frame by GLModel::draw
+static GLSLShader::UniformHandle const u_taskID{ GLSLShader::GetUniformHandle("u_taskID") };
+static GLSLShader::UniformHandle const u_modFlag{ GLSLShader::GetUniformHandle("u_modFlag") };
+static GLSLShader::UniformHandle const u_tileSize{ GLSLShader::GetUniformHandle("u_tileSize") };
+static GLSLShader::UniformHandle const u_resolution{ GLSLShader::GetUniformHandle("u_resolution") };
+static GLSLShader::UniformHandle const u_time{ GLSLShader::GetUniformHandle("u_time") };
+static GLSLShader::UniformHandle const u_tex2D{ GLSLShader::GetUniformHandle("u_tex2D") };
+
+/*  _________________________________________________________________________ */
+/*! converted_pathname
+ * @brief Path GLApp::convert_textures writes a texture file to.
+ *
+ * @param pathname[in] Path of the .tex file.
+ * @param suffix[in] Inserted before the extension of pathname.
+ * @return The path of the converted file.
+*/
+static std::string converted_pathname(std::string const& pathname, char const* suffix)
+{
+	std::filesystem::path path{ pathname };
+	std::filesystem::path const ext{ path.extension() };
+	path.replace_extension();
+	return path.string() + suffix + ext.string();
+}
 
 /*  _________________________________________________________________________ */
 /*! GLApp::init
@@ -70,7 +100,9 @@ GLuint GLApp::texobj2{};
  * 1. Clears the color buffer to white using glClearColor.
  * 2. Sets the viewport to use the entire window.
  * 3. Sets up VAO object and shader program.
- * 4. Sets up texture objects.
+ * 4. Starts JobSystem, used to compress textures, and TexLoader, and
+ *    requests the texture files, which are drawn with its placeholder
+ *    until they are loaded.
  *
  * @param none
  * @return void
@@ -83,10 +115,16 @@ void GLApp::init() {
 	// Part 2: use entire window as viewport ...
 	glViewport(0, 0, GLHelper::width, GLHelper::height);
 
-	// Part 3: initialize VAO and create shader program
+	// Part 3: initialize VAO and create shader program, loaded from the
+	// binary cache when a previous run linked it
 	mdl.setup_vao();
+	GLSLShader::SetBinaryCacheDir("../shader-cache");
 	mdl.setup_shdrpgm();
 
+	// worker threads of the block compressor
+	JobSystem::init();
+
+	TexLoader::init();
 	texobj1 = setup_texobj("../images/duck-rgba-256.tex");
 	texobj2 = setup_texobj("../images/water-rgba-256.tex");
 }
@@ -96,7 +134,10 @@ void GLApp::init() {
  * @brief Update the GLApp.
  *
  * This function updates the GLApp by performing the following tasks:
- * 1. Update user input and set flags
+ * 0. Upload the textures TexLoader decoded and retire finished uploads.
+ * 1. Update user input and set flags; B prints the mipmap and block
+ *    compression benchmarks, and C converts the texture files and
+ *    requests the converted files
  * 2. Update elapsed time for animation and reset when not in use.
  * 3. Implement ease in/out animation for change in tileSize
  *
@@ -105,6 +146,8 @@ void GLApp::init() {
 */
 void GLApp::update()
 {
+	TexLoader::update();
+
 	// update user input and set flags
 	if (GLHelper::keystateT)
 	{
@@ -142,6 +185,23 @@ void GLApp::update()
 		alphaFlagTriggered = GL_FALSE;
 	}
 
+	if (GLHelper::keystateB)
+	{
+		TexMip::benchmark(tex_files);
+		TexBC::benchmark(tex_files);
+		GLHelper::keystateB = GL_FALSE;
+	}
+
+	if (GLHelper::keystateC)
+	{
+		convert_textures();
+		TexLoader::release(texobj1);
+		TexLoader::release(texobj2);
+		texobj1 = setup_texobj("../images/duck-rgba-256.tex");
+		texobj2 = setup_texobj("../images/water-rgba-256.tex");
+		GLHelper::keystateC = GL_FALSE;
+	}
+
 	// update elapsed time for animation
 	if (taskID == 2 || taskID == 7 || taskID == 8)
 	{
@@ -216,10 +276,18 @@ void GLApp::draw()
 	}
 
 	title << "Tutorial 5 | Brandon Ho Jun Jie | " << taskStr << "Alpha Blend: "
-		<< (alphaFlag ? "ON" : "OFF") << " | Modulate: " << (modFlag ? "ON" : "OFF");
+		<< (alphaFlag ? "ON" : "OFF") << " | Modulate: " << (modFlag ? "ON" : "OFF")
+		<< " | Uniform lookups avoided: " << GLSLShader::GetLookupsAvoided();
+	if (GLuint const loading{ TexLoader::pending() }; loading > 0)
+	{
+		title << " | Textures loading: " << loading;
+	}
 
 	glfwSetWindowTitle(GLHelper::ptr_window, title.str().c_str());
 
+	// count lookups avoided by the uniform handles during this frame only
+	GLSLShader::ResetLookupsAvoided();
+
 	// clear buffer with color set in GLApp::init()
 	glClear(GL_COLOR_BUFFER_BIT);
 
@@ -229,13 +297,15 @@ void GLApp::draw()
 
 /*  _________________________________________________________________________ */
 /*! GLApp::cleanup
- * @brief Empty.
+ * @brief Stop TexLoader and delete the textures it loaded, then stop
+ * JobSystem.
  *
  * @param none
  * @return none
 */
 void GLApp::cleanup() {
-  // empty for now
+	TexLoader::cleanup();
+	JobSystem::cleanup();
 }
 
 /*  _________________________________________________________________________ */
@@ -310,6 +380,7 @@ void GLApp::GLModel::setup_vao()
  * 1. Defines the shader files for the vertex and fragment shaders.
  * 2. Compiles, links, and validates the shader program.
  * 3. Checks if the shader program is successfully linked and exits with an error message if not.
+ * 4. Checks that the uniform variables set by draw exist and exits with an error message if not.
  *
  * @return void
 */
@@ -330,6 +401,19 @@ void GLApp::GLModel::setup_shdrpgm() {
 		std::cout << shdr_pgm.GetLog() << std::endl;
 		std::exit(EXIT_FAILURE);
 	}
+
+	// draw sets these uniforms every frame, so a missing one is fatal here
+	// once instead of being reported on every draw
+	std::pair<GLSLShader::UniformHandle, char const*> const uniforms[]{
+		{ u_taskID, "u_taskID" }, { u_modFlag, "u_modFlag" },
+		{ u_tileSize, "u_tileSize" }, { u_resolution, "u_resolution" },
+		{ u_time, "u_time" }, { u_tex2D, "u_tex2D" } };
+	for (auto const& uniform : uniforms) {
+		if (GL_FALSE == shdr_pgm.HasUniform(uniform.first)) {
+			std::cout << "Uniform variable " << uniform.second << " doesn't exist!!!\n";
+			std::exit(EXIT_FAILURE);
+		}
+	}
 }
 
 /*  _________________________________________________________________________ */
@@ -338,7 +422,8 @@ void GLApp::GLModel::setup_shdrpgm() {
  *
  * This method performs the following tasks to draw the model:
  * 1. Enables or disables alpha blending based on the alphaFlag.
- * 2. Binds texobj1 to texture unit 6, binds texobj2 for taskID 8.
+ * 2. Binds the texture of texobj1 to texture unit 6, that of texobj2 for taskID 8;
+ *    the TexLoader placeholder while they are loading.
  * 3. Sets the texture sampling mode based on the taskID.
  * 4. Enables the shader program.
  * 5. Passes various uniform variables to the shader program.
@@ -363,108 +448,57 @@ void GLApp::GLModel::draw()
 	}
 
 	// bind texobj1 to texture unit 6
-	glBindTextureUnit(6, texobj1);
+	GLuint const tex1{ TexLoader::texture(texobj1) };
+	GLuint const tex2{ TexLoader::texture(texobj2) };
+	glBindTextureUnit(6, tex1);
 
 	// based on the task ID, switch texture sampling mode
 	switch (taskID)
 	{
 	case 3:
 	case 4:
-		glTextureParameteri(texobj1, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTextureParameteri(texobj1, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTextureParameteri(tex1, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTextureParameteri(tex1, GL_TEXTURE_WRAP_T, GL_REPEAT);
 		break;
 	case 5:
-		glTextureParameteri(texobj1, GL_TEXTURE_WRAP_S, GL_MIRRORED_REPEAT);
-		glTextureParameteri(texobj1, GL_TEXTURE_WRAP_T, GL_MIRRORED_REPEAT);
+		glTextureParameteri(tex1, GL_TEXTURE_WRAP_S, GL_MIRRORED_REPEAT);
+		glTextureParameteri(tex1, GL_TEXTURE_WRAP_T, GL_MIRRORED_REPEAT);
 		break;
 	case 6:
-		glTextureParameteri(texobj1, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTextureParameteri(texobj1, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(tex1, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(tex1, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 		break;
 	case 8: // bonus task, bind tex obj2 to texture unit 6
 		
-		glBindTextureUnit(6, texobj2);
-		glTextureParameteri(texobj2, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTextureParameteri(texobj2, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glBindTextureUnit(6, tex2);
+		glTextureParameteri(tex2, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTextureParameteri(tex2, GL_TEXTURE_WRAP_T, GL_REPEAT);
 		break;
 	}
 
 	// enable shader program
 	shdr_pgm.Use();
 
+	// pass uniform variables to shader through handles so that their
+	// locations are read from the table reflected after linking
 	// pass taskID to shader uniform variable in shader
-	GLint uniform_taskID_loc = glGetUniformLocation(shdr_pgm.GetHandle(), "u_taskID");
-	if (uniform_taskID_loc >= 0)
-	{
-		glUniform1ui(uniform_taskID_loc, taskID);
-	}
-	else
-	{
-		std::cout << "Uniform variable u_taskID doesn't exist!!!\n";
-		std::exit(EXIT_FAILURE);
-	}
-	
+	shdr_pgm.SetUniform(u_taskID, taskID);
+
 	// pass modulate flag to shader uniform variable in shader
-	GLint uniform_modFlag_loc = glGetUniformLocation(shdr_pgm.GetHandle(), "u_modFlag");
-	if (uniform_modFlag_loc >= 0)
-	{
-		glUniform1i(uniform_modFlag_loc, modFlag);
-	}
-	else
-	{
-		std::cout << "Uniform variable u_modFlag doesn't exist!!!\n";
-		std::exit(EXIT_FAILURE);
-	}
+	shdr_pgm.SetUniform(u_modFlag, modFlag);
 
 	// pass tile size to uniform variable in shader
-	GLint uniform_tileSize_loc = glGetUniformLocation(shdr_pgm.GetHandle(), "u_tileSize");
-	if (uniform_tileSize_loc >= 0)
-	{
-		glUniform1f(uniform_tileSize_loc, tileSize);
-	}
-	else
-	{
-		std::cout << "Uniform variable u_tileSize doesn't exist!!!\n";
-		std::exit(EXIT_FAILURE);
-	}
+	shdr_pgm.SetUniform(u_tileSize, tileSize);
 
 	// pass resolution to uniform variable in shader
-	GLint uniform_resolution_loc = glGetUniformLocation(shdr_pgm.GetHandle(), "u_resolution");
 	glm::vec2 resolution{ GLHelper::width, GLHelper::height };
-	if (uniform_resolution_loc >= 0)
-	{
-		glUniform2fv(uniform_resolution_loc, 1, glm::value_ptr(resolution));
-	}
-	else
-	{
-		std::cout << "Uniform variable u_resolution doesn't exist!!!\n";
-		std::exit(EXIT_FAILURE);
-	}
+	shdr_pgm.SetUniform(u_resolution, resolution);
 
 	// pass elapsed time to uniform variable in shader
-	GLint uniform_time_loc = glGetUniformLocation(shdr_pgm.GetHandle(), "u_time");
-	if (uniform_time_loc >= 0)
-	{
-		glUniform1f(uniform_time_loc, animElapsedTime);
-	}
-	else
-	{
-		std::cout << "Uniform variable u_time doesn't exist!!!\n";
-		std::exit(EXIT_FAILURE);
-	}
+	shdr_pgm.SetUniform(u_time, animElapsedTime);
 
 	// tell fragment shader sampler2D u_tex2d to use texture image unit 6
-	GLuint tex_loc = glGetUniformLocation(shdr_pgm.GetHandle(), "u_tex2D");
-	glUniform1i(tex_loc, 6);
-	if (uniform_time_loc >= 0)
-	{
-		glUniform1f(uniform_time_loc, animElapsedTime);
-	}
-	else
-	{
-		std::cout << "Uniform variable u_tex2D doesn't exist!!!\n";
-		std::exit(EXIT_FAILURE);
-	}
+	shdr_pgm.SetUniform(u_tex2D, 6);
 
 	// there are many models, each with their own initialized VAO object
 	// here, we're saying which VAO's state should be used to set up pipe
@@ -487,47 +521,61 @@ void GLApp::GLModel::draw()
 /*! GLApp::setup_texobj
  * @brief Set up a texture object.
  *
- * This method performs the following tasks to set up a texture object:
- * 1. Opens the binary file specified by the given pathname.
- * 2. Reads the image data from the file and stores it in client memory.
- * 3. Creates a texture object handle to encapsulate the texture.
- * 4. Allocates GPU storage for the texture image data.
- * 5. Copies the image data from client memory to the GPU texture buffer memory.
- * 6. Deletes the client memory since the image is now buffered in GPU memory.
- * 7. Returns the handle to the texture object.
+ * The file is loaded by TexLoader: a worker thread reads it and decodes it
+ * into a pixel unpack buffer, and TexLoader::update copies it to a texture
+ * object sized from the file, so init does not wait for the file and the
+ * render loop does not wait for the copy. Until then TexLoader::texture
+ * returns a placeholder for the handle. If GLApp::convert_textures has
+ * written the mipmap chain of the file, the chain is loaded instead and no
+ * chain is built while loading; the BC7 chain, a quarter the size in
+ * memory, is preferred to the RGBA8 one.
  *
- * @param[in] pathname The path to the binary file containing the texture image data.
- * @return The handle to the texture object.
+ * @param[in] pathname The path to the .tex file containing the texture image data.
+ * @return The TexLoader handle of the texture.
 */
-GLuint GLApp::setup_texobj(std::string pathname)
+TexLoader::Handle GLApp::setup_texobj(std::string pathname)
 {
-	// images have width and height of 256 texels and use 32-bit RGBA texel format
-	GLuint width{ 256 }, height{ 256 }, bytes_per_texel{ 4 };
-
-	// use standard C++ library to open binary file
-	// copy contents to heap memory pointed to by ptr_texels
-	std::ifstream ifs{ pathname, std::ios::binary};
-
-	char* ptr_texels;
-	ptr_texels = new char[width * height * bytes_per_texel];
-	ifs.read(ptr_texels, static_cast<std::streamsize>(width) * height * bytes_per_texel);
-	ifs.close();
-
-	// define and initialize a handle to texture object that will
-	// encapsulate two-dimensional textures
-	GLuint texobj_hdl;
-	glCreateTextures(GL_TEXTURE_2D, 1, &texobj_hdl);
-
-	// allocate GPU storage for texture image data loaded from file
-	glTextureStorage2D(texobj_hdl, 1, GL_RGBA8, width, height);
-
-	// copy image data from client memory to GPU texture buffer memory
-	glTextureSubImage2D(texobj_hdl, 0, 0, 0, width, height, GL_RGBA,
-						GL_UNSIGNED_BYTE, ptr_texels);
-
-	// client memory not required since image is buffered in GPU memory
-	delete[] ptr_texels;
+	std::string const bc7_pathname{ converted_pathname(pathname, "-bc7") };
+	if (std::filesystem::exists(bc7_pathname))
+	{
+		return TexLoader::request(bc7_pathname);
+	}
+	std::string const mip_pathname{ converted_pathname(pathname, "-mip") };
+	if (std::filesystem::exists(mip_pathname))
+	{
+		return TexLoader::request(mip_pathname);
+	}
+	return TexLoader::request(pathname);
+}
 
-	// return handle to texture object
-	return texobj_hdl;
+/*  _________________________________________________________________________ */
+/*! GLApp::convert_textures
+ * @brief Convert the texture files to files TexLoader uploads as they are.
+ *
+ * The full mipmap chain of each texture file, built with the Kaiser filter,
+ * which is too slow to run while loading, is written next to it with -mip
+ * before the extension, and the same chain compressed to BC7 blocks with
+ * -bc7. Files that cannot be converted are reported and skipped.
+ *
+ * @param none
+ * @return void
+*/
+void GLApp::convert_textures()
+{
+	for (std::string const& pathname : tex_files)
+	{
+		std::string const mip_pathname{ converted_pathname(pathname, "-mip") };
+		std::string const bc7_pathname{ converted_pathname(pathname, "-bc7") };
+		std::string error;
+		if (TexMip::convert(pathname, mip_pathname, TexMip::Filter::KAISER, error) &&
+			TexBC::convert(pathname, bc7_pathname, TexBC::Format::BC7, error))
+		{
+			std::cout << "Converted " << pathname << " to " << mip_pathname << " and "
+					  << bc7_pathname << "\n";
+		}
+		else
+		{
+			std::cout << error << "\n";
+		}
+	}
 }
@@ -30,6 +30,8 @@ GLFWwindow* GLHelper::ptr_window;
 GLboolean GLHelper::keystateM = GL_FALSE;
 GLboolean GLHelper::keystateT = GL_FALSE;
 GLboolean GLHelper::keystateA = GL_FALSE;
+GLboolean GLHelper::keystateB = GL_FALSE;
+GLboolean GLHelper::keystateC = GL_FALSE;
 GLboolean GLHelper::leftclickState = GL_FALSE;
 
 /*  _________________________________________________________________________ */
@@ -173,6 +175,8 @@ void GLHelper::key_cb(GLFWwindow* pwin, int key, int scancode, int action, int m
         keystateM = (key == GLFW_KEY_M) ? GL_TRUE : keystateM;
         keystateT = (key == GLFW_KEY_T) ? GL_TRUE : keystateT;
         keystateA = (key == GLFW_KEY_A) ? GL_TRUE : keystateA;
+        keystateB = (key == GLFW_KEY_B) ? GL_TRUE : keystateB;
+        keystateC = (key == GLFW_KEY_C) ? GL_TRUE : keystateC;
     }
     else if (GLFW_REPEAT == action)
     {
@@ -189,6 +193,8 @@ void GLHelper::key_cb(GLFWwindow* pwin, int key, int scancode, int action, int m
         keystateM = (key == GLFW_KEY_M) ? GL_FALSE : keystateM;
         keystateT = (key == GLFW_KEY_T) ? GL_FALSE : keystateT;
         keystateA = (key == GLFW_KEY_A) ? GL_FALSE : keystateA;
+        keystateB = (key == GLFW_KEY_B) ? GL_FALSE : keystateB;
+        keystateC = (key == GLFW_KEY_C) ? GL_FALSE : keystateC;
     }
 
     if (GLFW_KEY_ESCAPE == key && GLFW_PRESS == action) {
@@ -13,10 +13,226 @@ Please see the class declaration for information about these functions.
 
 *//*__________________________________________________________________________*/
 #include <glslshader.h>
+#include <filesystem>
+#include <cstdint>
+
+GLuint GLSLShader::lookups_avoided = 0;
+std::string GLSLShader::binary_cache_dir;
+GLuint GLSLShader::binary_cache_hits = 0;
+GLuint GLSLShader::binary_cache_misses = 0;
+
+namespace {
+  // header written in front of each cached program binary
+  struct BinaryHeader {
+    std::uint32_t magic;   // BINARY_MAGIC
+    std::uint32_t format;  // format returned by glGetProgramBinary
+    std::uint32_t length;  // size in bytes of the binary that follows
+  };
+  std::uint32_t const BINARY_MAGIC = 0x42504C47; // "GLPB"
+
+  // FNV-1a hash of size bytes at data, continuing from hash
+  std::uint64_t Fnv1a(void const* data, size_t size, std::uint64_t hash) {
+    unsigned char const* bytes = static_cast<unsigned char const*>(data);
+    for (size_t i = 0; i < size; ++i) {
+      hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+    }
+    return hash;
+  }
+
+  std::uint64_t Fnv1a(std::string const& str, std::uint64_t hash) {
+    // include the terminator so that "ab"+"c" and "a"+"bc" differ
+    return Fnv1a(str.c_str(), str.size() + 1, hash);
+  }
+
+  std::uint64_t BinaryCacheKey(std::vector<std::pair<GLenum, std::string>> const& vec) {
+    std::uint64_t key = 0xCBF29CE484222325ull;
+    GLenum const names[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+    for (GLenum name : names) {
+      GLubyte const* str = glGetString(name);
+      key = Fnv1a(str ? reinterpret_cast<char const*>(str) : "", key);
+    }
+    for (auto const& elem : vec) {
+      std::ifstream shader_file(elem.second, std::ifstream::in | std::ifstream::binary);
+      if (!shader_file) {
+        return 0;
+      }
+      std::stringstream buffer;
+      buffer << shader_file.rdbuf();
+      key = Fnv1a(&elem.first, sizeof(elem.first), key);
+      key = Fnv1a(buffer.str(), key);
+    }
+    return key;
+  }
+}
 
 GLint
 GLSLShader::GetUniformLocation(GLchar const* name) {
-  return glGetUniformLocation(pgm_handle, name);
+  auto it = uniform_locs.find(name);
+  if (it == uniform_locs.end()) {
+    return -1;
+  }
+  ++lookups_avoided;
+  return it->second;
+}
+
+GLint
+GLSLShader::GetUniformLocation(UniformHandle handle) {
+  if (handle.id >= handle_locs.size()) {
+    std::vector<std::string> const& names = HandleNames();
+    for (size_t i = handle_locs.size(); i < names.size(); ++i) {
+      auto it = uniform_locs.find(names[i]);
+      handle_locs.push_back(it == uniform_locs.end() ? -1 : it->second);
+    }
+  }
+  ++lookups_avoided;
+  return handle_locs[handle.id];
+}
+
+std::vector<std::string>&
+GLSLShader::HandleNames() {
+  static std::vector<std::string> names;
+  return names;
+}
+
+GLSLShader::UniformHandle
+GLSLShader::GetUniformHandle(GLchar const* name) {
+  std::vector<std::string>& names = HandleNames();
+  for (GLuint i = 0; i < names.size(); ++i) {
+    if (names[i] == name) {
+      return UniformHandle{ i };
+    }
+  }
+  names.push_back(name);
+  return UniformHandle{ static_cast<GLuint>(names.size() - 1) };
+}
+
+GLboolean
+GLSLShader::HasUniform(UniformHandle handle) {
+  return GetUniformLocation(handle) >= 0 ? GL_TRUE : GL_FALSE;
+}
+
+GLuint GLSLShader::GetLookupsAvoided() {
+  return lookups_avoided;
+}
+
+void GLSLShader::ResetLookupsAvoided() {
+  lookups_avoided = 0;
+}
+
+void GLSLShader::ReflectUniforms() {
+  uniform_locs.clear();
+  handle_locs.clear();
+
+  GLint max_length, num_uniforms;
+  glGetProgramiv(pgm_handle, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+  glGetProgramiv(pgm_handle, GL_ACTIVE_UNIFORMS, &num_uniforms);
+  std::vector<GLchar> pname(max_length > 0 ? max_length : 1);
+  for (GLint i = 0; i < num_uniforms; ++i) {
+    GLsizei written;
+    GLint size;
+    GLenum type;
+    glGetActiveUniform(pgm_handle, i, max_length, &written, &size, &type, pname.data());
+    GLint loc = glGetUniformLocation(pgm_handle, pname.data());
+    if (loc < 0) { // uniform block members have no location
+      continue;
+    }
+    std::string uniform_name(pname.data(), written);
+    uniform_locs[uniform_name] = loc;
+    // arrays are reported as "name[0]" but are also looked up as "name"
+    if (uniform_name.size() > 3 && uniform_name.compare(uniform_name.size() - 3, 3, "[0]") == 0) {
+      uniform_locs[uniform_name.substr(0, uniform_name.size() - 3)] = loc;
+    }
+  }
+}
+
+void GLSLShader::SetBinaryCacheDir(std::string const& dir) {
+  binary_cache_dir = dir;
+  if (!dir.empty()) {
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+  }
+}
+
+GLuint GLSLShader::GetBinaryCacheHits() {
+  return binary_cache_hits;
+}
+
+GLuint GLSLShader::GetBinaryCacheMisses() {
+  return binary_cache_misses;
+}
+
+std::string
+GLSLShader::BinaryCacheFile(std::vector<std::pair<GLenum, std::string>> const& vec) {
+  GLint num_formats = 0;
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_formats);
+  if (binary_cache_dir.empty() || num_formats <= 0) {
+    return std::string();
+  }
+  std::uint64_t key = BinaryCacheKey(vec);
+  if (key == 0) {
+    return std::string();
+  }
+  std::stringstream file_name;
+  file_name << binary_cache_dir << "/" << std::hex << key << ".bin";
+  return file_name.str();
+}
+
+GLboolean
+GLSLShader::LoadBinary(std::string const& file_name) {
+  std::ifstream in_file(file_name, std::ifstream::in | std::ifstream::binary);
+  if (!in_file) {
+    return GL_FALSE;
+  }
+  BinaryHeader header;
+  if (!in_file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      header.magic != BINARY_MAGIC) {
+    return GL_FALSE;
+  }
+  // a corrupt header must not size the buffer past the end of the file
+  std::streamoff const data_start{ in_file.tellg() };
+  in_file.seekg(0, std::ifstream::end);
+  std::streamoff const remaining{ in_file.tellg() - data_start };
+  in_file.seekg(data_start);
+  if (header.length == 0 || static_cast<std::streamoff>(header.length) > remaining) {
+    return GL_FALSE;
+  }
+  std::vector<char> binary(header.length);
+  if (!in_file.read(binary.data(), static_cast<std::streamsize>(binary.size()))) {
+    return GL_FALSE;
+  }
+
+  if (pgm_handle <= 0) {
+    pgm_handle = glCreateProgram();
+  }
+  glProgramBinary(pgm_handle, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+  GLint lnk_status;
+  glGetProgramiv(pgm_handle, GL_LINK_STATUS, &lnk_status);
+  if (GL_FALSE == lnk_status) { // stale binary, e.g. driver updated
+    glDeleteProgram(pgm_handle);
+    pgm_handle = 0;
+    return GL_FALSE;
+  }
+  ReflectUniforms();
+  is_linked = GL_TRUE;
+  return GL_TRUE;
+}
+
+void
+GLSLShader::SaveBinary(std::string const& file_name) {
+  GLint length = 0;
+  glGetProgramiv(pgm_handle, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) {
+    return;
+  }
+  std::vector<char> binary(length);
+  GLenum format;
+  glGetProgramBinary(pgm_handle, length, &length, &format, binary.data());
+
+  // the file name is the key; the header only describes the binary
+  BinaryHeader header{ BINARY_MAGIC, format, static_cast<std::uint32_t>(length) };
+  std::ofstream out_file(file_name, std::ofstream::out | std::ofstream::binary);
+  out_file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+  out_file.write(binary.data(), length);
 }
 
 GLboolean
@@ -29,21 +245,39 @@ GLSLShader::DeleteShaderProgram() {
   if (pgm_handle > 0) {
     glDeleteProgram(pgm_handle);
   }
+  uniform_locs.clear();
+  handle_locs.clear();
 }
 
 GLboolean
 GLSLShader::CompileLinkValidate(std::vector<std::pair<GLenum, std::string>> vec) {
+  // try the binary cache before compiling any source
+  std::string cache_file = BinaryCacheFile(vec);
+  if (!cache_file.empty()) {
+    if (GL_TRUE == LoadBinary(cache_file)) {
+      ++binary_cache_hits;
+      return Validate();
+    }
+    ++binary_cache_misses;
+  }
+
   for (auto& elem : vec) {
     if (GL_FALSE == CompileShaderFromFile(elem.first, elem.second.c_str())) {
       return GL_FALSE;
     }
   }
+  if (!cache_file.empty()) {
+    glProgramParameteri(pgm_handle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+  }
   if (GL_FALSE == Link()) {
     return GL_FALSE;
   }
   if (GL_FALSE == Validate()) {
     return GL_FALSE;
   }
+  if (!cache_file.empty()) {
+    SaveBinary(cache_file);
+  }
   PrintActiveAttribs();
   PrintActiveUniforms();
 
@@ -153,6 +387,7 @@ GLboolean GLSLShader::Link() {
     }
     return GL_FALSE;
   }
+  ReflectUniforms();
   return is_linked = GL_TRUE;
 }
 
@@ -212,7 +447,7 @@ void GLSLShader::BindFragDataLocation(GLuint color_number, GLchar const* name) {
 }
 
 void GLSLShader::SetUniform(GLchar const* name, GLboolean val) {
-  GLint loc = glGetUniformLocation(pgm_handle, name);
+  GLint loc = GetUniformLocation(name);
   if (loc >= 0) {
     glUniform1i(loc, val);
   } else {
@@ -221,7 +456,7 @@ void GLSLShader::SetUniform(GLchar const* name, GLboolean val) {
 }
 
 void GLSLShader::SetUniform(GLchar const* name, GLint val) {
-  GLint loc = glGetUniformLocation(pgm_handle, name);
+  GLint loc = GetUniformLocation(name);
   if (loc >= 0) {
     glUniform1i(loc, val);
   } else {
@@ -229,8 +464,17 @@ void GLSLShader::SetUniform(GLchar const* name, GLint val) {
   }
 }
 
+void GLSLShader::SetUniform(GLchar const* name, GLuint val) {
+  GLint loc = GetUniformLocation(name);
+  if (loc >= 0) {
+    glUniform1ui(loc, val);
+  } else {
+    std::cout << "Uniform variable " << name << " doesn't exist" << std::endl;
+  }
+}
+
 void GLSLShader::SetUniform(GLchar const* name, GLfloat val) {
-  GLint loc = glGetUniformLocation(pgm_handle, name);
+  GLint loc = GetUniformLocation(name);
   if (loc >= 0) {
     glUniform1f(loc, val);
   } else {
@@ -239,7 +483,7 @@ void GLSLShader::SetUniform(GLchar const* name, GLfloat val) {
 }
 
 void GLSLShader::SetUniform(GLchar const* name, GLfloat x, GLfloat y) {
-  GLint loc = glGetUniformLocation(pgm_handle, name);
+  GLint loc = GetUniformLocation(name);
   if (loc >= 0) {
     glUniform2f(loc, x, y);
   } else {
@@ -248,7 +492,7 @@ void GLSLShader::SetUniform(GLchar const* name, GLfloat x, GLfloat y) {
 }
 
 void GLSLShader::SetUniform(GLchar const* name, GLfloat x, GLfloat y, GLfloat z) {
-  GLint loc = glGetUniformLocation(pgm_handle, name);
+  GLint loc = GetUniformLocation(name);
   if (loc >= 0) {
     glUniform3f(loc, x, y, z);
   } else {
@@ -258,7 +502,7 @@ void GLSLShader::SetUniform(GLchar const* name, GLfloat x, GLfloat y, GLfloat z)
 
 void
 GLSLShader::SetUniform(GLchar const* name, GLfloat x, GLfloat y, GLfloat z, GLfloat w) {
-  GLint loc = glGetUniformLocation(pgm_handle, name);
+  GLint loc = GetUniformLocation(name);
   if (loc >= 0) {
     glUniform4f(loc, x, y, z, w);
   } else {
@@ -267,7 +511,7 @@ GLSLShader::SetUniform(GLchar const* name, GLfloat x, GLfloat y, GLfloat z, GLfl
 }
 
 void GLSLShader::SetUniform(GLchar const* name, glm::vec2 const& val) {
-  GLint loc = glGetUniformLocation(pgm_handle, name);
+  GLint loc = GetUniformLocation(name);
   if (loc >= 0) {
     glUniform2f(loc, val.x, val.y);
   } else {
@@ -276,7 +520,7 @@ void GLSLShader::SetUniform(GLchar const* name, glm::vec2 const& val) {
 }
 
 void GLSLShader::SetUniform(GLchar const* name, glm::vec3 const& val) {
-  GLint loc = glGetUniformLocation(pgm_handle, name);
+  GLint loc = GetUniformLocation(name);
   if (loc >= 0) {
     glUniform3f(loc, val.x, val.y, val.z);
   } else {
@@ -285,7 +529,7 @@ void GLSLShader::SetUniform(GLchar const* name, glm::vec3 const& val) {
 }
 
 void GLSLShader::SetUniform(GLchar const* name, glm::vec4 const& val) {
-  GLint loc = glGetUniformLocation(pgm_handle, name);
+  GLint loc = GetUniformLocation(name);
   if (loc >= 0) {
     glUniform4f(loc, val.x, val.y, val.z, val.w);
   } else {
@@ -294,7 +538,7 @@ void GLSLShader::SetUniform(GLchar const* name, glm::vec4 const& val) {
 }
 
 void GLSLShader::SetUniform(GLchar const* name, glm::mat3 const& val) {
-  GLint loc = glGetUniformLocation(pgm_handle, name);
+  GLint loc = GetUniformLocation(name);
   if (loc >= 0) {
     glUniformMatrix3fv(loc, 1, GL_FALSE, &val[0][0]);
   } else {
@@ -303,7 +547,7 @@ void GLSLShader::SetUniform(GLchar const* name, glm::mat3 const& val) {
 }
 
 void GLSLShader::SetUniform(GLchar const* name, glm::mat4 const& val) {
-  GLint loc = glGetUniformLocation(pgm_handle, name);
+  GLint loc = GetUniformLocation(name);
   if (loc >= 0) {
     glUniformMatrix4fv(loc, 1, GL_FALSE, &val[0][0]);
   } else {
@@ -311,6 +555,114 @@ void GLSLShader::SetUniform(GLchar const* name, glm::mat4 const& val) {
   }
 }
 
+void GLSLShader::SetUniform(UniformHandle handle, GLboolean val) {
+  GLint loc = GetUniformLocation(handle);
+  if (loc >= 0) {
+    glUniform1i(loc, val);
+  } else {
+    std::cout << "Uniform variable " << HandleNames()[handle.id] << " doesn't exist" << std::endl;
+  }
+}
+
+void GLSLShader::SetUniform(UniformHandle handle, GLint val) {
+  GLint loc = GetUniformLocation(handle);
+  if (loc >= 0) {
+    glUniform1i(loc, val);
+  } else {
+    std::cout << "Uniform variable " << HandleNames()[handle.id] << " doesn't exist" << std::endl;
+  }
+}
+
+void GLSLShader::SetUniform(UniformHandle handle, GLuint val) {
+  GLint loc = GetUniformLocation(handle);
+  if (loc >= 0) {
+    glUniform1ui(loc, val);
+  } else {
+    std::cout << "Uniform variable " << HandleNames()[handle.id] << " doesn't exist" << std::endl;
+  }
+}
+
+void GLSLShader::SetUniform(UniformHandle handle, GLfloat val) {
+  GLint loc = GetUniformLocation(handle);
+  if (loc >= 0) {
+    glUniform1f(loc, val);
+  } else {
+    std::cout << "Uniform variable " << HandleNames()[handle.id] << " doesn't exist" << std::endl;
+  }
+}
+
+void GLSLShader::SetUniform(UniformHandle handle, GLfloat x, GLfloat y) {
+  GLint loc = GetUniformLocation(handle);
+  if (loc >= 0) {
+    glUniform2f(loc, x, y);
+  } else {
+    std::cout << "Uniform variable " << HandleNames()[handle.id] << " doesn't exist" << std::endl;
+  }
+}
+
+void GLSLShader::SetUniform(UniformHandle handle, GLfloat x, GLfloat y, GLfloat z) {
+  GLint loc = GetUniformLocation(handle);
+  if (loc >= 0) {
+    glUniform3f(loc, x, y, z);
+  } else {
+    std::cout << "Uniform variable " << HandleNames()[handle.id] << " doesn't exist" << std::endl;
+  }
+}
+
+void GLSLShader::SetUniform(UniformHandle handle, GLfloat x, GLfloat y, GLfloat z, GLfloat w) {
+  GLint loc = GetUniformLocation(handle);
+  if (loc >= 0) {
+    glUniform4f(loc, x, y, z, w);
+  } else {
+    std::cout << "Uniform variable " << HandleNames()[handle.id] << " doesn't exist" << std::endl;
+  }
+}
+
+void GLSLShader::SetUniform(UniformHandle handle, glm::vec2 const& val) {
+  GLint loc = GetUniformLocation(handle);
+  if (loc >= 0) {
+    glUniform2f(loc, val.x, val.y);
+  } else {
+    std::cout << "Uniform variable " << HandleNames()[handle.id] << " doesn't exist" << std::endl;
+  }
+}
+
+void GLSLShader::SetUniform(UniformHandle handle, glm::vec3 const& val) {
+  GLint loc = GetUniformLocation(handle);
+  if (loc >= 0) {
+    glUniform3f(loc, val.x, val.y, val.z);
+  } else {
+    std::cout << "Uniform variable " << HandleNames()[handle.id] << " doesn't exist" << std::endl;
+  }
+}
+
+void GLSLShader::SetUniform(UniformHandle handle, glm::vec4 const& val) {
+  GLint loc = GetUniformLocation(handle);
+  if (loc >= 0) {
+    glUniform4f(loc, val.x, val.y, val.z, val.w);
+  } else {
+    std::cout << "Uniform variable " << HandleNames()[handle.id] << " doesn't exist" << std::endl;
+  }
+}
+
+void GLSLShader::SetUniform(UniformHandle handle, glm::mat3 const& val) {
+  GLint loc = GetUniformLocation(handle);
+  if (loc >= 0) {
+    glUniformMatrix3fv(loc, 1, GL_FALSE, &val[0][0]);
+  } else {
+    std::cout << "Uniform variable " << HandleNames()[handle.id] << " doesn't exist" << std::endl;
+  }
+}
+
+void GLSLShader::SetUniform(UniformHandle handle, glm::mat4 const& val) {
+  GLint loc = GetUniformLocation(handle);
+  if (loc >= 0) {
+    glUniformMatrix4fv(loc, 1, GL_FALSE, &val[0][0]);
+  } else {
+    std::cout << "Uniform variable " << HandleNames()[handle.id] << " doesn't exist" << std::endl;
+  }
+}
+
 void GLSLShader::PrintActiveAttribs() const {
 #if 1
   GLint max_length, num_attribs;
@@ -0,0 +1,1091 @@
+/*!
+* @file    texbc.cpp
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/22/2023
+*
+* @brief This file implements the block compressor declared in texbc.h.
+*		 A block is gathered channel by channel into 4 rows of 16 floats so
+*		 that SSE2 measures the distance of 4 texels to a palette color in
+*		 one pass. Palettes are built with the integer arithmetic of the
+*		 decoders, so the error the encoder minimizes is the error of the
+*		 decoded texture.
+*//*__________________________________________________________________________*/
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <texbc.h>
+#include <texloader.h>
+#include <texmip.h>
+#include <jobsystem.h>
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define TEXBC_SSE2
+#endif
+
+// the distances must not fuse multiplies and adds into FMA instructions in
+// one path only, or the paths would pick different endpoints
+#if defined(_MSC_VER)
+#pragma fp_contract(off)
+#elif defined(__clang__)
+#pragma clang fp contract(off)
+#else
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+/*                                                   objects with file scope
+----------------------------------------------------------------------------- */
+namespace {
+  char const BC_MAGIC[4]{ 'T', 'E', 'X', 'B' };
+
+  // passes of single step endpoint moves after the least squares refit
+  int const REFINE_PASSES{ 4 };
+
+  // channels counted in the error of a color palette
+  float const RGB_WEIGHTS[4]{ 1.f, 1.f, 1.f, 0.f };
+  float const RGBA_WEIGHTS[4]{ 1.f, 1.f, 1.f, 1.f };
+
+  // position between the endpoints of each BC1 palette index, in thirds
+  float const BC1_FRACTIONS[4]{ 0.f, 1.f, 1.f / 3.f, 2.f / 3.f };
+
+  // weights of the second endpoint of each BC7 2-bit and 4-bit index, in 64ths
+  int const BC7_WEIGHTS2[4]{ 0, 21, 43, 64 };
+  int const BC7_WEIGHTS[16]{ 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+  // texels of a block, channel by channel, row by row
+  struct Block {
+    alignas(16) float ch[4][16];
+  };
+
+  // quantized endpoints of a block, 2 of up to 4 channels
+  using Endpoints = int[2][4];
+
+  // appends bits to a block, least significant bit first
+  struct BitWriter {
+    GLubyte* out;
+    unsigned pos{ 0 };
+
+    void put(unsigned value, unsigned bits)
+    {
+      for (unsigned b{ 0 }; b < bits; ++b, ++pos) {
+        if ((value >> b) & 1u) {
+          out[pos / 8] |= static_cast<GLubyte>(1u << (pos % 8));
+        }
+      }
+    }
+  };
+
+  // reads bits of a block, least significant bit first
+  struct BitReader {
+    GLubyte const* in;
+    unsigned pos{ 0 };
+
+    unsigned get(unsigned bits)
+    {
+      unsigned value{ 0 };
+      for (unsigned b{ 0 }; b < bits; ++b, ++pos) {
+        value |= ((in[pos / 8] >> (pos % 8)) & 1u) << b;
+      }
+      return value;
+    }
+  };
+
+  /*  _______________________________________________________________________ */
+  /*! gather
+   * @brief Copy the texels of block (bx, by) of an image to block.
+   *
+   * Texels past the right or bottom edge repeat the edge texel.
+  */
+  void gather(GLubyte const* rgba, GLuint width, GLuint height, GLuint bx, GLuint by, Block& block)
+  {
+    for (GLuint i{ 0 }; i < 16; ++i) {
+      GLuint const x{ std::min(4 * bx + i % 4, width - 1) }, y{ std::min(4 * by + i / 4, height - 1) };
+      GLubyte const* texel{ rgba + 4 * (static_cast<size_t>(y) * width + x) };
+      for (int c{ 0 }; c < 4; ++c) {
+        block.ch[c][i] = texel[c];
+      }
+    }
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! fit
+   * @brief Find the nearest of n palette colors to each texel of a block.
+   *
+   * Distances are squared and weighted per channel; of equally near colors
+   * the first is taken.
+   *
+   * @param idx[out] Palette index of each texel; ignored if nullptr.
+   * @return Sum of the distances of the texels to their colors.
+  */
+  float fit(Block const& block, float const (*palette)[4], int n, float const* weights, GLubyte* idx)
+  {
+#ifdef TEXBC_SSE2
+    __m128 const w0{ _mm_set1_ps(weights[0]) }, w1{ _mm_set1_ps(weights[1]) };
+    __m128 const w2{ _mm_set1_ps(weights[2]) }, w3{ _mm_set1_ps(weights[3]) };
+    __m128 total{ _mm_setzero_ps() };
+    for (int g{ 0 }; g < 16; g += 4) {
+      __m128 const r{ _mm_load_ps(block.ch[0] + g) }, gr{ _mm_load_ps(block.ch[1] + g) };
+      __m128 const b{ _mm_load_ps(block.ch[2] + g) }, a{ _mm_load_ps(block.ch[3] + g) };
+      __m128 best{ _mm_set1_ps(FLT_MAX) }, best_k{ _mm_setzero_ps() };
+      for (int k{ 0 }; k < n; ++k) {
+        __m128 const dr{ _mm_sub_ps(r, _mm_set1_ps(palette[k][0])) };
+        __m128 const dg{ _mm_sub_ps(gr, _mm_set1_ps(palette[k][1])) };
+        __m128 const db{ _mm_sub_ps(b, _mm_set1_ps(palette[k][2])) };
+        __m128 const da{ _mm_sub_ps(a, _mm_set1_ps(palette[k][3])) };
+        __m128 const d{ _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(dr, dr), w0), _mm_mul_ps(_mm_mul_ps(dg, dg), w1)),
+                                   _mm_add_ps(_mm_mul_ps(_mm_mul_ps(db, db), w2), _mm_mul_ps(_mm_mul_ps(da, da), w3))) };
+        __m128 const closer{ _mm_cmplt_ps(d, best) };
+        best = _mm_min_ps(d, best);
+        best_k = _mm_or_ps(_mm_and_ps(closer, _mm_set1_ps(static_cast<float>(k))), _mm_andnot_ps(closer, best_k));
+      }
+      total = _mm_add_ps(total, best);
+      if (idx != nullptr) {
+        alignas(16) float k[4];
+        _mm_store_ps(k, best_k);
+        for (int j{ 0 }; j < 4; ++j) {
+          idx[g + j] = static_cast<GLubyte>(k[j]);
+        }
+      }
+    }
+    alignas(16) float lane[4];
+    _mm_store_ps(lane, total);
+#else
+    float lane[4]{ 0.f, 0.f, 0.f, 0.f };
+    for (int g{ 0 }; g < 16; g += 4) {
+      for (int j{ 0 }; j < 4; ++j) {
+        float best{ FLT_MAX };
+        int best_k{ 0 };
+        for (int k{ 0 }; k < n; ++k) {
+          float const dr{ block.ch[0][g + j] - palette[k][0] }, dg{ block.ch[1][g + j] - palette[k][1] };
+          float const db{ block.ch[2][g + j] - palette[k][2] }, da{ block.ch[3][g + j] - palette[k][3] };
+          float const d{ ((dr * dr) * weights[0] + (dg * dg) * weights[1]) + ((db * db) * weights[2] + (da * da) * weights[3]) };
+          if (d < best) {
+            best = d;
+            best_k = k;
+          }
+        }
+        lane[j] += best;
+        if (idx != nullptr) {
+          idx[g + j] = static_cast<GLubyte>(best_k);
+        }
+      }
+    }
+#endif
+    return (lane[0] + lane[1]) + (lane[2] + lane[3]);
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! axis_endpoints
+   * @brief Find the ends of the colors of a block along their principal axis.
+   *
+   * The axis is the dominant eigenvector of the covariance of the first
+   * channels channels, found by power iteration from the row of the
+   * channel varying most.
+  */
+  void axis_endpoints(Block const& block, int channels, float (&e)[2][4])
+  {
+    float mean[4]{ 0.f, 0.f, 0.f, 0.f };
+    for (int c{ 0 }; c < channels; ++c) {
+      for (int i{ 0 }; i < 16; ++i) {
+        mean[c] += block.ch[c][i];
+      }
+      mean[c] /= 16.f;
+    }
+
+    float cov[4][4]{};
+    for (int i{ 0 }; i < 16; ++i) {
+      for (int c{ 0 }; c < channels; ++c) {
+        for (int d{ 0 }; d < channels; ++d) {
+          cov[c][d] += (block.ch[c][i] - mean[c]) * (block.ch[d][i] - mean[d]);
+        }
+      }
+    }
+
+    int widest{ 0 };
+    for (int c{ 1 }; c < channels; ++c) {
+      widest = (cov[c][c] > cov[widest][widest]) ? c : widest;
+    }
+    float axis[4]{ 0.f, 0.f, 0.f, 0.f };
+    for (int c{ 0 }; c < channels; ++c) {
+      axis[c] = cov[widest][c];
+    }
+    for (int iter{ 0 }; iter < 8; ++iter) {
+      float next[4]{ 0.f, 0.f, 0.f, 0.f };
+      float largest{ 0.f };
+      for (int c{ 0 }; c < channels; ++c) {
+        for (int d{ 0 }; d < channels; ++d) {
+          next[c] += cov[c][d] * axis[d];
+        }
+        largest = std::max(largest, std::abs(next[c]));
+      }
+      if (largest == 0.f) {
+        break;
+      }
+      for (int c{ 0 }; c < channels; ++c) {
+        axis[c] = next[c] / largest;
+      }
+    }
+    float length2{ 0.f };
+    for (int c{ 0 }; c < channels; ++c) {
+      length2 += axis[c] * axis[c];
+    }
+
+    float t_min{ 0.f }, t_max{ 0.f };
+    if (length2 > 0.f) {
+      float const inv_length{ 1.f / std::sqrt(length2) };
+      for (int c{ 0 }; c < channels; ++c) {
+        axis[c] *= inv_length;
+      }
+      t_min = FLT_MAX;
+      t_max = -FLT_MAX;
+      for (int i{ 0 }; i < 16; ++i) {
+        float t{ 0.f };
+        for (int c{ 0 }; c < channels; ++c) {
+          t += (block.ch[c][i] - mean[c]) * axis[c];
+        }
+        t_min = std::min(t_min, t);
+        t_max = std::max(t_max, t);
+      }
+    }
+    for (int c{ 0 }; c < 4; ++c) {
+      e[0][c] = (c < channels) ? mean[c] + t_min * axis[c] : 255.f;
+      e[1][c] = (c < channels) ? mean[c] + t_max * axis[c] : 255.f;
+    }
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! least_squares
+   * @brief Find the endpoints best fitting texels to the palette indices
+   * they were given.
+   *
+   * Index k of a texel stands for the color fractions[k] of the way from
+   * the first endpoint to the second.
+   *
+   * @return false if every texel has the same fraction.
+  */
+  bool least_squares(Block const& block, int channels, GLubyte const* idx, float const* fractions,
+                     float (&e)[2][4])
+  {
+    float aa{ 0.f }, ab{ 0.f }, bb{ 0.f };
+    float ax[4]{ 0.f, 0.f, 0.f, 0.f }, bx[4]{ 0.f, 0.f, 0.f, 0.f };
+    for (int i{ 0 }; i < 16; ++i) {
+      float const t{ fractions[idx[i]] }, s{ 1.f - t };
+      aa += s * s;
+      ab += s * t;
+      bb += t * t;
+      for (int c{ 0 }; c < channels; ++c) {
+        ax[c] += s * block.ch[c][i];
+        bx[c] += t * block.ch[c][i];
+      }
+    }
+    float const det{ aa * bb - ab * ab };
+    if (std::abs(det) < 1e-6f) {
+      return false;
+    }
+    for (int c{ 0 }; c < channels; ++c) {
+      e[0][c] = (bb * ax[c] - ab * bx[c]) / det;
+      e[1][c] = (aa * bx[c] - ab * ax[c]) / det;
+    }
+    return true;
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! refine
+   * @brief Move each quantized endpoint channel by one step while that
+   * lowers the error of the block.
+   *
+   * @param make_palette[in] Builds the palette of quantized endpoints.
+   * @return Error of the endpoints left in q.
+  */
+  template <typename MakePalette>
+  float refine(Block const& block, int channels, int const* max_q, int n, float const* weights,
+               MakePalette const& make_palette, Endpoints& q)
+  {
+    float palette[16][4];
+    make_palette(q, palette);
+    float best{ fit(block, palette, n, weights, nullptr) };
+    bool improved{ true };
+    for (int pass{ 0 }; pass < REFINE_PASSES && improved; ++pass) {
+      improved = false;
+      for (int e{ 0 }; e < 2; ++e) {
+        for (int c{ 0 }; c < channels; ++c) {
+          for (int step : { -1, 1 }) {
+            int const value{ q[e][c] + step };
+            if (value < 0 || value > max_q[c]) {
+              continue;
+            }
+            q[e][c] = value;
+            make_palette(q, palette);
+            float const error{ fit(block, palette, n, weights, nullptr) };
+            if (error < best) {
+              best = error;
+              improved = true;
+            } else {
+              q[e][c] -= step;
+            }
+          }
+        }
+      }
+    }
+    return best;
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! expand565
+   * @brief Expand a quantized RGB565 channel to 8 bits as decoders do.
+  */
+  int expand565(int value, int c)
+  {
+    return (c == 1) ? (value << 2) | (value >> 4) : (value << 3) | (value >> 2);
+  }
+
+  // largest quantized value of each RGB565 channel
+  int const MAX_565[4]{ 31, 63, 31, 0 };
+
+  /*  _______________________________________________________________________ */
+  /*! bc1_palette
+   * @brief Build the 4 colors of quantized RGB565 endpoints.
+  */
+  void bc1_palette(Endpoints const& q, float (*palette)[4])
+  {
+    for (int c{ 0 }; c < 3; ++c) {
+      int const c0{ expand565(q[0][c], c) }, c1{ expand565(q[1][c], c) };
+      palette[0][c] = static_cast<float>(c0);
+      palette[1][c] = static_cast<float>(c1);
+      palette[2][c] = static_cast<float>((2 * c0 + c1 + 1) / 3);
+      palette[3][c] = static_cast<float>((c0 + 2 * c1 + 1) / 3);
+    }
+    for (int k{ 0 }; k < 4; ++k) {
+      palette[k][3] = 255.f;
+    }
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! quantize565
+   * @brief Round endpoint colors to RGB565.
+  */
+  void quantize565(float const (&e)[2][4], Endpoints& q)
+  {
+    for (int i{ 0 }; i < 2; ++i) {
+      for (int c{ 0 }; c < 3; ++c) {
+        q[i][c] = static_cast<int>(std::lround(std::clamp(e[i][c], 0.f, 255.f) * MAX_565[c] / 255.f));
+      }
+      q[i][3] = 0;
+    }
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! encode_color
+   * @brief Write the 8 byte BC1 block of the RGB of a block.
+   *
+   * The first endpoint is stored as the larger RGB565 value, which selects
+   * the 4 color mode without transparency.
+  */
+  void encode_color(Block const& block, GLubyte* out)
+  {
+    float e[2][4];
+    axis_endpoints(block, 3, e);
+    Endpoints q;
+    quantize565(e, q);
+
+    float palette[16][4];
+    GLubyte idx[16];
+    bc1_palette(q, palette);
+    float error{ fit(block, palette, 4, RGB_WEIGHTS, idx) };
+    if (least_squares(block, 3, idx, BC1_FRACTIONS, e)) {
+      Endpoints refit;
+      quantize565(e, refit);
+      bc1_palette(refit, palette);
+      if (fit(block, palette, 4, RGB_WEIGHTS, nullptr) < error) {
+        std::memcpy(q, refit, sizeof(q));
+      }
+    }
+    refine(block, 3, MAX_565, 4, RGB_WEIGHTS, bc1_palette, q);
+    bc1_palette(q, palette);
+    fit(block, palette, 4, RGB_WEIGHTS, idx);
+
+    GLuint c0{ static_cast<GLuint>((q[0][0] << 11) | (q[0][1] << 5) | q[0][2]) };
+    GLuint c1{ static_cast<GLuint>((q[1][0] << 11) | (q[1][1] << 5) | q[1][2]) };
+    if (c0 < c1) {
+      std::swap(c0, c1);
+      GLubyte const swapped[4]{ 1, 0, 3, 2 };
+      for (GLubyte& i : idx) {
+        i = swapped[i];
+      }
+    } else if (c0 == c1) {
+      std::fill(idx, idx + 16, GLubyte{ 0 });
+    }
+
+    GLuint bits{ 0 };
+    for (int i{ 0 }; i < 16; ++i) {
+      bits |= static_cast<GLuint>(idx[i]) << (2 * i);
+    }
+    out[0] = static_cast<GLubyte>(c0);
+    out[1] = static_cast<GLubyte>(c0 >> 8);
+    out[2] = static_cast<GLubyte>(c1);
+    out[3] = static_cast<GLubyte>(c1 >> 8);
+    for (int b{ 0 }; b < 4; ++b) {
+      out[4 + b] = static_cast<GLubyte>(bits >> (8 * b));
+    }
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! encode_alpha
+   * @brief Write the 8 byte BC3 alpha block of a block.
+   *
+   * The endpoints are the largest and smallest alpha, first the largest so
+   * that the 6 values between them are interpolated.
+  */
+  void encode_alpha(Block const& block, GLubyte* out)
+  {
+    int const a0{ static_cast<int>(*std::max_element(block.ch[3], block.ch[3] + 16)) };
+    int const a1{ static_cast<int>(*std::min_element(block.ch[3], block.ch[3] + 16)) };
+    out[0] = static_cast<GLubyte>(a0);
+    out[1] = static_cast<GLubyte>(a1);
+
+    std::uint64_t bits{ 0 };
+    if (a0 > a1) {
+      int values[8]{ a0, a1 };
+      for (int k{ 2 }; k < 8; ++k) {
+        values[k] = ((8 - k) * a0 + (k - 1) * a1 + 3) / 7;
+      }
+      for (int i{ 0 }; i < 16; ++i) {
+        int const a{ static_cast<int>(block.ch[3][i]) };
+        int best_k{ 0 };
+        for (int k{ 1 }; k < 8; ++k) {
+          best_k = (std::abs(values[k] - a) < std::abs(values[best_k] - a)) ? k : best_k;
+        }
+        bits |= static_cast<std::uint64_t>(best_k) << (3 * i);
+      }
+    }
+    for (int b{ 0 }; b < 6; ++b) {
+      out[2 + b] = static_cast<GLubyte>(bits >> (8 * b));
+    }
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! encode_mode6
+   * @brief Write the 16 byte BC7 mode 6 block of a block.
+   *
+   * Every combination of the low bits of the endpoints is quantized and
+   * the best one is refined. The first texel must get an index below 8,
+   * so the endpoints are swapped and the indices mirrored if it does not.
+   *
+   * @return Squared error of the block.
+  */
+  float encode_mode6(Block const& block, GLubyte* out)
+  {
+    int const max_q[4]{ 127, 127, 127, 127 };
+    int p[2]{ 0, 0 };
+    auto const make_palette = [&p](Endpoints const& q, float (*palette)[4]) {
+      for (int c{ 0 }; c < 4; ++c) {
+        int const e0{ (q[0][c] << 1) | p[0] }, e1{ (q[1][c] << 1) | p[1] };
+        for (int k{ 0 }; k < 16; ++k) {
+          palette[k][c] = static_cast<float>(((64 - BC7_WEIGHTS[k]) * e0 + BC7_WEIGHTS[k] * e1 + 32) >> 6);
+        }
+      }
+    };
+    auto const quantize = [&p](float const (&e)[2][4], Endpoints& q) {
+      for (int i{ 0 }; i < 2; ++i) {
+        for (int c{ 0 }; c < 4; ++c) {
+          q[i][c] = std::clamp(static_cast<int>(std::lround((std::clamp(e[i][c], 0.f, 255.f) - p[i]) / 2.f)), 0, 127);
+        }
+      }
+    };
+
+    float e[2][4];
+    axis_endpoints(block, 4, e);
+
+    float palette[16][4];
+    Endpoints q, candidate;
+    float error{ FLT_MAX };
+    int best_p[2]{ 0, 0 };
+    for (int bits{ 0 }; bits < 4; ++bits) {
+      p[0] = bits & 1;
+      p[1] = bits >> 1;
+      quantize(e, candidate);
+      make_palette(candidate, palette);
+      float const candidate_error{ fit(block, palette, 16, RGBA_WEIGHTS, nullptr) };
+      if (candidate_error < error) {
+        error = candidate_error;
+        std::memcpy(q, candidate, sizeof(q));
+        best_p[0] = p[0];
+        best_p[1] = p[1];
+      }
+    }
+    p[0] = best_p[0];
+    p[1] = best_p[1];
+
+    GLubyte idx[16];
+    make_palette(q, palette);
+    fit(block, palette, 16, RGBA_WEIGHTS, idx);
+    float fractions[16];
+    for (int k{ 0 }; k < 16; ++k) {
+      fractions[k] = BC7_WEIGHTS[k] / 64.f;
+    }
+    if (least_squares(block, 4, idx, fractions, e)) {
+      quantize(e, candidate);
+      make_palette(candidate, palette);
+      if (fit(block, palette, 16, RGBA_WEIGHTS, nullptr) < error) {
+        std::memcpy(q, candidate, sizeof(q));
+      }
+    }
+    refine(block, 4, max_q, 16, RGBA_WEIGHTS, make_palette, q);
+    make_palette(q, palette);
+    error = fit(block, palette, 16, RGBA_WEIGHTS, idx);
+
+    if (idx[0] >= 8) {
+      for (int c{ 0 }; c < 4; ++c) {
+        std::swap(q[0][c], q[1][c]);
+      }
+      std::swap(p[0], p[1]);
+      for (GLubyte& i : idx) {
+        i = static_cast<GLubyte>(15 - i);
+      }
+    }
+
+    std::memset(out, 0, 16);
+    BitWriter writer{ out };
+    writer.put(1u << 6, 7);
+    for (int c{ 0 }; c < 4; ++c) {
+      writer.put(static_cast<unsigned>(q[0][c]), 7);
+      writer.put(static_cast<unsigned>(q[1][c]), 7);
+    }
+    writer.put(static_cast<unsigned>(p[0]), 1);
+    writer.put(static_cast<unsigned>(p[1]), 1);
+    for (int i{ 0 }; i < 16; ++i) {
+      writer.put(idx[i], (i == 0) ? 3 : 4);
+    }
+    return error;
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! encode_mode5
+   * @brief Write the 16 byte BC7 mode 5 block of a block.
+   *
+   * RGB gets 7-bit endpoints and 2-bit indices, found as for BC1; alpha
+   * gets its own 8-bit endpoints, the smallest and largest alpha, and
+   * 2-bit indices. The first texel must get indices below 2, so each
+   * pair of endpoints is swapped and its indices mirrored if it does not.
+   *
+   * @return Squared error of the block.
+  */
+  float encode_mode5(Block const& block, GLubyte* out)
+  {
+    int const max_q[4]{ 127, 127, 127, 0 };
+    auto const make_palette = [](Endpoints const& q, float (*palette)[4]) {
+      for (int c{ 0 }; c < 3; ++c) {
+        int const e0{ (q[0][c] << 1) | (q[0][c] >> 6) }, e1{ (q[1][c] << 1) | (q[1][c] >> 6) };
+        for (int k{ 0 }; k < 4; ++k) {
+          palette[k][c] = static_cast<float>(((64 - BC7_WEIGHTS2[k]) * e0 + BC7_WEIGHTS2[k] * e1 + 32) >> 6);
+        }
+      }
+      for (int k{ 0 }; k < 4; ++k) {
+        palette[k][3] = 255.f;
+      }
+    };
+    auto const quantize = [](float const (&e)[2][4], Endpoints& q) {
+      for (int i{ 0 }; i < 2; ++i) {
+        for (int c{ 0 }; c < 3; ++c) {
+          q[i][c] = static_cast<int>(std::lround(std::clamp(e[i][c], 0.f, 255.f) * 127.f / 255.f));
+        }
+        q[i][3] = 0;
+      }
+    };
+
+    float e[2][4];
+    axis_endpoints(block, 3, e);
+    Endpoints q, refit;
+    quantize(e, q);
+
+    float palette[16][4];
+    GLubyte idx[16];
+    make_palette(q, palette);
+    float error{ fit(block, palette, 4, RGB_WEIGHTS, idx) };
+    float const fractions[4]{ 0.f, 21.f / 64.f, 43.f / 64.f, 1.f };
+    if (least_squares(block, 3, idx, fractions, e)) {
+      quantize(e, refit);
+      make_palette(refit, palette);
+      if (fit(block, palette, 4, RGB_WEIGHTS, nullptr) < error) {
+        std::memcpy(q, refit, sizeof(q));
+      }
+    }
+    refine(block, 3, max_q, 4, RGB_WEIGHTS, make_palette, q);
+    make_palette(q, palette);
+    error = fit(block, palette, 4, RGB_WEIGHTS, idx);
+
+    int a0{ static_cast<int>(*std::min_element(block.ch[3], block.ch[3] + 16)) };
+    int a1{ static_cast<int>(*std::max_element(block.ch[3], block.ch[3] + 16)) };
+    int values[4];
+    for (int k{ 0 }; k < 4; ++k) {
+      values[k] = ((64 - BC7_WEIGHTS2[k]) * a0 + BC7_WEIGHTS2[k] * a1 + 32) >> 6;
+    }
+    GLubyte alpha_idx[16];
+    for (int i{ 0 }; i < 16; ++i) {
+      int const a{ static_cast<int>(block.ch[3][i]) };
+      int best_k{ 0 };
+      for (int k{ 1 }; k < 4; ++k) {
+        best_k = (std::abs(values[k] - a) < std::abs(values[best_k] - a)) ? k : best_k;
+      }
+      alpha_idx[i] = static_cast<GLubyte>(best_k);
+      error += static_cast<float>((values[best_k] - a) * (values[best_k] - a));
+    }
+
+    if (idx[0] >= 2) {
+      for (int c{ 0 }; c < 3; ++c) {
+        std::swap(q[0][c], q[1][c]);
+      }
+      for (GLubyte& i : idx) {
+        i = static_cast<GLubyte>(3 - i);
+      }
+    }
+    if (alpha_idx[0] >= 2) {
+      std::swap(a0, a1);
+      for (GLubyte& i : alpha_idx) {
+        i = static_cast<GLubyte>(3 - i);
+      }
+    }
+
+    std::memset(out, 0, 16);
+    BitWriter writer{ out };
+    writer.put(1u << 5, 6);
+    writer.put(0, 2); // no channel rotation
+    for (int c{ 0 }; c < 3; ++c) {
+      writer.put(static_cast<unsigned>(q[0][c]), 7);
+      writer.put(static_cast<unsigned>(q[1][c]), 7);
+    }
+    writer.put(static_cast<unsigned>(a0), 8);
+    writer.put(static_cast<unsigned>(a1), 8);
+    for (int i{ 0 }; i < 16; ++i) {
+      writer.put(idx[i], (i == 0) ? 1 : 2);
+    }
+    for (int i{ 0 }; i < 16; ++i) {
+      writer.put(alpha_idx[i], (i == 0) ? 1 : 2);
+    }
+    return error;
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! encode_bc7
+   * @brief Write the 16 byte BC7 block of a block.
+   *
+   * Mode 6 interpolates RGBA along one line, which suits blocks whose
+   * alpha follows their color; mode 5 keeps alpha apart, which suits
+   * cut-out edges. The mode with the lower error is written.
+  */
+  void encode_bc7(Block const& block, GLubyte* out)
+  {
+    GLubyte mode5[16];
+    float const error6{ encode_mode6(block, out) };
+    if (encode_mode5(block, mode5) < error6) {
+      std::memcpy(out, mode5, sizeof(mode5));
+    }
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! decode_color
+   * @brief Decode the RGB of a BC1 block to 16 texels.
+   *
+   * A BC1 block whose first endpoint is not larger has 3 colors and
+   * transparent black; a BC3 color block always has 4 colors.
+  */
+  void decode_color(GLubyte const* in, bool bc3, GLubyte (*texels)[4])
+  {
+    GLuint const c0{ static_cast<GLuint>(in[0] | (in[1] << 8)) }, c1{ static_cast<GLuint>(in[2] | (in[3] << 8)) };
+    int const q0[3]{ static_cast<int>(c0 >> 11), static_cast<int>((c0 >> 5) & 63), static_cast<int>(c0 & 31) };
+    int const q1[3]{ static_cast<int>(c1 >> 11), static_cast<int>((c1 >> 5) & 63), static_cast<int>(c1 & 31) };
+    int colors[4][4];
+    for (int c{ 0 }; c < 3; ++c) {
+      int const e0{ expand565(q0[c], c) }, e1{ expand565(q1[c], c) };
+      colors[0][c] = e0;
+      colors[1][c] = e1;
+      if (bc3 || c0 > c1) {
+        colors[2][c] = (2 * e0 + e1 + 1) / 3;
+        colors[3][c] = (e0 + 2 * e1 + 1) / 3;
+      } else {
+        colors[2][c] = (e0 + e1 + 1) / 2;
+        colors[3][c] = 0;
+      }
+    }
+    colors[0][3] = colors[1][3] = colors[2][3] = 255;
+    colors[3][3] = (bc3 || c0 > c1) ? 255 : 0;
+
+    GLuint const bits{ static_cast<GLuint>(in[4] | (in[5] << 8) | (in[6] << 16)) | (static_cast<GLuint>(in[7]) << 24) };
+    for (int i{ 0 }; i < 16; ++i) {
+      int const* color{ colors[(bits >> (2 * i)) & 3] };
+      for (int c{ 0 }; c < 4; ++c) {
+        texels[i][c] = static_cast<GLubyte>(color[c]);
+      }
+    }
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! decode_alpha
+   * @brief Decode a BC3 alpha block into the alpha of 16 texels.
+  */
+  void decode_alpha(GLubyte const* in, GLubyte (*texels)[4])
+  {
+    int const a0{ in[0] }, a1{ in[1] };
+    int values[8]{ a0, a1 };
+    if (a0 > a1) {
+      for (int k{ 2 }; k < 8; ++k) {
+        values[k] = ((8 - k) * a0 + (k - 1) * a1 + 3) / 7;
+      }
+    } else {
+      for (int k{ 2 }; k < 6; ++k) {
+        values[k] = ((6 - k) * a0 + (k - 1) * a1 + 2) / 5;
+      }
+      values[6] = 0;
+      values[7] = 255;
+    }
+    std::uint64_t bits{ 0 };
+    for (int b{ 0 }; b < 6; ++b) {
+      bits |= static_cast<std::uint64_t>(in[2 + b]) << (8 * b);
+    }
+    for (int i{ 0 }; i < 16; ++i) {
+      texels[i][3] = static_cast<GLubyte>(values[(bits >> (3 * i)) & 7]);
+    }
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! decode_bc7
+   * @brief Decode a BC7 mode 5 or mode 6 block to 16 texels.
+   *
+   * Blocks of the other modes, which compress never writes, decode to
+   * transparent black.
+  */
+  void decode_bc7(GLubyte const* in, GLubyte (*texels)[4])
+  {
+    BitReader reader{ in };
+    if ((in[0] & 0x3F) == 0x20) {
+      reader.get(6);
+      unsigned const rotation{ reader.get(2) };
+      int q[2][4];
+      for (int c{ 0 }; c < 3; ++c) {
+        q[0][c] = static_cast<int>(reader.get(7));
+        q[1][c] = static_cast<int>(reader.get(7));
+      }
+      q[0][3] = static_cast<int>(reader.get(8));
+      q[1][3] = static_cast<int>(reader.get(8));
+      for (int i{ 0 }; i < 16; ++i) {
+        int const w{ BC7_WEIGHTS2[reader.get((i == 0) ? 1 : 2)] };
+        for (int c{ 0 }; c < 3; ++c) {
+          int const e0{ (q[0][c] << 1) | (q[0][c] >> 6) }, e1{ (q[1][c] << 1) | (q[1][c] >> 6) };
+          texels[i][c] = static_cast<GLubyte>(((64 - w) * e0 + w * e1 + 32) >> 6);
+        }
+      }
+      for (int i{ 0 }; i < 16; ++i) {
+        int const w{ BC7_WEIGHTS2[reader.get((i == 0) ? 1 : 2)] };
+        texels[i][3] = static_cast<GLubyte>(((64 - w) * q[0][3] + w * q[1][3] + 32) >> 6);
+        if (rotation > 0) {
+          std::swap(texels[i][3], texels[i][rotation - 1]);
+        }
+      }
+      return;
+    }
+    if ((in[0] & 0x7F) != 0x40) {
+      std::memset(texels, 0, 16 * 4);
+      return;
+    }
+
+    reader.get(7);
+    int q[2][4];
+    for (int c{ 0 }; c < 4; ++c) {
+      q[0][c] = static_cast<int>(reader.get(7));
+      q[1][c] = static_cast<int>(reader.get(7));
+    }
+    int const p0{ static_cast<int>(reader.get(1)) }, p1{ static_cast<int>(reader.get(1)) };
+    for (int i{ 0 }; i < 16; ++i) {
+      int const w{ BC7_WEIGHTS[reader.get((i == 0) ? 3 : 4)] };
+      for (int c{ 0 }; c < 4; ++c) {
+        int const e0{ (q[0][c] << 1) | p0 }, e1{ (q[1][c] << 1) | p1 };
+        texels[i][c] = static_cast<GLubyte>(((64 - w) * e0 + w * e1 + 32) >> 6);
+      }
+    }
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! TexBC::internal_format
+ * @brief Get the internal format of textures holding blocks of a format.
+ *
+ * @param format[in] Block format.
+ * @return GL_COMPRESSED_RGB_S3TC_DXT1_EXT, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+ * or GL_COMPRESSED_RGBA_BPTC_UNORM.
+*/
+GLenum TexBC::internal_format(Format format)
+{
+  switch (format) {
+  case Format::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+  case Format::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+  default:          return GL_COMPRESSED_RGBA_BPTC_UNORM;
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! TexBC::block_bytes
+ * @brief Get the size of a block of an internal format.
+ *
+ * @param internal_format[in] Internal format of a texture.
+ * @return 8 for BC1, 16 for BC3 and BC7, 0 for other formats.
+*/
+GLsizeiptr TexBC::block_bytes(GLenum internal_format)
+{
+  switch (internal_format) {
+  case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:  return 8;
+  case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT: return 16;
+  case GL_COMPRESSED_RGBA_BPTC_UNORM:    return 16;
+  default:                               return 0;
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! TexBC::level_offset
+ * @brief Find where a level starts in a chain of blocks.
+ *
+ * @param internal_format[in] Internal format of the blocks.
+ * @param width[in] Width of the image in texels.
+ * @param height[in] Height of the image in texels.
+ * @param level[in] Level; the bytes of the whole chain if it is the level count.
+ * @return Bytes of the blocks of the levels before level.
+*/
+GLsizeiptr TexBC::level_offset(GLenum internal_format, GLuint width, GLuint height, GLuint level)
+{
+  GLsizeiptr offset{ 0 };
+  for (GLuint l{ 0 }; l < level; ++l) {
+    GLsizeiptr const blocks_x{ (TexMip::level_size(width, l) + 3) / 4 };
+    GLsizeiptr const blocks_y{ (TexMip::level_size(height, l) + 3) / 4 };
+    offset += blocks_x * blocks_y * block_bytes(internal_format);
+  }
+  return offset;
+}
+
+/*  _________________________________________________________________________ */
+/*! TexBC::compress
+ * @brief Compress an RGBA8 image to blocks.
+ *
+ * Blocks are encoded in jobs of grain blocks on the threads of JobSystem.
+ * Each block depends on its own texels only, so the output is the same
+ * for any thread count.
+ *
+ * @param rgba[in] width * height RGBA8 texels, row by row.
+ * @param width[in] Width of the image in texels.
+ * @param height[in] Height of the image in texels.
+ * @param format[in] Block format.
+ * @param blocks[out] Receives the blocks, row by row.
+ * @return void
+*/
+void TexBC::compress(GLubyte const* rgba, GLuint width, GLuint height, Format format,
+                     GLubyte* blocks)
+{
+  GLuint const blocks_x{ (width + 3) / 4 }, blocks_y{ (height + 3) / 4 };
+  size_t const bytes{ static_cast<size_t>(block_bytes(internal_format(format))) };
+
+  JobSystem::parallel_for(static_cast<size_t>(blocks_x) * blocks_y, grain,
+                          [=](size_t first, size_t last) {
+    Block block;
+    for (size_t i{ first }; i < last; ++i) {
+      gather(rgba, width, height, static_cast<GLuint>(i % blocks_x), static_cast<GLuint>(i / blocks_x), block);
+      GLubyte* const out{ blocks + i * bytes };
+      switch (format) {
+      case Format::BC1:
+        encode_color(block, out);
+        break;
+      case Format::BC3:
+        encode_alpha(block, out);
+        encode_color(block, out + 8);
+        break;
+      default:
+        encode_bc7(block, out);
+        break;
+      }
+    }
+  });
+}
+
+/*  _________________________________________________________________________ */
+/*! TexBC::decompress
+ * @brief Decompress blocks to an RGBA8 image.
+ *
+ * @param blocks[in] Blocks written by compress.
+ * @param width[in] Width of the image in texels.
+ * @param height[in] Height of the image in texels.
+ * @param format[in] Block format.
+ * @param rgba[out] Receives width * height RGBA8 texels, row by row.
+ * @return void
+*/
+void TexBC::decompress(GLubyte const* blocks, GLuint width, GLuint height, Format format,
+                       GLubyte* rgba)
+{
+  GLuint const blocks_x{ (width + 3) / 4 }, blocks_y{ (height + 3) / 4 };
+  size_t const bytes{ static_cast<size_t>(block_bytes(internal_format(format))) };
+  GLubyte texels[16][4];
+
+  for (GLuint by{ 0 }; by < blocks_y; ++by) {
+    for (GLuint bx{ 0 }; bx < blocks_x; ++bx) {
+      GLubyte const* const in{ blocks + (static_cast<size_t>(by) * blocks_x + bx) * bytes };
+      switch (format) {
+      case Format::BC1:
+        decode_color(in, false, texels);
+        break;
+      case Format::BC3:
+        decode_color(in + 8, true, texels);
+        decode_alpha(in, texels);
+        break;
+      default:
+        decode_bc7(in, texels);
+        break;
+      }
+      for (GLuint i{ 0 }; i < 16; ++i) {
+        GLuint const x{ 4 * bx + i % 4 }, y{ 4 * by + i / 4 };
+        if (x < width && y < height) {
+          std::memcpy(rgba + 4 * (static_cast<size_t>(y) * width + x), texels[i], 4);
+        }
+      }
+    }
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! TexBC::convert
+ * @brief Write the compressed mipmap chain of a .tex file to a .tex file.
+ *
+ * The chain is filtered with TexMip::Filter::KAISER, as this runs offline.
+ *
+ * @param src[in] Path of the .tex file read with TexLoader::read.
+ * @param dst[in] Path of the file written.
+ * @param format[in] Block format.
+ * @param error[out] Why a file could not be read or written.
+ * @return false if src cannot be read or dst cannot be written.
+*/
+bool TexBC::convert(std::string const& src, std::string const& dst, Format format,
+                    std::string& error)
+{
+  GLuint width, height;
+  std::vector<GLubyte> rgba;
+  if (!TexLoader::read(src, width, height, rgba, error)) {
+    return false;
+  }
+
+  Header const header{ { BC_MAGIC[0], BC_MAGIC[1], BC_MAGIC[2], BC_MAGIC[3] },
+                       width, height, TexMip::level_count(width, height), internal_format(format) };
+  std::vector<GLubyte> chain(static_cast<size_t>(TexMip::level_offset(width, height, header.levels)));
+  TexMip::build(rgba.data(), width, height, header.levels, TexMip::Filter::KAISER, chain.data());
+
+  std::vector<GLubyte> blocks(static_cast<size_t>(level_offset(header.internal_format, width, height, header.levels)));
+  for (GLuint l{ 0 }; l < header.levels; ++l) {
+    compress(chain.data() + TexMip::level_offset(width, height, l),
+             TexMip::level_size(width, l), TexMip::level_size(height, l), format,
+             blocks.data() + level_offset(header.internal_format, width, height, l));
+  }
+
+  std::ofstream ofs{ dst, std::ios::binary };
+  ofs.write(reinterpret_cast<char const*>(&header), sizeof(header));
+  ofs.write(reinterpret_cast<char const*>(blocks.data()), static_cast<std::streamsize>(blocks.size()));
+  if (!ofs) {
+    error = "Unable to write texture file " + dst;
+    return false;
+  }
+  return true;
+}
+
+/*  _________________________________________________________________________ */
+/*! TexBC::benchmark
+ * @brief Print how fast and how well each format compresses images.
+ *
+ * For each image and format the table shows:
+ * - 1 thread, N threads: texels of the image compressed per second on one
+ *   thread and on every thread of JobSystem.
+ * - PSNR RGB, PSNR A: peak signal to noise ratio of the decompressed
+ *   image to the original, in dB; inf if they are equal.
+ * - VRAM: bytes of a texture of the compressed mipmap chain, as reported
+ *   by the driver, against the bytes of the RGBA8 chain.
+ *
+ * @param pathnames[in] Paths of the .tex files.
+ * @return void
+*/
+void TexBC::benchmark(std::vector<std::string> const& pathnames)
+{
+  int const runs{ 3 };
+  unsigned const threads{ std::max(JobSystem::get_thread_count(), 1u) };
+  char const* const names[3]{ "BC1", "BC3", "BC7" };
+
+  std::cout << "Image\t\t\t|\tFormat\t|\t1 thread (MTexel/s)\t|\t" << threads << " threads (MTexel/s)\t|\t"
+            << "PSNR RGB (dB)\t|\tPSNR A (dB)\t|\tVRAM (KB)\t|\tRGBA8 VRAM (KB)\n";
+  std::cout << "------------------------------------------------------------------------------------------------------------------------------------------------------------\n";
+  for (std::string const& pathname : pathnames) {
+    GLuint width, height;
+    std::vector<GLubyte> rgba;
+    std::string error;
+    if (!TexLoader::read(pathname, width, height, rgba, error)) {
+      std::cout << error << "\n";
+      continue;
+    }
+    GLuint const levels{ TexMip::level_count(width, height) };
+    std::vector<GLubyte> chain(static_cast<size_t>(TexMip::level_offset(width, height, levels)));
+    TexMip::build(rgba.data(), width, height, levels, TexMip::Filter::BOX, chain.data());
+
+    for (Format format : { Format::BC1, Format::BC3, Format::BC7 }) {
+      GLenum const gl_format{ internal_format(format) };
+      std::vector<GLubyte> blocks(static_cast<size_t>(level_offset(gl_format, width, height, levels)));
+      auto const mtexels_per_s = [&](unsigned thread_cnt) {
+        JobSystem::set_thread_count(thread_cnt);
+        auto const start{ std::chrono::steady_clock::now() };
+        for (int r{ 0 }; r < runs; ++r) {
+          compress(rgba.data(), width, height, format, blocks.data());
+        }
+        double const s{ std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() };
+        return static_cast<double>(width) * height * runs / s / 1e6;
+      };
+      double const single{ mtexels_per_s(1) };
+      double const multi{ mtexels_per_s(threads) };
+
+      std::vector<GLubyte> decoded(rgba.size());
+      decompress(blocks.data(), width, height, format, decoded.data());
+      double rgb_se{ 0.0 }, alpha_se{ 0.0 };
+      for (size_t i{ 0 }; i < rgba.size(); ++i) {
+        double const d{ static_cast<double>(decoded[i]) - rgba[i] };
+        ((i % 4 == 3) ? alpha_se : rgb_se) += d * d;
+      }
+      double const texel_cnt{ static_cast<double>(width) * height };
+      auto const psnr = [](double mse) { return 10.0 * std::log10(255.0 * 255.0 / mse); };
+
+      // the other levels are compressed from the box chain for the texture
+      for (GLuint l{ 1 }; l < levels; ++l) {
+        compress(chain.data() + TexMip::level_offset(width, height, l),
+                 TexMip::level_size(width, l), TexMip::level_size(height, l), format,
+                 blocks.data() + level_offset(gl_format, width, height, l));
+      }
+      GLuint texobj;
+      glCreateTextures(GL_TEXTURE_2D, 1, &texobj);
+      glTextureStorage2D(texobj, static_cast<GLsizei>(levels), gl_format, width, height);
+      GLint vram{ 0 };
+      for (GLuint l{ 0 }; l < levels; ++l) {
+        GLsizeiptr const offset{ level_offset(gl_format, width, height, l) };
+        glCompressedTextureSubImage2D(texobj, static_cast<GLint>(l), 0, 0,
+                                      TexMip::level_size(width, l), TexMip::level_size(height, l), gl_format,
+                                      static_cast<GLsizei>(level_offset(gl_format, width, height, l + 1) - offset),
+                                      blocks.data() + offset);
+        GLint level_bytes{ 0 };
+        glGetTextureLevelParameteriv(texobj, static_cast<GLint>(l), GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &level_bytes);
+        vram += level_bytes;
+      }
+      glDeleteTextures(1, &texobj);
+
+      std::cout << pathname << "\t|\t" << names[static_cast<int>(format)] << "\t|\t"
+                << std::setprecision(3) << std::fixed << single << "\t\t\t|\t" << multi << "\t\t\t|\t"
+                << psnr(rgb_se / (3.0 * texel_cnt)) << "\t\t|\t" << psnr(alpha_se / texel_cnt) << "\t\t|\t"
+                << vram / 1024.0 << "\t\t|\t" << TexMip::level_offset(width, height, levels) / 1024.0
+                << std::defaultfloat << "\n";
+    }
+  }
+  std::cout << "------------------------------------------------------------------------------------------------------------------------------------------------------------\n";
+}
@@ -0,0 +1,730 @@
+/*!
+* @file    texloader.cpp
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/21/2023
+*
+* @brief This file implements the asynchronous texture loader declared in
+*		 texloader.h. The staging buffer is used as a ring: workers take
+*		 regions from its head and update retires them from its tail once
+*		 their fences signal, so the workers only ever touch mapped memory
+*		 and every OpenGL call is made on the thread owning the context. A
+*		 worker finding the ring full waits until update frees space.
+*//*__________________________________________________________________________*/
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <texloader.h>
+#include <texmip.h>
+#include <texbc.h>
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*                                                   objects with file scope
+----------------------------------------------------------------------------- */
+namespace {
+  char const MAGIC[4]{ 'T', 'E', 'X', '1' };
+  char const MIP_MAGIC[4]{ 'T', 'E', 'X', 'M' };
+  char const BC_MAGIC[4]{ 'T', 'E', 'X', 'B' };
+
+  // staging regions start on multiples of this many bytes
+  GLsizeiptr const STAGING_ALIGNMENT{ 16 };
+
+  struct Job {
+    std::string pathname;
+    TexLoader::State state{ TexLoader::State::QUEUED };
+    std::string error;            // reported by update if the job failed
+    bool mipmaps{ true };         // build a chain if the file has none
+    bool released{ false };       // released while a worker or the GPU used it
+    GLuint width{ 0 }, height{ 0 };
+    GLuint levels{ 1 };
+    GLenum format{ GL_RGBA8 };    // or a block format of TexBC
+    GLsizeiptr size{ 0 };         // bytes of the texels or blocks of every level
+    GLintptr offset{ -1 };        // of the texels in the staging buffer, or -1
+    std::vector<GLubyte> texels;  // texels of images too large to stage
+    GLuint texobj{ 0 };
+    GLsync fence{ nullptr };
+  };
+
+  // region of the staging buffer, in the order it was taken
+  struct Region {
+    GLintptr offset;
+    GLsizeiptr size;
+    bool done;
+  };
+
+  // guards jobs, free_handles, queue, regions, head and stopping
+  std::mutex mutex;
+  std::condition_variable work_cv;  // a job was queued or the workers stop
+  std::condition_variable space_cv; // staging space was freed or the workers stop
+
+  std::deque<Job> jobs;             // indexed by handle; a deque keeps them in place
+  std::vector<TexLoader::Handle> free_handles; // released handles request reuses
+  std::deque<TexLoader::Handle> queue;
+  std::vector<std::thread> workers;
+  bool stopping{ false };
+
+  GLuint staging_buffer{ 0 };
+  GLubyte* staging_ptr{ nullptr };
+  std::deque<Region> regions;
+  GLintptr head{ 0 };
+
+  GLuint placeholder{ 0 };
+
+  /*  _______________________________________________________________________ */
+  /*! level_offset
+   * @brief Find where a level of a job starts in its texels or blocks.
+  */
+  GLsizeiptr level_offset(Job const& job, GLuint level)
+  {
+    return (job.format == GL_RGBA8) ? TexMip::level_offset(job.width, job.height, level)
+                                    : TexBC::level_offset(job.format, job.width, job.height, level);
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! stage
+   * @brief Take size bytes at the head of the staging ring.
+   *
+   * The mutex must be held.
+   *
+   * @param size[in] Bytes to take.
+   * @return Offset of the region; -1 if the ring has no room for it now.
+  */
+  GLintptr stage(GLsizeiptr size)
+  {
+    size = (size + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+    if (regions.empty()) {
+      head = 0;
+    }
+    GLintptr const tail{ regions.empty() ? 0 : regions.front().offset };
+
+    GLintptr offset{ -1 };
+    if (regions.empty() || head > tail) {
+      // the free space is [head, end) and [0, tail); head never catches up
+      // with tail so that a full ring is told apart from an empty one
+      if (head + size <= TexLoader::staging_size) {
+        offset = head;
+      } else if (size < tail) {
+        offset = 0;
+      }
+    } else if (head + size < tail) {
+      offset = head;
+    }
+
+    if (offset >= 0) {
+      regions.push_back(Region{ offset, size, false });
+      head = offset + size;
+    }
+    return offset;
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! unstage
+   * @brief Free the staging region at offset and retire the regions at the
+   * tail of the ring that are free.
+   *
+   * The mutex must be held.
+  */
+  void unstage(GLintptr offset)
+  {
+    for (Region& region : regions) {
+      if (region.offset == offset && !region.done) {
+        region.done = true;
+        break;
+      }
+    }
+    while (!regions.empty() && regions.front().done) {
+      regions.pop_front();
+    }
+    space_cv.notify_all();
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! recycle
+   * @brief Reset the job of a released handle and let request reuse it.
+   *
+   * The mutex must be held, and neither a worker nor the GPU may use the
+   * job any more; its texture object and staging region are already freed.
+  */
+  void recycle(TexLoader::Handle h)
+  {
+    jobs[h] = Job{};
+    jobs[h].state = TexLoader::State::RELEASED;
+    free_handles.push_back(h);
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! take
+   * @brief Get the memory the texels of a job are written to.
+   *
+   * Waits for job.size bytes of the staging buffer unless the job can
+   * never fit in it, in which case job.texels is sized to hold them.
+   *
+   * @param job[in,out] Job whose size is set.
+   * @return Where to write the texels; nullptr if the workers stop.
+  */
+  GLubyte* take(Job& job)
+  {
+    if (job.size > TexLoader::staging_size) {
+      job.texels.resize(static_cast<size_t>(job.size));
+      return job.texels.data();
+    }
+    std::unique_lock<std::mutex> lock{ mutex };
+    space_cv.wait(lock, [&job] { return stopping || (job.offset = stage(job.size)) >= 0; });
+    return stopping ? nullptr : staging_ptr + job.offset;
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! decode
+   * @brief Load the texels of every level of a job.
+   *
+   * The levels of a mip-chained or block-compressed file are read straight
+   * to their staging region. Other files are read to RGBA8 with
+   * TexLoader::read, and the chain TexMip::build filters from it, or the
+   * image alone if the job has no mipmaps, is written to the staging
+   * region. Runs on a worker thread without the mutex, except while taking
+   * staging space.
+   *
+   * @param job[in,out] Job of the file; its state is left to the caller.
+   * @return true if the texels are in the staging buffer or job.texels.
+  */
+  bool decode(Job& job)
+  {
+    std::ifstream ifs{ job.pathname, std::ios::binary | std::ios::ate };
+    if (!ifs) {
+      job.error = "Unable to open texture file " + job.pathname;
+      return false;
+    }
+    std::streamoff const file_size{ ifs.tellg() };
+    ifs.seekg(0);
+
+    char magic[4]{};
+    ifs.read(magic, sizeof(magic));
+    ifs.clear();
+    ifs.seekg(0);
+
+    if (std::memcmp(magic, MIP_MAGIC, sizeof(MIP_MAGIC)) == 0) {
+      TexMip::Header header{};
+      if (!ifs.read(reinterpret_cast<char*>(&header), sizeof(header))
+          || header.width == 0 || header.height == 0 || header.levels == 0
+          || header.levels > TexMip::level_count(header.width, header.height)) {
+        job.error = "Texture file " + job.pathname + " has a malformed header";
+        return false;
+      }
+      job.width = header.width;
+      job.height = header.height;
+      job.levels = header.levels;
+    } else if (std::memcmp(magic, BC_MAGIC, sizeof(BC_MAGIC)) == 0) {
+      TexBC::Header header{};
+      if (!ifs.read(reinterpret_cast<char*>(&header), sizeof(header))
+          || header.width == 0 || header.height == 0 || header.levels == 0
+          || header.levels > TexMip::level_count(header.width, header.height)
+          || TexBC::block_bytes(header.internal_format) == 0) {
+        job.error = "Texture file " + job.pathname + " has a malformed header";
+        return false;
+      }
+      job.width = header.width;
+      job.height = header.height;
+      job.levels = header.levels;
+      job.format = header.internal_format;
+    }
+
+    // mip-chained and block-compressed files are stored as uploaded
+    if (job.width > 0) {
+      job.size = level_offset(job, job.levels);
+      if (file_size - static_cast<std::streamoff>(ifs.tellg()) < job.size) {
+        job.error = "Texture file " + job.pathname + " is truncated";
+        return false;
+      }
+
+      GLubyte* const dst{ take(job) };
+      if (dst == nullptr) {
+        return false;
+      }
+      if (!ifs.read(reinterpret_cast<char*>(dst), job.size)) {
+        job.error = "Unable to read texture file " + job.pathname;
+        if (job.offset >= 0) {
+          std::lock_guard<std::mutex> lock{ mutex };
+          unstage(job.offset);
+          job.offset = -1;
+        }
+        job.texels.clear();
+        return false;
+      }
+      return true;
+    }
+    ifs.close();
+
+    std::vector<GLubyte> rgba;
+    if (!TexLoader::read(job.pathname, job.width, job.height, rgba, job.error)) {
+      return false;
+    }
+    job.levels = job.mipmaps ? TexMip::level_count(job.width, job.height) : 1;
+    job.size = TexMip::level_offset(job.width, job.height, job.levels);
+
+    GLubyte* const dst{ take(job) };
+    if (dst == nullptr) {
+      return false;
+    }
+    if (job.levels > 1) {
+      TexMip::build(rgba.data(), job.width, job.height, job.levels, TexLoader::mip_filter, dst);
+    } else {
+      std::memcpy(dst, rgba.data(), rgba.size());
+    }
+    return true;
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! work
+   * @brief Decode queued jobs until the workers stop.
+  */
+  void work()
+  {
+    std::unique_lock<std::mutex> lock{ mutex };
+    for (;;) {
+      work_cv.wait(lock, [] { return stopping || !queue.empty(); });
+      if (stopping) {
+        return;
+      }
+      TexLoader::Handle const h{ queue.front() };
+      Job& job{ jobs[h] };
+      queue.pop_front();
+
+      // no other thread touches a queued job
+      lock.unlock();
+      bool const decoded{ decode(job) };
+      lock.lock();
+      if (job.released) {
+        if (job.offset >= 0) {
+          unstage(job.offset);
+        }
+        recycle(h);
+      } else if (!stopping || decoded) {
+        job.state = decoded ? TexLoader::State::DECODED : TexLoader::State::FAILED;
+      }
+    }
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! TexLoader::init
+ * @brief Create the placeholder and staging buffer and start the workers.
+ *
+ * The placeholder is an 8 x 8 gray and magenta checkerboard. The staging
+ * buffer is mapped for writing for as long as it exists; its mapping is
+ * coherent, so texels written by the workers are visible to uploads
+ * issued after they finish.
+ *
+ * @param thread_cnt[in] Number of worker threads; at least 1.
+ * @return void
+*/
+void TexLoader::init(unsigned thread_cnt)
+{
+  GLubyte checker[8 * 8 * 4];
+  for (int i{ 0 }; i < 8 * 8; ++i) {
+    bool const odd{ ((i % 8) / 2 + (i / 8) / 2) % 2 == 1 };
+    checker[4 * i + 0] = odd ? 0xFF : 0x80;
+    checker[4 * i + 1] = odd ? 0x00 : 0x80;
+    checker[4 * i + 2] = odd ? 0xFF : 0x80;
+    checker[4 * i + 3] = 0xFF;
+  }
+  glCreateTextures(GL_TEXTURE_2D, 1, &placeholder);
+  glTextureStorage2D(placeholder, 1, GL_RGBA8, 8, 8);
+  glTextureSubImage2D(placeholder, 0, 0, 0, 8, 8, GL_RGBA, GL_UNSIGNED_BYTE, checker);
+
+  GLbitfield const flags{ GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT };
+  glCreateBuffers(1, &staging_buffer);
+  glNamedBufferStorage(staging_buffer, staging_size, nullptr, flags);
+  staging_ptr = static_cast<GLubyte*>(glMapNamedBufferRange(staging_buffer, 0, staging_size, flags));
+
+  stopping = false;
+  for (unsigned i{ 0 }; i < std::max(thread_cnt, 1u); ++i) {
+    workers.emplace_back(work);
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! TexLoader::cleanup
+ * @brief Stop the workers and delete every texture object, fence and buffer.
+ *
+ * Handles are invalid afterwards.
+ *
+ * @param none
+ * @return void
+*/
+void TexLoader::cleanup()
+{
+  {
+    std::lock_guard<std::mutex> lock{ mutex };
+    stopping = true;
+  }
+  work_cv.notify_all();
+  space_cv.notify_all();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  workers.clear();
+
+  for (Job& job : jobs) {
+    if (job.fence != nullptr) {
+      glDeleteSync(job.fence);
+    }
+    glDeleteTextures(1, &job.texobj);
+  }
+  jobs.clear();
+  free_handles.clear();
+  queue.clear();
+  regions.clear();
+  head = 0;
+
+  glUnmapNamedBuffer(staging_buffer);
+  glDeleteBuffers(1, &staging_buffer);
+  staging_buffer = 0;
+  staging_ptr = nullptr;
+  glDeleteTextures(1, &placeholder);
+  placeholder = 0;
+}
+
+/*  _________________________________________________________________________ */
+/*! TexLoader::request
+ * @brief Queue a texture file for loading.
+ *
+ * The handle of a released texture is reused if there is one.
+ *
+ * @param pathname[in] Path of the .tex file.
+ * @param mipmaps[in] Build a mipmap chain with mip_filter if the file has none.
+ * @return Handle of the texture; texture returns the placeholder for it
+ * until it is resident.
+*/
+TexLoader::Handle TexLoader::request(std::string const& pathname, GLboolean mipmaps)
+{
+  Handle h;
+  {
+    std::lock_guard<std::mutex> lock{ mutex };
+    if (free_handles.empty()) {
+      h = static_cast<Handle>(jobs.size());
+      jobs.emplace_back();
+    } else {
+      h = free_handles.back();
+      free_handles.pop_back();
+      jobs[h] = Job{};
+    }
+    jobs[h].pathname = pathname;
+    jobs[h].mipmaps = (mipmaps == GL_TRUE);
+    queue.push_back(h);
+  }
+  work_cv.notify_one();
+  return h;
+}
+
+/*  _________________________________________________________________________ */
+/*! TexLoader::release
+ * @brief Delete the texture of a handle or cancel its loading.
+ *
+ * A queued job is taken off the queue and a decoded one frees its staging
+ * region. A job a worker is decoding, or whose upload has not signaled its
+ * fence, is only marked: the worker or update frees it once it is done
+ * with it. Must be called on the thread owning the OpenGL context.
+ *
+ * @param h[in] Handle returned by request.
+ * @return void
+*/
+void TexLoader::release(Handle h)
+{
+  std::lock_guard<std::mutex> lock{ mutex };
+  if (h >= jobs.size()) {
+    return;
+  }
+
+  Job& job{ jobs[h] };
+  switch (job.state) {
+  case State::QUEUED: {
+    auto const it{ std::find(queue.begin(), queue.end(), h) };
+    if (it == queue.end()) {
+      job.released = true;
+      return;
+    }
+    queue.erase(it);
+    break;
+  }
+
+  case State::DECODED:
+    if (job.offset >= 0) {
+      unstage(job.offset);
+    }
+    break;
+
+  case State::UPLOADING:
+    job.released = true;
+    return;
+
+  case State::RESIDENT:
+    glDeleteTextures(1, &job.texobj);
+    break;
+
+  case State::RELEASED:
+    return;
+
+  default:
+    break;
+  }
+  recycle(h);
+}
+
+/*  _________________________________________________________________________ */
+/*! TexLoader::update
+ * @brief Advance the jobs decoded or uploading.
+ *
+ * Decoded images are copied to new RGBA8 or block-compressed texture
+ * objects, every level at once from the staging buffer bound as
+ * GL_PIXEL_UNPACK_BUFFER, until upload_budget bytes were started; the rest
+ * wait for the next call. Textures with mipmaps are minified with
+ * GL_LINEAR_MIPMAP_LINEAR. An upload whose fence has signaled frees its
+ * staging region and makes its texture resident, or deletes it if the
+ * handle was released meanwhile.
+ * Failures are printed once. Must be called on the thread owning the
+ * OpenGL context.
+ *
+ * @param none
+ * @return void
+*/
+void TexLoader::update()
+{
+  std::lock_guard<std::mutex> lock{ mutex };
+  GLsizeiptr uploaded{ 0 };
+
+  for (Handle h{ 0 }; h < jobs.size(); ++h) {
+    Job& job{ jobs[h] };
+    switch (job.state) {
+    case State::DECODED: {
+      if (uploaded > 0 && uploaded + job.size > upload_budget) {
+        break;
+      }
+      uploaded += job.size;
+      glCreateTextures(GL_TEXTURE_2D, 1, &job.texobj);
+      glTextureStorage2D(job.texobj, static_cast<GLsizei>(job.levels), job.format, job.width, job.height);
+      if (job.levels > 1) {
+        glTextureParameteri(job.texobj, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+      }
+
+      // every level is copied from the one staging region or, if the
+      // image is too large to stage, from client memory before returning
+      bool const staged{ job.offset >= 0 };
+      if (staged) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging_buffer);
+      }
+      for (GLuint level{ 0 }; level < job.levels; ++level) {
+        GLsizeiptr const offset{ level_offset(job, level) };
+        GLvoid const* const data{ staged ? reinterpret_cast<GLvoid const*>(job.offset + offset)
+                                         : static_cast<GLvoid const*>(job.texels.data() + offset) };
+        GLsizei const width{ static_cast<GLsizei>(TexMip::level_size(job.width, level)) };
+        GLsizei const height{ static_cast<GLsizei>(TexMip::level_size(job.height, level)) };
+        if (job.format == GL_RGBA8) {
+          glTextureSubImage2D(job.texobj, static_cast<GLint>(level), 0, 0, width, height,
+                              GL_RGBA, GL_UNSIGNED_BYTE, data);
+        } else {
+          glCompressedTextureSubImage2D(job.texobj, static_cast<GLint>(level), 0, 0, width, height, job.format,
+                                        static_cast<GLsizei>(level_offset(job, level + 1) - offset), data);
+        }
+      }
+      if (!staged) {
+        std::vector<GLubyte>().swap(job.texels);
+        job.state = State::RESIDENT;
+        break;
+      }
+      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+      job.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+      job.state = State::UPLOADING;
+      break;
+    }
+
+    case State::UPLOADING: {
+      GLenum const status{ glClientWaitSync(job.fence, 0, 0) };
+      if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+        glDeleteSync(job.fence);
+        job.fence = nullptr;
+        unstage(job.offset);
+        job.offset = -1;
+        if (job.released) {
+          glDeleteTextures(1, &job.texobj);
+          recycle(h);
+          break;
+        }
+        job.state = State::RESIDENT;
+      }
+      break;
+    }
+
+    case State::FAILED:
+      if (!job.error.empty()) {
+        std::cout << job.error << "\n";
+        job.error.clear();
+      }
+      break;
+
+    default:
+      break;
+    }
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! TexLoader::texture
+ * @brief Get the texture object to bind for a handle.
+ *
+ * @param h[in] Handle returned by request.
+ * @return The texture object of h if it is resident, the placeholder otherwise.
+*/
+GLuint TexLoader::texture(Handle h)
+{
+  std::lock_guard<std::mutex> lock{ mutex };
+  return (h < jobs.size() && jobs[h].state == State::RESIDENT) ? jobs[h].texobj : placeholder;
+}
+
+/*  _________________________________________________________________________ */
+/*! TexLoader::state
+ * @brief Get the state of a handle.
+ *
+ * @param h[in] Handle returned by request.
+ * @return The state of h; FAILED if h is not a handle.
+*/
+TexLoader::State TexLoader::state(Handle h)
+{
+  std::lock_guard<std::mutex> lock{ mutex };
+  return (h < jobs.size()) ? jobs[h].state : State::FAILED;
+}
+
+/*  _________________________________________________________________________ */
+/*! TexLoader::pending
+ * @brief Count the requests still loading.
+ *
+ * @param none
+ * @return Number of requests neither resident, failed nor released.
+*/
+GLuint TexLoader::pending()
+{
+  std::lock_guard<std::mutex> lock{ mutex };
+  return static_cast<GLuint>(std::count_if(jobs.begin(), jobs.end(), [](Job const& job) {
+    return job.state != State::RESIDENT && job.state != State::FAILED && job.state != State::RELEASED;
+  }));
+}
+
+/*  _________________________________________________________________________ */
+/*! TexLoader::read
+ * @brief Read the image of a .tex file to RGBA8.
+ *
+ * Gray texels are replicated to RGB and texels without alpha are opaque.
+ * Files without a header must hold a square RGBA8 image. Of a mip-chained
+ * file only the first level is read; block-compressed files are not read.
+ *
+ * @param pathname[in] Path of the file.
+ * @param width[out] Width of the image in texels.
+ * @param height[out] Height of the image in texels.
+ * @param rgba[out] width * height RGBA8 texels, row by row.
+ * @param error[out] Why the file could not be read.
+ * @return false if the file is missing, malformed or truncated.
+*/
+bool TexLoader::read(std::string const& pathname, GLuint& width, GLuint& height,
+                     std::vector<GLubyte>& rgba, std::string& error)
+{
+  std::ifstream ifs{ pathname, std::ios::binary | std::ios::ate };
+  if (!ifs) {
+    error = "Unable to open texture file " + pathname;
+    return false;
+  }
+  std::streamoff const file_size{ ifs.tellg() };
+  ifs.seekg(0);
+
+  Header header{};
+  std::streamoff data_start{ 0 };
+  if (file_size >= static_cast<std::streamoff>(sizeof(header))
+      && ifs.read(reinterpret_cast<char*>(&header), sizeof(header))
+      && (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0
+          || std::memcmp(header.magic, MIP_MAGIC, sizeof(MIP_MAGIC)) == 0)) {
+    data_start = sizeof(header);
+    if (std::memcmp(header.magic, MIP_MAGIC, sizeof(MIP_MAGIC)) == 0) {
+      header.channels = 4;
+    }
+  } else if (std::memcmp(header.magic, BC_MAGIC, sizeof(BC_MAGIC)) == 0) {
+    error = "Texture file " + pathname + " is block-compressed";
+    return false;
+  } else {
+    // no header: a square RGBA8 image
+    GLuint const side{ static_cast<GLuint>(std::lround(std::sqrt(static_cast<double>(file_size / 4)))) };
+    header = Header{ { MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3] }, side, side, 4 };
+    if (static_cast<std::streamoff>(side) * side * 4 != file_size) {
+      error = "Texture file " + pathname + " has no header and is not a square RGBA8 image";
+      return false;
+    }
+  }
+
+  std::streamoff const payload{ static_cast<std::streamoff>(header.width) * header.height * header.channels };
+  if (header.width == 0 || header.height == 0
+      || (header.channels != 1 && header.channels != 3 && header.channels != 4)
+      || file_size - data_start < payload) {
+    error = "Texture file " + pathname + " has a malformed header or is truncated";
+    return false;
+  }
+  width = header.width;
+  height = header.height;
+  rgba.resize(static_cast<size_t>(width) * height * 4);
+
+  ifs.seekg(data_start);
+  if (header.channels == 4) {
+    if (!ifs.read(reinterpret_cast<char*>(rgba.data()), static_cast<std::streamsize>(rgba.size()))) {
+      error = "Unable to read texture file " + pathname;
+      return false;
+    }
+    return true;
+  }
+
+  // expand a row at a time; gray is replicated to RGB, alpha is opaque
+  std::vector<GLubyte> row(static_cast<size_t>(width) * header.channels);
+  for (GLuint y{ 0 }; y < height; ++y) {
+    if (!ifs.read(reinterpret_cast<char*>(row.data()), static_cast<std::streamsize>(row.size()))) {
+      error = "Unable to read texture file " + pathname;
+      return false;
+    }
+    GLubyte* out{ rgba.data() + static_cast<size_t>(y) * width * 4 };
+    for (GLuint x{ 0 }; x < width; ++x, out += 4) {
+      GLubyte const* in{ row.data() + static_cast<size_t>(x) * header.channels };
+      out[0] = in[0];
+      out[1] = (header.channels == 3) ? in[1] : in[0];
+      out[2] = (header.channels == 3) ? in[2] : in[0];
+      out[3] = 0xFF;
+    }
+  }
+  return true;
+}
+
+/*  _________________________________________________________________________ */
+/*! TexLoader::write
+ * @brief Write an image to a .tex file with a header.
+ *
+ * @param pathname[in] Path of the file.
+ * @param width[in] Width of the image in texels.
+ * @param height[in] Height of the image in texels.
+ * @param channels[in] Bytes per texel: 1, 3 or 4.
+ * @param texels[in] width * height texels, row by row.
+ * @return false if the file cannot be written or the arguments are invalid.
+*/
+bool TexLoader::write(std::string const& pathname, GLuint width, GLuint height,
+                      GLuint channels, void const* texels)
+{
+  if (width == 0 || height == 0 || (channels != 1 && channels != 3 && channels != 4)) {
+    return false;
+  }
+  Header const header{ { MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3] }, width, height, channels };
+  std::ofstream ofs{ pathname, std::ios::binary };
+  ofs.write(reinterpret_cast<char const*>(&header), sizeof(header));
+  ofs.write(static_cast<char const*>(texels),
+            static_cast<std::streamsize>(width) * height * channels);
+  return static_cast<bool>(ofs);
+}
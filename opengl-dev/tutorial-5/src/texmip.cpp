@@ -0,0 +1,402 @@
+/*!
+* @file    texmip.cpp
+* @author  brandonjunjie.ho@digipen.edu
+* @date    7/21/2023
+*
+* @brief This file implements the mipmap chain builder declared in texmip.h.
+*		 Levels are kept as 4 linear floats per texel while they are
+*		 filtered, which lets SSE2 filter one texel per instruction. sRGB
+*		 bytes are decoded through a 256 entry table and linear values are
+*		 encoded through a 65536 entry table indexed by the value scaled to
+*		 16 bits, whose steps are finer than those of sRGB near black.
+*//*__________________________________________________________________________*/
+
+/*                                                                   includes
+----------------------------------------------------------------------------- */
+#include <texmip.h>
+#include <texloader.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define TEXMIP_SSE2
+#endif
+
+/*                                                   objects with file scope
+----------------------------------------------------------------------------- */
+namespace {
+  char const MIP_MAGIC[4]{ 'T', 'E', 'X', 'M' };
+
+  // taps of the Kaiser filter; tap k reads source texel 2x - 2 + k
+  int const KAISER_TAPS{ 6 };
+
+  // conversion tables and filter weights, built on first use
+  struct Tables {
+    float decode[256];       // sRGB byte to linear
+    GLubyte encode[65536];   // linear scaled to 16 bits to sRGB byte
+    float kaiser[KAISER_TAPS];
+
+    Tables()
+    {
+      for (int i{ 0 }; i < 256; ++i) {
+        double const c{ i / 255.0 };
+        decode[i] = static_cast<float>((c <= 0.04045) ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4));
+      }
+      for (int i{ 0 }; i < 65536; ++i) {
+        double const l{ i / 65535.0 };
+        double const c{ (l <= 0.0031308) ? 12.92 * l : 1.055 * std::pow(l, 1.0 / 2.4) - 0.055 };
+        encode[i] = static_cast<GLubyte>(std::lround(std::clamp(c, 0.0, 1.0) * 255.0));
+      }
+
+      // sinc halving the frequencies, windowed by a Kaiser window of
+      // alpha 4 reaching 3 source texels from the center
+      auto const bessel_i0 = [](double x) {
+        double sum{ 1.0 }, term{ 1.0 };
+        for (int k{ 1 }; k < 20; ++k) {
+          term *= (x / (2.0 * k)) * (x / (2.0 * k));
+          sum += term;
+        }
+        return sum;
+      };
+      double const pi{ 3.14159265358979323846 }, alpha{ 4.0 }, radius{ 3.0 };
+      double weights[KAISER_TAPS], total{ 0.0 };
+      for (int k{ 0 }; k < KAISER_TAPS; ++k) {
+        double const d{ k - 2.5 };
+        double const sinc{ std::sin(pi * d / 2.0) / (pi * d / 2.0) };
+        double const window{ bessel_i0(alpha * std::sqrt(1.0 - (d / radius) * (d / radius))) / bessel_i0(alpha) };
+        weights[k] = sinc * window;
+        total += weights[k];
+      }
+      for (int k{ 0 }; k < KAISER_TAPS; ++k) {
+        kaiser[k] = static_cast<float>(weights[k] / total);
+      }
+    }
+  };
+
+  Tables const& tables()
+  {
+    static Tables const t;
+    return t;
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! add_scaled
+   * @brief Add weight times the texel at src to the texel at dst.
+  */
+  inline void add_scaled(float* dst, float const* src, float weight)
+  {
+#ifdef TEXMIP_SSE2
+    _mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(_mm_loadu_ps(src), _mm_set1_ps(weight))));
+#else
+    for (int c{ 0 }; c < 4; ++c) {
+      dst[c] += src[c] * weight;
+    }
+#endif
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! box
+   * @brief Average 2 x 2 texels of src into each texel of dst.
+   *
+   * The last row or column of an odd-sized level is averaged with itself.
+  */
+  void box(float const* src, GLuint sw, GLuint sh, float* dst, GLuint dw, GLuint dh)
+  {
+    for (GLuint y{ 0 }; y < dh; ++y) {
+      float const* row0{ src + 4 * static_cast<size_t>(sw) * std::min(2 * y, sh - 1) };
+      float const* row1{ src + 4 * static_cast<size_t>(sw) * std::min(2 * y + 1, sh - 1) };
+      float* out{ dst + 4 * static_cast<size_t>(dw) * y };
+      for (GLuint x{ 0 }; x < dw; ++x, out += 4) {
+        size_t const x0{ 4 * static_cast<size_t>(std::min(2 * x, sw - 1)) };
+        size_t const x1{ 4 * static_cast<size_t>(std::min(2 * x + 1, sw - 1)) };
+#ifdef TEXMIP_SSE2
+        __m128 const sum{ _mm_add_ps(_mm_add_ps(_mm_loadu_ps(row0 + x0), _mm_loadu_ps(row0 + x1)),
+                                     _mm_add_ps(_mm_loadu_ps(row1 + x0), _mm_loadu_ps(row1 + x1))) };
+        _mm_storeu_ps(out, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+#else
+        for (int c{ 0 }; c < 4; ++c) {
+          out[c] = ((row0[x0 + c] + row0[x1 + c]) + (row1[x0 + c] + row1[x1 + c])) * 0.25f;
+        }
+#endif
+      }
+    }
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! kaiser
+   * @brief Filter src into dst with the Kaiser taps, rows first into tmp.
+   *
+   * Taps past the edges read the edge texels.
+  */
+  void kaiser(float const* src, GLuint sw, GLuint sh, float* tmp, float* dst, GLuint dw, GLuint dh)
+  {
+    float const* const w{ tables().kaiser };
+
+    std::fill(tmp, tmp + 4 * static_cast<size_t>(dw) * sh, 0.f);
+    for (GLuint y{ 0 }; y < sh; ++y) {
+      float const* in{ src + 4 * static_cast<size_t>(sw) * y };
+      float* out{ tmp + 4 * static_cast<size_t>(dw) * y };
+      for (GLuint x{ 0 }; x < dw; ++x, out += 4) {
+        for (int k{ 0 }; k < KAISER_TAPS; ++k) {
+          GLint const sx{ std::clamp(static_cast<GLint>(2 * x) - 2 + k, 0, static_cast<GLint>(sw) - 1) };
+          add_scaled(out, in + 4 * static_cast<size_t>(sx), w[k]);
+        }
+      }
+    }
+
+    std::fill(dst, dst + 4 * static_cast<size_t>(dw) * dh, 0.f);
+    for (GLuint y{ 0 }; y < dh; ++y) {
+      float* out{ dst + 4 * static_cast<size_t>(dw) * y };
+      for (int k{ 0 }; k < KAISER_TAPS; ++k) {
+        GLint const sy{ std::clamp(static_cast<GLint>(2 * y) - 2 + k, 0, static_cast<GLint>(sh) - 1) };
+        float const* in{ tmp + 4 * static_cast<size_t>(dw) * static_cast<size_t>(sy) };
+        for (GLuint x{ 0 }; x < dw; ++x) {
+          add_scaled(out + 4 * static_cast<size_t>(x), in + 4 * static_cast<size_t>(x), w[k]);
+        }
+      }
+    }
+  }
+
+  /*  _______________________________________________________________________ */
+  /*! encode
+   * @brief Convert cnt linear float texels to sRGB RGBA8 texels.
+   *
+   * Values are clamped to [0, 1] first, as the Kaiser filter overshoots.
+  */
+  void encode(float const* level, size_t cnt, GLubyte* out)
+  {
+    Tables const& t{ tables() };
+    for (size_t i{ 0 }; i < cnt; ++i, level += 4, out += 4) {
+      alignas(16) GLint q[4];
+#ifdef TEXMIP_SSE2
+      __m128 const v{ _mm_min_ps(_mm_max_ps(_mm_loadu_ps(level), _mm_setzero_ps()), _mm_set1_ps(1.f)) };
+      __m128 const scale{ _mm_setr_ps(65535.f, 65535.f, 65535.f, 255.f) };
+      _mm_store_si128(reinterpret_cast<__m128i*>(q), _mm_cvtps_epi32(_mm_mul_ps(v, scale)));
+#else
+      for (int c{ 0 }; c < 4; ++c) {
+        q[c] = static_cast<GLint>(std::nearbyint(std::clamp(level[c], 0.f, 1.f) * (c < 3 ? 65535.f : 255.f)));
+      }
+#endif
+      out[0] = t.encode[q[0]];
+      out[1] = t.encode[q[1]];
+      out[2] = t.encode[q[2]];
+      out[3] = static_cast<GLubyte>(q[3]);
+    }
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! TexMip::level_count
+ * @brief Count the levels of a full mipmap chain.
+ *
+ * @param width[in] Width of the image in texels.
+ * @param height[in] Height of the image in texels.
+ * @return 1 + floor(log2(max(width, height))).
+*/
+GLuint TexMip::level_count(GLuint width, GLuint height)
+{
+  GLuint levels{ 1 };
+  for (GLuint size{ std::max(width, height) }; size > 1; size >>= 1) {
+    ++levels;
+  }
+  return levels;
+}
+
+/*  _________________________________________________________________________ */
+/*! TexMip::level_offset
+ * @brief Find where a level starts in a chain.
+ *
+ * @param width[in] Width of the image in texels.
+ * @param height[in] Height of the image in texels.
+ * @param level[in] Level; the bytes of the whole chain if it is the level count.
+ * @return Bytes of the RGBA8 levels before level.
+*/
+GLsizeiptr TexMip::level_offset(GLuint width, GLuint height, GLuint level)
+{
+  GLsizeiptr offset{ 0 };
+  for (GLuint l{ 0 }; l < level; ++l) {
+    offset += static_cast<GLsizeiptr>(level_size(width, l)) * level_size(height, l) * 4;
+  }
+  return offset;
+}
+
+/*  _________________________________________________________________________ */
+/*! TexMip::level_size
+ * @brief Compute the width or height of a level.
+ *
+ * @param size[in] Width or height of the image in texels.
+ * @param level[in] Level.
+ * @return max(1, size >> level).
+*/
+GLuint TexMip::level_size(GLuint size, GLuint level)
+{
+  return (level >= 32) ? 1 : std::max(1u, size >> level);
+}
+
+/*  _________________________________________________________________________ */
+/*! TexMip::build
+ * @brief Build a mipmap chain of an RGBA8 image.
+ *
+ * Level 0 is the image itself. Each other level is filtered from the
+ * linear floats of the level before it and encoded to sRGB bytes.
+ *
+ * @param rgba[in] width * height RGBA8 texels, row by row.
+ * @param width[in] Width of the image in texels.
+ * @param height[in] Height of the image in texels.
+ * @param levels[in] Levels to build, at most level_count(width, height).
+ * @param filter[in] Filter computing a level from the one before it.
+ * @param chain[out] Receives the levels end to end.
+ * @return void
+*/
+void TexMip::build(GLubyte const* rgba, GLuint width, GLuint height, GLuint levels,
+                   Filter filter, GLubyte* chain)
+{
+  size_t const base_cnt{ static_cast<size_t>(width) * height };
+  std::memcpy(chain, rgba, 4 * base_cnt);
+  if (levels <= 1) {
+    return;
+  }
+
+  Tables const& t{ tables() };
+  std::vector<float> level(4 * base_cnt), next, tmp;
+  for (size_t i{ 0 }; i < base_cnt; ++i) {
+    level[4 * i + 0] = t.decode[rgba[4 * i + 0]];
+    level[4 * i + 1] = t.decode[rgba[4 * i + 1]];
+    level[4 * i + 2] = t.decode[rgba[4 * i + 2]];
+    level[4 * i + 3] = rgba[4 * i + 3] * (1.f / 255.f);
+  }
+
+  for (GLuint l{ 1 }; l < levels; ++l) {
+    GLuint const sw{ level_size(width, l - 1) }, sh{ level_size(height, l - 1) };
+    GLuint const dw{ level_size(width, l) }, dh{ level_size(height, l) };
+    next.resize(4 * static_cast<size_t>(dw) * dh);
+    if (filter == Filter::KAISER) {
+      tmp.resize(4 * static_cast<size_t>(dw) * sh);
+      kaiser(level.data(), sw, sh, tmp.data(), next.data(), dw, dh);
+    } else {
+      box(level.data(), sw, sh, next.data(), dw, dh);
+    }
+    encode(next.data(), static_cast<size_t>(dw) * dh, chain + level_offset(width, height, l));
+    level.swap(next);
+  }
+}
+
+/*  _________________________________________________________________________ */
+/*! TexMip::convert
+ * @brief Write the full mipmap chain of a .tex file to a mip-chained .tex file.
+ *
+ * @param src[in] Path of the .tex file read with TexLoader::read.
+ * @param dst[in] Path of the file written.
+ * @param filter[in] Filter of the chain.
+ * @param error[out] Why a file could not be read or written.
+ * @return false if src cannot be read or dst cannot be written.
+*/
+bool TexMip::convert(std::string const& src, std::string const& dst, Filter filter,
+                     std::string& error)
+{
+  GLuint width, height;
+  std::vector<GLubyte> rgba;
+  if (!TexLoader::read(src, width, height, rgba, error)) {
+    return false;
+  }
+
+  Header const header{ { MIP_MAGIC[0], MIP_MAGIC[1], MIP_MAGIC[2], MIP_MAGIC[3] },
+                       width, height, level_count(width, height) };
+  std::vector<GLubyte> chain(static_cast<size_t>(level_offset(width, height, header.levels)));
+  build(rgba.data(), width, height, header.levels, filter, chain.data());
+
+  std::ofstream ofs{ dst, std::ios::binary };
+  ofs.write(reinterpret_cast<char const*>(&header), sizeof(header));
+  ofs.write(reinterpret_cast<char const*>(chain.data()), static_cast<std::streamsize>(chain.size()));
+  if (!ofs) {
+    error = "Unable to write texture file " + dst;
+    return false;
+  }
+  return true;
+}
+
+/*  _________________________________________________________________________ */
+/*! TexMip::benchmark
+ * @brief Print the time to build and upload mipmap chains of images.
+ *
+ * For each image the table shows, averaged over several runs:
+ * - Box, Kaiser: building the chain on the CPU, which TexLoader does on a
+ *   worker thread.
+ * - Chain upload: copying every level of the box chain to a texture.
+ * - Generate: copying the image and filling the other levels with
+ *   glGenerateTextureMipmap; these two are what the render thread waits on.
+ * - Level 1 diff: mean absolute difference in bytes between level 1 of
+ *   glGenerateTextureMipmap and the gamma-correct box level 1.
+ *
+ * @param pathnames[in] Paths of the .tex files.
+ * @return void
+*/
+void TexMip::benchmark(std::vector<std::string> const& pathnames)
+{
+  int const runs{ 20 };
+  auto const time_ms = [runs](auto&& run) {
+    auto const start{ std::chrono::steady_clock::now() };
+    for (int r{ 0 }; r < runs; ++r) {
+      run();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / runs;
+  };
+
+  std::cout << "Image\t\t\t|\tBox (ms)\t|\tKaiser (ms)\t|\tChain upload (ms)\t|\tGenerate (ms)\t|\tLevel 1 diff\n";
+  std::cout << "--------------------------------------------------------------------------------------------------------------------------\n";
+  for (std::string const& pathname : pathnames) {
+    GLuint width, height;
+    std::vector<GLubyte> rgba;
+    std::string error;
+    if (!TexLoader::read(pathname, width, height, rgba, error)) {
+      std::cout << error << "\n";
+      continue;
+    }
+    GLuint const levels{ level_count(width, height) };
+    std::vector<GLubyte> chain(static_cast<size_t>(level_offset(width, height, levels)));
+
+    double const kaiser_ms{ time_ms([&] { build(rgba.data(), width, height, levels, Filter::KAISER, chain.data()); }) };
+    double const box_ms{ time_ms([&] { build(rgba.data(), width, height, levels, Filter::BOX, chain.data()); }) };
+
+    GLuint texobj;
+    glCreateTextures(GL_TEXTURE_2D, 1, &texobj);
+    glTextureStorage2D(texobj, static_cast<GLsizei>(levels), GL_RGBA8, width, height);
+
+    glFinish();
+    double const upload_ms{ time_ms([&] {
+      for (GLuint l{ 0 }; l < levels; ++l) {
+        glTextureSubImage2D(texobj, static_cast<GLint>(l), 0, 0, level_size(width, l), level_size(height, l),
+                            GL_RGBA, GL_UNSIGNED_BYTE, chain.data() + level_offset(width, height, l));
+      }
+      glFinish();
+    }) };
+    double const generate_ms{ time_ms([&] {
+      glTextureSubImage2D(texobj, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+      glGenerateTextureMipmap(texobj);
+      glFinish();
+    }) };
+
+    double diff{ 0.0 };
+    if (levels > 1) {
+      GLsizeiptr const offset{ level_offset(width, height, 1) };
+      std::vector<GLubyte> generated(static_cast<size_t>(level_offset(width, height, 2) - offset));
+      glGetTextureImage(texobj, 1, GL_RGBA, GL_UNSIGNED_BYTE, static_cast<GLsizei>(generated.size()),
+                        generated.data());
+      for (size_t i{ 0 }; i < generated.size(); ++i) {
+        diff += std::abs(static_cast<int>(generated[i]) - static_cast<int>(chain[offset + i]));
+      }
+      diff /= static_cast<double>(generated.size());
+    }
+    glDeleteTextures(1, &texobj);
+
+    std::cout << pathname << "\t|\t" << std::setprecision(3) << std::fixed
+              << box_ms << "\t\t|\t" << kaiser_ms << "\t\t|\t" << upload_ms << "\t\t\t|\t"
+              << generate_ms << "\t\t|\t" << diff << std::defaultfloat << "\n";
+  }
+  std::cout << "--------------------------------------------------------------------------------------------------------------------------\n";
+}